@@ -0,0 +1,234 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#pragma once
+
+#include "double_util.h"
+#include "matrix44.h"
+#include "point.h"
+#include "ray.h"
+#include "vector.h"
+
+#include <array>
+#include <cassert>
+#include <cinttypes>
+#include <stdexcept>
+
+namespace rtc
+{
+    // Affine transform stored as the top three rows of a 4x4 matrix. The implied bottom row is
+    // always 0 0 0 1, so points, vectors, and normals can be transformed with 9 multiplies instead
+    // of the 16 required for a full 4x4 matrix-tuple product.
+    template <typename T>
+    class BasicAffine34
+    {
+    public:
+        constexpr BasicAffine34() : data_{}
+        {
+        }
+
+        constexpr BasicAffine34(std::array<std::array<T, 4>, 3>&& data) :
+            data_(std::move(data))
+        {
+        }
+
+        // Drop the bottom row of a 4x4 matrix, which must describe an affine transform.
+        constexpr BasicAffine34(const BasicMatrix<T, 4, 4>& matrix)
+        {
+            assert(rtc::Equal(matrix.Get(3u, 0u), T{ 0 }) &&
+                   rtc::Equal(matrix.Get(3u, 1u), T{ 0 }) &&
+                   rtc::Equal(matrix.Get(3u, 2u), T{ 0 }) &&
+                   rtc::Equal(matrix.Get(3u, 3u), T{ 1 }) &&
+                   "rtc::Affine34 was initialized with a matrix that is not an affine transform");
+
+            for (uint32_t row = 0u; row < 3u; ++row)
+            {
+                for (uint32_t column = 0u; column < 4u; ++column)
+                {
+                    data_[row][column] = matrix.Get(row, column);
+                }
+            }
+        }
+
+        constexpr void Set(uint32_t row, uint32_t column, T value) { data_[row][column] = value; }
+
+        constexpr T Get(uint32_t row, uint32_t column) const { return data_[row][column]; }
+
+        // Expand to a 4x4 matrix with the implied bottom row.
+        constexpr BasicMatrix44<T> ToMatrix44() const
+        {
+            auto matrix = BasicMatrix44<T>::Identity();
+
+            for (uint32_t row = 0u; row < 3u; ++row)
+            {
+                for (uint32_t column = 0u; column < 4u; ++column)
+                {
+                    matrix.Set(row, column, data_[row][column]);
+                }
+            }
+
+            return matrix;
+        }
+
+        //
+        // Static operations that may create new transform objects.
+        //
+
+        static constexpr bool Equal(const BasicAffine34& lhs, const BasicAffine34& rhs)
+        {
+            for (uint32_t row = 0u; row < 3u; ++row)
+            {
+                for (uint32_t column = 0u; column < 4u; ++column)
+                {
+                    if (!rtc::Equal(lhs.data_[row][column], rhs.data_[row][column]))
+                    {
+                        return false;
+                    }
+                }
+            }
+
+            return true;
+        }
+
+        static constexpr BasicAffine34 Identity()
+        {
+            return BasicAffine34{ {{
+                    {{ T{ 1 }, T{ 0 }, T{ 0 }, T{ 0 } }},
+                    {{ T{ 0 }, T{ 1 }, T{ 0 }, T{ 0 } }},
+                    {{ T{ 0 }, T{ 0 }, T{ 1 }, T{ 0 } }}
+                    }} };
+        }
+
+        static constexpr BasicAffine34 Multiply(const BasicAffine34& lhs, const BasicAffine34& rhs)
+        {
+            auto result = BasicAffine34{};
+
+            for (uint32_t row = 0u; row < 3u; ++row)
+            {
+                for (uint32_t column = 0u; column < 4u; ++column)
+                {
+                    result.data_[row][column] =
+                        (lhs.data_[row][0u] * rhs.data_[0u][column]) +
+                        (lhs.data_[row][1u] * rhs.data_[1u][column]) +
+                        (lhs.data_[row][2u] * rhs.data_[2u][column]);
+                }
+
+                // The implied bottom row of rhs contributes lhs's translation.
+                result.data_[row][3u] += lhs.data_[row][3u];
+            }
+
+            return result;
+        }
+
+        // Transform a point, applying both the linear part and the translation.
+        static constexpr BasicPoint<T> TransformPoint(const BasicAffine34& m, const BasicPoint<T>& point)
+        {
+            const auto x = point.GetX();
+            const auto y = point.GetY();
+            const auto z = point.GetZ();
+
+            return BasicPoint<T>{
+                (m.data_[0u][0u] * x) + (m.data_[0u][1u] * y) + (m.data_[0u][2u] * z) + m.data_[0u][3u],
+                (m.data_[1u][0u] * x) + (m.data_[1u][1u] * y) + (m.data_[1u][2u] * z) + m.data_[1u][3u],
+                (m.data_[2u][0u] * x) + (m.data_[2u][1u] * y) + (m.data_[2u][2u] * z) + m.data_[2u][3u] };
+        }
+
+        // Transform a vector, which is unaffected by translation.
+        static constexpr BasicVector<T> TransformVector(const BasicAffine34& m, const BasicVector<T>& vector)
+        {
+            const auto x = vector.GetX();
+            const auto y = vector.GetY();
+            const auto z = vector.GetZ();
+
+            return BasicVector<T>{
+                (m.data_[0u][0u] * x) + (m.data_[0u][1u] * y) + (m.data_[0u][2u] * z),
+                (m.data_[1u][0u] * x) + (m.data_[1u][1u] * y) + (m.data_[1u][2u] * z),
+                (m.data_[2u][0u] * x) + (m.data_[2u][1u] * y) + (m.data_[2u][2u] * z) };
+        }
+
+        // Transform a surface normal with the transpose of the linear part of m. When m is the
+        // inverse of an object's transform, this maps an object space normal to world space without
+        // storing a separate transposed matrix. The result is not normalized.
+        static constexpr BasicVector<T> TransformNormal(const BasicAffine34& m, const BasicVector<T>& normal)
+        {
+            const auto x = normal.GetX();
+            const auto y = normal.GetY();
+            const auto z = normal.GetZ();
+
+            return BasicVector<T>{
+                (m.data_[0u][0u] * x) + (m.data_[1u][0u] * y) + (m.data_[2u][0u] * z),
+                (m.data_[0u][1u] * x) + (m.data_[1u][1u] * y) + (m.data_[2u][1u] * z),
+                (m.data_[0u][2u] * x) + (m.data_[1u][2u] * y) + (m.data_[2u][2u] * z) };
+        }
+
+        static constexpr BasicRay<T> Transform(const BasicRay<T>& ray, const BasicAffine34& m)
+        {
+            return BasicRay<T>{ TransformPoint(m, ray.GetOrigin()), TransformVector(m, ray.GetDirection()) };
+        }
+
+        static constexpr BasicAffine34 Inverse(const BasicAffine34& m)
+        {
+            // Invert the 3x3 linear part with its cofactors, then move the translation into the
+            // inverted space: inverse(L | t) = (inverse(L) | -inverse(L) * t).
+            const auto c00 = (m.data_[1u][1u] * m.data_[2u][2u]) - (m.data_[1u][2u] * m.data_[2u][1u]);
+            const auto c01 = (m.data_[1u][2u] * m.data_[2u][0u]) - (m.data_[1u][0u] * m.data_[2u][2u]);
+            const auto c02 = (m.data_[1u][0u] * m.data_[2u][1u]) - (m.data_[1u][1u] * m.data_[2u][0u]);
+
+            const auto determinant = (m.data_[0u][0u] * c00) + (m.data_[0u][1u] * c01) + (m.data_[0u][2u] * c02);
+
+            if (rtc::Equal(determinant, T{ 0 }))
+            {
+                throw std::runtime_error("Attempt to invert a non-invertible matrix");
+            }
+
+            const auto inv_det = T{ 1 } / determinant;
+            auto       inverse = BasicAffine34{};
+
+            inverse.data_[0u][0u] = c00 * inv_det;
+            inverse.data_[1u][0u] = c01 * inv_det;
+            inverse.data_[2u][0u] = c02 * inv_det;
+            inverse.data_[0u][1u] = ((m.data_[0u][2u] * m.data_[2u][1u]) - (m.data_[0u][1u] * m.data_[2u][2u])) * inv_det;
+            inverse.data_[1u][1u] = ((m.data_[0u][0u] * m.data_[2u][2u]) - (m.data_[0u][2u] * m.data_[2u][0u])) * inv_det;
+            inverse.data_[2u][1u] = ((m.data_[0u][1u] * m.data_[2u][0u]) - (m.data_[0u][0u] * m.data_[2u][1u])) * inv_det;
+            inverse.data_[0u][2u] = ((m.data_[0u][1u] * m.data_[1u][2u]) - (m.data_[0u][2u] * m.data_[1u][1u])) * inv_det;
+            inverse.data_[1u][2u] = ((m.data_[0u][2u] * m.data_[1u][0u]) - (m.data_[0u][0u] * m.data_[1u][2u])) * inv_det;
+            inverse.data_[2u][2u] = ((m.data_[0u][0u] * m.data_[1u][1u]) - (m.data_[0u][1u] * m.data_[1u][0u])) * inv_det;
+
+            for (uint32_t row = 0u; row < 3u; ++row)
+            {
+                inverse.data_[row][3u] = -((inverse.data_[row][0u] * m.data_[0u][3u]) +
+                                           (inverse.data_[row][1u] * m.data_[1u][3u]) +
+                                           (inverse.data_[row][2u] * m.data_[2u][3u]));
+            }
+
+            return inverse;
+        }
+
+    private:
+        using Row = std::array<T, 4>;
+
+    private:
+        std::array<Row, 3> data_;
+    };
+
+    using Affine34 = BasicAffine34<Scalar>;
+}
@@ -0,0 +1,159 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "catch2/catch.hpp"
+
+#include "affine34.h"
+#include "double_util.h"
+#include "matrix44.h"
+#include "point.h"
+#include "ray.h"
+#include "vector.h"
+
+const rtc::Matrix44 kChained = rtc::Matrix44::Multiply(
+    rtc::Matrix44::Translation(10.0, 5.0, 7.0),
+    rtc::Matrix44::Scaling(5.0, 5.0, 5.0),
+    rtc::Matrix44::RotationX(rtc::kPi / 2.0),
+    rtc::Matrix44::Shearing(1.0, 0.0, 0.0, 0.0, 0.0, 1.0));
+
+SCENARIO("An affine transform expands to the original 4x4 matrix", "[affine]")
+{
+    GIVEN("m <- translation(10, 5, 7) * scaling(5, 5, 5) * rotation_x(pi / 2) * shearing(1, 0, 0, 0, 0, 1)")
+    {
+        WHEN("a <- affine34(m)")
+        {
+            const auto a = rtc::Affine34{ kChained };
+
+            THEN("to_matrix44(a) = m")
+            {
+                REQUIRE(rtc::Matrix44::Equal(a.ToMatrix44(), kChained));
+            }
+        }
+    }
+}
+
+SCENARIO("Transforming points and vectors with an affine transform", "[affine]")
+{
+    GIVEN("a <- affine34(m) and p <- point(1, -2, 3) and v <- vector(-4, 5, 6)")
+    {
+        const auto a = rtc::Affine34{ kChained };
+        const auto p = rtc::Point{ 1.0, -2.0, 3.0 };
+        const auto v = rtc::Vector{ -4.0, 5.0, 6.0 };
+
+        THEN("transform_point(a, p) = m * p and transform_vector(a, v) = m * v")
+        {
+            REQUIRE(rtc::Tuple::Equal(rtc::Affine34::TransformPoint(a, p), rtc::Matrix44::Multiply(kChained, p)));
+            REQUIRE(rtc::Tuple::Equal(rtc::Affine34::TransformVector(a, v), rtc::Matrix44::Multiply(kChained, v)));
+        }
+    }
+}
+
+SCENARIO("Transforming a normal with an affine transform", "[affine]")
+{
+    GIVEN("a <- affine34(m) and n <- vector(0, 1, 0)")
+    {
+        const auto a = rtc::Affine34{ kChained };
+        const auto n = rtc::Vector{ 0.0, 1.0, 0.0 };
+
+        THEN("transform_normal(a, n) = transpose(m) * n, with w = 0")
+        {
+            const auto expected = rtc::Matrix44::Multiply(rtc::Matrix44::Transpose(kChained), n);
+            const auto normal   = rtc::Affine34::TransformNormal(a, n);
+
+            REQUIRE(rtc::Equal(normal.GetX(), expected.GetX()));
+            REQUIRE(rtc::Equal(normal.GetY(), expected.GetY()));
+            REQUIRE(rtc::Equal(normal.GetZ(), expected.GetZ()));
+            REQUIRE(rtc::Equal(normal.GetW(), 0.0));
+        }
+    }
+}
+
+SCENARIO("Inverting an affine transform", "[affine]")
+{
+    GIVEN("a <- affine34(m)")
+    {
+        const auto a = rtc::Affine34{ kChained };
+
+        WHEN("inv <- inverse(a)")
+        {
+            const auto inv = rtc::Affine34::Inverse(a);
+
+            THEN("inv = inverse(m) and inv * a = identity")
+            {
+                REQUIRE(rtc::Matrix44::Equal(inv.ToMatrix44(), rtc::Matrix44::Inverse(kChained)));
+                REQUIRE(rtc::Affine34::Equal(rtc::Affine34::Multiply(inv, a), rtc::Affine34::Identity()));
+            }
+        }
+    }
+}
+
+SCENARIO("Inverting a non-invertible affine transform", "[affine]")
+{
+    GIVEN("a <- affine34(scaling(1, 0, 1))")
+    {
+        const auto a = rtc::Affine34{ rtc::Matrix44::Scaling(1.0, 0.0, 1.0) };
+
+        THEN("inverse(a) throws")
+        {
+            REQUIRE_THROWS_AS(rtc::Affine34::Inverse(a), std::runtime_error);
+        }
+    }
+}
+
+SCENARIO("Multiplying affine transforms", "[affine]")
+{
+    GIVEN("a <- affine34(translation(1, 2, 3)) and b <- affine34(rotation_y(pi / 4) * scaling(2, 3, 4))")
+    {
+        const auto ma = rtc::Matrix44::Translation(1.0, 2.0, 3.0);
+        const auto mb = rtc::Matrix44::Multiply(rtc::Matrix44::RotationY(rtc::kPi / 4.0), rtc::Matrix44::Scaling(2.0, 3.0, 4.0));
+        const auto a  = rtc::Affine34{ ma };
+        const auto b  = rtc::Affine34{ mb };
+
+        THEN("a * b = affine34(ma * mb)")
+        {
+            REQUIRE(rtc::Matrix44::Equal(rtc::Affine34::Multiply(a, b).ToMatrix44(), rtc::Matrix44::Multiply(ma, mb)));
+        }
+    }
+}
+
+SCENARIO("Transforming a ray with an affine transform", "[affine]")
+{
+    GIVEN("r <- ray(point(1, 2, 3), vector(0, 1, 0)) and a <- affine34(translation(3, 4, 5) * scaling(2, 3, 4))")
+    {
+        const auto r = rtc::Ray{ rtc::Point{ 1.0, 2.0, 3.0 }, rtc::Vector{ 0.0, 1.0, 0.0 } };
+        const auto m = rtc::Matrix44::Multiply(rtc::Matrix44::Translation(3.0, 4.0, 5.0), rtc::Matrix44::Scaling(2.0, 3.0, 4.0));
+        const auto a = rtc::Affine34{ m };
+
+        WHEN("r2 <- transform(r, a)")
+        {
+            const auto r2 = rtc::Affine34::Transform(r, a);
+
+            THEN("r2 = transform(r, m)")
+            {
+                const auto expected = rtc::Matrix44::Transform(r, m);
+
+                REQUIRE(rtc::Point::Equal(r2.GetOrigin(), expected.GetOrigin()));
+                REQUIRE(rtc::Vector::Equal(r2.GetDirection(), expected.GetDirection()));
+            }
+        }
+    }
+}
@@ -0,0 +1,199 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "animation.h"
+
+#include "affine34.h"
+#include "parallel_bands.h"
+#include "ray_budget.h"
+#include "render_region.h"
+#include "shadow_cache.h"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace rtc
+{
+    namespace
+    {
+        // Rows rendered by a thread at a time.
+        constexpr uint32_t kBandHeight = 16u;
+
+        Vector Lerp(const Vector& lhs, const Vector& rhs, Scalar t)
+        {
+            return Vector{ Vector::Add(lhs, Vector::Multiply(Vector::Subtract(rhs, lhs), t)) };
+        }
+    }
+
+    Matrix44 Keyframe::GetTransform() const
+    {
+        return Matrix44::Multiply(
+            Matrix44::Translation(translation_.GetX(), translation_.GetY(), translation_.GetZ()),
+            Matrix44::RotationZ(rotation_.GetZ()),
+            Matrix44::RotationY(rotation_.GetY()),
+            Matrix44::RotationX(rotation_.GetX()),
+            Matrix44::Scaling(scale_.GetX(), scale_.GetY(), scale_.GetZ()));
+    }
+
+    Keyframe Keyframe::Interpolate(const Keyframe& lhs, const Keyframe& rhs, Scalar time, Scalar t)
+    {
+        return Keyframe{
+            time,
+            Lerp(lhs.translation_, rhs.translation_, t),
+            Lerp(lhs.rotation_, rhs.rotation_, t),
+            Lerp(lhs.scale_, rhs.scale_, t) };
+    }
+
+    TransformTrack::TransformTrack(const Keyframes& keyframes)
+    {
+        for (const auto& keyframe : keyframes)
+        {
+            AddKeyframe(keyframe);
+        }
+    }
+
+    void TransformTrack::AddKeyframe(const Keyframe& keyframe)
+    {
+        const auto position = std::upper_bound(keyframes_.begin(), keyframes_.end(), keyframe.GetTime(), [](Scalar time, const Keyframe& key) {
+            return time < key.GetTime();
+        });
+
+        keyframes_.insert(position, keyframe);
+    }
+
+    Matrix44 TransformTrack::TransformAt(Scalar time) const
+    {
+        if (keyframes_.empty())
+        {
+            return Matrix44::Identity();
+        }
+
+        // First key after the time.
+        const auto next = std::upper_bound(keyframes_.begin(), keyframes_.end(), time, [](Scalar time, const Keyframe& key) {
+            return time < key.GetTime();
+        });
+
+        if (next == keyframes_.begin())
+        {
+            return next->GetTransform();
+        }
+
+        if (next == keyframes_.end())
+        {
+            return keyframes_.back().GetTransform();
+        }
+
+        const auto& previous = *(next - 1);
+        const auto  t        = (time - previous.GetTime()) / (next->GetTime() - previous.GetTime());
+
+        return Keyframe::Interpolate(previous, *next, time, t).GetTransform();
+    }
+
+    void Animation::AnimateObject(const std::shared_ptr<Shape>& object, const TransformTrack& track)
+    {
+        assert(object && "rtc::Animation::AnimateObject requires an object");
+        object_tracks_.emplace_back(ObjectTrack{ object, object->GetTransform(), track });
+    }
+
+    void Animation::AnimateLight(const World& world, size_t light_index, const TransformTrack& track)
+    {
+        light_tracks_.emplace_back(LightTrack{ light_index, world.GetLight(light_index).GetPosition(), track });
+    }
+
+    void Animation::AnimateCamera(const Camera& camera, const TransformTrack& track)
+    {
+        camera_transform_ = camera.GetTransform();
+        camera_track_     = track;
+    }
+
+    Scalar Animation::GetDuration() const
+    {
+        auto duration = camera_track_.GetDuration();
+
+        for (const auto& object_track : object_tracks_)
+        {
+            duration = std::max(duration, object_track.track.GetDuration());
+        }
+
+        for (const auto& light_track : light_tracks_)
+        {
+            duration = std::max(duration, light_track.track.GetDuration());
+        }
+
+        return duration;
+    }
+
+    void Animation::Apply(Scalar time, World& world, Camera& camera) const
+    {
+        for (const auto& object_track : object_tracks_)
+        {
+            object_track.object->SetTransform(Matrix44::Multiply(object_track.track.TransformAt(time), object_track.transform));
+        }
+
+        if (!light_tracks_.empty())
+        {
+            for (const auto& light_track : light_tracks_)
+            {
+                world.SetLightPosition(light_track.light_index, Affine34::TransformPoint(Affine34{ light_track.track.TransformAt(time) }, light_track.position));
+            }
+
+            world.RefitLightTree();
+        }
+
+        if (IsCameraAnimated())
+        {
+            camera.SetTransform(Matrix44::Multiply(camera_transform_, Matrix44::Inverse(camera_track_.TransformAt(time))));
+        }
+    }
+
+    bool Animation::Render(World& world, Camera& camera, uint32_t first_frame, uint32_t frame_count, Scalar frames_per_second, uint32_t thread_count, const FrameWriter& writer) const
+    {
+        if ((frames_per_second <= 0) || !writer)
+        {
+            return false;
+        }
+
+        const auto height = camera.GetVSize();
+
+        // State shared by every frame: the image, and a shadow cache for each thread.
+        auto image         = Canvas{ camera.GetHSize(), height };
+        auto shadow_caches = std::vector<ShadowCache>(ParallelBands::GetWorkerCount(height, kBandHeight, thread_count));
+
+        for (uint32_t frame = first_frame; frame < (first_frame + frame_count); ++frame)
+        {
+            Apply(static_cast<Scalar>(frame) / frames_per_second, world, camera);
+
+            ParallelBands::ForEachBand(height, kBandHeight, thread_count, [&](uint32_t worker, uint32_t first_row, uint32_t last_row) {
+                auto budget = RayBudget{};
+                return camera.Render(world, RenderRegion{ 0u, first_row, camera.GetHSize(), last_row - first_row }, image, &shadow_caches[worker], budget);
+            });
+
+            if (!writer(frame, image))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,179 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#pragma once
+
+#include "camera.h"
+#include "canvas.h"
+#include "double_util.h"
+#include "matrix44.h"
+#include "shape.h"
+#include "vector.h"
+#include "world.h"
+
+#include <cinttypes>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace rtc
+{
+    // Translation, rotation and scale at a point in time. The transform scales, then rotates about the x, y
+    // and z axes in that order, then translates. Rotations are angles rather than orientations, so keys can
+    // describe any number of turns, such as a turntable rotating by 2 pi.
+    class Keyframe
+    {
+    public:
+        Keyframe(Scalar time, const Vector& translation) :
+            Keyframe(time, translation, Vector{}, Vector{ Scalar{ 1 }, Scalar{ 1 }, Scalar{ 1 } })
+        {
+        }
+
+        Keyframe(Scalar time, const Vector& translation, const Vector& rotation) :
+            Keyframe(time, translation, rotation, Vector{ Scalar{ 1 }, Scalar{ 1 }, Scalar{ 1 } })
+        {
+        }
+
+        Keyframe(Scalar time, const Vector& translation, const Vector& rotation, const Vector& scale) :
+            time_(time),
+            translation_(translation),
+            rotation_(rotation),
+            scale_(scale)
+        {
+        }
+
+        Scalar GetTime() const { return time_; }
+
+        const Vector& GetTranslation() const { return translation_; }
+
+        const Vector& GetRotation() const { return rotation_; }
+
+        const Vector& GetScale() const { return scale_; }
+
+        Matrix44 GetTransform() const;
+
+        // Keyframe at time whose components are interpolated linearly between the keys at fraction t.
+        static Keyframe Interpolate(const Keyframe& lhs, const Keyframe& rhs, Scalar time, Scalar t);
+
+    private:
+        Scalar time_;         ///< Time of the key, in seconds.
+        Vector translation_;  ///< Translation along the x, y and z axes.
+        Vector rotation_;     ///< Rotation about the x, y and z axes, in radians.
+        Vector scale_;        ///< Scale along the x, y and z axes.
+    };
+
+    // Keyframes describing a transform over time. Between keys the components are interpolated linearly,
+    // and before the first key and after the last the transform holds the nearest key. A track without keys
+    // is the identity.
+    class TransformTrack
+    {
+    public:
+        using Keyframes = std::vector<Keyframe>;
+
+    public:
+        TransformTrack() = default;
+
+        explicit TransformTrack(const Keyframes& keyframes);
+
+        size_t GetKeyframeCount() const { return keyframes_.size(); }
+
+        const Keyframes& GetKeyframes() const { return keyframes_; }
+
+        // Time of the last key, or zero without keys.
+        Scalar GetDuration() const { return keyframes_.empty() ? Scalar{ 0 } : keyframes_.back().GetTime(); }
+
+        // Add a key, keeping the keys ordered by time. A key with the same time as an existing key follows it.
+        void AddKeyframe(const Keyframe& keyframe);
+
+        Matrix44 TransformAt(Scalar time) const;
+
+    private:
+        Keyframes keyframes_;  ///< Keys ordered by time.
+    };
+
+    // Keyframed motion of the objects, lights and camera of a scene, which renders a sequence of frames by
+    // updating the existing world and camera rather than building a scene for each frame. Objects, materials,
+    // patterns and their caches are shared by every frame; only the transforms of animated objects change.
+    // A light tree is refit to the moved lights instead of being rebuilt, and each render thread keeps its
+    // shadow cache from frame to frame, where the occluders of the previous frame are usually still valid.
+    //
+    // Each track is applied relative to the state of its object, light or camera when the track is added:
+    //   - An object's transform is the track's transform followed by the object's original transform.
+    //   - A light's position is its original position moved by the track's transform.
+    //   - The track of the camera places the camera rig in the world, so the camera's view transform is the
+    //     inverse of the track's transform followed by the original view transform. A track rotating about
+    //     the y axis orbits the camera around the origin.
+    class Animation
+    {
+    public:
+        // Receive a rendered frame, returning false to stop the render. The canvas is reused for the next
+        // frame, so it must be copied to be kept.
+        using FrameWriter = std::function<bool(uint32_t frame, const Canvas& image)>;
+
+    public:
+        void AnimateObject(const std::shared_ptr<Shape>& object, const TransformTrack& track);
+
+        void AnimateLight(const World& world, size_t light_index, const TransformTrack& track);
+
+        void AnimateCamera(const Camera& camera, const TransformTrack& track);
+
+        size_t GetObjectTrackCount() const { return object_tracks_.size(); }
+
+        size_t GetLightTrackCount() const { return light_tracks_.size(); }
+
+        bool IsCameraAnimated() const { return camera_track_.GetKeyframeCount() > 0u; }
+
+        // Time of the last key of any track.
+        Scalar GetDuration() const;
+
+        // Update the animated objects, lights and camera to their state at time.
+        void Apply(Scalar time, World& world, Camera& camera) const;
+
+        // Render frame_count frames starting with first_frame, where frame n is the state at time
+        // n / frames_per_second, on thread_count threads, or one thread for each hardware thread when
+        // thread_count is 0. Frames are handed to the writer in order. The world and camera are left at the
+        // last rendered frame. Returns false when the writer returns false, or when frames_per_second is not
+        // positive.
+        bool Render(World& world, Camera& camera, uint32_t first_frame, uint32_t frame_count, Scalar frames_per_second, uint32_t thread_count, const FrameWriter& writer) const;
+
+    private:
+        struct ObjectTrack
+        {
+            std::shared_ptr<Shape> object;     ///< Animated object.
+            Matrix44               transform;  ///< Transform of the object when the track was added.
+            TransformTrack         track;      ///< Motion of the object.
+        };
+
+        struct LightTrack
+        {
+            size_t         light_index;  ///< Index of the animated light in the world's light list.
+            Point          position;     ///< Position of the light when the track was added.
+            TransformTrack track;        ///< Motion of the light.
+        };
+
+    private:
+        std::vector<ObjectTrack> object_tracks_;                             ///< Tracks of the animated objects.
+        std::vector<LightTrack>  light_tracks_;                              ///< Tracks of the animated lights.
+        Matrix44                 camera_transform_{ Matrix44::Identity() };  ///< View transform of the camera when its track was added.
+        TransformTrack           camera_track_;                              ///< Motion of the camera; no keys when the camera is not animated.
+    };
+}
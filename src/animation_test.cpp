@@ -0,0 +1,255 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "catch2/catch.hpp"
+
+#include "animation.h"
+#include "camera.h"
+#include "canvas.h"
+#include "color.h"
+#include "double_util.h"
+#include "matrix44.h"
+#include "point.h"
+#include "point_light.h"
+#include "vector.h"
+#include "world.h"
+
+#include <vector>
+
+namespace
+{
+    constexpr auto kHalfPi = static_cast<rtc::Scalar>(rtc::kPi / 2.0);
+    constexpr auto kTwoPi  = static_cast<rtc::Scalar>(rtc::kPi * 2.0);
+
+    rtc::Camera AnimationCamera()
+    {
+        return rtc::Camera{ 16u, 12u, kHalfPi, rtc::Matrix44::ViewTransform(rtc::Point{ 0.0, 0.0, -5.0 }, rtc::Point{ 0.0, 0.0, 0.0 }, rtc::Vector{ 0.0, 1.0, 0.0 }) };
+    }
+
+    bool CanvasEqual(const rtc::Canvas& lhs, const rtc::Canvas& rhs)
+    {
+        for (uint32_t y = 0u; y < lhs.GetHeight(); ++y)
+        {
+            for (uint32_t x = 0u; x < lhs.GetWidth(); ++x)
+            {
+                if (!rtc::Color::Equal(lhs.PixelAt(x, y), rhs.PixelAt(x, y)))
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+}
+
+SCENARIO("Evaluating a transform track", "[animation]")
+{
+    GIVEN("track <- transform_track() with keys added out of order")
+    {
+        auto track = rtc::TransformTrack{};
+        track.AddKeyframe(rtc::Keyframe{ 2.0, rtc::Vector{ 4.0, 0.0, 0.0 } });
+        track.AddKeyframe(rtc::Keyframe{ 0.0, rtc::Vector{ 0.0, 0.0, 0.0 } });
+
+        THEN("The keys are ordered by time")
+        {
+            REQUIRE(track.GetKeyframeCount() == 2u);
+            REQUIRE(track.GetKeyframes()[0].GetTime() == 0.0);
+            REQUIRE(track.GetDuration() == 2.0);
+        }
+
+        THEN("Between keys the transform is interpolated")
+        {
+            REQUIRE(rtc::Matrix44::Equal(track.TransformAt(1.0), rtc::Matrix44::Translation(2.0, 0.0, 0.0)));
+            REQUIRE(rtc::Matrix44::Equal(track.TransformAt(1.5), rtc::Matrix44::Translation(3.0, 0.0, 0.0)));
+        }
+
+        THEN("Outside the keys the transform holds the nearest key")
+        {
+            REQUIRE(rtc::Matrix44::Equal(track.TransformAt(-1.0), rtc::Matrix44::Identity()));
+            REQUIRE(rtc::Matrix44::Equal(track.TransformAt(5.0), rtc::Matrix44::Translation(4.0, 0.0, 0.0)));
+        }
+    }
+
+    GIVEN("track <- transform_track() without keys")
+    {
+        const auto track = rtc::TransformTrack{};
+
+        THEN("The transform is the identity")
+        {
+            REQUIRE(track.GetDuration() == 0.0);
+            REQUIRE(rtc::Matrix44::Equal(track.TransformAt(1.0), rtc::Matrix44::Identity()));
+        }
+    }
+
+    GIVEN("A turntable track rotating by 2 pi about the y axis over 4 seconds")
+    {
+        const auto track = rtc::TransformTrack{ {
+            rtc::Keyframe{ 0.0, rtc::Vector{}, rtc::Vector{} },
+            rtc::Keyframe{ 4.0, rtc::Vector{}, rtc::Vector{ 0.0, kTwoPi, 0.0 } } } };
+
+        THEN("The rotation is interpolated as an angle, through every quarter turn")
+        {
+            REQUIRE(rtc::Matrix44::Equal(track.TransformAt(1.0), rtc::Matrix44::RotationY(kHalfPi)));
+            REQUIRE(rtc::Matrix44::Equal(track.TransformAt(2.0), rtc::Matrix44::RotationY(kHalfPi * 2)));
+            REQUIRE(rtc::Matrix44::Equal(track.TransformAt(4.0), rtc::Matrix44::Identity()));
+        }
+    }
+
+    GIVEN("k <- keyframe(0, translation: (1, 2, 3), rotation: (pi / 2, 0, 0), scale: (2, 2, 2))")
+    {
+        const auto k = rtc::Keyframe{ 0.0, rtc::Vector{ 1.0, 2.0, 3.0 }, rtc::Vector{ kHalfPi, 0.0, 0.0 }, rtc::Vector{ 2.0, 2.0, 2.0 } };
+
+        THEN("The transform scales, then rotates, then translates")
+        {
+            const auto expected = rtc::Matrix44::Multiply(rtc::Matrix44::Translation(1.0, 2.0, 3.0), rtc::Matrix44::RotationX(kHalfPi), rtc::Matrix44::Scaling(2.0, 2.0, 2.0));
+            REQUIRE(rtc::Matrix44::Equal(k.GetTransform(), expected));
+        }
+    }
+}
+
+SCENARIO("Applying an animation to a world and camera", "[animation]")
+{
+    GIVEN("w <- default_world() and c <- camera() with an animated object, light and camera")
+    {
+        auto w = rtc::World::GetDefault();
+        auto c = rtc::Camera{ 16u, 12u, kHalfPi };
+        w.BuildLightTree();
+
+        const auto object = w.GetObject(1u);
+        const auto slide  = rtc::TransformTrack{ { rtc::Keyframe{ 0.0, rtc::Vector{} }, rtc::Keyframe{ 1.0, rtc::Vector{ 2.0, 0.0, 0.0 } } } };
+        const auto orbit  = rtc::TransformTrack{ { rtc::Keyframe{ 0.0, rtc::Vector{}, rtc::Vector{} }, rtc::Keyframe{ 4.0, rtc::Vector{}, rtc::Vector{ 0.0, kTwoPi, 0.0 } } } };
+
+        auto animation = rtc::Animation{};
+        animation.AnimateObject(object, slide);
+        animation.AnimateLight(w, 0u, slide);
+        animation.AnimateCamera(c, orbit);
+
+        THEN("The animation has a track for each")
+        {
+            REQUIRE(animation.GetObjectTrackCount() == 1u);
+            REQUIRE(animation.GetLightTrackCount() == 1u);
+            REQUIRE(animation.IsCameraAnimated());
+            REQUIRE(animation.GetDuration() == 4.0);
+        }
+
+        WHEN("animation is applied at time 1")
+        {
+            const auto tree = w.GetLightTree();
+            animation.Apply(1.0, w, c);
+
+            THEN("Each track is applied on top of the original state")
+            {
+                REQUIRE(rtc::Matrix44::Equal(object->GetTransform(), rtc::Matrix44::Multiply(rtc::Matrix44::Translation(2.0, 0.0, 0.0), rtc::Matrix44::Scaling(0.5, 0.5, 0.5))));
+                REQUIRE(rtc::Point::Equal(w.GetLight(0u).GetPosition(), rtc::Point{ -8.0, 10.0, -10.0 }));
+                REQUIRE(rtc::Matrix44::Equal(c.GetTransform(), rtc::Matrix44::RotationY(-kHalfPi)));
+            }
+
+            THEN("The light tree is refit rather than discarded")
+            {
+                REQUIRE(w.GetLightTree() != nullptr);
+                REQUIRE(w.GetLightTree() != tree);
+            }
+        }
+
+        WHEN("animation is applied at time 1 and then at time 0")
+        {
+            animation.Apply(1.0, w, c);
+            animation.Apply(0.0, w, c);
+
+            THEN("The original state is restored")
+            {
+                REQUIRE(rtc::Matrix44::Equal(object->GetTransform(), rtc::Matrix44::Scaling(0.5, 0.5, 0.5)));
+                REQUIRE(rtc::Point::Equal(w.GetLight(0u).GetPosition(), rtc::Point{ -10.0, 10.0, -10.0 }));
+                REQUIRE(rtc::Matrix44::Equal(c.GetTransform(), rtc::Matrix44::Identity()));
+            }
+        }
+    }
+}
+
+SCENARIO("Rendering an animation", "[animation]")
+{
+    GIVEN("w <- default_world() and c <- camera() with an object moving along x")
+    {
+        auto w = rtc::World::GetDefault();
+        auto c = AnimationCamera();
+
+        auto animation = rtc::Animation{};
+        animation.AnimateObject(w.GetObject(0u), rtc::TransformTrack{ { rtc::Keyframe{ 0.0, rtc::Vector{} }, rtc::Keyframe{ 2.0, rtc::Vector{ 1.0, 0.0, 0.0 } } } });
+        animation.AnimateLight(w, 0u, rtc::TransformTrack{ { rtc::Keyframe{ 0.0, rtc::Vector{} }, rtc::Keyframe{ 2.0, rtc::Vector{ 0.0, 0.0, 5.0 } } } });
+
+        WHEN("Frames 1 to 4 are rendered at 2 frames per second on 2 threads")
+        {
+            auto frames = std::vector<uint32_t>{};
+            auto images = std::vector<rtc::Canvas>{};
+
+            const auto result = animation.Render(w, c, 1u, 4u, 2.0, 2u, [&](uint32_t frame, const rtc::Canvas& image) {
+                frames.push_back(frame);
+                images.push_back(image);
+                return true;
+            });
+
+            THEN("Each frame matches a render of a scene built for the frame's time")
+            {
+                REQUIRE(result);
+                REQUIRE(frames == std::vector<uint32_t>{ 1u, 2u, 3u, 4u });
+
+                for (size_t i = 0u; i < frames.size(); ++i)
+                {
+                    const auto time = std::min(static_cast<rtc::Scalar>(frames[i]) / static_cast<rtc::Scalar>(2), static_cast<rtc::Scalar>(2));
+
+                    auto expected_world = rtc::World::GetDefault();
+                    expected_world.GetObject(0u)->SetTransform(rtc::Matrix44::Translation(time / 2, 0.0, 0.0));
+                    expected_world.SetLight(0u, rtc::PointLight{ rtc::Point{ -10.0, 10.0, (time * static_cast<rtc::Scalar>(2.5)) - static_cast<rtc::Scalar>(10) }, rtc::Color{ 1.0, 1.0, 1.0 } });
+
+                    REQUIRE(CanvasEqual(images[i], AnimationCamera().Render(expected_world)));
+                }
+
+                REQUIRE(!CanvasEqual(images[0], images[1]));
+            }
+        }
+
+        WHEN("The writer stops the render after the first frame")
+        {
+            auto count = 0u;
+
+            const auto result = animation.Render(w, c, 0u, 4u, 2.0, 1u, [&](uint32_t, const rtc::Canvas&) {
+                ++count;
+                return false;
+            });
+
+            THEN("Rendering stops")
+            {
+                REQUIRE(!result);
+                REQUIRE(count == 1u);
+            }
+        }
+
+        WHEN("The frame rate is not positive")
+        {
+            THEN("Nothing is rendered")
+            {
+                REQUIRE(!animation.Render(w, c, 0u, 4u, 0.0, 1u, [](uint32_t, const rtc::Canvas&) { return true; }));
+            }
+        }
+    }
+}
@@ -0,0 +1,214 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "async_file_output_stream.h"
+
+#include <algorithm>
+
+namespace rtc
+{
+    namespace
+    {
+        std::future<bool> MakeReadyFuture(bool value)
+        {
+            auto promise = std::promise<bool>{};
+            promise.set_value(value);
+            return promise.get_future();
+        }
+    }
+
+    AsyncFileOutputStream::AsyncFileOutputStream(const std::string& filename) :
+        AsyncFileOutputStream(filename, kDefaultBufferSize, kDefaultMaxBuffers)
+    {
+    }
+
+    AsyncFileOutputStream::AsyncFileOutputStream(const std::string& filename, size_t buffer_size, size_t max_buffers) :
+        file_(std::fopen(filename.c_str(), "wb")),
+        buffer_size_(std::max<size_t>(buffer_size, 1u)),
+        max_buffers_(std::max<size_t>(max_buffers, 1u))
+    {
+        current_.reserve(buffer_size_);
+
+        if (file_ != nullptr)
+        {
+            thread_ = std::thread(&AsyncFileOutputStream::Run, this);
+        }
+    }
+
+    AsyncFileOutputStream::~AsyncFileOutputStream()
+    {
+        if (file_ != nullptr)
+        {
+            if (!closed_)
+            {
+                Close();
+            }
+
+            thread_.join();
+        }
+    }
+
+    bool AsyncFileOutputStream::Fail()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return (file_ == nullptr) || failed_;
+    }
+
+    bool AsyncFileOutputStream::Write(const char* data, size_t size)
+    {
+        if ((file_ == nullptr) || closed_)
+        {
+            return false;
+        }
+
+        while (size > 0u)
+        {
+            const auto count = std::min(size, buffer_size_ - current_.size());
+            current_.insert(current_.end(), data, data + count);
+            data += count;
+            size -= count;
+
+            if (current_.size() == buffer_size_)
+            {
+                Submit(false, false);
+            }
+        }
+
+        return !Fail();
+    }
+
+    std::future<bool> AsyncFileOutputStream::Flush()
+    {
+        if ((file_ == nullptr) || closed_)
+        {
+            return MakeReadyFuture(false);
+        }
+
+        return Submit(true, false);
+    }
+
+    std::future<bool> AsyncFileOutputStream::Close()
+    {
+        if ((file_ == nullptr) || closed_)
+        {
+            return MakeReadyFuture(false);
+        }
+
+        closed_ = true;
+        return Submit(false, true);
+    }
+
+    std::future<bool> AsyncFileOutputStream::Submit(bool flush, bool close)
+    {
+        auto request  = Request{};
+        request.flush = flush;
+        request.close = close;
+
+        auto future = (flush || close) ? request.done.get_future() : std::future<bool>{};
+
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            if (!current_.empty())
+            {
+                // Wait for the writer to release a buffer when all of them are in flight.
+                condition_.wait(lock, [this]() { return in_flight_ < max_buffers_; });
+                ++in_flight_;
+
+                request.buffer = std::move(current_);
+
+                if (!free_.empty())
+                {
+                    current_ = std::move(free_.back());
+                    free_.pop_back();
+                }
+                else
+                {
+                    current_ = Buffer{};
+                    current_.reserve(buffer_size_);
+                }
+            }
+
+            if (!request.buffer.empty() || flush || close)
+            {
+                requests_.emplace_back(std::move(request));
+            }
+        }
+
+        condition_.notify_all();
+        return future;
+    }
+
+    void AsyncFileOutputStream::Run()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        while (true)
+        {
+            condition_.wait(lock, [this]() { return !requests_.empty(); });
+
+            auto request = std::move(requests_.front());
+            requests_.pop_front();
+            lock.unlock();
+
+            auto success = true;
+
+            if (!request.buffer.empty())
+            {
+                success = std::fwrite(request.buffer.data(), 1u, request.buffer.size(), file_) == request.buffer.size();
+            }
+
+            if (request.flush)
+            {
+                success = (std::fflush(file_) == 0) && success;
+            }
+
+            if (request.close)
+            {
+                success = (std::fclose(file_) == 0) && success;
+            }
+
+            lock.lock();
+
+            failed_            = failed_ || !success;
+            const auto written = !failed_;
+
+            if (!request.buffer.empty())
+            {
+                request.buffer.clear();
+                free_.emplace_back(std::move(request.buffer));
+                --in_flight_;
+                condition_.notify_all();
+            }
+
+            if (request.flush || request.close)
+            {
+                request.done.set_value(written);
+            }
+
+            if (request.close)
+            {
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,112 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#pragma once
+
+#include "output_stream.h"
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace rtc
+{
+    // File stream that writes from a background thread, so that the caller can continue, e.g. with the next
+    // render, while the file is written. Writes are copied into a buffer, and each full buffer is handed to
+    // the writer thread. At most max_buffers buffers are in flight; Write() waits for the writer when all of
+    // them are full, which bounds the memory used when the caller produces data faster than the disk takes
+    // it. Buffers are reused once they have been written.
+    class AsyncFileOutputStream : public OutputStream
+    {
+    public:
+        static constexpr size_t kDefaultBufferSize = 1u << 20u;
+        static constexpr size_t kDefaultMaxBuffers = 2u;
+
+    public:
+        explicit AsyncFileOutputStream(const std::string& filename);
+
+        AsyncFileOutputStream(const std::string& filename, size_t buffer_size, size_t max_buffers);
+
+        // Close the stream, waiting for the writer thread to finish.
+        virtual ~AsyncFileOutputStream() override;
+
+        AsyncFileOutputStream(const AsyncFileOutputStream&) = delete;
+
+        AsyncFileOutputStream& operator=(const AsyncFileOutputStream&) = delete;
+
+        virtual bool IsValid() override { return file_ != nullptr; }
+
+        // True when a write to the file has failed, which may be reported some time after the Write() call
+        // that provided the data.
+        virtual bool Fail() override;
+
+        virtual bool Write(const char* data, size_t size) override;
+
+        // Hand the buffered data to the writer thread. The future becomes ready when all of the data written
+        // before the call is flushed to the file, with false when a write failed.
+        std::future<bool> Flush();
+
+        // Flush the stream and close the file once it is written. Later writes fail.
+        std::future<bool> Close();
+
+        size_t GetBufferSize() const { return buffer_size_; }
+
+        size_t GetMaxBuffers() const { return max_buffers_; }
+
+    private:
+        using Buffer = std::vector<char>;
+
+        // Buffer to write, or a request to flush or close the file when the buffer is empty.
+        struct Request
+        {
+            Buffer             buffer;           ///< Data to write, which may be empty.
+            bool               flush{ false };   ///< Flush the file after the data, and fulfill done.
+            bool               close{ false };   ///< Close the file after the data, fulfill done, and exit the thread.
+            std::promise<bool> done;             ///< Success of the writes up to and including this request.
+        };
+
+    private:
+        // Hand the current buffer, and optionally a flush or close request, to the writer thread.
+        std::future<bool> Submit(bool flush, bool close);
+
+        void Run();
+
+    private:
+        std::FILE*              file_;                ///< File written by the thread, or null when it could not be opened.
+        size_t                  buffer_size_;         ///< Capacity of each buffer.
+        size_t                  max_buffers_;         ///< Number of buffers that can be queued or being written.
+        Buffer                  current_;             ///< Buffer receiving writes on the caller's thread.
+        std::mutex              mutex_;               ///< Guards the members below.
+        std::condition_variable condition_;           ///< Signaled when a request is queued or a buffer is released.
+        std::deque<Request>     requests_;            ///< Requests waiting for the writer thread.
+        std::vector<Buffer>     free_;                ///< Written buffers available for reuse.
+        size_t                  in_flight_{ 0u };     ///< Buffers queued or being written.
+        bool                    failed_{ false };     ///< A write to the file failed.
+        bool                    closed_{ false };     ///< Close() was called; only accessed by the caller's thread.
+        std::thread             thread_;              ///< Writer thread, started last.
+    };
+}
@@ -0,0 +1,157 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "catch2/catch.hpp"
+
+#include "async_file_output_stream.h"
+#include "canvas.h"
+#include "color.h"
+#include "memory_output_stream.h"
+#include "ppm_writer.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace
+{
+    std::string TestFilename(const char* name)
+    {
+        // Separate files for the double and float suites, which may run at the same time.
+        const auto filename = std::string{ name } + "_" + std::to_string(sizeof(rtc::Scalar));
+        return (std::filesystem::temp_directory_path() / filename).string();
+    }
+
+    std::string ReadFile(const std::string& filename)
+    {
+        auto file = std::ifstream{ filename, std::ios::binary };
+        return std::string{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+    }
+}
+
+SCENARIO("Writing more data than fits in the in-flight buffers", "[streams]")
+{
+    GIVEN("stream <- async_file_output_stream(file) with 16 byte buffers and at most 2 in flight")
+    {
+        const auto filename = TestFilename("rtc_async_stream_test.bin");
+        auto       expected = std::string{};
+
+        for (auto i = 0; i < 1000; ++i)
+        {
+            expected += std::to_string(i) + ",";
+        }
+
+        {
+            auto stream = rtc::AsyncFileOutputStream{ filename, 16u, 2u };
+            REQUIRE(stream.IsValid());
+
+            WHEN("the data is written in pieces of varying size and the stream is flushed")
+            {
+                auto written = true;
+                for (size_t offset = 0u, piece = 1u; offset < expected.size(); offset += piece, piece = (piece % 37u) + 1u)
+                {
+                    written = stream.Write(expected.data() + offset, std::min(piece, expected.size() - offset)) && written;
+                }
+
+                auto flushed = stream.Flush();
+
+                THEN("the flush succeeds and the file holds the data")
+                {
+                    REQUIRE(written);
+                    REQUIRE(flushed.get());
+                    REQUIRE(!stream.Fail());
+                    REQUIRE(ReadFile(filename) == expected);
+                }
+
+                AND_WHEN("more data is written and the stream is closed")
+                {
+                    REQUIRE(stream.Write("end", 3u));
+                    auto closed = stream.Close();
+
+                    THEN("the close succeeds, the file holds all of the data, and later writes fail")
+                    {
+                        REQUIRE(closed.get());
+                        REQUIRE(ReadFile(filename) == (expected + "end"));
+                        REQUIRE(!stream.Write("more", 4u));
+                        REQUIRE(!stream.Flush().get());
+                    }
+                }
+            }
+        }
+
+        std::filesystem::remove(filename);
+    }
+}
+
+SCENARIO("An async stream for a file that cannot be created", "[streams]")
+{
+    GIVEN("stream <- async_file_output_stream(a file in a missing directory)")
+    {
+        const auto filename = (std::filesystem::temp_directory_path() / "rtc_missing_directory" / "file.bin").string();
+        auto       stream   = rtc::AsyncFileOutputStream{ filename };
+
+        THEN("the stream is not valid and writes fail")
+        {
+            REQUIRE(!stream.IsValid());
+            REQUIRE(stream.Fail());
+            REQUIRE(!stream.Write("data", 4u));
+            REQUIRE(!stream.Flush().get());
+        }
+    }
+}
+
+SCENARIO("Writing a PPM file asynchronously", "[streams]")
+{
+    GIVEN("c <- canvas(5, 3) with a few colored pixels")
+    {
+        auto c = rtc::Canvas{ 5u, 3u };
+        c.WritePixel(0u, 0u, rtc::Color{ 1.5, 0.0, 0.0 });
+        c.WritePixel(2u, 1u, rtc::Color{ 0.0, 0.5, 0.0 });
+        c.WritePixel(4u, 2u, rtc::Color{ -0.5, 0.0, 1.0 });
+
+        WHEN("the canvas is written with write_file_async and the canvas is cleared")
+        {
+            const auto filename = TestFilename("rtc_async_ppm_test.ppm");
+            auto       written  = rtc::PpmWriter::WriteFileAsync(filename, c);
+
+            c.Clear(rtc::Color{ 1.0, 1.0, 1.0 });
+
+            THEN("the file holds the ppm of the canvas before it was cleared")
+            {
+                auto original = rtc::Canvas{ 5u, 3u };
+                original.WritePixel(0u, 0u, rtc::Color{ 1.5, 0.0, 0.0 });
+                original.WritePixel(2u, 1u, rtc::Color{ 0.0, 0.5, 0.0 });
+                original.WritePixel(4u, 2u, rtc::Color{ -0.5, 0.0, 1.0 });
+
+                auto expected = rtc::MemoryOutputStream{};
+                REQUIRE(rtc::PpmWriter::WriteStream(&expected, original));
+
+                REQUIRE(written.get());
+                REQUIRE(ReadFile(filename) == std::string{ reinterpret_cast<const char*>(expected.GetData()), expected.GetSize() });
+            }
+
+            std::filesystem::remove(filename);
+        }
+    }
+}
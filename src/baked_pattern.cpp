@@ -0,0 +1,252 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "baked_pattern.h"
+
+#include "affine34.h"
+#include "canvas.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace rtc
+{
+    namespace
+    {
+        // Color of the source pattern at a point in object space.
+        Color SourceAt(const Pattern& source, const Point& point)
+        {
+            return source.PatternAt(Affine34::TransformPoint(source.GetInverseTransform(), point));
+        }
+
+        // Continuous voxel coordinate of a position along one axis, clamped to the voxel centers.
+        Scalar VoxelCoordinate(Scalar position, Scalar min, Scalar max, uint32_t count)
+        {
+            const auto coordinate = (((position - min) / (max - min)) * static_cast<Scalar>(count)) - Scalar{ 0.5 };
+            return std::clamp(coordinate, Scalar{ 0 }, static_cast<Scalar>(count - 1u));
+        }
+    }
+
+    std::shared_ptr<BakedPattern> BakedPattern::BakeUv(
+        const Pattern& source,
+        UvMapping::Type mapping,
+        uint32_t width,
+        uint32_t height,
+        uint32_t samples_per_axis,
+        const std::shared_ptr<TextureCache>& cache)
+    {
+        assert(cache && "rtc::BakedPattern::BakeUv was called with an invalid cache");
+
+        if ((width == 0u) || (height == 0u) || (samples_per_axis == 0u))
+        {
+            return nullptr;
+        }
+
+        const auto samples = static_cast<Scalar>(samples_per_axis);
+        const auto weight  = Scalar{ 1 } / (samples * samples);
+
+        auto image = Canvas{ width, height };
+
+        for (uint32_t y = 0u; y < height; ++y)
+        {
+            for (uint32_t x = 0u; x < width; ++x)
+            {
+                auto color = Color{};
+
+                // Samples are spread evenly over the texel. Image rows run from the top down, opposite to v.
+                for (uint32_t sy = 0u; sy < samples_per_axis; ++sy)
+                {
+                    for (uint32_t sx = 0u; sx < samples_per_axis; ++sx)
+                    {
+                        const auto u = (static_cast<Scalar>(x) + ((static_cast<Scalar>(sx) + Scalar{ 0.5 }) / samples)) / static_cast<Scalar>(width);
+                        const auto v = Scalar{ 1 } - ((static_cast<Scalar>(y) + ((static_cast<Scalar>(sy) + Scalar{ 0.5 }) / samples)) / static_cast<Scalar>(height));
+
+                        color = Color::Add(color, SourceAt(source, UvMapping::MapInverse(mapping, u, v)));
+                    }
+                }
+
+                image.WritePixel(x, y, Color::Multiply(color, weight));
+            }
+        }
+
+        auto texture = Texture::Create(image);
+        if (!texture)
+        {
+            return nullptr;
+        }
+
+        return std::shared_ptr<BakedPattern>(new BakedPattern(texture, mapping, cache));
+    }
+
+    std::shared_ptr<BakedPattern> BakedPattern::BakeVolume(
+        const Pattern& source,
+        const Point& min,
+        const Point& max,
+        uint32_t width,
+        uint32_t height,
+        uint32_t depth,
+        uint32_t samples_per_axis)
+    {
+        if ((width == 0u) || (height == 0u) || (depth == 0u) || (samples_per_axis == 0u) ||
+            !(max.GetX() > min.GetX()) || !(max.GetY() > min.GetY()) || !(max.GetZ() > min.GetZ()))
+        {
+            return nullptr;
+        }
+
+        const auto samples = static_cast<Scalar>(samples_per_axis);
+        const auto weight  = Scalar{ 1 } / (samples * samples * samples);
+        const auto size_x  = (max.GetX() - min.GetX()) / static_cast<Scalar>(width);
+        const auto size_y  = (max.GetY() - min.GetY()) / static_cast<Scalar>(height);
+        const auto size_z  = (max.GetZ() - min.GetZ()) / static_cast<Scalar>(depth);
+
+        auto voxels = std::vector<float>{};
+        voxels.reserve(static_cast<size_t>(width) * height * depth * 3u);
+
+        for (uint32_t z = 0u; z < depth; ++z)
+        {
+            for (uint32_t y = 0u; y < height; ++y)
+            {
+                for (uint32_t x = 0u; x < width; ++x)
+                {
+                    auto color = Color{};
+
+                    for (uint32_t sz = 0u; sz < samples_per_axis; ++sz)
+                    {
+                        for (uint32_t sy = 0u; sy < samples_per_axis; ++sy)
+                        {
+                            for (uint32_t sx = 0u; sx < samples_per_axis; ++sx)
+                            {
+                                const auto point = Point{
+                                    min.GetX() + ((static_cast<Scalar>(x) + ((static_cast<Scalar>(sx) + Scalar{ 0.5 }) / samples)) * size_x),
+                                    min.GetY() + ((static_cast<Scalar>(y) + ((static_cast<Scalar>(sy) + Scalar{ 0.5 }) / samples)) * size_y),
+                                    min.GetZ() + ((static_cast<Scalar>(z) + ((static_cast<Scalar>(sz) + Scalar{ 0.5 }) / samples)) * size_z)
+                                };
+
+                                color = Color::Add(color, SourceAt(source, point));
+                            }
+                        }
+                    }
+
+                    color = Color::Multiply(color, weight);
+                    voxels.push_back(static_cast<float>(color.GetR()));
+                    voxels.push_back(static_cast<float>(color.GetG()));
+                    voxels.push_back(static_cast<float>(color.GetB()));
+                }
+            }
+        }
+
+        return std::shared_ptr<BakedPattern>(new BakedPattern(std::move(voxels), min, max, width, height, depth));
+    }
+
+    BakedPattern::BakedPattern(const std::shared_ptr<const Texture>& texture, UvMapping::Type mapping, const std::shared_ptr<TextureCache>& cache) :
+        domain_(Domain::kUv),
+        filter_(Filter::kLinear),
+        texture_(texture),
+        cache_(cache),
+        mapping_(mapping),
+        level_of_detail_(0),
+        width_(0u),
+        height_(0u),
+        depth_(0u)
+    {
+    }
+
+    BakedPattern::BakedPattern(std::vector<float>&& voxels, const Point& min, const Point& max, uint32_t width, uint32_t height, uint32_t depth) :
+        domain_(Domain::kVolume),
+        filter_(Filter::kLinear),
+        mapping_(UvMapping::Type::kPlanar),
+        level_of_detail_(0),
+        voxels_(std::move(voxels)),
+        min_(min),
+        max_(max),
+        width_(width),
+        height_(height),
+        depth_(depth)
+    {
+    }
+
+    size_t BakedPattern::GetMemorySize() const
+    {
+        if (domain_ == Domain::kUv)
+        {
+            return static_cast<size_t>(texture_->GetTileCount()) * Texture::GetTileBytes();
+        }
+
+        return voxels_.size() * sizeof(float);
+    }
+
+    Color BakedPattern::PatternAt(const Point& point) const
+    {
+        if (domain_ == Domain::kVolume)
+        {
+            return VolumeAt(point);
+        }
+
+        auto u = Scalar{ 0 };
+        auto v = Scalar{ 0 };
+        UvMapping::Map(mapping_, point, u, v);
+
+        if (filter_ == Filter::kNearest)
+        {
+            return texture_->SampleNearest(*cache_, u, v, static_cast<uint32_t>(std::max(std::round(level_of_detail_), Scalar{ 0 })));
+        }
+
+        return texture_->Sample(*cache_, u, v, level_of_detail_);
+    }
+
+    Color BakedPattern::VoxelAt(uint32_t x, uint32_t y, uint32_t z) const
+    {
+        const auto index = ((((static_cast<size_t>(z) * height_) + y) * width_) + x) * 3u;
+        return Color{ voxels_[index], voxels_[index + 1u], voxels_[index + 2u] };
+    }
+
+    Color BakedPattern::VolumeAt(const Point& point) const
+    {
+        const auto x = VoxelCoordinate(point.GetX(), min_.GetX(), max_.GetX(), width_);
+        const auto y = VoxelCoordinate(point.GetY(), min_.GetY(), max_.GetY(), height_);
+        const auto z = VoxelCoordinate(point.GetZ(), min_.GetZ(), max_.GetZ(), depth_);
+
+        if (filter_ == Filter::kNearest)
+        {
+            return VoxelAt(static_cast<uint32_t>(x + Scalar{ 0.5 }), static_cast<uint32_t>(y + Scalar{ 0.5 }), static_cast<uint32_t>(z + Scalar{ 0.5 }));
+        }
+
+        // Trilinear interpolation between the eight voxel centers around the point.
+        const auto x0 = static_cast<uint32_t>(x);
+        const auto y0 = static_cast<uint32_t>(y);
+        const auto z0 = static_cast<uint32_t>(z);
+        const auto x1 = std::min(x0 + 1u, width_ - 1u);
+        const auto y1 = std::min(y0 + 1u, height_ - 1u);
+        const auto z1 = std::min(z0 + 1u, depth_ - 1u);
+        const auto fx = x - static_cast<Scalar>(x0);
+        const auto fy = y - static_cast<Scalar>(y0);
+        const auto fz = z - static_cast<Scalar>(z0);
+
+        const auto lerp = [](const Color& a, const Color& b, Scalar t) { return Color::Add(a, Color::Multiply(Color::Subtract(b, a), t)); };
+
+        const auto front = lerp(lerp(VoxelAt(x0, y0, z0), VoxelAt(x1, y0, z0), fx), lerp(VoxelAt(x0, y1, z0), VoxelAt(x1, y1, z0), fx), fy);
+        const auto back  = lerp(lerp(VoxelAt(x0, y0, z1), VoxelAt(x1, y0, z1), fx), lerp(VoxelAt(x0, y1, z1), VoxelAt(x1, y1, z1), fx), fy);
+
+        return lerp(front, back, fz);
+    }
+}
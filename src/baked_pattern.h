@@ -0,0 +1,135 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#pragma once
+
+#include "color.h"
+#include "double_util.h"
+#include "pattern.h"
+#include "point.h"
+#include "texture.h"
+#include "texture_cache.h"
+#include "uv_mapping.h"
+
+#include <cinttypes>
+#include <memory>
+#include <vector>
+
+namespace rtc
+{
+    // Pattern sampled ahead of time into a lookup table, replacing an expensive pattern (e.g. a perturbed
+    // or nested pattern) with a texture read at render time. A pattern is baked over one of two domains:
+    //   - The texture coordinates of a UV mapping, into a mip-mapped Texture whose tiles are read through
+    //     a TextureCache, so the memory used at render time is bounded by the cache.
+    //   - A box, into a grid of voxels held in memory, for patterns that vary through a solid.
+    //
+    // The source pattern is evaluated in object space, with its own transform applied, so the baked
+    // pattern replaces it in a material without a transform of its own. The resolution bounds the
+    // detail that is kept and sets the memory cost, reported by GetMemorySize(). Each texel or voxel can
+    // average a grid of samples to reduce aliasing of sharp edges, at the cost of bake time, and lookups
+    // can be filtered or take the nearest texel or voxel.
+    class BakedPattern : public Pattern
+    {
+    public:
+        enum class Domain
+        {
+            kUv,     ///< Baked over the texture coordinates of a UV mapping.
+            kVolume  ///< Baked over a box.
+        };
+
+        enum class Filter
+        {
+            kNearest,  ///< Use the nearest texel or voxel.
+            kLinear    ///< Interpolate between the nearest texels or voxels.
+        };
+
+    public:
+        // Bake the pattern into a width x height texture for a UV mapping, averaging samples_per_axis^2
+        // samples for each texel. The planar mapping covers the unit square at the origin of the xz plane,
+        // repeating it, and the spherical mapping covers the unit sphere. Returns nullptr if a dimension is
+        // zero or the texture cannot be created.
+        static std::shared_ptr<BakedPattern> BakeUv(
+            const Pattern& source,
+            UvMapping::Type mapping,
+            uint32_t width,
+            uint32_t height,
+            uint32_t samples_per_axis = 1u,
+            const std::shared_ptr<TextureCache>& cache = TextureCache::GetShared());
+
+        // Bake the pattern into a grid of voxels covering the box from min to max, averaging
+        // samples_per_axis^3 samples for each voxel. Points outside the box take the color at the nearest
+        // point of the box. Returns nullptr if a dimension is zero or the box is empty.
+        static std::shared_ptr<BakedPattern> BakeVolume(
+            const Pattern& source,
+            const Point& min,
+            const Point& max,
+            uint32_t width,
+            uint32_t height,
+            uint32_t depth,
+            uint32_t samples_per_axis = 1u);
+
+    public:
+        Domain GetDomain() const { return domain_; }
+
+        Filter GetFilter() const { return filter_; }
+
+        void SetFilter(Filter filter) { filter_ = filter; }
+
+        // Mip level sampled by UV bakes, as for ImageTexturePattern.
+        Scalar GetLevelOfDetail() const { return level_of_detail_; }
+
+        void SetLevelOfDetail(Scalar level_of_detail) { level_of_detail_ = level_of_detail; }
+
+        // Texture holding a UV bake, or nullptr for a volume bake.
+        const std::shared_ptr<const Texture>& GetTexture() const { return texture_; }
+
+        // Size of the baked texels or voxels, in bytes. For UV bakes this includes every mip level, and
+        // is the most that the bake can occupy in the texture cache.
+        size_t GetMemorySize() const;
+
+        virtual Color PatternAt(const Point& point) const override;
+
+    protected:
+        BakedPattern(const std::shared_ptr<const Texture>& texture, UvMapping::Type mapping, const std::shared_ptr<TextureCache>& cache);
+
+        BakedPattern(std::vector<float>&& voxels, const Point& min, const Point& max, uint32_t width, uint32_t height, uint32_t depth);
+
+    private:
+        Color VoxelAt(uint32_t x, uint32_t y, uint32_t z) const;
+
+        Color VolumeAt(const Point& point) const;
+
+    private:
+        Domain                         domain_;           ///< Domain the pattern was baked over.
+        Filter                         filter_;           ///< Filter applied to lookups.
+        std::shared_ptr<const Texture> texture_;          ///< Texels of a UV bake.
+        std::shared_ptr<TextureCache>  cache_;            ///< Cache providing the tiles of a UV bake.
+        UvMapping::Type                mapping_;          ///< Mapping of a UV bake.
+        Scalar                         level_of_detail_;  ///< Mip level sampled by a UV bake.
+        std::vector<float>             voxels_;           ///< Red, green and blue values of a volume bake, in x, y, z order.
+        Point                          min_;              ///< Minimum corner of the box of a volume bake.
+        Point                          max_;              ///< Maximum corner of the box of a volume bake.
+        uint32_t                       width_;            ///< Number of voxels along x.
+        uint32_t                       height_;           ///< Number of voxels along y.
+        uint32_t                       depth_;            ///< Number of voxels along z.
+    };
+}
@@ -0,0 +1,209 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "catch2/catch.hpp"
+
+#include "baked_pattern.h"
+#include "color.h"
+#include "double_util.h"
+#include "material.h"
+#include "matrix44.h"
+#include "pattern.h"
+#include "point.h"
+#include "sphere.h"
+#include "stripe_pattern.h"
+#include "texture_cache.h"
+#include "uv_mapping.h"
+
+#include <memory>
+
+namespace
+{
+    // Pattern whose color is the pattern space point, which linear interpolation reproduces exactly.
+    class PointPattern : public rtc::Pattern
+    {
+    public:
+        static std::shared_ptr<PointPattern> Create() { return std::shared_ptr<PointPattern>(new PointPattern()); }
+
+        virtual rtc::Color PatternAt(const rtc::Point& point) const override { return rtc::Color{ point.GetX(), point.GetY(), point.GetZ() }; }
+    };
+}
+
+SCENARIO("Inverting a UV mapping", "[baking]")
+{
+    GIVEN("Texture coordinates inside the unit square")
+    {
+        const rtc::Scalar coordinates[] = { 0.1, 0.25, 0.5, 0.7, 0.9 };
+
+        THEN("map(map_inverse(u, v)) = (u, v) for the planar and spherical mappings")
+        {
+            for (const auto u : coordinates)
+            {
+                for (const auto v : coordinates)
+                {
+                    for (const auto type : { rtc::UvMapping::Type::kPlanar, rtc::UvMapping::Type::kSpherical })
+                    {
+                        auto mapped_u = rtc::Scalar{ 0 };
+                        auto mapped_v = rtc::Scalar{ 0 };
+                        rtc::UvMapping::Map(type, rtc::UvMapping::MapInverse(type, u, v), mapped_u, mapped_v);
+
+                        REQUIRE(rtc::Equal(mapped_u, u));
+                        REQUIRE(rtc::Equal(mapped_v, v));
+                    }
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Baking a pattern into a volume", "[baking]")
+{
+    GIVEN("source <- point_pattern() and baked <- bake_volume(source, point(-1, -1, -1), point(1, 1, 1), 8, 4, 2)")
+    {
+        const auto source = PointPattern::Create();
+        const auto baked  = rtc::BakedPattern::BakeVolume(*source, rtc::Point{ -1.0, -1.0, -1.0 }, rtc::Point{ 1.0, 1.0, 1.0 }, 8u, 4u, 2u);
+
+        THEN("The bake holds every voxel, and reproduces the pattern between the voxel centers")
+        {
+            REQUIRE(baked != nullptr);
+            REQUIRE(baked->GetDomain() == rtc::BakedPattern::Domain::kVolume);
+            REQUIRE(baked->GetTexture() == nullptr);
+            REQUIRE(baked->GetMemorySize() == (8u * 4u * 2u * 3u * sizeof(float)));
+
+            REQUIRE(rtc::Color::Equal(baked->PatternAt(rtc::Point{ 0.0, 0.0, 0.0 }), rtc::Color{ 0.0, 0.0, 0.0 }));
+            REQUIRE(rtc::Color::Equal(baked->PatternAt(rtc::Point{ 0.3, -0.6, 0.4 }), rtc::Color{ 0.3, -0.6, 0.4 }));
+            REQUIRE(rtc::Color::Equal(baked->PatternAt(rtc::Point{ -0.8, 0.7, -0.5 }), rtc::Color{ -0.8, 0.7, -0.5 }));
+        }
+
+        THEN("Points outside the voxel centers take the color at the nearest center")
+        {
+            REQUIRE(rtc::Color::Equal(baked->PatternAt(rtc::Point{ 5.0, -5.0, 0.0 }), rtc::Color{ 0.875, -0.75, 0.0 }));
+        }
+
+        WHEN("set_filter(baked, nearest)")
+        {
+            baked->SetFilter(rtc::BakedPattern::Filter::kNearest);
+
+            THEN("pattern_at(baked, p) is the color of the voxel containing p")
+            {
+                REQUIRE(baked->GetFilter() == rtc::BakedPattern::Filter::kNearest);
+                REQUIRE(rtc::Color::Equal(baked->PatternAt(rtc::Point{ 0.3, -0.6, 0.4 }), rtc::Color{ 0.375, -0.75, 0.5 }));
+            }
+        }
+    }
+}
+
+SCENARIO("Baking a volume averages samples within each voxel", "[baking]")
+{
+    GIVEN("source <- stripe_pattern(white, black) and baked <- bake_volume(source, point(0, 0, 0), point(2, 1, 1), 1, 1, 1, 4)")
+    {
+        const auto source = rtc::StripePattern::Create(rtc::Color{ 1.0, 1.0, 1.0 }, rtc::Color{ 0.0, 0.0, 0.0 });
+        const auto baked  = rtc::BakedPattern::BakeVolume(*source, rtc::Point{ 0.0, 0.0, 0.0 }, rtc::Point{ 2.0, 1.0, 1.0 }, 1u, 1u, 1u, 4u);
+
+        THEN("The voxel, covering one white and one black stripe, is gray")
+        {
+            REQUIRE(baked != nullptr);
+            REQUIRE(rtc::Color::Equal(baked->PatternAt(rtc::Point{ 1.0, 0.5, 0.5 }), rtc::Color{ 0.5, 0.5, 0.5 }));
+        }
+    }
+}
+
+SCENARIO("Baking applies the transform of the source pattern", "[baking]")
+{
+    GIVEN("source <- point_pattern() with transform scaling(2, 2, 2) and baked <- bake_volume(source, ...)")
+    {
+        const auto source = PointPattern::Create();
+        source->SetTransform(rtc::Matrix44::Scaling(2.0, 2.0, 2.0));
+
+        const auto baked = rtc::BakedPattern::BakeVolume(*source, rtc::Point{ -1.0, -1.0, -1.0 }, rtc::Point{ 1.0, 1.0, 1.0 }, 4u, 4u, 4u);
+
+        WHEN("shape <- sphere() with a material using baked")
+        {
+            const auto shape = rtc::Sphere::Create(rtc::Material{ baked, 0.1, 0.9, 0.9, 200.0 });
+
+            THEN("color_at(shape, p) matches the source pattern evaluated in object space")
+            {
+                REQUIRE(rtc::Color::Equal(shape->ColorAt(rtc::Point{ 0.5, -0.25, 0.0 }), rtc::Color{ 0.25, -0.125, 0.0 }));
+            }
+        }
+    }
+}
+
+SCENARIO("Baking a pattern into a texture", "[baking]")
+{
+    GIVEN("source <- stripe_pattern(white, black) scaled by 0.25 and baked <- bake_uv(source, planar, 64, 64)")
+    {
+        const auto white  = rtc::Color{ 1.0, 1.0, 1.0 };
+        const auto black  = rtc::Color{ 0.0, 0.0, 0.0 };
+        const auto source = rtc::StripePattern::Create(white, black, rtc::Matrix44::Scaling(0.25, 0.25, 0.25));
+        const auto cache  = std::make_shared<rtc::TextureCache>(1024u * 1024u);
+        const auto baked  = rtc::BakedPattern::BakeUv(*source, rtc::UvMapping::Type::kPlanar, 64u, 64u, 1u, cache);
+
+        THEN("The texture and every mip level of it are counted in the memory size")
+        {
+            REQUIRE(baked != nullptr);
+            REQUIRE(baked->GetDomain() == rtc::BakedPattern::Domain::kUv);
+            REQUIRE(baked->GetTexture() != nullptr);
+            REQUIRE(baked->GetTexture()->GetWidth(0u) == 64u);
+            REQUIRE(baked->GetMemorySize() == (10u * rtc::Texture::GetTileBytes()));
+        }
+
+        THEN("pattern_at(baked, p) = pattern_at(source, p) away from the edges of the stripes, repeating every unit")
+        {
+            const rtc::Scalar xs[] = { 0.1, 0.4, 0.6, 0.9 };
+
+            for (const auto x : xs)
+            {
+                const auto expected = (x < 0.25) || ((x >= 0.5) && (x < 0.75)) ? white : black;
+
+                REQUIRE(rtc::Color::Equal(baked->PatternAt(rtc::Point{ x, 0.0, 0.3 }), expected));
+                REQUIRE(rtc::Color::Equal(baked->PatternAt(rtc::Point{ x + 2, 0.0, -4.7 }), expected));
+            }
+        }
+
+        WHEN("set_filter(baked, nearest)")
+        {
+            baked->SetFilter(rtc::BakedPattern::Filter::kNearest);
+
+            THEN("Lookups next to the edge of a stripe take the texel's color without blending")
+            {
+                REQUIRE(rtc::Color::Equal(baked->PatternAt(rtc::Point{ 0.249, 0.0, 0.3 }), white));
+                REQUIRE(rtc::Color::Equal(baked->PatternAt(rtc::Point{ 0.251, 0.0, 0.3 }), black));
+            }
+        }
+    }
+}
+
+SCENARIO("Baking with an empty domain", "[baking]")
+{
+    GIVEN("source <- point_pattern()")
+    {
+        const auto source = PointPattern::Create();
+
+        THEN("Bakes with a zero resolution or an empty box fail")
+        {
+            REQUIRE(rtc::BakedPattern::BakeUv(*source, rtc::UvMapping::Type::kPlanar, 0u, 16u) == nullptr);
+            REQUIRE(rtc::BakedPattern::BakeVolume(*source, rtc::Point{ 0.0, 0.0, 0.0 }, rtc::Point{ 1.0, 1.0, 1.0 }, 4u, 0u, 4u) == nullptr);
+            REQUIRE(rtc::BakedPattern::BakeVolume(*source, rtc::Point{ 0.0, 0.0, 0.0 }, rtc::Point{ 1.0, 0.0, 1.0 }, 4u, 4u, 4u) == nullptr);
+        }
+    }
+}
@@ -0,0 +1,511 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "animation.h"
+#include "baked_pattern.h"
+#include "camera.h"
+#include "checkers_pattern.h"
+#include "color.h"
+#include "double_util.h"
+#include "g_buffer.h"
+#include "gradient_pattern.h"
+#include "material.h"
+#include "matrix44.h"
+#include "memory_output_stream.h"
+#include "noise_pattern.h"
+#include "perlin_noise.h"
+#include "perturbed_pattern.h"
+#include "plane.h"
+#include "png_writer.h"
+#include "point.h"
+#include "point_light.h"
+#include "ppm_writer.h"
+#include "ray_budget.h"
+#include "ring_pattern.h"
+#include "shadow_cache.h"
+#include "sphere.h"
+#include "stripe_pattern.h"
+#include "tone_mapper.h"
+#include "uv_mapping.h"
+#include "vector.h"
+#include "world.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // Number of times each benchmark repeats its work, to run for long enough to be measured.
+    constexpr uint32_t kIterations = 200u;
+
+    template <typename Function>
+    double Measure(Function function)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        for (uint32_t i = 0u; i < kIterations; ++i)
+        {
+            function();
+        }
+
+        const auto stop = std::chrono::steady_clock::now();
+
+        return std::chrono::duration<double>(stop - start).count();
+    }
+
+    void Report(const char* name, double seconds, size_t operations)
+    {
+        printf("%-28s %10.2f M/s  (%.3f seconds)\n", name, static_cast<double>(operations) / seconds / 1.0e6, seconds);
+    }
+
+    // Compare evaluating Perlin noise one point at a time with the batched kernel.
+    void BenchmarkNoise()
+    {
+        constexpr size_t kPoints = 100000u;
+
+        const auto noise = rtc::PerlinNoise{};
+
+        std::vector<rtc::Scalar> x(kPoints);
+        std::vector<rtc::Scalar> y(kPoints);
+        std::vector<rtc::Scalar> z(kPoints);
+        std::vector<rtc::Scalar> result(kPoints);
+
+        for (size_t i = 0u; i < kPoints; ++i)
+        {
+            const auto t = static_cast<rtc::Scalar>(i) * rtc::Scalar{ 0.001 };
+            x[i]         = (t * rtc::Scalar{ 3.7 }) - rtc::Scalar{ 50 };
+            y[i]         = (t * rtc::Scalar{ 1.3 }) + rtc::Scalar{ 0.5 };
+            z[i]         = t * rtc::Scalar{ -2.9 };
+        }
+
+        auto checksum = rtc::Scalar{ 0 };
+
+        const auto single = Measure([&]() {
+            for (size_t i = 0u; i < kPoints; ++i)
+            {
+                result[i] = noise.Noise(x[i], y[i], z[i]);
+            }
+
+            checksum += result[kPoints / 3u];
+        });
+
+        const auto batch = Measure([&]() {
+            noise.Evaluate(x.data(), y.data(), z.data(), result.data(), kPoints);
+            checksum += result[kPoints / 3u];
+        });
+
+        Report("noise (single point)", single, kPoints * kIterations);
+        Report("noise (batch)", batch, kPoints * kIterations);
+        printf("checksum %f\n", static_cast<double>(checksum));
+    }
+
+    // Sum of two patterns, standing in for a layered product material.
+    class LayeredPattern : public rtc::Pattern
+    {
+    public:
+        LayeredPattern(const std::shared_ptr<const rtc::Pattern>& a, const std::shared_ptr<const rtc::Pattern>& b) :
+            a_(a),
+            b_(b)
+        {
+        }
+
+        virtual rtc::Color PatternAt(const rtc::Point& point) const override { return rtc::Color::Add(a_->PatternAt(point), b_->PatternAt(point)); }
+
+    private:
+        std::shared_ptr<const rtc::Pattern> a_;
+        std::shared_ptr<const rtc::Pattern> b_;
+    };
+
+    // Compare evaluating a nested procedural pattern with lookups into bakes of it.
+    void BenchmarkBakedPattern()
+    {
+        constexpr size_t kPoints = 10000u;
+
+        const auto white    = rtc::Color{ 1.0, 1.0, 1.0 };
+        const auto noise    = rtc::NoisePattern::Create(rtc::Color{ 0.2, 0.3, 0.8 }, rtc::Color{ 0.9, 0.8, 0.1 });
+        const auto checkers = rtc::CheckersPattern::Create(white, rtc::Color{ 0.1, 0.1, 0.1 }, rtc::Matrix44::Scaling(0.25, 0.25, 0.25));
+        noise->SetOctaves(4u);
+
+        const auto layered = LayeredPattern{ rtc::PerturbedPattern::Create(checkers, rtc::Scalar{ 0.1 }), rtc::PerturbedPattern::Create(noise, rtc::Scalar{ 0.2 }) };
+
+        auto start = std::chrono::steady_clock::now();
+        const auto uv = rtc::BakedPattern::BakeUv(layered, rtc::UvMapping::Type::kSpherical, 512u, 256u);
+        printf("bake uv 512x256: %.3f seconds, %zu bytes\n", std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), uv->GetMemorySize());
+
+        start = std::chrono::steady_clock::now();
+        const auto volume = rtc::BakedPattern::BakeVolume(layered, rtc::Point{ -1.0, -1.0, -1.0 }, rtc::Point{ 1.0, 1.0, 1.0 }, 64u, 64u, 64u);
+        printf("bake volume 64^3: %.3f seconds, %zu bytes\n", std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), volume->GetMemorySize());
+
+        std::vector<rtc::Point> points;
+
+        for (size_t i = 0u; i < kPoints; ++i)
+        {
+            // Points on the unit sphere, along a spiral.
+            const auto t     = static_cast<rtc::Scalar>(i) / static_cast<rtc::Scalar>(kPoints);
+            const auto phi   = t * static_cast<rtc::Scalar>(rtc::kPi);
+            const auto theta = t * rtc::Scalar{ 200 };
+            points.emplace_back(std::sin(phi) * std::cos(theta), std::cos(phi), std::sin(phi) * std::sin(theta));
+        }
+
+        auto checksum = rtc::Scalar{ 0 };
+
+        const auto run = [&](const rtc::Pattern& pattern) {
+            return Measure([&]() {
+                for (const auto& point : points)
+                {
+                    checksum += pattern.PatternAt(point).GetR();
+                }
+            });
+        };
+
+        Report("pattern (procedural)", run(layered), kPoints * kIterations);
+        Report("pattern (baked uv)", run(*uv), kPoints * kIterations);
+        Report("pattern (baked volume)", run(*volume), kPoints * kIterations);
+
+        uv->SetFilter(rtc::BakedPattern::Filter::kNearest);
+        volume->SetFilter(rtc::BakedPattern::Filter::kNearest);
+
+        Report("pattern (baked uv, nearest)", run(*uv), kPoints * kIterations);
+        Report("pattern (baked vol, nearest)", run(*volume), kPoints * kIterations);
+        printf("checksum %f\n", static_cast<double>(checksum));
+    }
+
+    // The patterned floor, wall, and spheres of the Chapter 10 demo scene.
+    rtc::World PatternScene()
+    {
+        const auto matte = [](const std::shared_ptr<rtc::Pattern>& pattern, rtc::Scalar diffuse, rtc::Scalar specular) {
+            return rtc::Material{ pattern, rtc::Material::GetDefaultAmbient(), diffuse, specular, rtc::Material::GetDefaultShininess() };
+        };
+
+        return rtc::World{
+            { rtc::PointLight{ rtc::Point{ -10.0, 10.0, -10.0 }, rtc::Color{ 1.0, 1.0, 1.0 } }, rtc::PointLight{ rtc::Point{ 10.0, 10.0, -10.0 }, rtc::Color{ 0.0, 0.0, 1.0 } } },
+            { rtc::Plane::Create(matte(rtc::CheckersPattern::Create(rtc::Color{ 0.8, 0.8, 0.8 }, rtc::Color{ 0.2, 0.2, 0.2 }), rtc::Material::GetDefaultDiffuse(), 0.0)),
+              rtc::Plane::Create(
+                  matte(rtc::RingPattern::Create(rtc::Color{ 0.7, 0.7, 0.7 }, rtc::Color{ 0.1, 0.1, 0.1 }, rtc::Matrix44::Scaling(0.2, 0.2, 0.2)), rtc::Material::GetDefaultDiffuse(), 0.0),
+                  rtc::Matrix44::Multiply(rtc::Matrix44::Translation(0.0, 0.0, 5.0), rtc::Matrix44::RotationX(rtc::DegreesToRadians(90.0)))),
+              rtc::Sphere::Create(
+                  matte(rtc::StripePattern::Create(rtc::Color{ 0.8, 0.8, 0.0 }, rtc::Color{ 0.0, 0.8, 0.0 }, rtc::Matrix44::Scaling(0.3, 0.3, 0.3)), 0.7, 0.3),
+                  rtc::Matrix44::Translation(-0.5, 1.0, 0.5)),
+              rtc::Sphere::Create(
+                  matte(rtc::GradientPattern::Create(rtc::Color{ 0.8, 0.0, 0.0 }, rtc::Color{ 0.0, 0.0, 0.5 }), 0.7, 0.3),
+                  rtc::Matrix44::Multiply(rtc::Matrix44::Translation(1.5, 0.5, -0.5), rtc::Matrix44::Scaling(0.5, 0.5, 0.5))) }
+        };
+    }
+
+    // Binary PPM, as a baseline for the plain PPM and PNG encoders.
+    void WriteBinaryPpm(rtc::OutputStream* stream, const rtc::Canvas& canvas)
+    {
+        const auto header = "P6\n" + std::to_string(canvas.GetWidth()) + " " + std::to_string(canvas.GetHeight()) + "\n255\n";
+        auto       data   = std::vector<char>{};
+
+        data.reserve(static_cast<size_t>(canvas.GetWidth()) * canvas.GetHeight() * 3u);
+
+        for (uint32_t y = 0u; y < canvas.GetHeight(); ++y)
+        {
+            for (uint32_t x = 0u; x < canvas.GetWidth(); ++x)
+            {
+                const auto& pixel = canvas.PixelAt(x, y);
+                data.push_back(static_cast<char>(rtc::ToByte(pixel.GetR())));
+                data.push_back(static_cast<char>(rtc::ToByte(pixel.GetG())));
+                data.push_back(static_cast<char>(rtc::ToByte(pixel.GetB())));
+            }
+        }
+
+        stream->Write(header.c_str(), header.length());
+        stream->Write(data.data(), data.size());
+    }
+
+    // Compare the time to encode a rendered image, and the size of the result, for each image format.
+    void BenchmarkImageEncoding()
+    {
+        const auto from   = rtc::Point{ -1.5, 1.5, -5.0 };
+        const auto to     = rtc::Point{ 0.0, 1.0, 0.0 };
+        const auto up     = rtc::Vector{ 0.0, 1.0, 0.0 };
+        const auto camera = rtc::Camera{ 1000u, 500u, rtc::kPi / 3.0, rtc::Matrix44::ViewTransform(from, to, up) };
+        const auto canvas = camera.Render(PatternScene());
+        const auto cores  = std::max(std::thread::hardware_concurrency(), 1u);
+
+        const auto run = [&](const std::string& name, auto encode) {
+            auto       stream = rtc::MemoryOutputStream{};
+            const auto start  = std::chrono::steady_clock::now();
+
+            encode(&stream);
+
+            const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            printf("%-28s %10zu bytes  (%.3f seconds)\n", name.c_str(), stream.GetSize(), seconds);
+        };
+
+        run("ppm (plain)", [&](rtc::OutputStream* stream) { rtc::PpmWriter::WriteStream(stream, canvas); });
+        run("ppm (binary)", [&](rtc::OutputStream* stream) { WriteBinaryPpm(stream, canvas); });
+
+        for (const auto level : { 0u, 1u, 6u, 9u })
+        {
+            for (const auto threads : { 1u, cores })
+            {
+                const auto name = "png (level " + std::to_string(level) + ", " + std::to_string(threads) + " threads)";
+                run(name, [&](rtc::OutputStream* stream) { rtc::PngWriter::WriteStream(stream, canvas, level, threads); });
+            }
+        }
+    }
+
+    // Compare rendering a turntable preview by building the scene for each frame against updating one scene
+    // with an animation. The scene is the pattern scene with a sphere textured by a baked noise pattern, lit by
+    // a ring of dim lights sampled with a light tree, which orbits the scene with the camera.
+    void BenchmarkAnimation()
+    {
+        constexpr uint32_t    kFrames    = 24u;
+        constexpr uint32_t    kLights    = 1024u;
+        constexpr rtc::Scalar kFrameRate = 24;
+        constexpr auto        kTurn      = static_cast<rtc::Scalar>(rtc::kPi * 2.0);
+
+        const auto view  = rtc::Matrix44::ViewTransform(rtc::Point{ 0.0, 1.5, -5.0 }, rtc::Point{ 0.0, 1.0, 0.0 }, rtc::Vector{ 0.0, 1.0, 0.0 });
+        const auto orbit = rtc::TransformTrack{ { rtc::Keyframe{ 0, rtc::Vector{}, rtc::Vector{} }, rtc::Keyframe{ kFrames / kFrameRate, rtc::Vector{}, rtc::Vector{ 0, kTurn, 0 } } } };
+
+        const auto scene = [&](rtc::Scalar time) {
+            auto world = PatternScene();
+            auto noise = rtc::NoisePattern::Create(rtc::Color{ 0.2, 0.3, 0.8 }, rtc::Color{ 0.9, 0.8, 0.1 });
+            noise->SetOctaves(4u);
+
+            const auto texture = rtc::BakedPattern::BakeUv(*noise, rtc::UvMapping::Type::kSpherical, 256u, 128u);
+            world.AppendObject(rtc::Sphere::Create(rtc::Material{ texture, rtc::Material::GetDefaultAmbient(), 0.7, 0.3, rtc::Material::GetDefaultShininess() }, rtc::Matrix44::Translation(0.5, 0.5, -1.5)));
+
+            for (uint32_t i = 0u; i < kLights; ++i)
+            {
+                const auto angle = (kTurn * static_cast<rtc::Scalar>(i)) / static_cast<rtc::Scalar>(kLights);
+                const auto ring  = rtc::Point{ 8 * std::cos(angle), 6, 8 * std::sin(angle) };
+                world.AppendLight(rtc::PointLight{ rtc::Affine34::TransformPoint(rtc::Affine34{ orbit.TransformAt(time) }, ring), rtc::Color{ 0.001, 0.001, 0.001 } });
+            }
+
+            world.BuildLightTree(rtc::Scalar{ 0 }, 4u);
+            return world;
+        };
+
+        const auto camera_at = [&](rtc::Scalar time) {
+            return rtc::Camera{ 32u, 18u, static_cast<rtc::Scalar>(rtc::kPi / 3.0), rtc::Matrix44::Multiply(view, rtc::Matrix44::Inverse(orbit.TransformAt(time))) };
+        };
+
+        const auto report = [](const char* name, double seconds) {
+            printf("%-28s %10.2f frames/s  (%.3f seconds)\n", name, static_cast<double>(kFrames) / seconds, seconds);
+        };
+
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t frame = 0u; frame < kFrames; ++frame)
+        {
+            const auto time = static_cast<rtc::Scalar>(frame) / kFrameRate;
+            camera_at(time).Render(scene(time));
+        }
+        report("animation (rebuild)", std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+        start = std::chrono::steady_clock::now();
+        auto world     = scene(0);
+        auto camera    = camera_at(0);
+        auto animation = rtc::Animation{};
+        animation.AnimateCamera(camera, orbit);
+        for (size_t i = 2u; i < world.GetLightCount(); ++i)
+        {
+            animation.AnimateLight(world, i, orbit);
+        }
+
+        animation.Render(world, camera, 0u, kFrames, kFrameRate, 1u, [](uint32_t, const rtc::Canvas&) { return true; });
+        report("animation (update)", std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    // Compare rendering the pattern scene with and without the shadow cache, and report the cache's hit rate.
+    void BenchmarkShadowCache()
+    {
+        const auto view   = rtc::Matrix44::ViewTransform(rtc::Point{ -1.5, 1.5, -5.0 }, rtc::Point{ 0.0, 1.0, 0.0 }, rtc::Vector{ 0.0, 1.0, 0.0 });
+        const auto camera = rtc::Camera{ 400u, 200u, static_cast<rtc::Scalar>(rtc::kPi / 3.0), view };
+        const auto world  = PatternScene();
+
+        const auto report = [](const char* name, double seconds) {
+            printf("%-28s %10.2f frames/s  (%.3f seconds)\n", name, 1.0 / seconds, seconds);
+        };
+
+        auto start = std::chrono::steady_clock::now();
+        camera.Render(world, nullptr);
+        report("render (no shadow cache)", std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+        auto shadow_cache = rtc::ShadowCache{};
+        start             = std::chrono::steady_clock::now();
+        camera.Render(world, &shadow_cache);
+        report("render (shadow cache)", std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        printf("shadow cache hit rate: %.1f%%\n", shadow_cache.GetHitRate() * 100.0);
+    }
+
+    // Compare rendering a scene of reflective and transparent spheres with every secondary ray traced to the depth
+    // limit against culling rays by their contribution, and report the rays counted by the budget.
+    void BenchmarkRayBudget()
+    {
+        auto floor_material = rtc::Material{
+            rtc::CheckersPattern::Create(rtc::Color{ 0.35, 0.35, 0.35 }, rtc::Color{ 0.65, 0.65, 0.65 }),
+            rtc::Material::GetDefaultAmbient(),
+            rtc::Material::GetDefaultDiffuse(),
+            0.0,
+            rtc::Material::GetDefaultShininess() };
+        floor_material.SetReflective(0.4);
+
+        auto mirror_material = rtc::Material{ rtc::Color{ 0.1, 0.1, 0.1 }, 0.0, 0.2, 1.0, 300.0 };
+        mirror_material.SetReflective(0.9);
+
+        auto glass_material = rtc::Material{ rtc::Color{ 0.1, 0.1, 0.1 }, 0.0, 0.1, 1.0, 300.0 };
+        glass_material.SetReflective(0.9);
+        glass_material.SetTransparency(0.9);
+        glass_material.SetRefractiveIndex(1.5);
+
+        const auto world = rtc::World{
+            { rtc::PointLight{ rtc::Point{ -10.0, 10.0, -10.0 }, rtc::Color{ 1.0, 1.0, 1.0 } } },
+            { rtc::Plane::Create(floor_material),
+              rtc::Sphere::Create(mirror_material, rtc::Matrix44::Translation(-1.5, 1.0, 0.5)),
+              rtc::Sphere::Create(glass_material, rtc::Matrix44::Translation(0.5, 1.0, -0.5)),
+              rtc::Sphere::Create(rtc::Material{ rtc::Color{ 0.8, 0.1, 0.1 }, rtc::Material::GetDefaultAmbient(), 0.7, 0.3, rtc::Material::GetDefaultShininess() }, rtc::Matrix44::Multiply(rtc::Matrix44::Translation(2.0, 0.5, 1.5), rtc::Matrix44::Scaling(0.5, 0.5, 0.5))) }
+        };
+
+        const auto view   = rtc::Matrix44::ViewTransform(rtc::Point{ 0.0, 1.5, -5.0 }, rtc::Point{ 0.0, 1.0, 0.0 }, rtc::Vector{ 0.0, 1.0, 0.0 });
+        const auto camera = rtc::Camera{ 400u, 200u, static_cast<rtc::Scalar>(rtc::kPi / 3.0), view };
+
+        const auto render = [&](const char* name, rtc::Scalar min_contribution) {
+            auto budget = rtc::RayBudget{ rtc::RayBudget::kDefaultMaxDepth, min_contribution };
+
+            const auto start = std::chrono::steady_clock::now();
+            camera.Render(world, nullptr, budget);
+            const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            printf("%-28s %10.2f frames/s  (%.3f seconds)\n", name, 1.0 / seconds, seconds);
+            printf("  %llu rays, %llu stopped at the depth limit, %llu culled by contribution\n",
+                static_cast<unsigned long long>(budget.GetTotalRayCount()),
+                static_cast<unsigned long long>(budget.GetDepthLimitedCount()),
+                static_cast<unsigned long long>(budget.GetCulledCount()));
+        };
+
+        render("reflection (no culling)", rtc::Scalar{ 0 });
+        render("reflection (ray budget)", rtc::RayBudget::kDefaultMinContribution);
+    }
+
+    // Compare rendering the pattern scene with the camera against updating it from a G-buffer after a material
+    // edit, which only shades, and after moving a sphere, which traces the pixels near the sphere and shades.
+    void BenchmarkGBuffer()
+    {
+        const auto view   = rtc::Matrix44::ViewTransform(rtc::Point{ -1.5, 1.5, -5.0 }, rtc::Point{ 0.0, 1.0, 0.0 }, rtc::Vector{ 0.0, 1.0, 0.0 });
+        const auto camera = rtc::Camera{ 400u, 200u, static_cast<rtc::Scalar>(rtc::kPi / 3.0), view };
+        const auto world  = PatternScene();
+        const auto sphere = world.GetObject(3u);
+
+        auto image   = rtc::Canvas{ camera.GetHSize(), camera.GetVSize() };
+        auto gbuffer = rtc::GBuffer{ camera.GetHSize(), camera.GetVSize() };
+        gbuffer.Render(world, camera, image, 1u);
+
+        const auto report = [](const char* name, double seconds) {
+            printf("%-28s %10.2f frames/s  (%.3f seconds)\n", name, 1.0 / seconds, seconds);
+        };
+
+        auto start = std::chrono::steady_clock::now();
+        image      = camera.Render(world);
+        report("edit (camera render)", std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+        auto material = sphere->GetMaterial();
+        material.SetSpecular(0.9);
+        sphere->SetMaterial(material);
+
+        start = std::chrono::steady_clock::now();
+        gbuffer.Shade(world, image, 1u);
+        report("edit (material, g-buffer)", std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+        start = std::chrono::steady_clock::now();
+        sphere->SetTransform(rtc::Matrix44::Multiply(rtc::Matrix44::Translation(1.0, 0.5, -0.5), rtc::Matrix44::Scaling(0.5, 0.5, 0.5)));
+        gbuffer.Invalidate(camera, *sphere);
+        const auto traced = gbuffer.GetInvalidCount();
+        gbuffer.Render(world, camera, image, 1u);
+        report("edit (move, g-buffer)", std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        printf("pixels traced after move: %zu of %u\n", traced, camera.GetHSize() * camera.GetVSize());
+    }
+
+    // Compare tone mapping a canvas with the vectorized post-process against mapping each channel with the
+    // standard library, reported in megapixels per second.
+    void BenchmarkToneMapping()
+    {
+        constexpr uint32_t kWidth  = 640u;
+        constexpr uint32_t kHeight = 360u;
+
+        auto canvas = rtc::Canvas{ kWidth, kHeight, rtc::Canvas::PixelFormat::kFloat };
+        for (uint32_t y = 0u; y < kHeight; ++y)
+        {
+            for (uint32_t x = 0u; x < kWidth; ++x)
+            {
+                const auto t = static_cast<rtc::Scalar>(x + (y * kWidth)) / static_cast<rtc::Scalar>(kWidth * kHeight);
+                canvas.WritePixel(x, y, rtc::Color{ t * rtc::Scalar{ 4 }, t, rtc::Scalar{ 1 } - t });
+            }
+        }
+
+        const auto mapper = rtc::ToneMapper{ rtc::Scalar{ 0 }, rtc::ToneMapper::Curve::kAces, true };
+        const auto pixels = static_cast<size_t>(kWidth) * kHeight * kIterations;
+        const auto cores  = std::max(std::thread::hardware_concurrency(), 1u);
+
+        auto reference = canvas;
+        const auto scalar = Measure([&]() {
+            for (uint32_t y = 0u; y < kHeight; ++y)
+            {
+                for (uint32_t x = 0u; x < kWidth; ++x)
+                {
+                    const auto pixel = canvas.PixelAt(x, y);
+                    const auto map   = [](rtc::Scalar value) {
+                        const auto x = static_cast<double>(value);
+                        const auto c = std::clamp((x * ((2.51 * x) + 0.03)) / ((x * ((2.43 * x) + 0.59)) + 0.14), 0.0, 1.0);
+                        return static_cast<rtc::Scalar>((c <= 0.0031308) ? (c * 12.92) : ((1.055 * std::pow(c, 1.0 / 2.4)) - 0.055));
+                    };
+
+                    reference.WritePixel(x, y, rtc::Color{ map(pixel.GetR()), map(pixel.GetG()), map(pixel.GetB()) });
+                }
+            }
+        });
+
+        auto mapped = canvas;
+        const auto single = Measure([&]() { mapper.Apply(mapped = canvas, 1u); });
+        const auto multi  = Measure([&]() { mapper.Apply(mapped = canvas, cores); });
+        const auto bytes  = Measure([&]() { mapped = mapper.Apply(canvas, rtc::Canvas::PixelFormat::kByte, cores); });
+
+        Report("tone map (scalar std::pow)", scalar, pixels);
+        Report("tone map (1 thread)", single, pixels);
+        Report(("tone map (" + std::to_string(cores) + " threads)").c_str(), multi, pixels);
+        Report("tone map (to 8-bit)", bytes, pixels);
+    }
+}
+
+// Micro-benchmarks for performance sensitive kernels. Build in release mode for meaningful results.
+int main()
+{
+    BenchmarkNoise();
+    BenchmarkBakedPattern();
+    BenchmarkImageEncoding();
+    BenchmarkToneMapping();
+    BenchmarkAnimation();
+    BenchmarkShadowCache();
+    BenchmarkRayBudget();
+    BenchmarkGBuffer();
+
+    return 0;
+}
@@ -22,18 +22,22 @@
 
 #include "camera.h"
 #include "computations.h"
+#include "parallel_bands.h"
 #include "point.h"
 #include "vector.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <vector>
 
 namespace rtc
 {
     Ray Camera::RayForPixel(uint32_t px, uint32_t py) const
     {
         // Compute the offset from the edge of the canvas to the pixel's center.
-        const auto xoffset = (static_cast<double>(px) + 0.5) * pixel_size_;
-        const auto yoffset = (static_cast<double>(py) + 0.5) * pixel_size_;
+        const auto xoffset = (static_cast<Scalar>(px) + Scalar{ 0.5 }) * pixel_size_;
+        const auto yoffset = (static_cast<Scalar>(py) + Scalar{ 0.5 }) * pixel_size_;
 
         // Compute the untransformed coordinates of the pixel in world space.
         // Note that the camera looks toward -z, so +x is to the *left*.
@@ -43,35 +47,150 @@ namespace rtc
         // Using the camera matrix, transform the canvas point and the origin,
         // and then compute the ray's direction vector.
         // Note that the canvas is at z = -1.
-        const auto pixel     = Matrix44::Multiply(inverse_transform_, Point{ world_x, world_y, -1.0 });
-        const auto origin    = Matrix44::Multiply(inverse_transform_, Point{ 0.0, 0.0, 0.0 });
+        const auto pixel     = Affine34::TransformPoint(inverse_transform_, Point{ world_x, world_y, Scalar{ -1 } });
+        const auto origin    = Affine34::TransformPoint(inverse_transform_, Point{ 0.0, 0.0, 0.0 });
         const auto direction = Vector::Normalize(Vector::Subtract(pixel, origin));
 
         return Ray{ origin, direction };
     }
 
     Canvas Camera::Render(const World& world) const
+    {
+        auto shadow_cache = ShadowCache{};
+        return Render(world, &shadow_cache);
+    }
+
+    Canvas Camera::Render(const World& world, ShadowCache* shadow_cache) const
+    {
+        auto budget = RayBudget{};
+        return Render(world, shadow_cache, budget);
+    }
+
+    Canvas Camera::Render(const World& world, ShadowCache* shadow_cache, RayBudget& budget) const
     {
         auto image = Canvas{ hsize_, vsize_ };
+        RenderPixels(world, GetImageRegion(), 0u, 0u, image, shadow_cache, budget, nullptr);
+        return image;
+    }
+
+    Canvas Camera::Render(const World& world, const RenderRegion& region) const
+    {
+        auto shadow_cache = ShadowCache{};
+        auto budget       = RayBudget{};
+        return Render(world, region, &shadow_cache, budget);
+    }
+
+    Canvas Camera::Render(const World& world, const RenderRegion& region, ShadowCache* shadow_cache, RayBudget& budget) const
+    {
+        const auto clipped = RenderRegion::Intersect(region, GetImageRegion());
+
+        auto image = Canvas{ clipped.GetWidth(), clipped.GetHeight() };
+        RenderPixels(world, clipped, clipped.GetX(), clipped.GetY(), image, shadow_cache, budget, nullptr);
+        return image;
+    }
+
+    bool Camera::Render(const World& world, const RenderRegion& region, Canvas& canvas, ShadowCache* shadow_cache, RayBudget& budget) const
+    {
+        return Render(world, region, canvas, shadow_cache, budget, nullptr);
+    }
 
-        for (uint32_t y = 0u; y < vsize_; ++y)
+    bool Camera::Render(const World& world, const RenderRegion& region, Canvas& canvas, ShadowCache* shadow_cache, RayBudget& budget, const CancellationToken* cancellation) const
+    {
+        if (!IsRenderable(region, canvas))
         {
-            for (uint32_t x = 0u; x < hsize_; ++x)
+            return false;
+        }
+
+        return RenderPixels(world, region, 0u, 0u, canvas, shadow_cache, budget, cancellation);
+    }
+
+    bool Camera::Render(const World& world, const std::vector<RenderRegion>& regions, Canvas& canvas, ShadowCache* shadow_cache, RayBudget& budget) const
+    {
+        for (const auto& region : regions)
+        {
+            if (!IsRenderable(region, canvas))
             {
-                auto color = Computations::ColorAt(world, RayForPixel(x, y));
-                image.WritePixel(x, y, std::move(color));
+                return false;
             }
         }
 
-        return image;
+        for (const auto& region : regions)
+        {
+            RenderPixels(world, region, 0u, 0u, canvas, shadow_cache, budget, nullptr);
+        }
+
+        return true;
+    }
+
+    bool Camera::RenderBands(const World& world, uint32_t band_height, uint32_t thread_count, const BandWriter& writer) const
+    {
+        return RenderBands(world, band_height, thread_count, writer, nullptr);
+    }
+
+    bool Camera::RenderBands(const World& world, uint32_t band_height, uint32_t thread_count, const BandWriter& writer, const CancellationToken* cancellation) const
+    {
+        return RenderBands(world, band_height, thread_count, writer, cancellation, nullptr);
+    }
+
+    bool Camera::RenderBands(const World& world, uint32_t band_height, uint32_t thread_count, const BandWriter& writer, const CancellationToken* cancellation, const std::function<void()>& abort) const
+    {
+        if ((band_height == 0u) || !writer)
+        {
+            return false;
+        }
+
+        auto shadow_caches = std::vector<ShadowCache>(ParallelBands::GetWorkerCount(vsize_, band_height, thread_count));
+        auto aborted       = std::atomic<bool>{ false };
+
+        return ParallelBands::ForEachBand(vsize_, band_height, thread_count, [&](uint32_t worker, uint32_t first_row, uint32_t last_row) {
+            const auto region = RenderRegion{ 0u, first_row, hsize_, last_row - first_row };
+
+            auto image  = Canvas{ region.GetWidth(), region.GetHeight() };
+            auto budget = RayBudget{};
+
+            if (!RenderPixels(world, region, 0u, first_row, image, &shadow_caches[worker], budget, cancellation) || !writer(first_row, image))
+            {
+                // Release threads that are waiting in the writer for this band, or for a band after it.
+                if (!aborted.exchange(true) && abort)
+                {
+                    abort();
+                }
+
+                return false;
+            }
+
+            return true;
+        });
+    }
+
+    bool Camera::RenderPixels(const World& world, const RenderRegion& region, uint32_t x_origin, uint32_t y_origin, Canvas& canvas, ShadowCache* shadow_cache, RayBudget& budget, const CancellationToken* cancellation) const
+    {
+        const auto x_end = region.GetX() + region.GetWidth();
+        const auto y_end = region.GetY() + region.GetHeight();
+
+        for (uint32_t y = region.GetY(); y < y_end; ++y)
+        {
+            for (uint32_t x = region.GetX(); x < x_end; ++x)
+            {
+                if ((cancellation != nullptr) && cancellation->IsCancelled())
+                {
+                    return false;
+                }
+
+                auto color = Computations::ColorAt(world, RayForPixel(x, y), shadow_cache, budget, 0u, Scalar{ 1 });
+                canvas.WritePixel(x - x_origin, y - y_origin, std::move(color));
+            }
+        }
+
+        return true;
     }
 
-    void Camera::ComputeSizes(uint32_t hsize, uint32_t vsize, double field_of_view)
+    void Camera::ComputeSizes(uint32_t hsize, uint32_t vsize, Scalar field_of_view)
     {
-        const auto half_view = tan(field_of_view / 2.0);
-        const auto aspect    = static_cast<double>(hsize) / static_cast<double>(vsize);
+        const auto half_view = std::tan(field_of_view / Scalar{ 2 });
+        const auto aspect    = static_cast<Scalar>(hsize) / static_cast<Scalar>(vsize);
 
-        if (aspect >= 1.0)
+        if (aspect >= Scalar{ 1 })
         {
             half_width_  = half_view;
             half_height_ = half_view / aspect;
@@ -84,6 +203,6 @@ namespace rtc
 
         // Assuming square pixels, where horizontal size is equal to vertical size, so
         // vertical size does not need to be computed separately.
-        pixel_size_ = (half_width_ * 2.0) / hsize;
+        pixel_size_ = (half_width_ * Scalar{ 2 }) / static_cast<Scalar>(hsize);
     }
 }
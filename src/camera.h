@@ -22,43 +22,46 @@
 
 #pragma once
 
+#include "affine34.h"
+#include "cancellation_token.h"
 #include "canvas.h"
 #include "matrix44.h"
 #include "ray.h"
+#include "ray_budget.h"
+#include "render_region.h"
+#include "shadow_cache.h"
 #include "world.h"
 
+#include <functional>
+#include <vector>
+
 namespace rtc
 {
     class Camera
     {
     public:
-        Camera(uint32_t hsize, uint32_t vsize, double field_of_view) :
-            hsize_(hsize),
-            vsize_(vsize),
-            field_of_view_(field_of_view),
-            transform_(rtc::Matrix44::Identity()),
-            inverse_transform_(rtc::Matrix44::Identity())
-        {
-            ComputeSizes(hsize, vsize, field_of_view);
-        }
+        // Receive a completed band of rows, whose first row is the image row first_row, returning false to stop
+        // the render. Called from the render threads, in any order.
+        using BandWriter = std::function<bool(uint32_t first_row, const Canvas& band)>;
 
-        Camera(uint32_t hsize, uint32_t vsize, double field_of_view, const Matrix44& transform) :
+    public:
+        Camera(uint32_t hsize, uint32_t vsize, Scalar field_of_view) :
             hsize_(hsize),
             vsize_(vsize),
             field_of_view_(field_of_view),
-            transform_(transform),
-            inverse_transform_(rtc::Matrix44::Inverse(transform))
+            transform_(rtc::Affine34::Identity()),
+            inverse_transform_(rtc::Affine34::Identity())
         {
             ComputeSizes(hsize, vsize, field_of_view);
         }
 
-        Camera(uint32_t hsize, uint32_t vsize, double field_of_view, Matrix44&& transform) :
+        Camera(uint32_t hsize, uint32_t vsize, Scalar field_of_view, const Matrix44& transform) :
             hsize_(hsize),
             vsize_(vsize),
             field_of_view_(field_of_view),
-            transform_(std::move(transform))
+            transform_(transform),
+            inverse_transform_(rtc::Affine34::Inverse(transform_))
         {
-            inverse_transform_ = rtc::Matrix44::Inverse(transform_);
             ComputeSizes(hsize, vsize, field_of_view);
         }
 
@@ -66,43 +69,96 @@ namespace rtc
 
         uint32_t GetVSize() const { return vsize_; }
 
-        double GetFieldOfView() const { return field_of_view_; }
+        Scalar GetFieldOfView() const { return field_of_view_; }
 
-        double GetHalfWidth() const { return half_width_; }
+        Scalar GetHalfWidth() const { return half_width_; }
 
-        double GetHalfHeight() const { return half_height_; }
+        Scalar GetHalfHeight() const { return half_height_; }
 
-        double GetPixelSize() const { return pixel_size_; }
+        Scalar GetPixelSize() const { return pixel_size_; }
 
-        const Matrix44& GetTransform() const { return transform_; }
+        Matrix44 GetTransform() const { return transform_.ToMatrix44(); }
 
+        // Set the view transform. Throws, leaving the camera unchanged, when the transform is not invertible.
         void SetTransform(const Matrix44& transform)
         {
-            transform_ = transform;
-            inverse_transform_ = rtc::Matrix44::Inverse(transform_);
-        }
-
-        void SetTransform(Matrix44&& transform)
-        {
-            transform_ = std::move(transform);
-            inverse_transform_ = rtc::Matrix44::Inverse(transform_);
+            const auto affine  = rtc::Affine34{ transform };
+            inverse_transform_ = rtc::Affine34::Inverse(affine);
+            transform_         = affine;
         }
 
         Ray RayForPixel(uint32_t px, uint32_t py) const;
 
         Canvas Render(const World& world) const;
 
+        // Render with the specified shadow cache, or with no shadow caching when it is null. Render(world)
+        // uses a cache local to the call.
+        Canvas Render(const World& world, ShadowCache* shadow_cache) const;
+
+        // Render with reflected and refracted rays limited by the budget, which counts the rays traced.
+        // The other overloads use a budget with the default limits, local to the call.
+        Canvas Render(const World& world, ShadowCache* shadow_cache, RayBudget& budget) const;
+
+        // Render a region of the image into a canvas the size of the region, where canvas pixel (0, 0) is image
+        // pixel (region.x, region.y). The parts of the region outside of the image are not rendered, and the
+        // canvas is sized to the rest. Each pixel matches the same pixel of a full render.
+        Canvas Render(const World& world, const RenderRegion& region) const;
+
+        Canvas Render(const World& world, const RenderRegion& region, ShadowCache* shadow_cache, RayBudget& budget) const;
+
+        // Render a region of the image into the same pixels of an existing canvas, leaving the other pixels
+        // unchanged. Returns false, without rendering, when the region is not within the image or the canvas.
+        bool Render(const World& world, const RenderRegion& region, Canvas& canvas, ShadowCache* shadow_cache, RayBudget& budget) const;
+
+        // Render a region into an existing canvas, stopping when the optional cancellation token is cancelled,
+        // which is checked before each pixel. Returns false when the region is not within the image or the
+        // canvas, or when the render was cancelled, leaving the region partially rendered.
+        bool Render(const World& world, const RenderRegion& region, Canvas& canvas, ShadowCache* shadow_cache, RayBudget& budget, const CancellationToken* cancellation) const;
+
+        // Render a list of regions, such as tiles, into an existing canvas. Returns false, without rendering,
+        // when any of the regions is not within the image or the canvas.
+        bool Render(const World& world, const std::vector<RenderRegion>& regions, Canvas& canvas, ShadowCache* shadow_cache, RayBudget& budget) const;
+
+        // Render the image in bands of band_height rows on thread_count threads, or one thread for each
+        // hardware thread when thread_count is 0, and hand each band to the writer as it completes. Only the
+        // bands being rendered are held by the camera, so memory use is independent of the image height when
+        // the writer streams the bands out. Bands are claimed in order from the top of the image. Returns false
+        // when the writer returns false.
+        bool RenderBands(const World& world, uint32_t band_height, uint32_t thread_count, const BandWriter& writer) const;
+
+        // Render the image in bands, stopping when the optional cancellation token is cancelled. Bands that were
+        // not completed are not handed to the writer. Returns false when the writer returns false or the render
+        // was cancelled.
+        bool RenderBands(const World& world, uint32_t band_height, uint32_t thread_count, const BandWriter& writer, const CancellationToken* cancellation) const;
+
+        // Render the image in bands, calling the optional abort function once, from the thread that finds that
+        // the render has been cancelled or the writer has failed. A writer that waits for earlier bands, such
+        // as PpmStreamWriter, can release its waiting threads from abort, as the bands it waits for may never
+        // arrive.
+        bool RenderBands(const World& world, uint32_t band_height, uint32_t thread_count, const BandWriter& writer, const CancellationToken* cancellation, const std::function<void()>& abort) const;
+
+        RenderRegion GetImageRegion() const { return RenderRegion{ 0u, 0u, hsize_, vsize_ }; }
+
     private:
-        void ComputeSizes(uint32_t hsize, uint32_t vsize, double field_of_view);
+        void ComputeSizes(uint32_t hsize, uint32_t vsize, Scalar field_of_view);
+
+        bool IsRenderable(const RenderRegion& region, const Canvas& canvas) const
+        {
+            return region.IsWithin(hsize_, vsize_) && region.IsWithin(canvas.GetWidth(), canvas.GetHeight());
+        }
+
+        // Render the pixels of the region, writing image pixel (x, y) to canvas pixel (x - x_origin, y - y_origin).
+        // Returns false when the optional cancellation token was cancelled before every pixel was rendered.
+        bool RenderPixels(const World& world, const RenderRegion& region, uint32_t x_origin, uint32_t y_origin, Canvas& canvas, ShadowCache* shadow_cache, RayBudget& budget, const CancellationToken* cancellation) const;
 
     private:
         uint32_t hsize_;             ///< The horizontal size, in pixels, of the canvas.
         uint32_t vsize_;             ///< The vertical size, in pixels, of the canvas.
-        double field_of_view_;       ///< The angle that describes how much the camera can see.
-        double half_width_;          ///< Half the width of the canvas in world-space units.
-        double half_height_;         ///< Half the height of the canvas in world-space units.
-        double pixel_size_;          ///< Size, in world-space units, of the pixels on the canvas.
-        Matrix44 transform_;         ///< The matrix describing how the world should be oriented relative to the camera.
-        Matrix44 inverse_transform_; ///< The inverted transformation matrix.
+        Scalar field_of_view_;       ///< The angle that describes how much the camera can see.
+        Scalar half_width_;          ///< Half the width of the canvas in world-space units.
+        Scalar half_height_;         ///< Half the height of the canvas in world-space units.
+        Scalar pixel_size_;          ///< Size, in world-space units, of the pixels on the canvas.
+        Affine34 transform_;         ///< The matrix describing how the world should be oriented relative to the camera.
+        Affine34 inverse_transform_; ///< The inverted transformation matrix.
     };
 }
@@ -0,0 +1,43 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#pragma once
+
+#include <atomic>
+
+namespace rtc
+{
+    // Flag for one thread to ask work running on other threads to stop. Checking the flag is a relaxed load, so
+    // it can be checked for every pixel of a render; a render sees the request within a pixel of it being made.
+    class CancellationToken
+    {
+    public:
+        bool IsCancelled() const { return cancelled_.load(std::memory_order_relaxed); }
+
+        void Cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+
+        void Reset() { cancelled_.store(false, std::memory_order_relaxed); }
+
+    private:
+        std::atomic<bool> cancelled_{ false };  ///< Indicates that cancellation was requested.
+    };
+}
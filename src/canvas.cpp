@@ -22,26 +22,74 @@
 
 #include "canvas.h"
 
+#include <algorithm>
+
 namespace rtc
 {
-    Canvas::Canvas(uint32_t width, uint32_t height) :
+    Canvas::Canvas(uint32_t width, uint32_t height, PixelFormat format) :
         width_(width),
-        height_(height)
+        height_(height),
+        format_(format)
+    {
+        const auto count = static_cast<size_t>(width) * height;
+
+        switch (format)
+        {
+        case PixelFormat::kColor:
+            colors_.resize(count, Color{ 0.0, 0.0, 0.0 });
+            break;
+        case PixelFormat::kFloat:
+            floats_.resize(count * 3u, 0.0f);
+            break;
+        case PixelFormat::kHalf:
+            halves_.resize(count * 3u, uint16_t{ 0u });
+            break;
+        case PixelFormat::kByte:
+            bytes_.resize(count * 3u, uint8_t{ 0u });
+            break;
+        }
+    }
+
+    size_t Canvas::GetPixelSize(PixelFormat format)
     {
-        for (uint32_t i = 0u; i < height; ++i)
+        switch (format)
         {
-            pixels_.emplace_back(PixelRow(width, Color{ 0.0, 0.0, 0.0 }));
+        case PixelFormat::kFloat:
+            return 3u * sizeof(float);
+        case PixelFormat::kHalf:
+            return 3u * sizeof(uint16_t);
+        case PixelFormat::kByte:
+            return 3u;
+        case PixelFormat::kColor:
+        default:
+            return sizeof(Color);
         }
     }
 
     void Canvas::Clear(const Color& color)
     {
-        for (auto& row : pixels_)
+        if (format_ == PixelFormat::kColor)
+        {
+            std::fill(colors_.begin(), colors_.end(), color);
+            return;
+        }
+
+        if ((width_ == 0u) || (height_ == 0u))
+        {
+            return;
+        }
+
+        // Convert the color once, then copy the converted pixel.
+        WritePixel(0u, 0u, color);
+
+        const auto pixel_size = GetPixelSize();
+        auto*      data       = (format_ == PixelFormat::kFloat) ? reinterpret_cast<uint8_t*>(floats_.data()) :
+                                ((format_ == PixelFormat::kHalf) ? reinterpret_cast<uint8_t*>(halves_.data()) : bytes_.data());
+        const auto size       = static_cast<size_t>(width_) * height_ * pixel_size;
+
+        for (auto offset = pixel_size; offset < size; offset += pixel_size)
         {
-            for (auto& pixel : row)
-            {
-                pixel = color;
-            }
+            std::copy(data, data + pixel_size, data + offset);
         }
     }
 }
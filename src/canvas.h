@@ -23,6 +23,8 @@
 #pragma once
 
 #include "color.h"
+#include "double_util.h"
+#include "half.h"
 
 #include <cinttypes>
 #include <vector>
@@ -32,26 +34,90 @@ namespace rtc
     class Canvas
     {
     public:
-        Canvas(uint32_t width, uint32_t height);
+        // Storage for the pixels. The compact formats convert colors as pixels are written and read, trading
+        // precision and range for memory.
+        enum class PixelFormat
+        {
+            kColor, ///< Color, at the precision of Scalar.
+            kFloat, ///< 32-bit float RGB.
+            kHalf,  ///< 16-bit float RGB.
+            kByte   ///< 8-bit RGB, clamped to [0, 1] as for PPM output.
+        };
+
+    public:
+        Canvas(uint32_t width, uint32_t height, PixelFormat format = PixelFormat::kColor);
 
         uint32_t GetWidth() const { return width_; }
 
         uint32_t GetHeight() const { return height_; }
 
-        void WritePixel(uint32_t x, uint32_t y, const Color& color) { pixels_[y][x] = color; }
+        PixelFormat GetPixelFormat() const { return format_; }
+
+        // Bytes of storage for each pixel.
+        size_t GetPixelSize() const { return GetPixelSize(format_); }
+
+        static size_t GetPixelSize(PixelFormat format);
 
-        void WritePixel(uint32_t x, uint32_t y, Color&& color) { pixels_[y][x] = std::move(color); }
+        void WritePixel(uint32_t x, uint32_t y, const Color& color)
+        {
+            const auto index = GetIndex(x, y);
 
-        const Color& PixelAt(uint32_t x, uint32_t y) const { return pixels_[y][x]; }
+            switch (format_)
+            {
+            case PixelFormat::kColor:
+                colors_[index] = color;
+                break;
+            case PixelFormat::kFloat:
+                floats_[(index * 3u)]      = static_cast<float>(color.GetR());
+                floats_[(index * 3u) + 1u] = static_cast<float>(color.GetG());
+                floats_[(index * 3u) + 2u] = static_cast<float>(color.GetB());
+                break;
+            case PixelFormat::kHalf:
+                halves_[(index * 3u)]      = FloatToHalf(static_cast<float>(color.GetR()));
+                halves_[(index * 3u) + 1u] = FloatToHalf(static_cast<float>(color.GetG()));
+                halves_[(index * 3u) + 2u] = FloatToHalf(static_cast<float>(color.GetB()));
+                break;
+            case PixelFormat::kByte:
+                bytes_[(index * 3u)]      = ToByte(color.GetR());
+                bytes_[(index * 3u) + 1u] = ToByte(color.GetG());
+                bytes_[(index * 3u) + 2u] = ToByte(color.GetB());
+                break;
+            }
+        }
+
+        Color PixelAt(uint32_t x, uint32_t y) const
+        {
+            const auto index = GetIndex(x, y);
+
+            switch (format_)
+            {
+            case PixelFormat::kFloat:
+                return Color{ floats_[(index * 3u)], floats_[(index * 3u) + 1u], floats_[(index * 3u) + 2u] };
+            case PixelFormat::kHalf:
+                return Color{ HalfToFloat(halves_[(index * 3u)]), HalfToFloat(halves_[(index * 3u) + 1u]), HalfToFloat(halves_[(index * 3u) + 2u]) };
+            case PixelFormat::kByte:
+                return Color{ bytes_[(index * 3u)] / Scalar{ 255 }, bytes_[(index * 3u) + 1u] / Scalar{ 255 }, bytes_[(index * 3u) + 2u] / Scalar{ 255 } };
+            case PixelFormat::kColor:
+            default:
+                return colors_[index];
+            }
+        }
 
         void Clear(const Color& color);
 
+        // Components of row y of a kFloat canvas, three for each pixel, or nullptr for the other formats.
+        const float* GetFloatRow(uint32_t y) const { return (format_ == PixelFormat::kFloat) ? (floats_.data() + (GetIndex(0u, y) * 3u)) : nullptr; }
+
     private:
-        using PixelRow = std::vector<Color>;
+        size_t GetIndex(uint32_t x, uint32_t y) const { return (static_cast<size_t>(y) * width_) + x; }
 
     private:
-        uint32_t              width_;
-        uint32_t              height_;
-        std::vector<PixelRow> pixels_;
+        uint32_t              width_;  ///< Width of the image.
+        uint32_t              height_; ///< Height of the image.
+        PixelFormat           format_; ///< Storage for the pixels, which is held by one of the vectors below.
+        std::vector<Color>    colors_; ///< Pixels stored as colors, in scanline order.
+        std::vector<float>    floats_; ///< Pixels stored as 32-bit float components.
+        std::vector<uint16_t> halves_; ///< Pixels stored as 16-bit float components.
+        std::vector<uint8_t>  bytes_;  ///< Pixels stored as 8-bit components.
     };
 }
@@ -0,0 +1,232 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "catch2/catch.hpp"
+
+#include "camera.h"
+#include "canvas.h"
+#include "color.h"
+#include "double_util.h"
+#include "half.h"
+#include "matrix44.h"
+#include "memory_output_stream.h"
+#include "point.h"
+#include "ppm_writer.h"
+#include "ray_budget.h"
+#include "shadow_cache.h"
+#include "vector.h"
+#include "world.h"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace
+{
+    std::vector<uint8_t> EncodePpm(const rtc::Canvas& canvas)
+    {
+        auto stream = rtc::MemoryOutputStream{};
+        rtc::PpmWriter::WriteStream(&stream, canvas);
+        return std::vector<uint8_t>{ stream.GetData(), stream.GetData() + stream.GetSize() };
+    }
+}
+
+SCENARIO("Storage required by each pixel format", "[canvas]")
+{
+    GIVEN("canvases of each pixel format")
+    {
+        THEN("the compact formats use fewer bytes for each pixel")
+        {
+            REQUIRE(rtc::Canvas::GetPixelSize(rtc::Canvas::PixelFormat::kColor) == sizeof(rtc::Color));
+            REQUIRE(rtc::Canvas::GetPixelSize(rtc::Canvas::PixelFormat::kFloat) == 12u);
+            REQUIRE(rtc::Canvas::GetPixelSize(rtc::Canvas::PixelFormat::kHalf) == 6u);
+            REQUIRE(rtc::Canvas::GetPixelSize(rtc::Canvas::PixelFormat::kByte) == 3u);
+
+            const auto c = rtc::Canvas{ 4u, 2u, rtc::Canvas::PixelFormat::kHalf };
+            REQUIRE(c.GetPixelFormat() == rtc::Canvas::PixelFormat::kHalf);
+            REQUIRE(c.GetPixelSize() == 6u);
+        }
+
+        THEN("every pixel starts black")
+        {
+            for (const auto format : { rtc::Canvas::PixelFormat::kColor, rtc::Canvas::PixelFormat::kFloat, rtc::Canvas::PixelFormat::kHalf, rtc::Canvas::PixelFormat::kByte })
+            {
+                const auto c = rtc::Canvas{ 3u, 2u, format };
+                REQUIRE(rtc::Color::Equal(c.PixelAt(2u, 1u), rtc::Color{ 0.0, 0.0, 0.0 }));
+            }
+        }
+    }
+}
+
+SCENARIO("Writing pixels to compact canvases", "[canvas]")
+{
+    GIVEN("hdr <- color(1.5, 0.25, -2)")
+    {
+        const auto hdr = rtc::Color{ static_cast<rtc::Scalar>(1.5), static_cast<rtc::Scalar>(0.25), static_cast<rtc::Scalar>(-2.0) };
+
+        THEN("float and half canvases keep values outside [0, 1]")
+        {
+            for (const auto format : { rtc::Canvas::PixelFormat::kFloat, rtc::Canvas::PixelFormat::kHalf })
+            {
+                auto c = rtc::Canvas{ 2u, 2u, format };
+                c.WritePixel(1u, 0u, hdr);
+                REQUIRE(rtc::Color::Equal(c.PixelAt(1u, 0u), hdr));
+                REQUIRE(rtc::Color::Equal(c.PixelAt(0u, 1u), rtc::Color{ 0.0, 0.0, 0.0 }));
+            }
+        }
+
+        THEN("a byte canvas clamps and quantizes the color")
+        {
+            auto c = rtc::Canvas{ 2u, 2u, rtc::Canvas::PixelFormat::kByte };
+            c.WritePixel(1u, 0u, hdr);
+            REQUIRE(rtc::Color::Equal(c.PixelAt(1u, 0u), rtc::Color{ 1.0, 63.0 / 255.0, 0.0 }));
+        }
+    }
+
+    GIVEN("a color that a half stores approximately")
+    {
+        const auto color = rtc::Color{ static_cast<rtc::Scalar>(0.1), static_cast<rtc::Scalar>(0.7), static_cast<rtc::Scalar>(123.4) };
+        auto       c     = rtc::Canvas{ 1u, 1u, rtc::Canvas::PixelFormat::kHalf };
+        c.WritePixel(0u, 0u, color);
+
+        THEN("the stored color is within the half's precision")
+        {
+            const auto stored = c.PixelAt(0u, 0u);
+            REQUIRE(std::abs(stored.GetR() - color.GetR()) <= (color.GetR() / 1024.0));
+            REQUIRE(std::abs(stored.GetG() - color.GetG()) <= (color.GetG() / 1024.0));
+            REQUIRE(std::abs(stored.GetB() - color.GetB()) <= (color.GetB() / 1024.0));
+        }
+    }
+
+    GIVEN("colors in the displayable range")
+    {
+        auto full    = rtc::Canvas{ 5u, 3u };
+        auto compact = rtc::Canvas{ 5u, 3u, rtc::Canvas::PixelFormat::kByte };
+
+        for (uint32_t y = 0u; y < 3u; ++y)
+        {
+            for (uint32_t x = 0u; x < 5u; ++x)
+            {
+                const auto color = rtc::Color{ static_cast<rtc::Scalar>(x) / static_cast<rtc::Scalar>(4), static_cast<rtc::Scalar>(y) / static_cast<rtc::Scalar>(3), static_cast<rtc::Scalar>(0.3) };
+                full.WritePixel(x, y, color);
+                compact.WritePixel(x, y, color);
+            }
+        }
+
+        THEN("a byte canvas writes the same PPM as a color canvas")
+        {
+            REQUIRE(EncodePpm(compact) == EncodePpm(full));
+        }
+    }
+}
+
+SCENARIO("Clearing compact canvases", "[canvas]")
+{
+    GIVEN("a canvas of each pixel format")
+    {
+        const auto color = rtc::Color{ 1.0, 0.5, 0.25 };
+
+        THEN("every pixel is set to the color")
+        {
+            for (const auto format : { rtc::Canvas::PixelFormat::kColor, rtc::Canvas::PixelFormat::kFloat, rtc::Canvas::PixelFormat::kHalf, rtc::Canvas::PixelFormat::kByte })
+            {
+                auto c = rtc::Canvas{ 3u, 4u, format };
+                c.Clear(color);
+
+                const auto expected = (format == rtc::Canvas::PixelFormat::kByte) ? rtc::Color{ 1.0, 127.0 / 255.0, 63.0 / 255.0 } : color;
+                REQUIRE(rtc::Color::Equal(c.PixelAt(0u, 0u), expected));
+                REQUIRE(rtc::Color::Equal(c.PixelAt(2u, 3u), expected));
+            }
+        }
+    }
+}
+
+SCENARIO("Converting between floats and halves", "[canvas]")
+{
+    GIVEN("every half value")
+    {
+        THEN("each value that is not a NaN converts to a float and back unchanged")
+        {
+            auto mismatches = 0u;
+            for (uint32_t bits = 0u; bits <= 0xffffu; ++bits)
+            {
+                const auto half  = static_cast<uint16_t>(bits);
+                const auto value = rtc::HalfToFloat(half);
+                if (!std::isnan(value) && (rtc::FloatToHalf(value) != half))
+                {
+                    ++mismatches;
+                }
+            }
+
+            REQUIRE(mismatches == 0u);
+        }
+    }
+
+    GIVEN("floats outside the range of a half")
+    {
+        THEN("large values become infinity and tiny values become zero")
+        {
+            REQUIRE(rtc::FloatToHalf(65504.0f) == 0x7bffu);
+            REQUIRE(rtc::FloatToHalf(70000.0f) == 0x7c00u);
+            REQUIRE(rtc::FloatToHalf(-70000.0f) == 0xfc00u);
+            REQUIRE(rtc::FloatToHalf(1.0e-10f) == 0x0000u);
+            REQUIRE(std::isnan(rtc::HalfToFloat(rtc::FloatToHalf(std::numeric_limits<float>::quiet_NaN()))));
+        }
+
+        THEN("values between halves round to the nearest, with ties to even")
+        {
+            // Halves near 1 are 1/1024 apart.
+            REQUIRE(rtc::FloatToHalf(1.0f + (0.5f / 1024.0f)) == 0x3c00u);
+            REQUIRE(rtc::FloatToHalf(1.0f + (1.5f / 1024.0f)) == 0x3c02u);
+            REQUIRE(rtc::FloatToHalf(1.0f + (0.6f / 1024.0f)) == 0x3c01u);
+        }
+    }
+}
+
+SCENARIO("Rendering into a compact canvas", "[canvas]")
+{
+    GIVEN("the default world and an 11x11 camera")
+    {
+        const auto w    = rtc::World::GetDefault();
+        const auto from = rtc::Point{ 0.0, 0.0, -5.0 };
+        const auto to   = rtc::Point{ 0.0, 0.0, 0.0 };
+        const auto up   = rtc::Vector{ 0.0, 1.0, 0.0 };
+        const auto c    = rtc::Camera{ 11u, 11u, rtc::kPi / 2.0, rtc::Matrix44::ViewTransform(from, to, up) };
+
+        WHEN("the image is rendered into a half canvas")
+        {
+            auto image  = rtc::Canvas{ 11u, 11u, rtc::Canvas::PixelFormat::kHalf };
+            auto cache  = rtc::ShadowCache{};
+            auto budget = rtc::RayBudget{};
+
+            REQUIRE(c.Render(w, c.GetImageRegion(), image, &cache, budget));
+
+            THEN("the pixels match the full precision render within the half's precision")
+            {
+                const auto full = c.Render(w);
+                REQUIRE(std::abs(image.PixelAt(5u, 5u).GetR() - full.PixelAt(5u, 5u).GetR()) < 1.0e-3);
+                REQUIRE(std::abs(image.PixelAt(5u, 5u).GetG() - full.PixelAt(5u, 5u).GetG()) < 1.0e-3);
+                REQUIRE(std::abs(image.PixelAt(5u, 5u).GetB() - full.PixelAt(5u, 5u).GetB()) < 1.0e-3);
+            }
+        }
+    }
+}
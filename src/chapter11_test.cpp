@@ -0,0 +1,631 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "catch2/catch.hpp"
+
+#include "color.h"
+#include "computations.h"
+#include "double_util.h"
+#include "intersection.h"
+#include "intersections.h"
+#include "material.h"
+#include "matrix44.h"
+#include "pattern.h"
+#include "plane.h"
+#include "point.h"
+#include "point_light.h"
+#include "ray.h"
+#include "ray_budget.h"
+#include "sphere.h"
+#include "vector.h"
+#include "world.h"
+
+#include <cmath>
+#include <memory>
+
+// The expected colors that depend on the over and under points differ slightly from the book's, which offsets
+// them by an EPSILON of 0.0001 rather than rtc::kEpsilon.
+namespace
+{
+    const auto kHalfSqrt2 = static_cast<rtc::Scalar>(std::sqrt(2.0) / 2.0);
+
+    // Pattern whose color is the pattern space point.
+    class PointPattern : public rtc::Pattern
+    {
+    public:
+        static std::shared_ptr<PointPattern> Create() { return std::shared_ptr<PointPattern>(new PointPattern()); }
+
+        virtual rtc::Color PatternAt(const rtc::Point& point) const override { return rtc::Color{ point.GetX(), point.GetY(), point.GetZ() }; }
+    };
+
+    rtc::Material GlassMaterial(rtc::Scalar refractive_index)
+    {
+        auto material = rtc::Material{};
+        material.SetTransparency(1.0);
+        material.SetRefractiveIndex(refractive_index);
+        return material;
+    }
+
+    std::shared_ptr<rtc::Sphere> GlassSphere()
+    {
+        return rtc::Sphere::Create(GlassMaterial(1.5));
+    }
+
+    // Change a material attribute of an object, through a copy of its material.
+    template <typename Function>
+    void ModifyMaterial(const std::shared_ptr<rtc::Shape>& shape, Function function)
+    {
+        auto material = shape->GetMaterial();
+        function(material);
+        shape->SetMaterial(material);
+    }
+}
+
+SCENARIO("Reflectivity for the default material", "[reflection]")
+{
+    GIVEN("m <- material()")
+    {
+        const auto m = rtc::Material{};
+
+        THEN("m.reflective = 0.0")
+        {
+            REQUIRE(m.GetReflective() == 0.0);
+        }
+    }
+}
+
+SCENARIO("Precomputing the reflection vector", "[reflection]")
+{
+    GIVEN("shape <- plane() and r <- ray(point(0, 1, -1), vector(0, -sqrt(2)/2, sqrt(2)/2)) and i <- intersection(sqrt(2), shape)")
+    {
+        const auto shape = rtc::Plane::Create();
+        const auto r     = rtc::Ray{ rtc::Point{ 0.0, 1.0, -1.0 }, rtc::Vector{ 0.0, -kHalfSqrt2, kHalfSqrt2 } };
+        const auto i     = rtc::Intersection{ static_cast<rtc::Scalar>(std::sqrt(2.0)), shape };
+
+        WHEN("comps <- prepare_computations(i, r)")
+        {
+            const auto comps = rtc::Computations::Prepare(i, r);
+
+            THEN("comps.reflectv = vector(0, sqrt(2)/2, sqrt(2)/2)")
+            {
+                REQUIRE(rtc::Vector::Equal(comps.GetReflect(), rtc::Vector{ 0.0, kHalfSqrt2, kHalfSqrt2 }));
+            }
+        }
+    }
+}
+
+SCENARIO("The reflected color for a nonreflective material", "[reflection]")
+{
+    GIVEN("w <- default_world() and r <- ray(point(0, 0, 0), vector(0, 0, 1)) and shape <- the second object in w with ambient 1 and i <- intersection(1, shape)")
+    {
+        auto       w     = rtc::World::GetDefault();
+        const auto r     = rtc::Ray{ rtc::Point{ 0.0, 0.0, 0.0 }, rtc::Vector{ 0.0, 0.0, 1.0 } };
+        const auto shape = w.GetObject(1);
+        ModifyMaterial(shape, [](rtc::Material& m) { m.SetAmbient(1.0); });
+        const auto i = rtc::Intersection{ 1.0, shape };
+
+        WHEN("comps <- prepare_computations(i, r) and color <- reflected_color(w, comps)")
+        {
+            const auto comps  = rtc::Computations::Prepare(i, r);
+            auto       budget = rtc::RayBudget{};
+            const auto color  = comps.ReflectedColor(w, budget);
+
+            THEN("color = color(0, 0, 0)")
+            {
+                REQUIRE(rtc::Color::Equal(color, rtc::Color{ 0.0, 0.0, 0.0 }));
+            }
+        }
+    }
+}
+
+SCENARIO("The reflected color for a reflective material", "[reflection]")
+{
+    GIVEN("w <- default_world() and shape <- plane() with reflective 0.5 and transform translation(0, -1, 0) added to w and r <- ray(point(0, 0, -3), vector(0, -sqrt(2)/2, sqrt(2)/2)) and i <- intersection(sqrt(2), shape)")
+    {
+        auto w     = rtc::World::GetDefault();
+        auto shape = rtc::Plane::Create(rtc::Matrix44::Translation(0.0, -1.0, 0.0));
+        ModifyMaterial(shape, [](rtc::Material& m) { m.SetReflective(0.5); });
+        w.AppendObject(shape);
+
+        const auto r = rtc::Ray{ rtc::Point{ 0.0, 0.0, -3.0 }, rtc::Vector{ 0.0, -kHalfSqrt2, kHalfSqrt2 } };
+        const auto i = rtc::Intersection{ static_cast<rtc::Scalar>(std::sqrt(2.0)), shape };
+
+        WHEN("comps <- prepare_computations(i, r) and color <- reflected_color(w, comps)")
+        {
+            const auto comps  = rtc::Computations::Prepare(i, r);
+            auto       budget = rtc::RayBudget{ rtc::RayBudget::kDefaultMaxDepth, 0.0 };
+            const auto color  = comps.ReflectedColor(w, budget);
+
+            THEN("color = color(0.19033, 0.23792, 0.14275)")
+            {
+                REQUIRE(rtc::Color::Equal(color, rtc::Color{ 0.19033, 0.23792, 0.14275 }));
+            }
+        }
+    }
+}
+
+SCENARIO("shade_hit() with a reflective material", "[reflection]")
+{
+    GIVEN("w <- default_world() and shape <- plane() with reflective 0.5 and transform translation(0, -1, 0) added to w and r <- ray(point(0, 0, -3), vector(0, -sqrt(2)/2, sqrt(2)/2)) and i <- intersection(sqrt(2), shape)")
+    {
+        auto w     = rtc::World::GetDefault();
+        auto shape = rtc::Plane::Create(rtc::Matrix44::Translation(0.0, -1.0, 0.0));
+        ModifyMaterial(shape, [](rtc::Material& m) { m.SetReflective(0.5); });
+        w.AppendObject(shape);
+
+        const auto r = rtc::Ray{ rtc::Point{ 0.0, 0.0, -3.0 }, rtc::Vector{ 0.0, -kHalfSqrt2, kHalfSqrt2 } };
+        const auto i = rtc::Intersection{ static_cast<rtc::Scalar>(std::sqrt(2.0)), shape };
+
+        WHEN("comps <- prepare_computations(i, r) and color <- shade_hit(w, comps)")
+        {
+            const auto comps = rtc::Computations::Prepare(i, r);
+            const auto color = comps.ShadeHit(w);
+
+            THEN("color = color(0.87676, 0.92434, 0.82917)")
+            {
+                REQUIRE(rtc::Color::Equal(color, rtc::Color{ 0.87676, 0.92434, 0.82917 }));
+            }
+        }
+    }
+}
+
+SCENARIO("color_at() with mutually reflective surfaces", "[reflection]")
+{
+    GIVEN("w <- world() with light at point(0, 0, 0) and reflective planes lower at y = -1 and upper at y = 1 and r <- ray(point(0, 0, 0), vector(0, 1, 0))")
+    {
+        auto w = rtc::World{};
+        w.AppendLight(rtc::PointLight{ rtc::Point{ 0.0, 0.0, 0.0 }, rtc::Color{ 1.0, 1.0, 1.0 } });
+
+        auto lower = rtc::Plane::Create(rtc::Matrix44::Translation(0.0, -1.0, 0.0));
+        auto upper = rtc::Plane::Create(rtc::Matrix44::Translation(0.0, 1.0, 0.0));
+        ModifyMaterial(lower, [](rtc::Material& m) { m.SetReflective(1.0); });
+        ModifyMaterial(upper, [](rtc::Material& m) { m.SetReflective(1.0); });
+        w.AppendObject(lower);
+        w.AppendObject(upper);
+
+        const auto r = rtc::Ray{ rtc::Point{ 0.0, 0.0, 0.0 }, rtc::Vector{ 0.0, 1.0, 0.0 } };
+
+        WHEN("budget <- ray_budget(5, 0) and c <- color_at(w, r, budget)")
+        {
+            auto budget = rtc::RayBudget{ 5u, 0.0 };
+            rtc::Computations::ColorAt(w, r, budget);
+
+            THEN("color_at() terminates after one ray at each depth up to the maximum")
+            {
+                for (uint32_t depth = 0u; depth <= 5u; ++depth)
+                {
+                    REQUIRE(budget.GetRayCount(depth) == 1u);
+                }
+
+                REQUIRE(budget.GetRayCount(6u) == 0u);
+                REQUIRE(budget.GetTotalRayCount() == 6u);
+                REQUIRE(budget.GetDepthLimitedCount() == 1u);
+                REQUIRE(budget.GetCulledCount() == 0u);
+            }
+        }
+    }
+}
+
+SCENARIO("The reflected color at the maximum recursive depth", "[reflection]")
+{
+    GIVEN("w <- default_world() and shape <- plane() with reflective 0.5 and transform translation(0, -1, 0) added to w and r <- ray(point(0, 0, -3), vector(0, -sqrt(2)/2, sqrt(2)/2)) and i <- intersection(sqrt(2), shape)")
+    {
+        auto w     = rtc::World::GetDefault();
+        auto shape = rtc::Plane::Create(rtc::Matrix44::Translation(0.0, -1.0, 0.0));
+        ModifyMaterial(shape, [](rtc::Material& m) { m.SetReflective(0.5); });
+        w.AppendObject(shape);
+
+        const auto r = rtc::Ray{ rtc::Point{ 0.0, 0.0, -3.0 }, rtc::Vector{ 0.0, -kHalfSqrt2, kHalfSqrt2 } };
+        const auto i = rtc::Intersection{ static_cast<rtc::Scalar>(std::sqrt(2.0)), shape };
+
+        WHEN("comps <- prepare_computations(i, r) and color <- reflected_color(w, comps, 0)")
+        {
+            const auto comps  = rtc::Computations::Prepare(i, r);
+            auto       budget = rtc::RayBudget{ 0u, 0.0 };
+            const auto color  = comps.ReflectedColor(w, budget);
+
+            THEN("color = color(0, 0, 0)")
+            {
+                REQUIRE(rtc::Color::Equal(color, rtc::Color{ 0.0, 0.0, 0.0 }));
+                REQUIRE(budget.GetDepthLimitedCount() == 1u);
+            }
+        }
+    }
+}
+
+SCENARIO("Transparency and Refractive Index for the default material", "[refraction]")
+{
+    GIVEN("m <- material()")
+    {
+        const auto m = rtc::Material{};
+
+        THEN("m.transparency = 0.0 and m.refractive_index = 1.0")
+        {
+            REQUIRE(m.GetTransparency() == 0.0);
+            REQUIRE(m.GetRefractiveIndex() == 1.0);
+        }
+    }
+}
+
+SCENARIO("A helper for producing a sphere with a glassy material", "[refraction]")
+{
+    GIVEN("s <- glass_sphere()")
+    {
+        const auto s = GlassSphere();
+
+        THEN("s.transform = identity_matrix and s.material.transparency = 1.0 and s.material.refractive_index = 1.5")
+        {
+            REQUIRE(rtc::Matrix44::Equal(s->GetTransform(), rtc::Matrix44::Identity()));
+            REQUIRE(s->GetMaterial().GetTransparency() == 1.0);
+            REQUIRE(s->GetMaterial().GetRefractiveIndex() == 1.5);
+        }
+    }
+}
+
+SCENARIO("Finding n1 and n2 at various intersections", "[refraction]")
+{
+    GIVEN("A <- glass_sphere() scaled by 2 with refractive index 1.5, B <- glass_sphere() translated by (0, 0, -0.25) with refractive index 2, C <- glass_sphere() translated by (0, 0, 0.25) with refractive index 2.5, and r <- ray(point(0, 0, -4), vector(0, 0, 1))")
+    {
+        const auto a = rtc::Sphere::Create(GlassMaterial(1.5), rtc::Matrix44::Scaling(2.0, 2.0, 2.0));
+        const auto b = rtc::Sphere::Create(GlassMaterial(2.0), rtc::Matrix44::Translation(0.0, 0.0, -0.25));
+        const auto c = rtc::Sphere::Create(GlassMaterial(2.5), rtc::Matrix44::Translation(0.0, 0.0, 0.25));
+        const auto r = rtc::Ray{ rtc::Point{ 0.0, 0.0, -4.0 }, rtc::Vector{ 0.0, 0.0, 1.0 } };
+
+        const auto xs = rtc::Intersections::Values{
+            rtc::Intersection{ 2.0, a },
+            rtc::Intersection{ 2.75, b },
+            rtc::Intersection{ 3.25, c },
+            rtc::Intersection{ 4.75, b },
+            rtc::Intersection{ 5.25, c },
+            rtc::Intersection{ 6.0, a }
+        };
+
+        THEN("comps <- prepare_computations(xs[index], r, xs) has the expected n1 and n2")
+        {
+            const rtc::Scalar n1[] = { 1.0, 1.5, 2.0, 2.5, 2.5, 1.5 };
+            const rtc::Scalar n2[] = { 1.5, 2.0, 2.5, 2.5, 1.5, 1.0 };
+
+            for (size_t index = 0u; index < xs.size(); ++index)
+            {
+                const auto comps = rtc::Computations::Prepare(xs[index], r, xs);
+
+                REQUIRE(comps.GetN1() == n1[index]);
+                REQUIRE(comps.GetN2() == n2[index]);
+            }
+        }
+    }
+}
+
+SCENARIO("The under point is offset below the surface", "[refraction]")
+{
+    GIVEN("r <- ray(point(0, 0, -5), vector(0, 0, 1)) and shape <- glass_sphere() with transform translation(0, 0, 1) and i <- intersection(5, shape)")
+    {
+        const auto r     = rtc::Ray{ rtc::Point{ 0.0, 0.0, -5.0 }, rtc::Vector{ 0.0, 0.0, 1.0 } };
+        const auto shape = rtc::Sphere::Create(GlassMaterial(1.5), rtc::Matrix44::Translation(0.0, 0.0, 1.0));
+        const auto i     = rtc::Intersection{ 5.0, shape };
+
+        WHEN("comps <- prepare_computations(i, r, xs)")
+        {
+            const auto comps = rtc::Computations::Prepare(i, r, rtc::Intersections::Values{ i });
+
+            THEN("comps.under_point.z > EPSILON/2 and comps.point.z < comps.under_point.z")
+            {
+                REQUIRE(comps.GetUnderPoint().GetZ() > rtc::kEpsilon / 2);
+                REQUIRE(comps.GetPoint().GetZ() < comps.GetUnderPoint().GetZ());
+            }
+        }
+    }
+}
+
+SCENARIO("The refracted color with an opaque surface", "[refraction]")
+{
+    GIVEN("w <- default_world() and shape <- the first object in w and r <- ray(point(0, 0, -5), vector(0, 0, 1)) and xs <- intersections(4:shape, 6:shape)")
+    {
+        const auto w     = rtc::World::GetDefault();
+        const auto shape = w.GetObject(0);
+        const auto r     = rtc::Ray{ rtc::Point{ 0.0, 0.0, -5.0 }, rtc::Vector{ 0.0, 0.0, 1.0 } };
+        const auto xs    = rtc::Intersections::Values{ rtc::Intersection{ 4.0, shape }, rtc::Intersection{ 6.0, shape } };
+
+        WHEN("comps <- prepare_computations(xs[0], r, xs) and c <- refracted_color(w, comps, 5)")
+        {
+            const auto comps  = rtc::Computations::Prepare(xs[0], r, xs);
+            auto       budget = rtc::RayBudget{ 5u, 0.0 };
+            const auto c      = comps.RefractedColor(w, budget);
+
+            THEN("c = color(0, 0, 0)")
+            {
+                REQUIRE(rtc::Color::Equal(c, rtc::Color{ 0.0, 0.0, 0.0 }));
+            }
+        }
+    }
+}
+
+SCENARIO("The refracted color at the maximum recursive depth", "[refraction]")
+{
+    GIVEN("w <- default_world() and shape <- the first object in w with transparency 1 and refractive index 1.5 and r <- ray(point(0, 0, -5), vector(0, 0, 1)) and xs <- intersections(4:shape, 6:shape)")
+    {
+        const auto w     = rtc::World::GetDefault();
+        const auto shape = w.GetObject(0);
+        ModifyMaterial(shape, [](rtc::Material& m) { m.SetTransparency(1.0); m.SetRefractiveIndex(1.5); });
+
+        const auto r  = rtc::Ray{ rtc::Point{ 0.0, 0.0, -5.0 }, rtc::Vector{ 0.0, 0.0, 1.0 } };
+        const auto xs = rtc::Intersections::Values{ rtc::Intersection{ 4.0, shape }, rtc::Intersection{ 6.0, shape } };
+
+        WHEN("comps <- prepare_computations(xs[0], r, xs) and c <- refracted_color(w, comps, 0)")
+        {
+            const auto comps  = rtc::Computations::Prepare(xs[0], r, xs);
+            auto       budget = rtc::RayBudget{ 0u, 0.0 };
+            const auto c      = comps.RefractedColor(w, budget);
+
+            THEN("c = color(0, 0, 0)")
+            {
+                REQUIRE(rtc::Color::Equal(c, rtc::Color{ 0.0, 0.0, 0.0 }));
+            }
+        }
+    }
+}
+
+SCENARIO("The refracted color under total internal reflection", "[refraction]")
+{
+    GIVEN("w <- default_world() and shape <- the first object in w with transparency 1 and refractive index 1.5 and r <- ray(point(0, 0, sqrt(2)/2), vector(0, 1, 0)) and xs <- intersections(-sqrt(2)/2:shape, sqrt(2)/2:shape)")
+    {
+        const auto w     = rtc::World::GetDefault();
+        const auto shape = w.GetObject(0);
+        ModifyMaterial(shape, [](rtc::Material& m) { m.SetTransparency(1.0); m.SetRefractiveIndex(1.5); });
+
+        const auto r  = rtc::Ray{ rtc::Point{ 0.0, 0.0, kHalfSqrt2 }, rtc::Vector{ 0.0, 1.0, 0.0 } };
+        const auto xs = rtc::Intersections::Values{ rtc::Intersection{ -kHalfSqrt2, shape }, rtc::Intersection{ kHalfSqrt2, shape } };
+
+        WHEN("comps <- prepare_computations(xs[1], r, xs) and c <- refracted_color(w, comps, 5)")
+        {
+            const auto comps  = rtc::Computations::Prepare(xs[1], r, xs);
+            auto       budget = rtc::RayBudget{ 5u, 0.0 };
+            const auto c      = comps.RefractedColor(w, budget);
+
+            THEN("c = color(0, 0, 0), without tracing a ray")
+            {
+                REQUIRE(rtc::Color::Equal(c, rtc::Color{ 0.0, 0.0, 0.0 }));
+                REQUIRE(budget.GetTotalRayCount() == 0u);
+            }
+        }
+    }
+}
+
+SCENARIO("The refracted color with a refracted ray", "[refraction]")
+{
+    GIVEN("w <- default_world() and A <- the first object in w with ambient 1 and a test pattern and B <- the second object in w with transparency 1 and refractive index 1.5 and r <- ray(point(0, 0, 0.1), vector(0, 1, 0)) and xs <- intersections(-0.9899:A, -0.4899:B, 0.4899:B, 0.9899:A)")
+    {
+        const auto w = rtc::World::GetDefault();
+        const auto a = w.GetObject(0);
+        const auto b = w.GetObject(1);
+        ModifyMaterial(a, [](rtc::Material& m) { m = rtc::Material{ PointPattern::Create(), 1.0, m.GetDiffuse(), m.GetSpecular(), m.GetShininess() }; });
+        ModifyMaterial(b, [](rtc::Material& m) { m.SetTransparency(1.0); m.SetRefractiveIndex(1.5); });
+
+        const auto r  = rtc::Ray{ rtc::Point{ 0.0, 0.0, 0.1 }, rtc::Vector{ 0.0, 1.0, 0.0 } };
+        const auto xs = rtc::Intersections::Values{
+            rtc::Intersection{ -0.9899, a },
+            rtc::Intersection{ -0.4899, b },
+            rtc::Intersection{ 0.4899, b },
+            rtc::Intersection{ 0.9899, a }
+        };
+
+        WHEN("comps <- prepare_computations(xs[2], r, xs) and c <- refracted_color(w, comps, 5)")
+        {
+            const auto comps  = rtc::Computations::Prepare(xs[2], r, xs);
+            auto       budget = rtc::RayBudget{ 5u, 0.0 };
+            const auto c      = comps.RefractedColor(w, budget);
+
+            THEN("c = color(0, 0.99888, 0.04722)")
+            {
+                REQUIRE(rtc::Color::Equal(c, rtc::Color{ 0.0, 0.99888, 0.04722 }));
+            }
+        }
+    }
+}
+
+SCENARIO("shade_hit() with a transparent material", "[refraction]")
+{
+    GIVEN("w <- default_world() with floor <- plane() translated by (0, -1, 0) with transparency 0.5 and refractive index 1.5 and ball <- sphere() colored (1, 0, 0) with ambient 0.5 translated by (0, -3.5, -0.5) and r <- ray(point(0, 0, -3), vector(0, -sqrt(2)/2, sqrt(2)/2)) and xs <- intersections(sqrt(2):floor)")
+    {
+        auto w     = rtc::World::GetDefault();
+        auto floor = rtc::Plane::Create(rtc::Matrix44::Translation(0.0, -1.0, 0.0));
+        ModifyMaterial(floor, [](rtc::Material& m) { m.SetTransparency(0.5); m.SetRefractiveIndex(1.5); });
+        auto ball = rtc::Sphere::Create(rtc::Material{ rtc::Color{ 1.0, 0.0, 0.0 }, 0.5, 0.9, 0.9, 200.0 }, rtc::Matrix44::Translation(0.0, -3.5, -0.5));
+        w.AppendObject(floor);
+        w.AppendObject(ball);
+
+        const auto r  = rtc::Ray{ rtc::Point{ 0.0, 0.0, -3.0 }, rtc::Vector{ 0.0, -kHalfSqrt2, kHalfSqrt2 } };
+        const auto xs = rtc::Intersections::Values{ rtc::Intersection{ static_cast<rtc::Scalar>(std::sqrt(2.0)), floor } };
+
+        WHEN("comps <- prepare_computations(xs[0], r, xs) and color <- shade_hit(w, comps, 5)")
+        {
+            const auto comps  = rtc::Computations::Prepare(xs[0], r, xs);
+            auto       budget = rtc::RayBudget{ 5u, 0.0 };
+            const auto color  = comps.ShadeHit(w, budget);
+
+            // The book's floor casts an opaque shadow on the ball, for color(0.93642, 0.68642, 0.68642). Here half of
+            // the light passes through the transparent floor and adds to the ball's red diffuse light.
+            THEN("color = color(1.12547, 0.68642, 0.68642)")
+            {
+                REQUIRE(rtc::Color::Equal(color, rtc::Color{ 1.12547, 0.68642, 0.68642 }));
+            }
+        }
+    }
+}
+
+SCENARIO("The Schlick approximation under total internal reflection", "[refraction]")
+{
+    GIVEN("shape <- glass_sphere() and r <- ray(point(0, 0, sqrt(2)/2), vector(0, 1, 0)) and xs <- intersections(-sqrt(2)/2:shape, sqrt(2)/2:shape)")
+    {
+        const auto shape = GlassSphere();
+        const auto r     = rtc::Ray{ rtc::Point{ 0.0, 0.0, kHalfSqrt2 }, rtc::Vector{ 0.0, 1.0, 0.0 } };
+        const auto xs    = rtc::Intersections::Values{ rtc::Intersection{ -kHalfSqrt2, shape }, rtc::Intersection{ kHalfSqrt2, shape } };
+
+        WHEN("comps <- prepare_computations(xs[1], r, xs) and reflectance <- schlick(comps)")
+        {
+            const auto comps       = rtc::Computations::Prepare(xs[1], r, xs);
+            const auto reflectance = comps.Schlick();
+
+            THEN("reflectance = 1.0")
+            {
+                REQUIRE(reflectance == 1.0);
+            }
+        }
+    }
+}
+
+SCENARIO("The Schlick approximation with a perpendicular viewing angle", "[refraction]")
+{
+    GIVEN("shape <- glass_sphere() and r <- ray(point(0, 0, 0), vector(0, 1, 0)) and xs <- intersections(-1:shape, 1:shape)")
+    {
+        const auto shape = GlassSphere();
+        const auto r     = rtc::Ray{ rtc::Point{ 0.0, 0.0, 0.0 }, rtc::Vector{ 0.0, 1.0, 0.0 } };
+        const auto xs    = rtc::Intersections::Values{ rtc::Intersection{ -1.0, shape }, rtc::Intersection{ 1.0, shape } };
+
+        WHEN("comps <- prepare_computations(xs[1], r, xs) and reflectance <- schlick(comps)")
+        {
+            const auto comps       = rtc::Computations::Prepare(xs[1], r, xs);
+            const auto reflectance = comps.Schlick();
+
+            THEN("reflectance = 0.04")
+            {
+                REQUIRE(rtc::Equal(reflectance, 0.04));
+            }
+        }
+    }
+}
+
+SCENARIO("The Schlick approximation with small angle and n2 > n1", "[refraction]")
+{
+    GIVEN("shape <- glass_sphere() and r <- ray(point(0, 0.99, -2), vector(0, 0, 1)) and xs <- intersections(1.8589:shape)")
+    {
+        const auto shape = GlassSphere();
+        const auto r     = rtc::Ray{ rtc::Point{ 0.0, 0.99, -2.0 }, rtc::Vector{ 0.0, 0.0, 1.0 } };
+        const auto xs    = rtc::Intersections::Values{ rtc::Intersection{ 1.8589, shape } };
+
+        WHEN("comps <- prepare_computations(xs[0], r, xs) and reflectance <- schlick(comps)")
+        {
+            const auto comps       = rtc::Computations::Prepare(xs[0], r, xs);
+            const auto reflectance = comps.Schlick();
+
+            THEN("reflectance = 0.48873")
+            {
+                REQUIRE(rtc::Equal(reflectance, 0.48873));
+            }
+        }
+    }
+}
+
+SCENARIO("shade_hit() with a reflective, transparent material", "[refraction]")
+{
+    GIVEN("w <- default_world() with floor <- plane() translated by (0, -1, 0) with reflective 0.5, transparency 0.5 and refractive index 1.5 and ball <- sphere() colored (1, 0, 0) with ambient 0.5 translated by (0, -3.5, -0.5) and r <- ray(point(0, 0, -3), vector(0, -sqrt(2)/2, sqrt(2)/2)) and xs <- intersections(sqrt(2):floor)")
+    {
+        auto w     = rtc::World::GetDefault();
+        auto floor = rtc::Plane::Create(rtc::Matrix44::Translation(0.0, -1.0, 0.0));
+        ModifyMaterial(floor, [](rtc::Material& m) { m.SetReflective(0.5); m.SetTransparency(0.5); m.SetRefractiveIndex(1.5); });
+        auto ball = rtc::Sphere::Create(rtc::Material{ rtc::Color{ 1.0, 0.0, 0.0 }, 0.5, 0.9, 0.9, 200.0 }, rtc::Matrix44::Translation(0.0, -3.5, -0.5));
+        w.AppendObject(floor);
+        w.AppendObject(ball);
+
+        const auto r  = rtc::Ray{ rtc::Point{ 0.0, 0.0, -3.0 }, rtc::Vector{ 0.0, -kHalfSqrt2, kHalfSqrt2 } };
+        const auto xs = rtc::Intersections::Values{ rtc::Intersection{ static_cast<rtc::Scalar>(std::sqrt(2.0)), floor } };
+
+        WHEN("comps <- prepare_computations(xs[0], r, xs) and color <- shade_hit(w, comps, 5)")
+        {
+            const auto comps  = rtc::Computations::Prepare(xs[0], r, xs);
+            auto       budget = rtc::RayBudget{ 5u, 0.0 };
+            const auto color  = comps.ShadeHit(w, budget);
+
+            // The book's floor casts an opaque shadow on the ball, for color(0.93391, 0.69643, 0.69243).
+            THEN("color = color(1.11500, 0.69643, 0.69243)")
+            {
+                REQUIRE(rtc::Color::Equal(color, rtc::Color{ 1.11500, 0.69643, 0.69243 }));
+            }
+        }
+    }
+}
+
+SCENARIO("Rays with a negligible contribution are not traced", "[reflection]")
+{
+    GIVEN("w <- world() with light at point(0, 0, 0) and planes at y = -1 and y = 1 with reflective 0.5 and r <- ray(point(0, 0, 0), vector(0, 1, 0))")
+    {
+        auto w = rtc::World{};
+        w.AppendLight(rtc::PointLight{ rtc::Point{ 0.0, 0.0, 0.0 }, rtc::Color{ 1.0, 1.0, 1.0 } });
+
+        auto lower = rtc::Plane::Create(rtc::Matrix44::Translation(0.0, -1.0, 0.0));
+        auto upper = rtc::Plane::Create(rtc::Matrix44::Translation(0.0, 1.0, 0.0));
+        ModifyMaterial(lower, [](rtc::Material& m) { m.SetReflective(0.5); });
+        ModifyMaterial(upper, [](rtc::Material& m) { m.SetReflective(0.5); });
+        w.AppendObject(lower);
+        w.AppendObject(upper);
+
+        const auto r = rtc::Ray{ rtc::Point{ 0.0, 0.0, 0.0 }, rtc::Vector{ 0.0, 1.0, 0.0 } };
+
+        WHEN("budget <- ray_budget(10, 0.2) and c <- color_at(w, r, budget)")
+        {
+            auto budget = rtc::RayBudget{ 10u, 0.2 };
+            rtc::Computations::ColorAt(w, r, budget);
+
+            THEN("The reflections with weights 0.5 and 0.25 are traced, and the one with weight 0.125 is not")
+            {
+                REQUIRE(budget.GetRayCount(0u) == 1u);
+                REQUIRE(budget.GetRayCount(1u) == 1u);
+                REQUIRE(budget.GetRayCount(2u) == 1u);
+                REQUIRE(budget.GetRayCount(3u) == 0u);
+                REQUIRE(budget.GetCulledCount() == 1u);
+                REQUIRE(budget.GetDepthLimitedCount() == 0u);
+            }
+        }
+    }
+}
+
+SCENARIO("The contribution cutoff bounds the cost of nested glass", "[refraction]")
+{
+    GIVEN("w <- default_world() with both spheres reflective and transparent glass, and r <- ray(point(0, 0.1, -5), vector(0, 0, 1))")
+    {
+        auto w = rtc::World::GetDefault();
+
+        for (size_t index = 0u; index < w.GetObjectCount(); ++index)
+        {
+            ModifyMaterial(w.GetObject(index), [](rtc::Material& m) { m.SetReflective(0.9); m.SetTransparency(0.9); m.SetRefractiveIndex(1.5); });
+        }
+
+        const auto r = rtc::Ray{ rtc::Point{ 0.0, 0.1, -5.0 }, rtc::Vector{ 0.0, 0.0, 1.0 } };
+
+        WHEN("exact <- color_at(w, r, ray_budget(8, 0)) and culled <- color_at(w, r, ray_budget(8, 0.01))")
+        {
+            auto       exact_budget  = rtc::RayBudget{ 8u, 0.0 };
+            auto       culled_budget = rtc::RayBudget{ 8u, 0.01 };
+            const auto exact         = rtc::Computations::ColorAt(w, r, exact_budget);
+            const auto culled        = rtc::Computations::ColorAt(w, r, culled_budget);
+
+            THEN("The cutoff traces fewer rays and changes the color by little")
+            {
+                REQUIRE(culled_budget.GetCulledCount() > 0u);
+                REQUIRE(culled_budget.GetTotalRayCount() < exact_budget.GetTotalRayCount());
+                REQUIRE(std::abs(culled.GetR() - exact.GetR()) < 0.05);
+                REQUIRE(std::abs(culled.GetG() - exact.GetG()) < 0.05);
+                REQUIRE(std::abs(culled.GetB() - exact.GetB()) < 0.05);
+            }
+        }
+    }
+}
@@ -86,8 +86,8 @@ SCENARIO(" A 3x3 matrix ought to be representable", "[matrix]")
     {
         WHEN("M is { { -3, 5, 0 }, { 1, -2, -7 }, { 0, 1, 1 } }")
         {
-            const double data[3][3] = { { -3.0, 5.0, 0.0 }, { 1.0, -2.0, -7.0 }, { 0.0, 1.0, 1.0 } };
-            const auto   M          = rtc::Matrix<3, 3>{ data };
+            const rtc::Scalar data[3][3] = { { -3.0, 5.0, 0.0 }, { 1.0, -2.0, -7.0 }, { 0.0, 1.0, 1.0 } };
+            const auto        M          = rtc::Matrix<3, 3>{ data };
 
             THEN("Then M[0,0] = -3 and M[1, 1] = -2 and M[2, 2] = 1")
             {
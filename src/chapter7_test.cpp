@@ -386,7 +386,7 @@ SCENARIO("Constructing a camera", "[world]")
     {
         const auto hsize         = 160u;
         const auto vsize         = 120u;
-        const auto field_of_view = rtc::kPi / 2.0;
+        const auto field_of_view = rtc::Scalar{ rtc::kPi / 2.0 };
 
         WHEN("c <- camera(hsize, vsize, field_of_view)")
         {
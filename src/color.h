@@ -30,29 +30,32 @@
 
 namespace rtc
 {
-    class Color : public Tuple
+    template <typename T>
+    class BasicColor : public BasicTuple<T>
     {
     public:
-        Color() : Tuple(0.0, 0.0, 0.0, 0.0) {}
+        constexpr BasicColor() : BasicTuple<T>(T{ 0 }, T{ 0 }, T{ 0 }, T{ 0 }) {}
 
-        Color(const Tuple& tuple) : Tuple(tuple) { assert(rtc::Equal(GetW(), 0.0)); }
+        constexpr BasicColor(const BasicTuple<T>& tuple) : BasicTuple<T>(tuple) { assert(rtc::Equal(this->GetW(), T{ 0 })); }
 
-        Color(Tuple&& tuple) : Tuple(std::move(tuple)) { assert(rtc::Equal(GetW(), 0.0)); }
+        constexpr BasicColor(BasicTuple<T>&& tuple) : BasicTuple<T>(std::move(tuple)) { assert(rtc::Equal(this->GetW(), T{ 0 })); }
 
-        Color(double r, double g, double b) : Tuple(r, g, b, 0.0) {}
+        constexpr BasicColor(T r, T g, T b) : BasicTuple<T>(r, g, b, T{ 0 }) {}
 
-        double GetR() const { return GetX(); }
+        constexpr T GetR() const { return this->GetX(); }
 
-        double GetG() const { return GetY(); }
+        constexpr T GetG() const { return this->GetY(); }
 
-        double GetB() const { return GetZ(); }
+        constexpr T GetB() const { return this->GetZ(); }
 
-        static Color HadamardProduct(const Color& lhs, const Color& rhs)
+        static constexpr BasicColor HadamardProduct(const BasicColor& lhs, const BasicColor& rhs)
         {
-            return Color(
+            return BasicColor(
                 lhs.GetR() * rhs.GetR(),
                 lhs.GetG() * rhs.GetG(),
                 lhs.GetB() * rhs.GetB());
         }
     };
+
+    using Color = BasicColor<Scalar>;
 }
@@ -25,46 +25,61 @@
 #include "color.h"
 #include "double_util.h"
 #include "intersection.h"
+#include "light_tree.h"
 #include "phong.h"
 #include "point.h"
+#include "ray_budget.h"
+#include "shadow_cache.h"
 #include "shape.h"
 #include "ray.h"
 #include "vector.h"
 #include "world.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cinttypes>
+#include <cmath>
 #include <memory>
+#include <vector>
 
 namespace rtc
 {
     class Computations
     {
     public:
-        Computations(double t, const std::shared_ptr<const Shape> object, const Point& point, const Point& over_point, const Vector& eye, const Vector& normal, bool inside) :
+        Computations(Scalar t, const std::shared_ptr<const Shape> object, const Point& point, const Point& over_point, const Point& under_point, const Vector& eye, const Vector& normal, const Vector& reflect, bool inside, Scalar n1, Scalar n2) :
             t_(t),
             object_(object),
             point_(point),
             over_point_(over_point),
+            under_point_(under_point),
             eye_(eye),
             normal_(normal),
-            inside_(inside)
+            reflect_(reflect),
+            inside_(inside),
+            n1_(n1),
+            n2_(n2)
         {
             assert(object_ && "rtc::Computations was initialized with an invalid object");
         }
 
-        Computations(double t, std::shared_ptr<const Shape>&& object, Point&& point, Point&& over_point, Vector&& eye, Vector&& normal, bool inside) :
+        Computations(Scalar t, std::shared_ptr<const Shape>&& object, Point&& point, Point&& over_point, Point&& under_point, Vector&& eye, Vector&& normal, Vector&& reflect, bool inside, Scalar n1, Scalar n2) :
             t_(t),
             object_(std::move(object)),
             point_(std::move(point)),
             over_point_(std::move(over_point)),
+            under_point_(std::move(under_point)),
             eye_(std::move(eye)),
             normal_(std::move(normal)),
-            inside_(inside)
+            reflect_(std::move(reflect)),
+            inside_(inside),
+            n1_(n1),
+            n2_(n2)
         {
             assert(object_ && "rtc::Computations was initialized with an invalid object");
         }
 
-        double GetT() const { return t_; }
+        Scalar GetT() const { return t_; }
 
         const std::shared_ptr<const Shape>& GetObject() const { return object_; }
 
@@ -74,11 +89,44 @@ namespace rtc
 
         const Vector& GetNormal() const { return normal_; }
 
+        const Vector& GetReflect() const { return reflect_; }
+
         bool IsInside() const { return inside_; }
 
         const Point& GetOverPoint() const { return over_point_; }
 
+        const Point& GetUnderPoint() const { return under_point_; }
+
+        // Refractive index of the material the ray is leaving.
+        Scalar GetN1() const { return n1_; }
+
+        // Refractive index of the material the ray is entering.
+        Scalar GetN2() const { return n2_; }
+
+        // Shade the hit, including reflection and refraction up to the default maximum depth, without
+        // skipping rays for their contribution.
         Color ShadeHit(const World& world) const
+        {
+            return ShadeHit(world, nullptr);
+        }
+
+        // Shade the hit, testing shadow rays against the last occluders recorded in the optional shadow cache first.
+        Color ShadeHit(const World& world, ShadowCache* shadow_cache) const
+        {
+            auto budget = RayBudget{ RayBudget::kDefaultMaxDepth, Scalar{ 0 } };
+            return ShadeHit(world, shadow_cache, budget, 0u, Scalar{ 1 });
+        }
+
+        // Shade the hit of a primary ray, with reflected and refracted rays limited by the budget.
+        Color ShadeHit(const World& world, RayBudget& budget) const
+        {
+            return ShadeHit(world, nullptr, budget, 0u, Scalar{ 1 });
+        }
+
+        // Shade the hit of a ray at the specified depth, whose weight is its share of the pixel: the
+        // surface's lighting plus its reflected and refracted light. When the surface both reflects and
+        // refracts, the Schlick approximation of the Fresnel equations divides the light between the two.
+        Color ShadeHit(const World& world, ShadowCache* shadow_cache, RayBudget& budget, uint32_t depth, Scalar weight) const
         {
             assert(object_ && "rtc::Computations was initialized with an invalid object");
 
@@ -86,19 +134,129 @@ namespace rtc
 
             if (object_ != nullptr)
             {
-                const auto& lights = world.GetLights();
+                color = ShadeSurface(world, shadow_cache);
+
+                const auto& material = object_->GetMaterial();
 
-                for (const auto& light : lights)
+                if ((material.GetReflective() > 0) && (material.GetTransparency() > 0))
                 {
-                    color.Add(Phong::Lighting(object_->GetMaterial(), object_->GetInverseTransform(), light, over_point_, eye_, normal_, IsShadowed(world, light, over_point_)));
+                    const auto reflectance = Schlick();
+                    const auto reflected   = ReflectedColor(world, shadow_cache, budget, depth, weight * reflectance);
+                    const auto refracted   = RefractedColor(world, shadow_cache, budget, depth, weight * (Scalar{ 1 } - reflectance));
+
+                    color.Add(Color::Multiply(reflected, reflectance));
+                    color.Add(Color::Multiply(refracted, Scalar{ 1 } - reflectance));
+                }
+                else
+                {
+                    color.Add(ReflectedColor(world, shadow_cache, budget, depth, weight));
+                    color.Add(RefractedColor(world, shadow_cache, budget, depth, weight));
                 }
             }
 
             return color;
         }
 
-        // Instantiate a data strucutre for storing some precomputed values.
+        Color ReflectedColor(const World& world, RayBudget& budget) const
+        {
+            return ReflectedColor(world, nullptr, budget, 0u, Scalar{ 1 });
+        }
+
+        // Color seen along the reflection of the eye vector, scaled by the material's reflectivity.
+        Color ReflectedColor(const World& world, ShadowCache* shadow_cache, RayBudget& budget, uint32_t depth, Scalar weight) const
+        {
+            const auto reflective = object_->GetMaterial().GetReflective();
+
+            if (!(reflective > 0))
+            {
+                return Color{};
+            }
+
+            const auto reflected_weight = weight * reflective;
+
+            if (!budget.Admit(depth + 1u, reflected_weight))
+            {
+                return Color{};
+            }
+
+            const auto color = ColorAt(world, Ray{ over_point_, reflect_ }, shadow_cache, budget, depth + 1u, reflected_weight);
+            return Color::Multiply(color, reflective);
+        }
+
+        Color RefractedColor(const World& world, RayBudget& budget) const
+        {
+            return RefractedColor(world, nullptr, budget, 0u, Scalar{ 1 });
+        }
+
+        // Color seen through the surface along the refracted eye vector, scaled by the material's
+        // transparency. Black under total internal reflection, which the reflected ray accounts for.
+        Color RefractedColor(const World& world, ShadowCache* shadow_cache, RayBudget& budget, uint32_t depth, Scalar weight) const
+        {
+            const auto transparency = object_->GetMaterial().GetTransparency();
+
+            if (!(transparency > 0))
+            {
+                return Color{};
+            }
+
+            // Snell's law gives the sine of the refracted angle from the ratio of the refractive indices.
+            const auto n_ratio = n1_ / n2_;
+            const auto cos_i   = Vector::Dot(eye_, normal_);
+            const auto sin2_t  = Square(n_ratio) * (Scalar{ 1 } - Square(cos_i));
+
+            if (sin2_t > 1)
+            {
+                return Color{};
+            }
+
+            const auto refracted_weight = weight * transparency;
+
+            if (!budget.Admit(depth + 1u, refracted_weight))
+            {
+                return Color{};
+            }
+
+            const auto cos_t     = std::sqrt(Scalar{ 1 } - sin2_t);
+            const auto direction = Vector{ Vector::Subtract(Vector::Multiply(normal_, (n_ratio * cos_i) - cos_t), Vector::Multiply(eye_, n_ratio)) };
+
+            const auto color = ColorAt(world, Ray{ under_point_, direction }, shadow_cache, budget, depth + 1u, refracted_weight);
+            return Color::Multiply(color, transparency);
+        }
+
+        // Fraction of the light reflected at the hit, from Schlick's approximation of the Fresnel equations.
+        Scalar Schlick() const
+        {
+            auto cos = Vector::Dot(eye_, normal_);
+
+            // Total internal reflection can only occur when leaving a denser material.
+            if (n1_ > n2_)
+            {
+                const auto sin2_t = Square(n1_ / n2_) * (Scalar{ 1 } - Square(cos));
+                if (sin2_t > 1)
+                {
+                    return Scalar{ 1 };
+                }
+
+                // Use the cosine of the refracted angle instead.
+                cos = std::sqrt(Scalar{ 1 } - sin2_t);
+            }
+
+            const auto r0 = Square((n1_ - n2_) / (n1_ + n2_));
+            const auto x  = Scalar{ 1 } - cos;
+
+            return r0 + ((Scalar{ 1 } - r0) * x * x * x * x * x);
+        }
+
+        // Instantiate a data strucutre for storing some precomputed values, for a hit that is the only
+        // intersection along the ray.
         static Computations Prepare(const Intersection& intersection, const Ray& ray)
+        {
+            return Prepare(intersection, ray, Intersections::Values{ intersection });
+        }
+
+        // Instantiate a data strucutre for storing some precomputed values, with the refractive indices on
+        // either side of the hit found from the sorted intersections along the ray.
+        static Computations Prepare(const Intersection& intersection, const Ray& ray, const Intersections::Values& intersections)
         {
             assert(intersection.GetObject() && "rtc::Computations::Prepare was called with an invalid rtc::Intersect::Intersection object");
 
@@ -107,59 +265,231 @@ namespace rtc
             auto position     = ray.GetPosition(t);
             auto eye          = Vector::Negate(ray.GetDirection());
             auto normal       = object->NormalAt(position);
+            auto inside       = false;
 
             if (Vector::Dot(normal, eye) < 0)
             {
                 normal.Negate();
-                auto over_point = rtc::Point{ rtc::Point::Add(position, rtc::Vector::Multiply(normal, rtc::kEpsilon)) };
-                return Computations{ t, object, std::move(position), std::move(over_point), std::move(eye), std::move(normal), true };
-            }
-            else
-            {
-                auto over_point = rtc::Point{ rtc::Point::Add(position, rtc::Vector::Multiply(normal, rtc::kEpsilon)) };
-                return Computations{ t, object, std::move(position), std::move(over_point), std::move(eye), std::move(normal), false };
+                inside = true;
             }
+
+            auto n1 = Scalar{ 1 };
+            auto n2 = Scalar{ 1 };
+            RefractiveIndices(intersection, intersections, n1, n2);
+
+            return Prepare(t, object, position, eye, normal, inside, n1, n2);
+        }
+
+        // Instantiate a data structure for storing some precomputed values, from the values found for a hit by
+        // the other forms of Prepare(), with the normal facing the eye.
+        static Computations Prepare(Scalar t, const std::shared_ptr<const Shape>& object, const Point& point, const Vector& eye, const Vector& normal, bool inside, Scalar n1, Scalar n2)
+        {
+            auto reflect     = Vector::Reflect(Vector::Negate(eye), normal);
+            auto over_point  = rtc::Point{ rtc::Point::Add(point, rtc::Vector::Multiply(normal, rtc::kEpsilon)) };
+            auto under_point = rtc::Point{ rtc::Point::Subtract(point, rtc::Vector::Multiply(normal, rtc::kEpsilon)) };
+
+            return Computations{ t, object, point, std::move(over_point), std::move(under_point), eye, normal, std::move(reflect), inside, n1, n2 };
         }
 
+        // Color seen along a primary ray, including reflection and refraction up to the default maximum
+        // depth, without skipping rays for their contribution.
         static Color ColorAt(const World& world, const Ray& ray)
         {
+            return ColorAt(world, ray, nullptr);
+        }
+
+        static Color ColorAt(const World& world, const Ray& ray, ShadowCache* shadow_cache)
+        {
+            auto budget = RayBudget{ RayBudget::kDefaultMaxDepth, Scalar{ 0 } };
+            return ColorAt(world, ray, shadow_cache, budget, 0u, Scalar{ 1 });
+        }
+
+        static Color ColorAt(const World& world, const Ray& ray, RayBudget& budget)
+        {
+            return ColorAt(world, ray, nullptr, budget, 0u, Scalar{ 1 });
+        }
+
+        // Color seen along a ray at the specified depth and weight, counting the ray in the budget.
+        static Color ColorAt(const World& world, const Ray& ray, ShadowCache* shadow_cache, RayBudget& budget, uint32_t depth, Scalar weight)
+        {
+            budget.CountRay(depth);
+
             const auto intersect    = world.Intersect(ray);
             const auto intersection = intersect.Hit();
 
             if (intersection != nullptr)
             {
-                const auto comps = Computations::Prepare(*intersection, ray);
-                return comps.ShadeHit(world);
+                const auto comps = Computations::Prepare(*intersection, ray, intersect.GetValues());
+                return comps.ShadeHit(world, shadow_cache, budget, depth, weight);
             }
 
             return Color{};
         };
 
+        // A point is in shadow when no light reaches it, after attenuation by transparent occluders.
         static bool IsShadowed(const World& world, const PointLight& light, const Point& point)
         {
-            auto       v        = rtc::Vector{ rtc::Vector::Subtract(light.GetPosition(), point) };
-            const auto distance = v.Magnitude();
-            v.Normalize(); // Direction
+            return ShadowTransmittance(world, light, point) <= 0;
+        }
+
+        static bool IsShadowed(const World& world, size_t light_index, const Point& point, ShadowCache& shadow_cache)
+        {
+            return ShadowTransmittance(world, light_index, point, shadow_cache) <= 0;
+        }
+
+        // Fraction of the light's intensity that reaches the point, from 0 when an opaque object blocks the
+        // light to 1 when nothing that casts shadows is in the way.
+        static Scalar ShadowTransmittance(const World& world, const PointLight& light, const Point& point)
+        {
+            auto       distance = Scalar{ 0 };
+            const auto r        = ShadowRay(light, point, distance);
+
+            return world.Transmittance(r, distance, nullptr);
+        }
+
+        // Shadow transmittance for the light at light_index that first tests the last opaque occluder recorded
+        // for that light in the cache, and only traverses the world when it does not block the shadow ray.
+        static Scalar ShadowTransmittance(const World& world, size_t light_index, const Point& point, ShadowCache& shadow_cache)
+        {
+            auto       distance = Scalar{ 0 };
+            const auto r        = ShadowRay(world.GetLight(light_index), point, distance);
+
+            if (shadow_cache.TestOccluder(light_index, r, distance))
+            {
+                return Scalar{ 0 };
+            }
+
+            auto       occluder      = std::shared_ptr<const Shape>{};
+            const auto transmittance = world.Transmittance(r, distance, &occluder);
+
+            if (occluder != nullptr)
+            {
+                shadow_cache.SetOccluder(light_index, occluder);
+            }
+
+            return transmittance;
+        }
+
+    private:
+        // Lighting of the surface at the hit, without reflection or refraction.
+        Color ShadeSurface(const World& world, ShadowCache* shadow_cache) const
+        {
+            const auto& light_tree = world.GetLightTree();
+            if (light_tree != nullptr)
+            {
+                return ShadeSurface(world, *light_tree, shadow_cache);
+            }
+
+            const auto& material      = object_->GetMaterial();
+            const auto  surface_color = object_->ColorAt(over_point_);
+            const auto& lights        = world.GetLights();
 
-            const auto r             = rtc::Ray{ point, v };
-            const auto intersections = world.Intersect(r);
+            // Shade with the cache's storage for visibility, or allocate it when shading without a cache.
+            auto  uncached_visibility = std::vector<Scalar>{};
+            auto& visibility          = (shadow_cache != nullptr) ? shadow_cache->GetVisibility() : uncached_visibility;
+            visibility.resize(lights.size());
 
-            const auto h = intersections.Hit();
-            if ((h != nullptr) && (h->GetT() < distance))
+            for (size_t i = 0u; i < lights.size(); ++i)
             {
-                return true;
+                visibility[i] = (shadow_cache != nullptr) ? ShadowTransmittance(world, i, over_point_, *shadow_cache) : ShadowTransmittance(world, lights[i], over_point_);
             }
 
-            return false;
+            return Phong::Lighting(material, surface_color, world.GetLightBatch(), visibility, over_point_, eye_, normal_);
+        }
+
+        // Shade the hit with the lights selected by the light tree. Every light contributes ambient light,
+        // so the ambient term is computed once from the total intensity, and only the selected lights
+        // are tested for shadows and contribute diffuse and specular light.
+        Color ShadeSurface(const World& world, const LightTree& light_tree, ShadowCache* shadow_cache) const
+        {
+            const auto& material      = object_->GetMaterial();
+            const auto  surface_color = object_->ColorAt(over_point_);
+
+            auto color = Color{ Phong::Ambient(material, surface_color, light_tree.GetTotalIntensity()) };
+
+            // Select lights into the cache's storage, or allocate it when shading without a cache.
+            auto  uncached_samples = LightTree::Samples{};
+            auto& samples          = (shadow_cache != nullptr) ? shadow_cache->GetSamples() : uncached_samples;
+
+            light_tree.Select(over_point_, normal_, LightTree::Seed(over_point_), samples);
+
+            for (const auto& sample : samples)
+            {
+                const auto  index     = sample.GetLightIndex();
+                const auto& light     = world.GetLight(index);
+                const auto  visibility = (shadow_cache != nullptr) ? ShadowTransmittance(world, index, over_point_, *shadow_cache) : ShadowTransmittance(world, light, over_point_);
+
+                if (visibility > 0)
+                {
+                    color.Add(Color::Multiply(Phong::DiffuseSpecular(material, surface_color, light, over_point_, eye_, normal_), sample.GetWeight() * visibility));
+                }
+            }
+
+            return color;
+        }
+
+        // Construct a ray from point toward the light, returning the distance to the light.
+        static Ray ShadowRay(const PointLight& light, const Point& point, Scalar& distance)
+        {
+            auto v   = rtc::Vector{ rtc::Vector::Subtract(light.GetPosition(), point) };
+            distance = v.Magnitude();
+            v.Normalize(); // Direction
+
+            return rtc::Ray{ point, v };
+        }
+
+        // Find the refractive indices of the materials on either side of the hit, by tracking the
+        // transparent objects that contain each intersection along the ray. Objects are entered and
+        // exited in order, so the innermost container is the one most recently entered.
+        static void RefractiveIndices(const Intersection& hit, const Intersections::Values& intersections, Scalar& n1, Scalar& n2)
+        {
+            std::vector<const Shape*> containers;
+
+            for (const auto& intersection : intersections)
+            {
+                const auto object = intersection.GetObject().get();
+                const auto found  = std::find(containers.begin(), containers.end(), object);
+
+                if ((intersection.GetT() == hit.GetT()) && (object == hit.GetObject().get()))
+                {
+                    n1 = containers.empty() ? Scalar{ 1 } : containers.back()->GetMaterial().GetRefractiveIndex();
+
+                    // The ray exits the object when it is already inside it, and enters it otherwise.
+                    if (found != containers.end())
+                    {
+                        containers.erase(found);
+                        n2 = containers.empty() ? Scalar{ 1 } : containers.back()->GetMaterial().GetRefractiveIndex();
+                    }
+                    else
+                    {
+                        n2 = object->GetMaterial().GetRefractiveIndex();
+                    }
+
+                    return;
+                }
+
+                if (found != containers.end())
+                {
+                    containers.erase(found);
+                }
+                else
+                {
+                    containers.push_back(object);
+                }
+            }
         }
 
     private:
-        const double                       t_;          ///< Value representing intersection 'time'.
-        const std::shared_ptr<const Shape> object_;     ///< Pointer to intersected object.
-        const Point                        point_;      ///< Position of intersection between ray and object.
-        const Point                        over_point_; ///< Same as point_ with the z component set to a value slightly less than zero.
-        const Vector                       eye_;        ///< Eye vector computed from ray.
-        const Vector                       normal_;     ///< Normal vector at ray intersection point with object.
-        const bool                         inside_;     ///< Indicates that the intersection is inside the object.
+        const Scalar                       t_;           ///< Value representing intersection 'time'.
+        const std::shared_ptr<const Shape> object_;      ///< Pointer to intersected object.
+        const Point                        point_;       ///< Position of intersection between ray and object.
+        const Point                        over_point_;  ///< Same as point_ with the z component set to a value slightly less than zero.
+        const Point                        under_point_; ///< Same as point_, offset slightly below the surface for refracted rays.
+        const Vector                       eye_;         ///< Eye vector computed from ray.
+        const Vector                       normal_;      ///< Normal vector at ray intersection point with object.
+        const Vector                       reflect_;     ///< Direction of the ray reflected about the normal.
+        const bool                         inside_;      ///< Indicates that the intersection is inside the object.
+        const Scalar                       n1_;          ///< Refractive index of the material the ray is leaving.
+        const Scalar                       n2_;          ///< Refractive index of the material the ray is entering.
     };
 }
@@ -0,0 +1,154 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "catch2/catch.hpp"
+
+#include "affine34.h"
+#include "double_util.h"
+#include "matrix.h"
+#include "matrix22.h"
+#include "matrix33.h"
+#include "matrix44.h"
+#include "point.h"
+#include "tuple.h"
+#include "vector.h"
+
+SCENARIO("Identity matrices are compile-time constants", "[constexpr]")
+{
+    GIVEN("constexpr identity matrices of each size")
+    {
+        constexpr auto identity44 = rtc::Matrix44::Identity();
+        constexpr auto identity33 = rtc::Matrix33::Identity();
+        constexpr auto generic    = rtc::Matrix<4, 4>::Identity();
+
+        THEN("They are evaluated at compile time")
+        {
+            STATIC_REQUIRE(identity44.Get(0u, 0u) == 1.0);
+            STATIC_REQUIRE(identity44.Get(3u, 2u) == 0.0);
+            STATIC_REQUIRE(identity33.Get(2u, 2u) == 1.0);
+            STATIC_REQUIRE(rtc::Matrix44::Equal(identity44, generic));
+        }
+    }
+}
+
+SCENARIO("Translating a point at compile time", "[constexpr]")
+{
+    GIVEN("constexpr transform <- translation(5, -3, 2) and p <- point(-3, 4, 5)")
+    {
+        constexpr auto transform = rtc::Matrix44::Translation(5.0, -3.0, 2.0);
+        constexpr auto p         = rtc::Point{ -3.0, 4.0, 5.0 };
+
+        THEN("transform * p = point(2, 1, 7) is a constant expression")
+        {
+            STATIC_REQUIRE(rtc::Tuple::Equal(rtc::Matrix44::Multiply(transform, p), rtc::Point{ 2.0, 1.0, 7.0 }));
+        }
+    }
+}
+
+SCENARIO("Rotating a point at compile time", "[constexpr]")
+{
+    GIVEN("constexpr half_quarter <- rotation_x(pi / 4) and p <- point(0, 1, 0)")
+    {
+        constexpr auto half_quarter = rtc::Matrix44::RotationX(rtc::Scalar{ rtc::kPi / 4.0 });
+        constexpr auto p            = rtc::Point{ 0.0, 1.0, 0.0 };
+
+        THEN("half_quarter * p = point(0, sqrt(2)/2, sqrt(2)/2) is a constant expression")
+        {
+            constexpr auto root_half = rtc::Sqrt(rtc::Scalar{ 2.0 }) / rtc::Scalar{ 2.0 };
+
+            STATIC_REQUIRE(rtc::Tuple::Equal(rtc::Matrix44::Multiply(half_quarter, p), rtc::Point{ 0.0, root_half, root_half }));
+        }
+
+        THEN("The compile-time rotation matches the runtime rotation")
+        {
+            const auto angle = rtc::Scalar{ rtc::kPi / 4.0 };
+
+            REQUIRE(rtc::Matrix44::Equal(half_quarter, rtc::Matrix44::RotationX(angle)));
+        }
+    }
+}
+
+SCENARIO("Chaining transformations at compile time", "[constexpr]")
+{
+    GIVEN("constexpr t <- translation(10, 5, 7) * scaling(5, 5, 5) * rotation_x(pi / 2)")
+    {
+        constexpr auto t = rtc::Matrix44::Multiply(
+            rtc::Matrix44::Translation(10.0, 5.0, 7.0),
+            rtc::Matrix44::Scaling(5.0, 5.0, 5.0),
+            rtc::Matrix44::RotationX(rtc::Scalar{ rtc::kPi / 2.0 }));
+
+        THEN("t * point(1, 0, 1) = point(15, 0, 7) is a constant expression")
+        {
+            STATIC_REQUIRE(rtc::Tuple::Equal(rtc::Matrix44::Multiply(t, rtc::Point{ 1.0, 0.0, 1.0 }), rtc::Point{ 15.0, 0.0, 7.0 }));
+        }
+    }
+}
+
+SCENARIO("Calculating a determinant and an inverse at compile time", "[constexpr]")
+{
+    GIVEN("constexpr A <- a 4x4 matrix")
+    {
+        constexpr auto A = rtc::Matrix44{ {{
+            {{ -5.0,  2.0,  6.0, -8.0 }},
+            {{  1.0, -5.0,  1.0,  8.0 }},
+            {{  7.0,  7.0, -6.0, -7.0 }},
+            {{  1.0, -3.0,  7.0,  4.0 }}
+            }} };
+
+        THEN("determinant(A) = 532 and inverse(A) * A = identity are constant expressions")
+        {
+            constexpr auto B = rtc::Matrix44::Inverse(A);
+
+            STATIC_REQUIRE(rtc::Equal(A.Determinant(), rtc::Scalar{ 532.0 }));
+            STATIC_REQUIRE(rtc::Equal(B.Get(3u, 2u), rtc::Scalar{ -160.0 / 532.0 }));
+            STATIC_REQUIRE(rtc::Matrix44::Equal(rtc::Matrix44::Multiply(B, A), rtc::Matrix44::Identity()));
+        }
+    }
+}
+
+SCENARIO("Constructing a view transform at compile time", "[constexpr]")
+{
+    GIVEN("constexpr from <- point(0, 0, 8) and to <- point(0, 0, 0) and up <- vector(0, 1, 0)")
+    {
+        constexpr auto from = rtc::Point{ 0.0, 0.0, 8.0 };
+        constexpr auto to   = rtc::Point{ 0.0, 0.0, 0.0 };
+        constexpr auto up   = rtc::Vector{ 0.0, 1.0, 0.0 };
+
+        THEN("view_transform(from, to, up) = translation(0, 0, -8) is a constant expression")
+        {
+            STATIC_REQUIRE(rtc::Matrix44::Equal(rtc::Matrix44::ViewTransform(from, to, up), rtc::Matrix44::Translation(0.0, 0.0, -8.0)));
+        }
+    }
+}
+
+SCENARIO("Inverting an affine transform at compile time", "[constexpr]")
+{
+    GIVEN("constexpr a <- affine34(translation(1, 2, 3) * scaling(2, 4, 8))")
+    {
+        constexpr auto a = rtc::Affine34{ rtc::Matrix44::Multiply(rtc::Matrix44::Translation(1.0, 2.0, 3.0), rtc::Matrix44::Scaling(2.0, 4.0, 8.0)) };
+
+        THEN("inverse(a) * point(3, 6, 11) = point(1, 1, 1) is a constant expression")
+        {
+            STATIC_REQUIRE(rtc::Tuple::Equal(rtc::Affine34::TransformPoint(rtc::Affine34::Inverse(a), rtc::Point{ 3.0, 6.0, 11.0 }), rtc::Point{ 1.0, 1.0, 1.0 }));
+        }
+    }
+}
@@ -0,0 +1,837 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "deflate.h"
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <queue>
+#include <utility>
+
+namespace rtc
+{
+    namespace Deflate
+    {
+        namespace
+        {
+            constexpr uint32_t kMinMatch           = 3u;
+            constexpr uint32_t kMaxMatch           = 258u;
+            constexpr uint32_t kFarMatch           = 4096u; ///< A minimum length match farther than this costs more than its literals.
+            constexpr uint32_t kHashBits           = 15u;
+            constexpr uint32_t kHashSize           = 1u << kHashBits;
+            constexpr uint32_t kMaxCodeLength      = 15u;
+            constexpr uint32_t kMaxCodeLengthBits  = 7u;
+            constexpr uint32_t kLiteralLengthCodes = 286u;
+            constexpr uint32_t kFixedLiteralCodes  = 288u;
+            constexpr uint32_t kDistanceCodes      = 30u;
+            constexpr uint32_t kCodeLengthCodes    = 19u;
+            constexpr uint32_t kEndOfBlock         = 256u;
+            constexpr size_t   kMaxBlockTokens     = 16384u;
+            constexpr size_t   kMaxStoredSize      = 65535u;
+            constexpr uint32_t kAdlerBase          = 65521u;
+            constexpr size_t   kAdlerMaxRun        = 5552u; ///< Most bytes summed before the Adler-32 sums can overflow.
+
+            // Match search effort for each compression level, following the zlib configuration table.
+            struct LevelParameters
+            {
+                uint32_t max_chain;   ///< Most hash chain entries searched for a match.
+                uint32_t nice_length; ///< Stop searching after finding a match this long.
+                uint32_t lazy_length; ///< Look for a longer match at the next position when shorter than this; 0 for greedy matching.
+            };
+
+            constexpr LevelParameters kLevels[kMaxLevel + 1u] = {
+                { 0u, 0u, 0u },          { 4u, 8u, 0u },        { 8u, 16u, 0u },       { 32u, 32u, 0u },
+                { 16u, 16u, 4u },        { 32u, 32u, 16u },     { 128u, 128u, 16u },   { 256u, 128u, 32u },
+                { 1024u, 258u, 128u },   { 4096u, 258u, 258u }
+            };
+
+            constexpr uint16_t kLengthBase[29]   = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+            constexpr uint8_t  kLengthExtra[29]  = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+            constexpr uint16_t kDistanceBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+            constexpr uint8_t  kDistanceExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+            // Order in which the code length code lengths are stored in a dynamic block header.
+            constexpr uint8_t kCodeLengthOrder[kCodeLengthCodes] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+            // A literal byte, when distance is 0, or a match of length bytes at distance bytes back.
+            struct Token
+            {
+                uint16_t value;    ///< Literal byte or match length.
+                uint16_t distance; ///< Match distance, or 0 for a literal.
+            };
+
+            // Symbol lookups for match lengths and distances.
+            struct CodeTables
+            {
+                CodeTables()
+                {
+                    for (uint32_t code = 0u; code < 29u; ++code)
+                    {
+                        const auto end = (code == 28u) ? (kMaxMatch + 1u) : kLengthBase[code + 1u];
+                        for (uint32_t length = kLengthBase[code]; length < end; ++length)
+                        {
+                            length_code[length] = static_cast<uint8_t>(code);
+                        }
+                    }
+
+                    for (uint32_t code = 0u; code < kDistanceCodes; ++code)
+                    {
+                        const auto end = (code == (kDistanceCodes - 1u)) ? (kWindowSize + 1u) : kDistanceBase[code + 1u];
+                        for (uint32_t distance = kDistanceBase[code]; distance < end; ++distance)
+                        {
+                            distance_code[distance - 1u] = static_cast<uint8_t>(code);
+                        }
+                    }
+                }
+
+                std::array<uint8_t, kMaxMatch + 1u> length_code{};   ///< Length code, less 257, by match length.
+                std::array<uint8_t, kWindowSize>    distance_code{}; ///< Distance code, by match distance less 1.
+            };
+
+            const CodeTables& GetCodeTables()
+            {
+                static const auto tables = CodeTables{};
+                return tables;
+            }
+
+            // Writes bit fields, least significant bit first, to a byte vector.
+            class BitWriter
+            {
+            public:
+                explicit BitWriter(std::vector<uint8_t>& output) : output_(output) {}
+
+                void Write(uint32_t bits, uint32_t count)
+                {
+                    buffer_ |= static_cast<uint64_t>(bits) << count_;
+                    count_ += count;
+
+                    while (count_ >= 8u)
+                    {
+                        output_.push_back(static_cast<uint8_t>(buffer_));
+                        buffer_ >>= 8u;
+                        count_ -= 8u;
+                    }
+                }
+
+                void AlignToByte()
+                {
+                    if (count_ > 0u)
+                    {
+                        output_.push_back(static_cast<uint8_t>(buffer_));
+                        buffer_ = 0u;
+                        count_  = 0u;
+                    }
+                }
+
+                // Append bytes, after aligning to a byte.
+                void WriteBytes(const uint8_t* data, size_t size) { output_.insert(output_.end(), data, data + size); }
+
+            private:
+                std::vector<uint8_t>& output_;
+                uint64_t              buffer_{ 0u };
+                uint32_t              count_{ 0u };
+            };
+
+            // Huffman code lengths for the symbol frequencies, limited to max_length bits. Every code has at least
+            // two symbols, so that it is complete.
+            std::vector<uint8_t> BuildLengths(std::vector<uint32_t> frequencies, uint32_t max_length)
+            {
+                const auto symbol_count = frequencies.size();
+
+                auto used = static_cast<size_t>(std::count_if(frequencies.begin(), frequencies.end(), [](uint32_t frequency) { return frequency > 0u; }));
+                for (size_t symbol = 0u; (used < 2u) && (symbol < symbol_count); ++symbol)
+                {
+                    if (frequencies[symbol] == 0u)
+                    {
+                        frequencies[symbol] = 1u;
+                        ++used;
+                    }
+                }
+
+                auto lengths = std::vector<uint8_t>(symbol_count, 0u);
+
+                for (;;)
+                {
+                    // Nodes are leaves for each symbol, followed by the internal nodes in the order they are created,
+                    // so that every child precedes its parent.
+                    using Entry  = std::pair<uint64_t, size_t>;
+                    auto queue   = std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>>{};
+                    auto parents = std::vector<size_t>(symbol_count, 0u);
+
+                    for (size_t symbol = 0u; symbol < symbol_count; ++symbol)
+                    {
+                        if (frequencies[symbol] > 0u)
+                        {
+                            queue.emplace(frequencies[symbol], symbol);
+                        }
+                    }
+
+                    while (queue.size() > 1u)
+                    {
+                        const auto first = queue.top();
+                        queue.pop();
+                        const auto second = queue.top();
+                        queue.pop();
+
+                        const auto node = parents.size();
+                        parents.push_back(0u);
+                        parents[first.second]  = node;
+                        parents[second.second] = node;
+                        queue.emplace(first.first + second.first, node);
+                    }
+
+                    // Depths, from the root down.
+                    const auto root   = parents.size() - 1u;
+                    auto       depths = std::vector<uint32_t>(parents.size(), 0u);
+                    auto       deepest = 0u;
+
+                    for (auto node = root; node-- > 0u;)
+                    {
+                        if ((node >= symbol_count) || (frequencies[node] > 0u))
+                        {
+                            depths[node] = depths[parents[node]] + 1u;
+                            deepest      = std::max(deepest, depths[node]);
+                        }
+                    }
+
+                    if (deepest <= max_length)
+                    {
+                        for (size_t symbol = 0u; symbol < symbol_count; ++symbol)
+                        {
+                            lengths[symbol] = static_cast<uint8_t>(depths[symbol]);
+                        }
+
+                        return lengths;
+                    }
+
+                    // Flatten the distribution and try again; repeated halving ends with a balanced tree.
+                    for (auto& frequency : frequencies)
+                    {
+                        frequency = (frequency > 0u) ? ((frequency + 1u) / 2u) : 0u;
+                    }
+                }
+            }
+
+            // Canonical Huffman codes for the code lengths, with their bits reversed for writing.
+            std::vector<uint16_t> BuildCodes(const uint8_t* lengths, size_t symbol_count)
+            {
+                uint32_t counts[kMaxCodeLength + 1u] = {};
+                uint32_t next[kMaxCodeLength + 1u]   = {};
+
+                for (size_t symbol = 0u; symbol < symbol_count; ++symbol)
+                {
+                    ++counts[lengths[symbol]];
+                }
+
+                counts[0] = 0u;
+
+                auto code = 0u;
+                for (uint32_t bits = 1u; bits <= kMaxCodeLength; ++bits)
+                {
+                    code       = (code + counts[bits - 1u]) << 1u;
+                    next[bits] = code;
+                }
+
+                auto codes = std::vector<uint16_t>(symbol_count, 0u);
+
+                for (size_t symbol = 0u; symbol < symbol_count; ++symbol)
+                {
+                    const auto length = lengths[symbol];
+                    if (length > 0u)
+                    {
+                        auto value    = next[length]++;
+                        auto reversed = 0u;
+                        for (uint32_t bit = 0u; bit < length; ++bit)
+                        {
+                            reversed = (reversed << 1u) | (value & 1u);
+                            value >>= 1u;
+                        }
+
+                        codes[symbol] = static_cast<uint16_t>(reversed);
+                    }
+                }
+
+                return codes;
+            }
+
+            // A Huffman code, as the code length and bit reversed code of each symbol.
+            struct HuffmanCode
+            {
+                std::vector<uint8_t>  lengths; ///< Code length of each symbol, 0 for unused symbols.
+                std::vector<uint16_t> codes;   ///< Code of each symbol, in the order it is written.
+            };
+
+            const HuffmanCode& GetFixedLiteralCode()
+            {
+                static const auto code = []() {
+                    auto lengths = std::vector<uint8_t>(kFixedLiteralCodes, 8u);
+                    std::fill(lengths.begin() + 144, lengths.begin() + 256, uint8_t{ 9u });
+                    std::fill(lengths.begin() + 256, lengths.begin() + 280, uint8_t{ 7u });
+                    return HuffmanCode{ lengths, BuildCodes(lengths.data(), lengths.size()) };
+                }();
+
+                return code;
+            }
+
+            const HuffmanCode& GetFixedDistanceCode()
+            {
+                static const auto code = []() {
+                    auto lengths = std::vector<uint8_t>(kDistanceCodes, 5u);
+                    return HuffmanCode{ lengths, BuildCodes(lengths.data(), lengths.size()) };
+                }();
+
+                return code;
+            }
+
+            // Symbol counts for a block of tokens.
+            struct BlockStatistics
+            {
+                std::vector<uint32_t> literals  = std::vector<uint32_t>(kLiteralLengthCodes, 0u); ///< Literal/length symbol counts.
+                std::vector<uint32_t> distances = std::vector<uint32_t>(kDistanceCodes, 0u);      ///< Distance symbol counts.
+                uint64_t              extra_bits{ 0u };                                          ///< Length and distance extra bits.
+            };
+
+            BlockStatistics CountSymbols(const std::vector<Token>& tokens)
+            {
+                const auto& tables     = GetCodeTables();
+                auto        statistics = BlockStatistics{};
+
+                for (const auto& token : tokens)
+                {
+                    if (token.distance == 0u)
+                    {
+                        ++statistics.literals[token.value];
+                    }
+                    else
+                    {
+                        const auto length_code   = tables.length_code[token.value];
+                        const auto distance_code = tables.distance_code[token.distance - 1u];
+                        ++statistics.literals[257u + length_code];
+                        ++statistics.distances[distance_code];
+                        statistics.extra_bits += kLengthExtra[length_code] + kDistanceExtra[distance_code];
+                    }
+                }
+
+                ++statistics.literals[kEndOfBlock];
+
+                return statistics;
+            }
+
+            uint64_t CodeSize(const std::vector<uint32_t>& frequencies, const std::vector<uint8_t>& lengths)
+            {
+                auto bits = uint64_t{ 0u };
+                for (size_t symbol = 0u; symbol < frequencies.size(); ++symbol)
+                {
+                    bits += static_cast<uint64_t>(frequencies[symbol]) * lengths[symbol];
+                }
+
+                return bits;
+            }
+
+            // A code length symbol of a dynamic block header, with the value of its extra bits.
+            struct CodeLengthSymbol
+            {
+                uint8_t symbol; ///< Code length, or 16 to 18 for a run.
+                uint8_t extra;  ///< Run length, less the shortest run of the symbol.
+            };
+
+            // Run length encode the literal/length and distance code lengths for a dynamic block header.
+            std::vector<CodeLengthSymbol> EncodeCodeLengths(const std::vector<uint8_t>& lengths)
+            {
+                auto symbols = std::vector<CodeLengthSymbol>{};
+                auto index   = size_t{ 0u };
+
+                while (index < lengths.size())
+                {
+                    const auto length = lengths[index];
+
+                    auto run = size_t{ 1u };
+                    while (((index + run) < lengths.size()) && (lengths[index + run] == length))
+                    {
+                        ++run;
+                    }
+
+                    index += run;
+
+                    if (length == 0u)
+                    {
+                        while (run >= 11u)
+                        {
+                            const auto count = std::min(run, size_t{ 138u });
+                            symbols.push_back(CodeLengthSymbol{ 18u, static_cast<uint8_t>(count - 11u) });
+                            run -= count;
+                        }
+
+                        if (run >= 3u)
+                        {
+                            symbols.push_back(CodeLengthSymbol{ 17u, static_cast<uint8_t>(run - 3u) });
+                            run = 0u;
+                        }
+                    }
+                    else
+                    {
+                        symbols.push_back(CodeLengthSymbol{ length, 0u });
+                        --run;
+
+                        while (run >= 3u)
+                        {
+                            const auto count = std::min(run, size_t{ 6u });
+                            symbols.push_back(CodeLengthSymbol{ 16u, static_cast<uint8_t>(count - 3u) });
+                            run -= count;
+                        }
+                    }
+
+                    for (; run > 0u; --run)
+                    {
+                        symbols.push_back(CodeLengthSymbol{ length, 0u });
+                    }
+                }
+
+                return symbols;
+            }
+
+            uint32_t CodeLengthExtraBits(uint8_t symbol) { return (symbol == 16u) ? 2u : ((symbol == 17u) ? 3u : ((symbol == 18u) ? 7u : 0u)); }
+
+            void WriteTokens(BitWriter& writer, const std::vector<Token>& tokens, const HuffmanCode& literals, const HuffmanCode& distances)
+            {
+                const auto& tables = GetCodeTables();
+
+                for (const auto& token : tokens)
+                {
+                    if (token.distance == 0u)
+                    {
+                        writer.Write(literals.codes[token.value], literals.lengths[token.value]);
+                    }
+                    else
+                    {
+                        const auto length_code = tables.length_code[token.value];
+                        const auto symbol      = 257u + length_code;
+                        writer.Write(literals.codes[symbol], literals.lengths[symbol]);
+                        writer.Write(token.value - kLengthBase[length_code], kLengthExtra[length_code]);
+
+                        const auto distance_code = tables.distance_code[token.distance - 1u];
+                        writer.Write(distances.codes[distance_code], distances.lengths[distance_code]);
+                        writer.Write(token.distance - kDistanceBase[distance_code], kDistanceExtra[distance_code]);
+                    }
+                }
+
+                writer.Write(literals.codes[kEndOfBlock], literals.lengths[kEndOfBlock]);
+            }
+
+            void WriteStored(BitWriter& writer, const uint8_t* data, size_t size, bool final)
+            {
+                do
+                {
+                    const auto count = std::min(size, kMaxStoredSize);
+                    const auto last  = final && (count == size);
+
+                    writer.Write(last ? 1u : 0u, 3u);
+                    writer.AlignToByte();
+
+                    const uint8_t header[4] = { static_cast<uint8_t>(count), static_cast<uint8_t>(count >> 8u), static_cast<uint8_t>(~count), static_cast<uint8_t>(~count >> 8u) };
+                    writer.WriteBytes(header, sizeof(header));
+                    writer.WriteBytes(data, count);
+
+                    data += count;
+                    size -= count;
+                } while (size > 0u);
+            }
+
+            // Write the tokens, which encode the raw data, as whichever of a dynamic, fixed, or stored block is
+            // smallest.
+            void WriteBlock(BitWriter& writer, const std::vector<Token>& tokens, const uint8_t* raw, size_t raw_size, bool final)
+            {
+                const auto statistics = CountSymbols(tokens);
+
+                auto dynamic_literals  = HuffmanCode{ BuildLengths(statistics.literals, kMaxCodeLength), {} };
+                auto dynamic_distances = HuffmanCode{ BuildLengths(statistics.distances, kMaxCodeLength), {} };
+
+                // Trailing unused codes are not stored.
+                auto literal_count = kLiteralLengthCodes;
+                while (dynamic_literals.lengths[literal_count - 1u] == 0u)
+                {
+                    --literal_count;
+                }
+
+                auto distance_count = kDistanceCodes;
+                while (dynamic_distances.lengths[distance_count - 1u] == 0u)
+                {
+                    --distance_count;
+                }
+
+                auto all_lengths = std::vector<uint8_t>(dynamic_literals.lengths.begin(), dynamic_literals.lengths.begin() + literal_count);
+                all_lengths.insert(all_lengths.end(), dynamic_distances.lengths.begin(), dynamic_distances.lengths.begin() + distance_count);
+
+                const auto length_symbols   = EncodeCodeLengths(all_lengths);
+                auto       length_frequency = std::vector<uint32_t>(kCodeLengthCodes, 0u);
+                auto       length_extra     = uint64_t{ 0u };
+                for (const auto& symbol : length_symbols)
+                {
+                    ++length_frequency[symbol.symbol];
+                    length_extra += CodeLengthExtraBits(symbol.symbol);
+                }
+
+                const auto length_lengths = BuildLengths(length_frequency, kMaxCodeLengthBits);
+
+                auto length_code_count = kCodeLengthCodes;
+                while (length_lengths[kCodeLengthOrder[length_code_count - 1u]] == 0u)
+                {
+                    --length_code_count;
+                }
+
+                const auto& fixed_literals  = GetFixedLiteralCode();
+                const auto& fixed_distances = GetFixedDistanceCode();
+
+                const auto literal_lengths = std::vector<uint8_t>(fixed_literals.lengths.begin(), fixed_literals.lengths.begin() + kLiteralLengthCodes);
+
+                const auto dynamic_bits = 3u + 14u + (3u * length_code_count) + CodeSize(length_frequency, length_lengths) + length_extra +
+                                          CodeSize(statistics.literals, dynamic_literals.lengths) + CodeSize(statistics.distances, dynamic_distances.lengths) + statistics.extra_bits;
+                const auto fixed_bits  = 3u + CodeSize(statistics.literals, literal_lengths) + CodeSize(statistics.distances, fixed_distances.lengths) + statistics.extra_bits;
+                const auto stored_bits = (((raw_size / kMaxStoredSize) + 1u) * (3u + 7u + 32u)) + (8u * static_cast<uint64_t>(raw_size));
+
+                if ((stored_bits < dynamic_bits) && (stored_bits < fixed_bits))
+                {
+                    WriteStored(writer, raw, raw_size, final);
+                }
+                else if (fixed_bits <= dynamic_bits)
+                {
+                    writer.Write(final ? 1u : 0u, 1u);
+                    writer.Write(1u, 2u);
+                    WriteTokens(writer, tokens, fixed_literals, fixed_distances);
+                }
+                else
+                {
+                    dynamic_literals.codes  = BuildCodes(dynamic_literals.lengths.data(), dynamic_literals.lengths.size());
+                    dynamic_distances.codes = BuildCodes(dynamic_distances.lengths.data(), dynamic_distances.lengths.size());
+
+                    const auto length_codes = BuildCodes(length_lengths.data(), length_lengths.size());
+
+                    writer.Write(final ? 1u : 0u, 1u);
+                    writer.Write(2u, 2u);
+                    writer.Write(literal_count - 257u, 5u);
+                    writer.Write(distance_count - 1u, 5u);
+                    writer.Write(length_code_count - 4u, 4u);
+
+                    for (uint32_t i = 0u; i < length_code_count; ++i)
+                    {
+                        writer.Write(length_lengths[kCodeLengthOrder[i]], 3u);
+                    }
+
+                    for (const auto& symbol : length_symbols)
+                    {
+                        writer.Write(length_codes[symbol.symbol], length_lengths[symbol.symbol]);
+                        writer.Write(symbol.extra, CodeLengthExtraBits(symbol.symbol));
+                    }
+
+                    WriteTokens(writer, tokens, dynamic_literals, dynamic_distances);
+                }
+            }
+
+            // LZ77 match finder over a window of the dictionary followed by the data, using hash chains of the
+            // positions of each three byte sequence.
+            class Matcher
+            {
+            public:
+                Matcher(const uint8_t* window, size_t size, const LevelParameters& parameters) :
+                    window_(window),
+                    size_(size),
+                    parameters_(parameters),
+                    head_(kHashSize, -1),
+                    previous_(size, -1)
+                {
+                }
+
+                // Add the sequence at the position to its hash chain. Positions must be inserted in order.
+                void Insert(size_t position)
+                {
+                    if ((position + kMinMatch) <= size_)
+                    {
+                        const auto hash     = Hash(position);
+                        previous_[position] = head_[hash];
+                        head_[hash]         = static_cast<int32_t>(position);
+                    }
+                }
+
+                // Length of the longest match for the position, before it is inserted, or 0 when there is none.
+                uint32_t Find(size_t position, uint32_t& distance) const
+                {
+                    const auto limit = static_cast<uint32_t>(std::min(size_t{ kMaxMatch }, size_ - position));
+                    if (limit < kMinMatch)
+                    {
+                        return 0u;
+                    }
+
+                    const auto* current   = window_ + position;
+                    auto        best      = kMinMatch - 1u;
+                    auto        chain     = parameters_.max_chain;
+                    auto        candidate = head_[Hash(position)];
+
+                    while ((candidate >= 0) && (chain-- > 0u))
+                    {
+                        const auto candidate_distance = position - static_cast<size_t>(candidate);
+                        if (candidate_distance > kWindowSize)
+                        {
+                            break;
+                        }
+
+                        const auto* match = window_ + candidate;
+                        if ((match[best] == current[best]) && (match[0] == current[0]))
+                        {
+                            auto length = 0u;
+                            while ((length < limit) && (match[length] == current[length]))
+                            {
+                                ++length;
+                            }
+
+                            if (length > best)
+                            {
+                                best     = length;
+                                distance = static_cast<uint32_t>(candidate_distance);
+
+                                if ((length >= parameters_.nice_length) || (length == limit))
+                                {
+                                    break;
+                                }
+                            }
+                        }
+
+                        candidate = previous_[candidate];
+                    }
+
+                    if ((best < kMinMatch) || ((best == kMinMatch) && (distance > kFarMatch)))
+                    {
+                        return 0u;
+                    }
+
+                    return best;
+                }
+
+            private:
+                uint32_t Hash(size_t position) const
+                {
+                    const auto* bytes = window_ + position;
+                    return ((static_cast<uint32_t>(bytes[0]) << 10u) ^ (static_cast<uint32_t>(bytes[1]) << 5u) ^ bytes[2]) & (kHashSize - 1u);
+                }
+
+            private:
+                const uint8_t*         window_;     ///< Dictionary followed by the data.
+                size_t                 size_;       ///< Size of the window.
+                LevelParameters        parameters_; ///< Search effort.
+                std::vector<int32_t>   head_;       ///< Most recent position with each hash.
+                std::vector<int32_t>   previous_;   ///< Previous position with the same hash as each position.
+            };
+        }
+
+        bool Compress(const uint8_t* data, size_t size, size_t dictionary_size, uint32_t level, bool final, std::vector<uint8_t>& output)
+        {
+            if (level > kMaxLevel)
+            {
+                return false;
+            }
+
+            auto writer = BitWriter{ output };
+
+            if (level == 0u)
+            {
+                if ((size > 0u) || final)
+                {
+                    WriteStored(writer, data, size, final);
+                }
+
+                return true;
+            }
+
+            dictionary_size = std::min(dictionary_size, kWindowSize);
+
+            const auto& parameters = kLevels[level];
+            const auto* window     = data - dictionary_size;
+            const auto  end        = dictionary_size + size;
+
+            auto matcher = Matcher{ window, end, parameters };
+            for (size_t position = 0u; position < dictionary_size; ++position)
+            {
+                matcher.Insert(position);
+            }
+
+            auto tokens = std::vector<Token>{};
+            tokens.reserve(kMaxBlockTokens);
+
+            auto block_start = dictionary_size;
+            auto position    = dictionary_size;
+
+            // A match found at the next position while looking for a longer match, which is used next.
+            auto pending_length   = 0u;
+            auto pending_distance = 0u;
+            auto pending          = false;
+
+            while (position < end)
+            {
+                if (tokens.size() >= kMaxBlockTokens)
+                {
+                    WriteBlock(writer, tokens, window + block_start, position - block_start, false);
+                    tokens.clear();
+                    block_start = position;
+                }
+
+                auto distance = pending_distance;
+                auto length   = pending ? pending_length : matcher.Find(position, distance);
+                pending       = false;
+
+                if (length == 0u)
+                {
+                    tokens.push_back(Token{ window[position], 0u });
+                    matcher.Insert(position);
+                    ++position;
+                    continue;
+                }
+
+                if ((length < parameters.lazy_length) && ((position + 1u) < end))
+                {
+                    matcher.Insert(position);
+
+                    auto next_distance = 0u;
+                    auto next_length   = matcher.Find(position + 1u, next_distance);
+
+                    if (next_length > length)
+                    {
+                        // Emit a literal and take the longer match at the next position.
+                        tokens.push_back(Token{ window[position], 0u });
+                        ++position;
+
+                        pending_length   = next_length;
+                        pending_distance = next_distance;
+                        pending          = true;
+                        continue;
+                    }
+                }
+                else
+                {
+                    matcher.Insert(position);
+                }
+
+                tokens.push_back(Token{ static_cast<uint16_t>(length), static_cast<uint16_t>(distance) });
+
+                for (size_t inserted = position + 1u; inserted < (position + length); ++inserted)
+                {
+                    matcher.Insert(inserted);
+                }
+
+                position += length;
+            }
+
+            if (final || !tokens.empty())
+            {
+                WriteBlock(writer, tokens, window + block_start, end - block_start, final);
+            }
+
+            if (!final)
+            {
+                // Empty stored block, to end the segment on a byte boundary.
+                WriteStored(writer, nullptr, 0u, false);
+            }
+
+            writer.AlignToByte();
+
+            return true;
+        }
+
+        uint16_t ZlibHeader(uint32_t level)
+        {
+            // Deflate with a 32K window, and the level as the compression level hint.
+            const auto method = 0x78u;
+            auto       flags  = (level <= 1u) ? 0u : ((level <= 5u) ? 1u : ((level == 6u) ? 2u : 3u));
+
+            flags <<= 6u;
+            flags += 31u - (((method << 8u) + flags) % 31u);
+
+            return static_cast<uint16_t>((method << 8u) | flags);
+        }
+
+        uint32_t Adler32(const uint8_t* data, size_t size, uint32_t adler)
+        {
+            auto a = adler & 0xffffu;
+            auto b = adler >> 16u;
+
+            while (size > 0u)
+            {
+                const auto count = std::min(size, kAdlerMaxRun);
+                size -= count;
+
+                for (size_t i = 0u; i < count; ++i)
+                {
+                    a += data[i];
+                    b += a;
+                }
+
+                data += count;
+                a %= kAdlerBase;
+                b %= kAdlerBase;
+            }
+
+            return (b << 16u) | a;
+        }
+
+        uint32_t Adler32Combine(uint32_t first, uint32_t second, size_t second_size)
+        {
+            const auto remainder = static_cast<uint32_t>(second_size % kAdlerBase);
+
+            auto a = first & 0xffffu;
+            auto b = static_cast<uint32_t>((static_cast<uint64_t>(remainder) * a) % kAdlerBase);
+
+            a += (second & 0xffffu) + kAdlerBase - 1u;
+            b += (first >> 16u) + (second >> 16u) + kAdlerBase - remainder;
+
+            a %= kAdlerBase;
+            b %= kAdlerBase;
+
+            return (b << 16u) | a;
+        }
+
+        uint32_t Crc32(const uint8_t* data, size_t size, uint32_t crc)
+        {
+            static const auto table = []() {
+                auto entries = std::array<uint32_t, 256u>{};
+                for (uint32_t n = 0u; n < 256u; ++n)
+                {
+                    auto value = n;
+                    for (uint32_t bit = 0u; bit < 8u; ++bit)
+                    {
+                        value = (value & 1u) ? (0xedb88320u ^ (value >> 1u)) : (value >> 1u);
+                    }
+
+                    entries[n] = value;
+                }
+
+                return entries;
+            }();
+
+            crc = ~crc;
+            for (size_t i = 0u; i < size; ++i)
+            {
+                crc = table[(crc ^ data[i]) & 0xffu] ^ (crc >> 8u);
+            }
+
+            return ~crc;
+        }
+    }
+}
@@ -0,0 +1,58 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+#include <vector>
+
+namespace rtc
+{
+    // DEFLATE (RFC 1951) compression and the checksums used by the zlib (RFC 1950) and PNG formats.
+    namespace Deflate
+    {
+        // Compression levels follow zlib: 0 stores the data, 1 is the fastest and 9 produces the smallest output.
+        constexpr uint32_t kMaxLevel     = 9u;
+        constexpr uint32_t kDefaultLevel = 6u;
+
+        // Distance that a match may reach back, and so the most dictionary data that a segment can use.
+        constexpr size_t kWindowSize = 32768u;
+
+        // Compress data[0, size) as a segment of deflate blocks, appended to output. Matches may refer to the
+        // dictionary_size bytes before data, which must be the data that precedes the segment in the stream,
+        // so that independently compressed segments lose little compression. A segment that is not final ends
+        // with an empty stored block, which aligns it to a byte so the next segment can be appended. Returns
+        // false for an invalid level.
+        bool Compress(const uint8_t* data, size_t size, size_t dictionary_size, uint32_t level, bool final, std::vector<uint8_t>& output);
+
+        // The two byte zlib stream header for a deflate stream compressed at the level.
+        uint16_t ZlibHeader(uint32_t level);
+
+        uint32_t Adler32(const uint8_t* data, size_t size, uint32_t adler = 1u);
+
+        // Adler-32 of the concatenation of two blocks of data, from the checksums of each block.
+        uint32_t Adler32Combine(uint32_t first, uint32_t second, size_t second_size);
+
+        uint32_t Crc32(const uint8_t* data, size_t size, uint32_t crc = 0u);
+    }
+}
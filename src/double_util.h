@@ -22,22 +22,236 @@
 
 #pragma once
 
+#include <bit>
 #include <cinttypes>
+#include <cmath>
 #include <cstdlib>
+#include <limits>
+#include <type_traits>
 
 namespace rtc
 {
-    constexpr double kEpsilon = 0.00001;
+    // Scalar type used by the math core and renderer. Double precision is the default; defining
+    // RTC_FLOAT_SCALAR switches the whole project to single precision for faster previews.
+#if defined(RTC_FLOAT_SCALAR)
+    using Scalar = float;
+#else
+    using Scalar = double;
+#endif
+
+    // Tolerance for approximate comparisons of values of type T. Single precision accumulates more
+    // rounding error through transforms and shading, so it gets a wider tolerance.
+    template <typename T>
+    constexpr T kTypeEpsilon = static_cast<T>(0.00001);
+
+    template <>
+    constexpr float kTypeEpsilon<float> = 0.0001f;
+
+    constexpr Scalar kEpsilon = kTypeEpsilon<Scalar>;
 
     constexpr double kPi = 3.141592653589793238462643383279502884;
 
-    inline bool Equal(double l, double r) { return std::abs(l - r) < kEpsilon; }
+    template <typename T>
+    constexpr T Abs(T d) { return (d < T{ 0 }) ? -d : d; }
+
+    template <typename T>
+    constexpr typename std::enable_if<std::is_floating_point<T>::value, bool>::type Equal(T l, T r) { return Abs(l - r) < kTypeEpsilon<T>; }
+
+    // Mixed precision comparisons (e.g. a Scalar against a double literal) use the tolerance of the
+    // project's scalar type.
+    constexpr bool Equal(double l, double r) { return Abs(l - r) < kEpsilon; }
+
+    template <typename T>
+    constexpr T Square(T d) { return d * d; }
+
+    //
+    // Math functions that can also be evaluated at compile time, so transforms built from constant
+    // arguments fold to constants. Runtime calls forward to the standard library.
+    //
+
+    template <typename T>
+    constexpr T Sqrt(T d)
+    {
+        if (std::is_constant_evaluated())
+        {
+            if (!(d > T{ 0 }))
+            {
+                return (d == T{ 0 }) ? d : std::numeric_limits<T>::quiet_NaN();
+            }
+
+            // Newton's method starting above the root decreases monotonically until it converges.
+            auto current = (d > T{ 1 }) ? d : T{ 1 };
+            auto next    = (current + (d / current)) / T{ 2 };
+
+            while (next < current)
+            {
+                current = next;
+                next    = (current + (d / current)) / T{ 2 };
+            }
+
+            return current;
+        }
+
+        return std::sqrt(d);
+    }
+
+    template <typename T>
+    constexpr T Sin(T rad)
+    {
+        if (std::is_constant_evaluated())
+        {
+            // Reduce to [-pi, pi] and sum the Taylor series in double precision.
+            const auto turns = static_cast<int64_t>(static_cast<double>(rad) / (2.0 * kPi));
+            auto       x     = static_cast<double>(rad) - (static_cast<double>(turns) * 2.0 * kPi);
+            x = (x > kPi) ? x - (2.0 * kPi) : (x < -kPi) ? x + (2.0 * kPi) : x;
+
+            auto term = x;
+            auto sum  = x;
+            for (int32_t n = 1; n < 32; ++n)
+            {
+                term *= -(x * x) / static_cast<double>((2 * n) * (2 * n + 1));
+                sum += term;
+            }
+
+            return static_cast<T>(sum);
+        }
+
+        return std::sin(rad);
+    }
+
+    template <typename T>
+    constexpr T Cos(T rad)
+    {
+        if (std::is_constant_evaluated())
+        {
+            const auto turns = static_cast<int64_t>(static_cast<double>(rad) / (2.0 * kPi));
+            auto       x     = static_cast<double>(rad) - (static_cast<double>(turns) * 2.0 * kPi);
+            x = (x > kPi) ? x - (2.0 * kPi) : (x < -kPi) ? x + (2.0 * kPi) : x;
+
+            auto term = 1.0;
+            auto sum  = 1.0;
+            for (int32_t n = 1; n < 32; ++n)
+            {
+                term *= -(x * x) / static_cast<double>((2 * n - 1) * (2 * n));
+                sum += term;
+            }
+
+            return static_cast<T>(sum);
+        }
+
+        return std::cos(rad);
+    }
+
+    //
+    // Fast approximations of log2, exp2 and pow built from exponent bit manipulation and short
+    // polynomials, without branches on the data, so loops calling them can be vectorized.
+    //
 
-    constexpr double Square(double d) { return d * d; }
+    // Approximate log2 for positive, normal d. In double precision the absolute error is below 1e-9.
+    template <typename T>
+    constexpr T FastLog2(T d)
+    {
+        static_assert(std::is_floating_point<T>::value && std::numeric_limits<T>::is_iec559, "rtc::FastLog2 requires IEEE 754 floating point");
+
+        using Bits = typename std::conditional<sizeof(T) == sizeof(uint64_t), uint64_t, uint32_t>::type;
+
+        constexpr auto kMantissaBits = std::numeric_limits<T>::digits - 1;
+        constexpr auto kBias         = std::numeric_limits<T>::max_exponent - 1;
+        constexpr auto kMantissaMask = (Bits{ 1 } << kMantissaBits) - Bits{ 1 };
+        constexpr auto kOneExponent  = static_cast<Bits>(kBias) << kMantissaBits;
+        constexpr auto kSqrt2Fraction = std::bit_cast<Bits>(static_cast<T>(1.4142135623730951)) & kMantissaMask;
+        constexpr auto kShift        = static_cast<T>(Bits{ 1 } << kMantissaBits);
+
+        // Split into an exponent and a mantissa in [sqrt(1/2), sqrt(2)). The fold is selected with integer
+        // arithmetic, from the sign of the difference between the mantissa bits and those of sqrt(2), so
+        // that it compiles without branches. The biased exponent is converted by placing it in the
+        // mantissa of 2^kMantissaBits, avoiding an integer to floating point conversion.
+        const auto bits     = std::bit_cast<Bits>(d);
+        const auto fraction = static_cast<Bits>(bits & kMantissaMask);
+        const auto fold     = static_cast<Bits>(static_cast<Bits>(kSqrt2Fraction - fraction) >> ((sizeof(Bits) * 8u) - 1u));
+        const auto biased   = static_cast<Bits>((bits >> kMantissaBits) + fold);
+        const auto exponent = std::bit_cast<T>(static_cast<Bits>(biased | std::bit_cast<Bits>(kShift))) - (kShift + static_cast<T>(kBias));
+        const auto mantissa = std::bit_cast<T>(static_cast<Bits>(fraction | (kOneExponent - (fold << kMantissaBits))));
+
+        // ln(m) = 2 atanh(t) with t = (m - 1) / (m + 1), which is at most 0.172 after folding.
+        const auto t  = (mantissa - T{ 1 }) / (mantissa + T{ 1 });
+        const auto t2 = t * t;
+        const auto ln = T{ 2 } * t * (T{ 1 } + t2 * (T{ 1 } / T{ 3 } + t2 * (T{ 1 } / T{ 5 } + t2 * (T{ 1 } / T{ 7 } + t2 * (T{ 1 } / T{ 9 })))));
+
+        return exponent + (ln * static_cast<T>(1.4426950408889634));
+    }
+
+    // Approximate exp2 for d <= 0, flushing results below the smallest normal number to zero. In
+    // double precision the relative error is below 1e-8.
+    template <typename T>
+    constexpr T FastExp2(T d)
+    {
+        static_assert(std::is_floating_point<T>::value && std::numeric_limits<T>::is_iec559, "rtc::FastExp2 requires IEEE 754 floating point");
+
+        using Bits = typename std::conditional<sizeof(T) == sizeof(uint64_t), uint64_t, uint32_t>::type;
+
+        constexpr auto kMantissaBits = std::numeric_limits<T>::digits - 1;
+        constexpr auto kBias         = std::numeric_limits<T>::max_exponent - 1;
+        constexpr auto kZeroExponent = -static_cast<T>(kBias);
+        constexpr auto kRound        = static_cast<T>(Bits{ 3 } << (kMantissaBits - 1));
+
+        // Clamp d so that it is not below the exponent of zero, for which the scale computed below is zero.
+        // For negative values a larger magnitude has larger bits, so the comparison is made on the bits:
+        // d is below when it is negative and the difference of the bits is negative. The result selects
+        // the clamped bits without a branch.
+        constexpr auto kSignShift = (sizeof(Bits) * 8u) - 1u;
+
+        const auto bits      = std::bit_cast<Bits>(d);
+        const auto zero_bits = std::bit_cast<Bits>(kZeroExponent);
+        const auto below     = static_cast<Bits>((bits >> kSignShift) & static_cast<Bits>(static_cast<Bits>(zero_bits - bits) >> kSignShift));
+        const auto clamped   = std::bit_cast<T>(static_cast<Bits>(bits ^ ((bits ^ zero_bits) & (Bits{ 0 } - below))));
+
+        // Adding 1.5 * 2^kMantissaBits rounds to the nearest integer n, which is left in the low bits of
+        // the sum. Then 2^d = 2^n * e^x with x = (d - n) ln(2), which is at most 0.347 in magnitude.
+        const auto shifted = clamped + kRound;
+        const auto n       = shifted - kRound;
+        const auto x       = (clamped - n) * static_cast<T>(0.6931471805599453);
+        const auto e       = T{ 1 } + x * (T{ 1 } + x * (T{ 1 } / T{ 2 } + x * (T{ 1 } / T{ 6 } + x * (T{ 1 } / T{ 24 } + x * (T{ 1 } / T{ 120 } + x * (T{ 1 } / T{ 720 } + x * (T{ 1 } / T{ 5040 })))))));
+        const auto scale   = std::bit_cast<T>(static_cast<Bits>((std::bit_cast<Bits>(shifted) + static_cast<Bits>(kBias)) << kMantissaBits));
+
+        return e * scale;
+    }
+
+    // Approximate pow(base, exponent) for base in (0, 1] and a positive exponent, as used for the
+    // specular highlight of the Phong reflection model. For exponents up to 1000 the relative error is
+    // below 1e-6 in double precision and 1e-4 in single precision.
+    template <typename T>
+    constexpr T FastPow(T base, T exponent)
+    {
+        return FastExp2(exponent * FastLog2(base));
+    }
+
+    // Floor computed by rounding with the 1.5 * 2^kMantissaBits addition used by FastExp2, and subtracting
+    // one when the rounded value is above d, selected from the sign bit of the difference. Exact for |d|
+    // below 2^51 in double precision and 2^22 in single precision.
+    template <typename T>
+    constexpr T FastFloor(T d)
+    {
+        static_assert(std::is_floating_point<T>::value && std::numeric_limits<T>::is_iec559, "rtc::FastFloor requires IEEE 754 floating point");
+
+        using Bits = typename std::conditional<sizeof(T) == sizeof(uint64_t), uint64_t, uint32_t>::type;
+
+        constexpr auto kMantissaBits = std::numeric_limits<T>::digits - 1;
+        constexpr auto kRound        = static_cast<T>(Bits{ 3 } << (kMantissaBits - 1));
+        constexpr auto kSignShift    = (sizeof(Bits) * 8u) - 1u;
+
+        // Adding zero turns -0 into +0, which would otherwise leave a negative difference and a floor of -1.
+        const auto value   = d + T{ 0 };
+        const auto rounded = (value + kRound) - kRound;
+        const auto above   = static_cast<Bits>(std::bit_cast<Bits>(value - rounded) >> kSignShift);
+
+        return rounded - std::bit_cast<T>(static_cast<Bits>(std::bit_cast<Bits>(T{ 1 }) & (Bits{ 0 } - above)));
+    }
 
-    constexpr uint8_t ToByte(double d)
+    template <typename T>
+    constexpr uint8_t ToByte(T d)
     {
-        auto b = static_cast<int32_t>(255.0 * d);
+        auto b = static_cast<int32_t>(T{ 255 } * d);
         return static_cast<uint8_t>((b < 0) ? 0 : (b > 255) ? 255 : b);
     }
 
@@ -0,0 +1,246 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "g_buffer.h"
+
+#include "intersections.h"
+#include "parallel_bands.h"
+#include "ray.h"
+#include "ray_budget.h"
+#include "shadow_cache.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace rtc
+{
+    namespace
+    {
+        // Rows processed by a thread at a time.
+        constexpr uint32_t kBandHeight = 16u;
+
+        // Test a ray against the slab along one axis, narrowing the range of distances [near, far] within all
+        // of the slabs tested. Returns false when the ray is parallel to the slab and outside of it.
+        bool ClipSlab(Scalar origin, Scalar direction, Scalar min_bound, Scalar max_bound, Scalar& near, Scalar& far)
+        {
+            if (direction == 0)
+            {
+                return (origin >= min_bound) && (origin <= max_bound);
+            }
+
+            const auto t1 = (min_bound - origin) / direction;
+            const auto t2 = (max_bound - origin) / direction;
+
+            near = std::max(near, std::min(t1, t2));
+            far  = std::min(far, std::max(t1, t2));
+
+            return true;
+        }
+
+        // Test a ray against bounds grown by kEpsilon, so that rays found to hit an object by its intersection
+        // test are not found to miss its bounds by rounding.
+        bool RayHitsBounds(const Ray& ray, const Point& min_bounds, const Point& max_bounds)
+        {
+            const auto& origin    = ray.GetOrigin();
+            const auto& direction = ray.GetDirection();
+
+            auto near = Scalar{ 0 };
+            auto far  = std::numeric_limits<Scalar>::infinity();
+
+            return ClipSlab(origin.GetX(), direction.GetX(), min_bounds.GetX() - kEpsilon, max_bounds.GetX() + kEpsilon, near, far) &&
+                   ClipSlab(origin.GetY(), direction.GetY(), min_bounds.GetY() - kEpsilon, max_bounds.GetY() + kEpsilon, near, far) &&
+                   ClipSlab(origin.GetZ(), direction.GetZ(), min_bounds.GetZ() - kEpsilon, max_bounds.GetZ() + kEpsilon, near, far) &&
+                   (near <= far);
+        }
+    }
+
+    GBuffer::GBuffer(uint32_t width, uint32_t height) :
+        width_(width),
+        height_(height),
+        hits_(static_cast<size_t>(width) * height),
+        valid_(static_cast<size_t>(width) * height, 0u),
+        invalid_count_(static_cast<size_t>(width) * height)
+    {
+    }
+
+    std::optional<Computations> GBuffer::HitAt(uint32_t x, uint32_t y) const
+    {
+        const auto  index = GetIndex(x, y);
+        const auto& hit   = hits_[index];
+
+        if ((valid_[index] == 0u) || !hit.object)
+        {
+            return std::nullopt;
+        }
+
+        return Computations::Prepare(hit.t, hit.object, hit.point, hit.eye, hit.normal, hit.inside, hit.n1, hit.n2);
+    }
+
+    void GBuffer::Invalidate()
+    {
+        std::fill(valid_.begin(), valid_.end(), uint8_t{ 0u });
+        invalid_count_ = valid_.size();
+    }
+
+    void GBuffer::Invalidate(const Camera& camera, const Shape& object)
+    {
+        auto bounds = std::vector<Bounds>{};
+
+        const auto traced = object_bounds_.find(&object);
+        if (traced != object_bounds_.end())
+        {
+            bounds.push_back(traced->second);
+        }
+
+        auto current    = Bounds{};
+        current.bounded = object.GetBounds(current.min_bounds, current.max_bounds);
+        bounds.push_back(current);
+
+        for (const auto& bound : bounds)
+        {
+            if (!bound.bounded)
+            {
+                Invalidate();
+                return;
+            }
+        }
+
+        for (uint32_t y = 0u; y < height_; ++y)
+        {
+            for (uint32_t x = 0u; x < width_; ++x)
+            {
+                const auto index = GetIndex(x, y);
+
+                if (valid_[index] != 0u)
+                {
+                    const auto ray = camera.RayForPixel(x, y);
+
+                    for (const auto& bound : bounds)
+                    {
+                        if (RayHitsBounds(ray, bound.min_bounds, bound.max_bounds))
+                        {
+                            valid_[index] = 0u;
+                            ++invalid_count_;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    bool GBuffer::Trace(const World& world, const Camera& camera, uint32_t thread_count)
+    {
+        if ((camera.GetHSize() != width_) || (camera.GetVSize() != height_))
+        {
+            return false;
+        }
+
+        if (invalid_count_ > 0u)
+        {
+            ParallelBands::ForEachBand(height_, kBandHeight, thread_count, [&](uint32_t, uint32_t first_row, uint32_t last_row) {
+                for (auto y = first_row; y < last_row; ++y)
+                {
+                    for (uint32_t x = 0u; x < width_; ++x)
+                    {
+                        const auto index = GetIndex(x, y);
+
+                        if (valid_[index] == 0u)
+                        {
+                            const auto ray          = camera.RayForPixel(x, y);
+                            const auto intersect    = world.Intersect(ray);
+                            const auto intersection = intersect.Hit();
+
+                            auto& hit = hits_[index];
+
+                            if (intersection != nullptr)
+                            {
+                                const auto comps = Computations::Prepare(*intersection, ray, intersect.GetValues());
+                                hit = Hit{ comps.GetObject(), comps.GetPoint(), comps.GetEye(), comps.GetNormal(), comps.GetT(), comps.GetN1(), comps.GetN2(), comps.IsInside() };
+                            }
+                            else
+                            {
+                                hit = Hit{};
+                            }
+
+                            valid_[index] = 1u;
+                        }
+                    }
+                }
+
+                return true;
+            });
+
+            invalid_count_ = 0u;
+        }
+
+        // Remember the bounds of the objects the pixels were traced against, to find the pixels an edit affects.
+        object_bounds_.clear();
+
+        for (const auto& object : world.GetObjects())
+        {
+            auto bounds    = Bounds{};
+            bounds.bounded = object->GetBounds(bounds.min_bounds, bounds.max_bounds);
+            object_bounds_.emplace(object.get(), bounds);
+        }
+
+        return true;
+    }
+
+    bool GBuffer::Shade(const World& world, Canvas& canvas, uint32_t thread_count) const
+    {
+        if ((canvas.GetWidth() != width_) || (canvas.GetHeight() != height_) || (invalid_count_ > 0u))
+        {
+            return false;
+        }
+
+        auto shadow_caches = std::vector<ShadowCache>(ParallelBands::GetWorkerCount(height_, kBandHeight, thread_count));
+
+        ParallelBands::ForEachBand(height_, kBandHeight, thread_count, [&](uint32_t worker, uint32_t first_row, uint32_t last_row) {
+            auto& shadow_cache = shadow_caches[worker];
+            auto  budget       = RayBudget{};
+
+            for (auto y = first_row; y < last_row; ++y)
+            {
+                for (uint32_t x = 0u; x < width_; ++x)
+                {
+                    const auto& hit = hits_[GetIndex(x, y)];
+
+                    if (hit.object)
+                    {
+                        const auto comps = Computations::Prepare(hit.t, hit.object, hit.point, hit.eye, hit.normal, hit.inside, hit.n1, hit.n2);
+                        canvas.WritePixel(x, y, comps.ShadeHit(world, &shadow_cache, budget, 0u, Scalar{ 1 }));
+                    }
+                    else
+                    {
+                        canvas.WritePixel(x, y, Color{});
+                    }
+                }
+            }
+
+            return true;
+        });
+
+        return true;
+    }
+}
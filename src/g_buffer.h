@@ -0,0 +1,120 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#pragma once
+
+#include "camera.h"
+#include "canvas.h"
+#include "computations.h"
+#include "double_util.h"
+#include "point.h"
+#include "shape.h"
+#include "vector.h"
+#include "world.h"
+
+#include <cinttypes>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace rtc
+{
+    // Primary hit of each pixel of an image, with the values computed by Computations::Prepare, so that an image
+    // can be shaded again without tracing its primary rays. Shading recomputes the lighting, shadows, reflection
+    // and refraction of every pixel, so it reflects any change to the world, but the stored hits only remain
+    // valid while the camera and the geometry seen by the primary rays are unchanged:
+    //   - After editing lights, or materials other than their transparency or refractive index, shade again.
+    //   - After moving, reshaping or removing an object, or changing its transparency or refractive index,
+    //     invalidate the object before tracing and shading again. Only the pixels whose primary rays pass
+    //     through the object's bounds, before or after the edit, are traced again.
+    //   - After adding an object, invalidate it; after moving the camera, invalidate every pixel.
+    class GBuffer
+    {
+    public:
+        GBuffer(uint32_t width, uint32_t height);
+
+        uint32_t GetWidth() const { return width_; }
+
+        uint32_t GetHeight() const { return height_; }
+
+        // Number of pixels whose primary rays will be traced by the next call to Trace().
+        size_t GetInvalidCount() const { return invalid_count_; }
+
+        bool IsValid(uint32_t x, uint32_t y) const { return valid_[GetIndex(x, y)] != 0u; }
+
+        // Primary hit of a pixel, which is empty when the ray missed or the pixel is not valid.
+        std::optional<Computations> HitAt(uint32_t x, uint32_t y) const;
+
+        void Invalidate();
+
+        // Invalidate the pixels whose primary rays pass through the bounds of the object when the pixels were
+        // traced, or its current bounds. Every pixel is invalidated when the object is unbounded.
+        void Invalidate(const Camera& camera, const Shape& object);
+
+        // Trace the primary rays of the invalid pixels, on thread_count threads, or one thread for each hardware
+        // thread when thread_count is 0. Returns false when the camera is not the size of the buffer.
+        bool Trace(const World& world, const Camera& camera, uint32_t thread_count);
+
+        // Shade every pixel from its primary hit into a canvas the size of the buffer. Returns false, without
+        // shading, when the canvas is not the size of the buffer or any pixel is invalid.
+        bool Shade(const World& world, Canvas& canvas, uint32_t thread_count) const;
+
+        // Trace the invalid pixels and shade every pixel.
+        bool Render(const World& world, const Camera& camera, Canvas& canvas, uint32_t thread_count)
+        {
+            return Trace(world, camera, thread_count) && Shade(world, canvas, thread_count);
+        }
+
+    private:
+        // The values of a primary hit that Computations derives the rest from.
+        struct Hit
+        {
+            std::shared_ptr<const Shape> object;  ///< Object hit, or null when the ray missed.
+            Point                        point;   ///< Position of the hit.
+            Vector                       eye;     ///< Vector toward the eye.
+            Vector                       normal;  ///< Normal at the hit, facing the eye.
+            Scalar                       t;       ///< Distance along the ray to the hit.
+            Scalar                       n1;      ///< Refractive index of the material the ray is leaving.
+            Scalar                       n2;      ///< Refractive index of the material the ray is entering.
+            bool                         inside;  ///< Indicates that the hit is inside the object.
+        };
+
+        struct Bounds
+        {
+            bool  bounded;     ///< Indicates that the object is bounded, and the corners are valid.
+            Point min_bounds;  ///< Minimum corner of the object's world space bounds.
+            Point max_bounds;  ///< Maximum corner of the object's world space bounds.
+        };
+
+    private:
+        size_t GetIndex(uint32_t x, uint32_t y) const { return (static_cast<size_t>(y) * width_) + x; }
+
+    private:
+        uint32_t                                 width_;          ///< Width of the image, in pixels.
+        uint32_t                                 height_;         ///< Height of the image, in pixels.
+        std::vector<Hit>                         hits_;           ///< Primary hit of each pixel, by row.
+        std::vector<uint8_t>                     valid_;          ///< Nonzero for each pixel whose hit is valid.
+        size_t                                   invalid_count_;  ///< Number of pixels whose hits are not valid.
+        std::unordered_map<const Shape*, Bounds> object_bounds_;  ///< Bounds of each object of the world when it was last traced.
+    };
+}
@@ -0,0 +1,234 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "catch2/catch.hpp"
+
+#include "camera.h"
+#include "canvas.h"
+#include "color.h"
+#include "double_util.h"
+#include "g_buffer.h"
+#include "material.h"
+#include "matrix44.h"
+#include "plane.h"
+#include "point.h"
+#include "point_light.h"
+#include "sphere.h"
+#include "vector.h"
+#include "world.h"
+
+namespace
+{
+    // A reflective floor with two spheres apart from each other, one of which is glass.
+    rtc::World GBufferScene()
+    {
+        auto floor = rtc::Material{};
+        floor.SetReflective(0.3);
+
+        auto glass = rtc::Material{};
+        glass.SetColor(rtc::Color{ 0.1, 0.1, 0.1 });
+        glass.SetTransparency(0.9);
+        glass.SetRefractiveIndex(1.5);
+
+        return rtc::World{
+            { rtc::PointLight{ rtc::Point{ -10.0, 10.0, -10.0 }, rtc::Color{ 1.0, 1.0, 1.0 } } },
+            { rtc::Plane::Create(floor),
+              rtc::Sphere::Create(rtc::Material{ rtc::Color{ 0.8, 0.2, 0.1 }, 0.1, 0.9, 0.9, 200.0 }, rtc::Matrix44::Translation(-1.5, 1.0, 0.0)),
+              rtc::Sphere::Create(glass, rtc::Matrix44::Multiply(rtc::Matrix44::Translation(1.5, 0.5, 0.0), rtc::Matrix44::Scaling(0.5, 0.5, 0.5))) }
+        };
+    }
+
+    rtc::Camera GBufferCamera()
+    {
+        return rtc::Camera{ 40u, 20u, static_cast<rtc::Scalar>(rtc::kPi / 2.0), rtc::Matrix44::ViewTransform(rtc::Point{ 0.0, 1.5, -5.0 }, rtc::Point{ 0.0, 1.0, 0.0 }, rtc::Vector{ 0.0, 1.0, 0.0 }) };
+    }
+
+    bool CanvasEqual(const rtc::Canvas& lhs, const rtc::Canvas& rhs)
+    {
+        for (uint32_t y = 0u; y < lhs.GetHeight(); ++y)
+        {
+            for (uint32_t x = 0u; x < lhs.GetWidth(); ++x)
+            {
+                if (!rtc::Color::Equal(lhs.PixelAt(x, y), rhs.PixelAt(x, y)))
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+}
+
+SCENARIO("The bounds of a shape", "[shapes]")
+{
+    GIVEN("s <- sphere() with transform translation(1, 2, 3) * scaling(2, 2, 2)")
+    {
+        const auto s = rtc::Sphere::Create(rtc::Matrix44::Multiply(rtc::Matrix44::Translation(1.0, 2.0, 3.0), rtc::Matrix44::Scaling(2.0, 2.0, 2.0)));
+
+        THEN("The bounds are the transformed unit cube")
+        {
+            auto min_bounds = rtc::Point{};
+            auto max_bounds = rtc::Point{};
+
+            REQUIRE(s->GetBounds(min_bounds, max_bounds));
+            REQUIRE(rtc::Point::Equal(min_bounds, rtc::Point{ -1.0, 0.0, 1.0 }));
+            REQUIRE(rtc::Point::Equal(max_bounds, rtc::Point{ 3.0, 4.0, 5.0 }));
+        }
+    }
+
+    GIVEN("s <- sphere() with transform rotation_z(pi / 4)")
+    {
+        const auto s = rtc::Sphere::Create(rtc::Matrix44::RotationZ(static_cast<rtc::Scalar>(rtc::kPi / 4.0)));
+
+        THEN("The bounds contain the rotated cube")
+        {
+            auto min_bounds = rtc::Point{};
+            auto max_bounds = rtc::Point{};
+            const auto root2 = static_cast<rtc::Scalar>(std::sqrt(2.0));
+
+            REQUIRE(s->GetBounds(min_bounds, max_bounds));
+            REQUIRE(rtc::Point::Equal(min_bounds, rtc::Point{ -root2, -root2, -1.0 }));
+            REQUIRE(rtc::Point::Equal(max_bounds, rtc::Point{ root2, root2, 1.0 }));
+        }
+    }
+
+    GIVEN("p <- plane()")
+    {
+        const auto p = rtc::Plane::Create();
+
+        THEN("The plane is unbounded")
+        {
+            auto min_bounds = rtc::Point{};
+            auto max_bounds = rtc::Point{};
+
+            REQUIRE(!p->GetBounds(min_bounds, max_bounds));
+        }
+    }
+}
+
+SCENARIO("Rendering with a G-buffer", "[g_buffer]")
+{
+    GIVEN("w <- g_buffer_scene() and c <- camera() and g <- g_buffer(40, 20)")
+    {
+        auto       w = GBufferScene();
+        const auto c = GBufferCamera();
+        auto       g = rtc::GBuffer{ 40u, 20u };
+
+        REQUIRE(g.GetInvalidCount() == 800u);
+
+        WHEN("image <- render(g, w, c)")
+        {
+            auto image = rtc::Canvas{ 40u, 20u };
+            REQUIRE(g.Render(w, c, image, 2u));
+
+            THEN("The image matches rendering with the camera, and every pixel is valid")
+            {
+                REQUIRE(g.GetInvalidCount() == 0u);
+                REQUIRE(CanvasEqual(image, c.Render(w)));
+            }
+
+            THEN("The buffer holds the primary hit of each pixel")
+            {
+                const auto ray          = c.RayForPixel(5u, 10u);
+                const auto xs           = w.Intersect(ray);
+                const auto intersection = xs.Hit();
+                const auto hit          = g.HitAt(5u, 10u);
+
+                REQUIRE(intersection != nullptr);
+                REQUIRE(hit.has_value());
+                REQUIRE(hit->GetObject() == intersection->GetObject());
+                REQUIRE(hit->GetT() == intersection->GetT());
+                REQUIRE(!g.HitAt(20u, 0u).has_value());
+            }
+
+            AND_WHEN("A material and the light are changed, and image <- shade(g, w)")
+            {
+                auto material = w.GetObject(1u)->GetMaterial();
+                material.SetColor(rtc::Color{ 0.1, 0.8, 0.2 });
+                material.SetReflective(0.5);
+                w.GetObject(1u)->SetMaterial(material);
+                w.SetLight(0u, rtc::PointLight{ rtc::Point{ 5.0, 10.0, -10.0 }, rtc::Color{ 1.0, 0.9, 0.8 } });
+
+                REQUIRE(g.Shade(w, image, 2u));
+
+                THEN("The image matches rendering the edited world without tracing primary rays")
+                {
+                    REQUIRE(CanvasEqual(image, c.Render(w)));
+                }
+            }
+
+            AND_WHEN("A sphere is moved and invalidated, and image <- render(g, w, c)")
+            {
+                const auto& sphere = w.GetObject(2u);
+                sphere->SetTransform(rtc::Matrix44::Multiply(rtc::Matrix44::Translation(1.0, 1.0, 0.0), rtc::Matrix44::Scaling(0.5, 0.5, 0.5)));
+                g.Invalidate(c, *sphere);
+
+                const auto invalid_count = g.GetInvalidCount();
+                REQUIRE(g.Render(w, c, image, 2u));
+
+                THEN("Only the pixels whose rays pass by the sphere were traced, and the image matches rendering the edited world")
+                {
+                    REQUIRE(invalid_count > 0u);
+                    REQUIRE(invalid_count < 200u);
+                    REQUIRE(!g.HitAt(20u, 0u).has_value());
+                    REQUIRE(CanvasEqual(image, c.Render(w)));
+                }
+            }
+
+            AND_WHEN("The floor is changed and invalidated")
+            {
+                auto material = w.GetObject(0u)->GetMaterial();
+                material.SetRefractiveIndex(1.2);
+                w.GetObject(0u)->SetMaterial(material);
+                g.Invalidate(c, *w.GetObject(0u));
+
+                THEN("Every pixel is invalid, as the plane is unbounded")
+                {
+                    REQUIRE(g.GetInvalidCount() == 800u);
+                }
+            }
+
+            AND_WHEN("g is invalidated")
+            {
+                g.Invalidate();
+
+                THEN("Every pixel is invalid, and the image cannot be shaded until it is traced")
+                {
+                    REQUIRE(g.GetInvalidCount() == 800u);
+                    REQUIRE(!g.IsValid(0u, 0u));
+                    REQUIRE(!g.HitAt(5u, 10u).has_value());
+                    REQUIRE(!g.Shade(w, image, 1u));
+                }
+            }
+        }
+
+        THEN("A camera or canvas of a different size is rejected")
+        {
+            auto image = rtc::Canvas{ 20u, 20u };
+
+            REQUIRE(!g.Trace(w, rtc::Camera{ 20u, 20u, static_cast<rtc::Scalar>(rtc::kPi / 2.0) }, 1u));
+            REQUIRE(g.Trace(w, c, 1u));
+            REQUIRE(!g.Shade(w, image, 1u));
+        }
+    }
+}
@@ -0,0 +1,107 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#pragma once
+
+#include <bit>
+#include <cinttypes>
+#include <cmath>
+
+namespace rtc
+{
+    // Conversions between 32-bit floats and IEEE 754 16-bit (half precision) floats, rounding to the nearest
+    // half, with ties to even. Values too large for a half become infinity, and values too small become zero.
+    inline uint16_t FloatToHalf(float value)
+    {
+        const auto bits     = std::bit_cast<uint32_t>(value);
+        const auto sign     = static_cast<uint16_t>((bits >> 16u) & 0x8000u);
+        const auto exponent = static_cast<int32_t>((bits >> 23u) & 0xffu);
+        auto       mantissa = bits & 0x7fffffu;
+
+        if (exponent == 0xff)
+        {
+            // Infinity, or NaN with its payload kept quiet.
+            return static_cast<uint16_t>(sign | 0x7c00u | ((mantissa != 0u) ? (0x200u | (mantissa >> 13u)) : 0u));
+        }
+
+        const auto half_exponent = exponent - 127 + 15;
+
+        if (half_exponent >= 31)
+        {
+            return static_cast<uint16_t>(sign | 0x7c00u);
+        }
+
+        if (half_exponent <= 0)
+        {
+            if (half_exponent < -10)
+            {
+                return sign;
+            }
+
+            // Subnormal half, with the implicit leading bit made explicit.
+            mantissa |= 0x800000u;
+
+            const auto shift     = static_cast<uint32_t>(14 - half_exponent);
+            const auto remainder = mantissa & ((1u << shift) - 1u);
+            const auto halfway   = 1u << (shift - 1u);
+            auto       half      = mantissa >> shift;
+
+            if ((remainder > halfway) || ((remainder == halfway) && ((half & 1u) != 0u)))
+            {
+                ++half;
+            }
+
+            return static_cast<uint16_t>(sign | half);
+        }
+
+        auto       half      = (static_cast<uint32_t>(half_exponent) << 10u) | (mantissa >> 13u);
+        const auto remainder = mantissa & 0x1fffu;
+
+        // Rounding up may carry into the exponent, which gives the next power of two or infinity.
+        if ((remainder > 0x1000u) || ((remainder == 0x1000u) && ((half & 1u) != 0u)))
+        {
+            ++half;
+        }
+
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    inline float HalfToFloat(uint16_t half)
+    {
+        const auto sign     = static_cast<uint32_t>(half & 0x8000u) << 16u;
+        const auto exponent = (half >> 10u) & 0x1fu;
+        const auto mantissa = static_cast<uint32_t>(half & 0x3ffu);
+
+        if (exponent == 0u)
+        {
+            const auto magnitude = std::ldexp(static_cast<float>(mantissa), -24);
+            return (sign != 0u) ? -magnitude : magnitude;
+        }
+
+        if (exponent == 0x1fu)
+        {
+            return std::bit_cast<float>(sign | 0x7f800000u | (mantissa << 13u));
+        }
+
+        return std::bit_cast<float>(sign | ((exponent + 112u) << 23u) | (mantissa << 13u));
+    }
+}
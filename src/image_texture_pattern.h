@@ -0,0 +1,105 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#pragma once
+
+#include "color.h"
+#include "double_util.h"
+#include "matrix44.h"
+#include "pattern.h"
+#include "point.h"
+#include "texture.h"
+#include "texture_cache.h"
+#include "uv_mapping.h"
+
+#include <cassert>
+#include <memory>
+
+namespace rtc
+{
+    class ImageTexturePattern : public Pattern
+    {
+    public:
+        template <typename... Args>
+        static std::shared_ptr<ImageTexturePattern> Create(Args... args)
+        {
+            return std::shared_ptr<ImageTexturePattern>(new ImageTexturePattern(args...));
+        }
+
+    public:
+        const std::shared_ptr<const Texture>& GetTexture() const { return texture_; }
+
+        const std::shared_ptr<TextureCache>& GetCache() const { return cache_; }
+
+        UvMapping::Type GetMapping() const { return mapping_; }
+
+        Scalar GetLevelOfDetail() const { return level_of_detail_; }
+
+        // Patterns are evaluated at a point, without the footprint of the ray, so the mip level is chosen
+        // here: 0 samples the full image, and each increment halves the resolution.
+        void SetLevelOfDetail(Scalar level_of_detail) { level_of_detail_ = level_of_detail; }
+
+        virtual Color PatternAt(const Point& point) const override
+        {
+            auto u = Scalar{ 0 };
+            auto v = Scalar{ 0 };
+            UvMapping::Map(mapping_, point, u, v);
+            return texture_->Sample(*cache_, u, v, level_of_detail_);
+        }
+
+    protected:
+        ImageTexturePattern(const std::shared_ptr<const Texture>& texture, UvMapping::Type mapping) :
+            ImageTexturePattern(texture, mapping, TextureCache::GetShared())
+        {
+        }
+
+        ImageTexturePattern(const std::shared_ptr<const Texture>& texture, UvMapping::Type mapping, const Matrix44& transform) :
+            ImageTexturePattern(texture, mapping, TextureCache::GetShared(), transform)
+        {
+        }
+
+        ImageTexturePattern(const std::shared_ptr<const Texture>& texture, UvMapping::Type mapping, const std::shared_ptr<TextureCache>& cache) :
+            texture_(texture),
+            cache_(cache),
+            mapping_(mapping),
+            level_of_detail_(0)
+        {
+            assert(texture_ && cache_ && "rtc::ImageTexturePattern was initialized with an invalid texture or cache");
+        }
+
+        ImageTexturePattern(const std::shared_ptr<const Texture>& texture, UvMapping::Type mapping, const std::shared_ptr<TextureCache>& cache, const Matrix44& transform) :
+            Pattern(transform),
+            texture_(texture),
+            cache_(cache),
+            mapping_(mapping),
+            level_of_detail_(0)
+        {
+            assert(texture_ && cache_ && "rtc::ImageTexturePattern was initialized with an invalid texture or cache");
+        }
+
+    private:
+        std::shared_ptr<const Texture> texture_;          ///< Mip-mapped image to sample.
+        std::shared_ptr<TextureCache>  cache_;            ///< Cache providing the texture's tiles.
+        UvMapping::Type                mapping_;          ///< Mapping from pattern space points to texture coordinates.
+        Scalar                         level_of_detail_;  ///< Mip level to sample, which may be fractional.
+    };
+}
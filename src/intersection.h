@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include "double_util.h"
+
 #include <memory>
 
 namespace rtc
@@ -31,24 +33,24 @@ namespace rtc
     class Intersection
     {
     public:
-        Intersection(double t, const std::shared_ptr<const Shape>& object) :
+        Intersection(Scalar t, const std::shared_ptr<const Shape>& object) :
             t_(t),
             object_(object)
         {
         }
 
-        Intersection(double t, std::shared_ptr<const Shape>&& object) :
+        Intersection(Scalar t, std::shared_ptr<const Shape>&& object) :
             t_(t),
             object_(std::move(object))
         {
         }
 
-        double GetT() const { return t_; }
+        Scalar GetT() const { return t_; }
 
         const std::shared_ptr<const Shape> GetObject() const { return object_; }
 
     private:
-        double                       t_;        ///< Value representing intersection 'time'.
+        Scalar                       t_;        ///< Value representing intersection 'time'.
         std::shared_ptr<const Shape> object_;   ///< Pointer to intersected object.
     };
 }
@@ -0,0 +1,110 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#pragma once
+
+#include "color.h"
+#include "double_util.h"
+#include "point_light.h"
+
+#include <vector>
+
+namespace rtc
+{
+    // Structure of arrays copy of a list of point lights, so that shading can evaluate many lights in a
+    // loop over contiguous positions and intensities.
+    class LightBatch
+    {
+    public:
+        LightBatch() = default;
+
+        explicit LightBatch(const std::vector<PointLight>& lights)
+        {
+            for (const auto& light : lights)
+            {
+                Append(light);
+            }
+        }
+
+        size_t GetCount() const { return x_.size(); }
+
+        const Scalar* GetX() const { return x_.data(); }
+
+        const Scalar* GetY() const { return y_.data(); }
+
+        const Scalar* GetZ() const { return z_.data(); }
+
+        const Scalar* GetR() const { return r_.data(); }
+
+        const Scalar* GetG() const { return g_.data(); }
+
+        const Scalar* GetB() const { return b_.data(); }
+
+        // Sum of the intensities of all lights in the batch.
+        const Color& GetTotalIntensity() const { return total_intensity_; }
+
+        void Append(const PointLight& light)
+        {
+            x_.push_back(light.GetPosition().GetX());
+            y_.push_back(light.GetPosition().GetY());
+            z_.push_back(light.GetPosition().GetZ());
+            r_.push_back(light.GetIntensity().GetR());
+            g_.push_back(light.GetIntensity().GetG());
+            b_.push_back(light.GetIntensity().GetB());
+            total_intensity_.Add(light.GetIntensity());
+        }
+
+        void Set(size_t index, const PointLight& light)
+        {
+            x_.at(index) = light.GetPosition().GetX();
+            y_.at(index) = light.GetPosition().GetY();
+            z_.at(index) = light.GetPosition().GetZ();
+            r_.at(index) = light.GetIntensity().GetR();
+            g_.at(index) = light.GetIntensity().GetG();
+            b_.at(index) = light.GetIntensity().GetB();
+
+            // Recompute the total rather than adjusting it, so that it does not drift with repeated updates.
+            total_intensity_ = Color{};
+            for (size_t i = 0u; i < r_.size(); ++i)
+            {
+                total_intensity_.Add(Color{ r_[i], g_[i], b_[i] });
+            }
+        }
+
+        // Move a light, leaving its intensity and the total intensity unchanged.
+        void SetPosition(size_t index, const Point& position)
+        {
+            x_.at(index) = position.GetX();
+            y_.at(index) = position.GetY();
+            z_.at(index) = position.GetZ();
+        }
+
+    private:
+        std::vector<Scalar> x_;                ///< X coordinate of the position of each light.
+        std::vector<Scalar> y_;                ///< Y coordinate of the position of each light.
+        std::vector<Scalar> z_;                ///< Z coordinate of the position of each light.
+        std::vector<Scalar> r_;                ///< Red component of the intensity of each light.
+        std::vector<Scalar> g_;                ///< Green component of the intensity of each light.
+        std::vector<Scalar> b_;                ///< Blue component of the intensity of each light.
+        Color               total_intensity_;  ///< Sum of the intensities of all lights.
+    };
+}
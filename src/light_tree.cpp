@@ -0,0 +1,345 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "light_tree.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <numeric>
+
+namespace rtc
+{
+    namespace
+    {
+        // Deepest tree built by median splits of a light list that fits in memory.
+        constexpr size_t kMaxDepth = 64u;
+
+        Scalar Component(const Point& point, size_t axis)
+        {
+            return (axis == 0u) ? point.GetX() : ((axis == 1u) ? point.GetY() : point.GetZ());
+        }
+
+        Scalar Power(const Color& intensity)
+        {
+            return std::max({ intensity.GetR(), intensity.GetG(), intensity.GetB() });
+        }
+
+        // SplitMix64 finalizer.
+        uint64_t Mix(uint64_t value)
+        {
+            value = (value ^ (value >> 30u)) * 0xbf58476d1ce4e5b9ull;
+            value = (value ^ (value >> 27u)) * 0x94d049bb133111ebull;
+            return value ^ (value >> 31u);
+        }
+
+        // Uniform random number in [0, 1), advancing the state.
+        double NextUniform(uint64_t& state)
+        {
+            state += 0x9e3779b97f4a7c15ull;
+            return static_cast<double>(Mix(state) >> 11u) * 0x1.0p-53;
+        }
+    }
+
+    LightTree::LightTree(const Lights& lights) :
+        LightTree(lights, Scalar{ 0 }, 0u)
+    {
+    }
+
+    LightTree::LightTree(const Lights& lights, Scalar min_importance, uint32_t sample_count) :
+        light_count_(lights.size()),
+        min_importance_(min_importance),
+        sample_count_(sample_count)
+    {
+        for (const auto& light : lights)
+        {
+            total_intensity_.Add(light.GetIntensity());
+        }
+
+        if (!lights.empty())
+        {
+            auto indices = std::vector<uint32_t>(lights.size());
+            std::iota(indices.begin(), indices.end(), 0u);
+
+            nodes_.reserve((2u * lights.size()) - 1u);
+            Build(lights, indices, 0u, lights.size());
+        }
+    }
+
+    LightTree::LightTree(const LightTree& tree, const Lights& lights) :
+        nodes_(tree.nodes_),
+        light_count_(tree.light_count_),
+        min_importance_(tree.min_importance_),
+        sample_count_(tree.sample_count_)
+    {
+        assert((lights.size() == light_count_) && "rtc::LightTree refit requires the lights the tree was built for");
+
+        for (const auto& light : lights)
+        {
+            total_intensity_.Add(light.GetIntensity());
+        }
+
+        // Children follow their parents in depth first order, so visiting the nodes in reverse updates both
+        // children of a node before the node.
+        for (auto index = nodes_.size(); index-- > 0u;)
+        {
+            auto& node = nodes_[index];
+
+            if (node.right_child == 0u)
+            {
+                const auto& light = lights[node.light_index];
+                node.min_bounds   = light.GetPosition();
+                node.max_bounds   = light.GetPosition();
+                node.power        = Power(light.GetIntensity());
+                node.max_power    = node.power;
+            }
+            else
+            {
+                const auto& left  = nodes_[index + 1u];
+                const auto& right = nodes_[node.right_child];
+                node.min_bounds   = Point{ std::min(left.min_bounds.GetX(), right.min_bounds.GetX()), std::min(left.min_bounds.GetY(), right.min_bounds.GetY()), std::min(left.min_bounds.GetZ(), right.min_bounds.GetZ()) };
+                node.max_bounds   = Point{ std::max(left.max_bounds.GetX(), right.max_bounds.GetX()), std::max(left.max_bounds.GetY(), right.max_bounds.GetY()), std::max(left.max_bounds.GetZ(), right.max_bounds.GetZ()) };
+                node.power        = left.power + right.power;
+                node.max_power    = std::max(left.max_power, right.max_power);
+            }
+        }
+    }
+
+    void LightTree::Select(const Point& point, const Vector& normal, uint64_t seed, Samples& samples) const
+    {
+        samples.clear();
+
+        if (!nodes_.empty())
+        {
+            if (sample_count_ > 0u)
+            {
+                SelectStochastic(point, normal, seed, samples);
+            }
+            else
+            {
+                SelectAll(point, normal, samples);
+            }
+        }
+    }
+
+    uint64_t LightTree::Seed(const Point& point)
+    {
+        auto seed = uint64_t{ 0u };
+
+        for (const auto value : { point.GetX(), point.GetY(), point.GetZ() })
+        {
+            auto bits = uint64_t{ 0u };
+            std::memcpy(&bits, &value, sizeof(value));
+            seed = Mix(seed ^ bits);
+        }
+
+        return seed;
+    }
+
+    uint32_t LightTree::Build(const Lights& lights, std::vector<uint32_t>& indices, size_t first, size_t count)
+    {
+        const auto index = static_cast<uint32_t>(nodes_.size());
+        const auto begin = indices.begin() + first;
+        const auto end   = begin + count;
+
+        auto node = Node{ lights[*begin].GetPosition(), lights[*begin].GetPosition(), Scalar{ 0 }, Scalar{ 0 }, *begin, 0u };
+
+        for (auto iter = begin; iter != end; ++iter)
+        {
+            const auto& position = lights[*iter].GetPosition();
+            const auto  power    = Power(lights[*iter].GetIntensity());
+
+            node.min_bounds = Point{ std::min(node.min_bounds.GetX(), position.GetX()), std::min(node.min_bounds.GetY(), position.GetY()), std::min(node.min_bounds.GetZ(), position.GetZ()) };
+            node.max_bounds = Point{ std::max(node.max_bounds.GetX(), position.GetX()), std::max(node.max_bounds.GetY(), position.GetY()), std::max(node.max_bounds.GetZ(), position.GetZ()) };
+            node.power += power;
+            node.max_power = std::max(node.max_power, power);
+        }
+
+        nodes_.emplace_back(node);
+
+        if (count > 1u)
+        {
+            // Split at the median along the axis with the largest extent.
+            const auto extent = Vector{ Point::Subtract(node.max_bounds, node.min_bounds) };
+            auto       axis   = size_t{ 0u };
+
+            if (extent.GetY() > extent.GetX())
+            {
+                axis = 1u;
+            }
+
+            if (extent.GetZ() > std::max(extent.GetX(), extent.GetY()))
+            {
+                axis = 2u;
+            }
+
+            const auto left_count = count / 2u;
+
+            std::nth_element(begin, begin + left_count, end, [&lights, axis](uint32_t lhs, uint32_t rhs) {
+                return Component(lights[lhs].GetPosition(), axis) < Component(lights[rhs].GetPosition(), axis);
+            });
+
+            Build(lights, indices, first, left_count);
+            nodes_[index].right_child = Build(lights, indices, first + left_count, count - left_count);
+        }
+
+        return index;
+    }
+
+    bool LightTree::IsCulled(const Node& node, const Point& point, const Vector& normal) const
+    {
+        // Largest distance above the tangent plane of any point in the bounds. When it is negative,
+        // every light in the node is behind the surface.
+        const auto height =
+            (((normal.GetX() >= 0) ? node.max_bounds.GetX() : node.min_bounds.GetX()) - point.GetX()) * normal.GetX() +
+            (((normal.GetY() >= 0) ? node.max_bounds.GetY() : node.min_bounds.GetY()) - point.GetY()) * normal.GetY() +
+            (((normal.GetZ() >= 0) ? node.max_bounds.GetZ() : node.min_bounds.GetZ()) - point.GetZ()) * normal.GetZ();
+
+        if (height < 0)
+        {
+            return true;
+        }
+
+        if (min_importance_ > 0)
+        {
+            // The brightest light at the nearest point of the bounds bounds the importance of every light in the node.
+            const auto dx       = std::max({ node.min_bounds.GetX() - point.GetX(), Scalar{ 0 }, point.GetX() - node.max_bounds.GetX() });
+            const auto dy       = std::max({ node.min_bounds.GetY() - point.GetY(), Scalar{ 0 }, point.GetY() - node.max_bounds.GetY() });
+            const auto dz       = std::max({ node.min_bounds.GetZ() - point.GetZ(), Scalar{ 0 }, point.GetZ() - node.max_bounds.GetZ() });
+            const auto distance = (dx * dx) + (dy * dy) + (dz * dz);
+
+            if (node.max_power < (min_importance_ * distance))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    Scalar LightTree::Importance(const Node& node, const Point& point, const Vector& normal) const
+    {
+        if (IsCulled(node, point, normal))
+        {
+            return Scalar{ 0 };
+        }
+
+        // Power over the squared distance to the center of the bounds, clamped to the size of the bounds
+        // so that nodes containing the point are not favored without limit.
+        const auto center   = Point{ (node.min_bounds.GetX() + node.max_bounds.GetX()) / Scalar{ 2 }, (node.min_bounds.GetY() + node.max_bounds.GetY()) / Scalar{ 2 }, (node.min_bounds.GetZ() + node.max_bounds.GetZ()) / Scalar{ 2 } };
+        const auto diagonal = Vector{ Point::Subtract(node.max_bounds, node.min_bounds) };
+        const auto offset   = Vector{ Point::Subtract(center, point) };
+        const auto distance = std::max({ Vector::Dot(offset, offset), Vector::Dot(diagonal, diagonal) / Scalar{ 4 }, kEpsilon });
+
+        return node.power / distance;
+    }
+
+    void LightTree::SelectAll(const Point& point, const Vector& normal, Samples& samples) const
+    {
+        uint32_t stack[kMaxDepth];
+        size_t   top = 0u;
+
+        stack[top++] = 0u;
+
+        while (top > 0u)
+        {
+            const auto  index = stack[--top];
+            const auto& node  = nodes_[index];
+
+            if (!IsCulled(node, point, normal))
+            {
+                if (node.right_child == 0u)
+                {
+                    samples.emplace_back(node.light_index, Scalar{ 1 });
+                }
+                else
+                {
+                    assert((top + 2u) <= kMaxDepth);
+                    stack[top++] = node.right_child;
+                    stack[top++] = index + 1u;
+                }
+            }
+        }
+    }
+
+    void LightTree::SelectStochastic(const Point& point, const Vector& normal, uint64_t seed, Samples& samples) const
+    {
+        if (IsCulled(nodes_[0], point, normal))
+        {
+            return;
+        }
+
+        auto state = seed;
+
+        for (uint32_t i = 0u; i < sample_count_; ++i)
+        {
+            auto index = uint32_t{ 0u };
+            auto pdf   = Scalar{ 1 };
+
+            while (nodes_[index].right_child != 0u)
+            {
+                const auto left         = index + 1u;
+                const auto right        = nodes_[index].right_child;
+                const auto left_weight  = Importance(nodes_[left], point, normal);
+                const auto right_weight = Importance(nodes_[right], point, normal);
+                const auto total_weight = left_weight + right_weight;
+
+                if (total_weight <= 0)
+                {
+                    // Every light below the node was culled by the importance cutoff.
+                    pdf = Scalar{ 0 };
+                    break;
+                }
+
+                const auto left_probability = left_weight / total_weight;
+
+                if (NextUniform(state) < static_cast<double>(left_probability))
+                {
+                    index = left;
+                    pdf *= left_probability;
+                }
+                else
+                {
+                    index = right;
+                    pdf *= (Scalar{ 1 } - left_probability);
+                }
+            }
+
+            if (pdf > 0)
+            {
+                const auto light_index = nodes_[index].light_index;
+                const auto weight      = Scalar{ 1 } / (pdf * static_cast<Scalar>(sample_count_));
+
+                // Merge repeated selections of a light so that it is only shaded once.
+                auto sample = std::find_if(samples.begin(), samples.end(), [light_index](const LightSample& s) { return s.GetLightIndex() == light_index; });
+                if (sample != samples.end())
+                {
+                    *sample = LightSample{ light_index, sample->GetWeight() + weight };
+                }
+                else
+                {
+                    samples.emplace_back(light_index, weight);
+                }
+            }
+        }
+    }
+}
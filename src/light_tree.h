@@ -0,0 +1,133 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#pragma once
+
+#include "color.h"
+#include "double_util.h"
+#include "point.h"
+#include "point_light.h"
+#include "vector.h"
+
+#include <cinttypes>
+#include <vector>
+
+namespace rtc
+{
+    // A light selected for shading, with the weight to apply to its diffuse and specular contribution.
+    class LightSample
+    {
+    public:
+        LightSample(size_t light_index, Scalar weight) :
+            light_index_(light_index),
+            weight_(weight)
+        {
+        }
+
+        size_t GetLightIndex() const { return light_index_; }
+
+        Scalar GetWeight() const { return weight_; }
+
+    private:
+        size_t light_index_;  ///< Index of the light in the world's light list.
+        Scalar weight_;       ///< Weight for the light's contribution; 1 unless the light was chosen stochastically.
+    };
+
+    // Bounding volume hierarchy over a list of point lights, with the combined intensity of the lights
+    // below each node. Shading queries the tree for the lights that can illuminate a point, skipping
+    // whole groups of lights that are behind the surface. Those lights only contribute ambient light,
+    // which is linear in the intensity and can be computed from GetTotalIntensity(), so this culling
+    // does not change the image.
+    //
+    // Two optional approximations reduce the cost further for scenes with many lights:
+    //   - An importance cutoff skips lights with an intensity / distance^2 estimate below min_importance.
+    //     The Phong model does not attenuate with distance, so this assumes distant, dim lights are
+    //     negligible.
+    //   - Stochastic selection picks sample_count lights by walking the tree with probabilities
+    //     proportional to node importance, and weights each by 1 / (pdf * sample_count), which keeps
+    //     the estimate unbiased at the cost of noise. Traversal is O(log n) per sample.
+    // Both are disabled with a min_importance and sample_count of zero.
+    class LightTree
+    {
+    public:
+        using Lights  = std::vector<PointLight>;
+        using Samples = std::vector<LightSample>;
+
+    public:
+        explicit LightTree(const Lights& lights);
+
+        LightTree(const Lights& lights, Scalar min_importance, uint32_t sample_count);
+
+        // Refit a tree to the new positions and intensities of the lights it was built for, keeping its
+        // structure and settings. Refitting is linear in the number of lights, without the sorting of a
+        // build, but the hierarchy is only as tight as the original split of the lights allows, so a tree
+        // should be rebuilt after large movements. The lights must be the same number as those of the tree.
+        LightTree(const LightTree& tree, const Lights& lights);
+
+        size_t GetLightCount() const { return light_count_; }
+
+        size_t GetNodeCount() const { return nodes_.size(); }
+
+        Scalar GetMinImportance() const { return min_importance_; }
+
+        uint32_t GetSampleCount() const { return sample_count_; }
+
+        // Sum of the intensities of all lights in the tree.
+        const Color& GetTotalIntensity() const { return total_intensity_; }
+
+        // Replace samples with the lights to shade for a surface point with the specified normal. The
+        // seed is only used for stochastic selection; the same seed always selects the same lights.
+        void Select(const Point& point, const Vector& normal, uint64_t seed, Samples& samples) const;
+
+        // Derive a selection seed from a surface point, so that renders are repeatable.
+        static uint64_t Seed(const Point& point);
+
+    private:
+        struct Node
+        {
+            Point    min_bounds;     ///< Minimum corner of the bounds of the lights below the node.
+            Point    max_bounds;     ///< Maximum corner of the bounds of the lights below the node.
+            Scalar   power;          ///< Sum of the brightest channel of each light below the node.
+            Scalar   max_power;      ///< Brightest channel of any light below the node.
+            uint32_t light_index;    ///< Index of the light for a leaf node.
+            uint32_t right_child;    ///< Index of the right child for an interior node; the left child follows the node. Zero for a leaf.
+        };
+
+    private:
+        uint32_t Build(const Lights& lights, std::vector<uint32_t>& indices, size_t first, size_t count);
+
+        bool IsCulled(const Node& node, const Point& point, const Vector& normal) const;
+
+        Scalar Importance(const Node& node, const Point& point, const Vector& normal) const;
+
+        void SelectAll(const Point& point, const Vector& normal, Samples& samples) const;
+
+        void SelectStochastic(const Point& point, const Vector& normal, uint64_t seed, Samples& samples) const;
+
+    private:
+        std::vector<Node> nodes_;             ///< Tree nodes in depth first order, with the root first.
+        Color             total_intensity_;   ///< Sum of the intensities of all lights.
+        size_t            light_count_;       ///< Number of lights in the tree.
+        Scalar            min_importance_;    ///< Importance below which lights are skipped; zero to disable.
+        uint32_t          sample_count_;      ///< Number of lights to select stochastically; zero to select every light that is not culled.
+    };
+}
@@ -0,0 +1,287 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "catch2/catch.hpp"
+
+#include "camera.h"
+#include "color.h"
+#include "double_util.h"
+#include "light_tree.h"
+#include "matrix44.h"
+#include "point.h"
+#include "point_light.h"
+#include "vector.h"
+#include "world.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    // A 5x5 grid of lights above the plane y = 0 and a 5x5 grid of lights below it.
+    rtc::LightTree::Lights GridLights()
+    {
+        auto lights = rtc::LightTree::Lights{};
+
+        for (int y : { -4, 4 })
+        {
+            for (int x = -2; x <= 2; ++x)
+            {
+                for (int z = -2; z <= 2; ++z)
+                {
+                    lights.emplace_back(rtc::Point{ static_cast<rtc::Scalar>(x * 3), static_cast<rtc::Scalar>(y), static_cast<rtc::Scalar>(z * 3) }, rtc::Color{ 0.05, 0.05, 0.05 });
+                }
+            }
+        }
+
+        return lights;
+    }
+}
+
+SCENARIO("Building a light tree", "[lights]")
+{
+    GIVEN("lights <- 50 point lights")
+    {
+        const auto lights = GridLights();
+
+        WHEN("tree <- light_tree(lights)")
+        {
+            const auto tree = rtc::LightTree{ lights };
+
+            THEN("The tree holds every light and their total intensity")
+            {
+                REQUIRE(tree.GetLightCount() == 50u);
+                REQUIRE(tree.GetNodeCount() == 99u);
+                REQUIRE(rtc::Color::Equal(tree.GetTotalIntensity(), rtc::Color{ 2.5, 2.5, 2.5 }));
+            }
+        }
+    }
+}
+
+SCENARIO("A light tree culls lights behind the surface", "[lights]")
+{
+    GIVEN("tree <- light_tree(lights) and p <- point(0, 0, 0) and n <- vector(0, 1, 0)")
+    {
+        const auto lights = GridLights();
+        const auto tree   = rtc::LightTree{ lights };
+        const auto p      = rtc::Point{ 0.0, 0.0, 0.0 };
+        const auto n      = rtc::Vector{ 0.0, 1.0, 0.0 };
+
+        WHEN("samples <- select(tree, p, n)")
+        {
+            auto samples = rtc::LightTree::Samples{};
+            tree.Select(p, n, rtc::LightTree::Seed(p), samples);
+
+            THEN("Only the lights above the surface are selected, with unit weight")
+            {
+                REQUIRE(samples.size() == 25u);
+
+                for (const auto& sample : samples)
+                {
+                    REQUIRE(lights[sample.GetLightIndex()].GetPosition().GetY() > 0.0);
+                    REQUIRE(sample.GetWeight() == 1.0);
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("A light tree importance cutoff skips distant, dim lights", "[lights]")
+{
+    GIVEN("A bright light near p and a dim light far from p")
+    {
+        const auto lights = rtc::LightTree::Lights{
+            rtc::PointLight{ rtc::Point{ 0.0, 1.0, 0.0 }, rtc::Color{ 1.0, 1.0, 1.0 } },
+            rtc::PointLight{ rtc::Point{ 0.0, 100.0, 0.0 }, rtc::Color{ 1.0, 1.0, 1.0 } }
+        };
+        const auto p = rtc::Point{ 0.0, 0.0, 0.0 };
+        const auto n = rtc::Vector{ 0.0, 1.0, 0.0 };
+
+        WHEN("tree <- light_tree(lights, min_importance: 0.01)")
+        {
+            const auto tree    = rtc::LightTree{ lights, 0.01, 0u };
+            auto       samples = rtc::LightTree::Samples{};
+            tree.Select(p, n, rtc::LightTree::Seed(p), samples);
+
+            THEN("Only the near light is selected")
+            {
+                REQUIRE(samples.size() == 1u);
+                REQUIRE(samples[0].GetLightIndex() == 0u);
+            }
+        }
+    }
+}
+
+SCENARIO("Stochastic light selection is unbiased", "[lights]")
+{
+    GIVEN("tree <- light_tree(lights, sample_count: 4) and p <- point(1, 0, 2) and n <- vector(0, 1, 0)")
+    {
+        const auto lights = GridLights();
+        const auto tree   = rtc::LightTree{ lights, 0.0, 4u };
+        const auto p      = rtc::Point{ 1.0, 0.0, 2.0 };
+        const auto n      = rtc::Vector{ 0.0, 1.0, 0.0 };
+
+        WHEN("The weights of the selected lights are averaged over many seeds")
+        {
+            auto       samples  = rtc::LightTree::Samples{};
+            auto       total    = 0.0;
+            const auto trials   = 4000u;
+            auto       selected = size_t{ 0u };
+
+            for (uint64_t seed = 0u; seed < trials; ++seed)
+            {
+                tree.Select(p, n, seed, samples);
+                selected = std::max(selected, samples.size());
+
+                for (const auto& sample : samples)
+                {
+                    REQUIRE(lights[sample.GetLightIndex()].GetPosition().GetY() > 0.0);
+                    total += sample.GetWeight();
+                }
+            }
+
+            THEN("At most sample_count lights are selected, and the weights estimate the number of visible lights")
+            {
+                REQUIRE(selected <= 4u);
+                REQUIRE(std::abs((total / trials) - 25.0) < 1.0);
+            }
+        }
+    }
+}
+
+SCENARIO("Shading with a light tree matches shading every light", "[lights]")
+{
+    GIVEN("w <- default_world() with 50 additional lights and c <- camera(11, 11, pi/2)")
+    {
+        auto w = rtc::World::GetDefault();
+
+        for (const auto& light : GridLights())
+        {
+            w.AppendLight(light);
+        }
+
+        auto c = rtc::Camera{ 11, 11, rtc::Scalar{ rtc::kPi / 2.0 } };
+        c.SetTransform(rtc::Matrix44::ViewTransform(rtc::Point{ 0.0, 0.0, -5.0 }, rtc::Point{ 0.0, 0.0, 0.0 }, rtc::Vector{ 0.0, 1.0, 0.0 }));
+
+        WHEN("image <- render(c, w) and tree_image <- render(c, w with light tree)")
+        {
+            const auto image = c.Render(w);
+            w.BuildLightTree();
+            const auto tree_image = c.Render(w);
+
+            THEN("Every pixel matches")
+            {
+                for (uint32_t y = 0u; y < image.GetHeight(); ++y)
+                {
+                    for (uint32_t x = 0u; x < image.GetWidth(); ++x)
+                    {
+                        REQUIRE(rtc::Color::Equal(tree_image.PixelAt(x, y), image.PixelAt(x, y)));
+                    }
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Changing the lights discards the light tree", "[lights]")
+{
+    GIVEN("w <- default_world() with a light tree")
+    {
+        auto w = rtc::World::GetDefault();
+        w.BuildLightTree();
+
+        REQUIRE(w.GetLightTree() != nullptr);
+
+        WHEN("A light is added to w")
+        {
+            w.AppendLight(rtc::PointLight{ rtc::Point{ 0.0, 10.0, 0.0 }, rtc::Color{ 1.0, 1.0, 1.0 } });
+
+            THEN("w has no light tree")
+            {
+                REQUIRE(w.GetLightTree() == nullptr);
+            }
+        }
+    }
+}
+
+SCENARIO("Refitting a light tree to moved lights", "[lights]")
+{
+    GIVEN("tree <- light_tree(lights) and p <- point(0, 0, 0) and n <- vector(0, 1, 0)")
+    {
+        auto       lights = GridLights();
+        const auto tree   = rtc::LightTree{ lights };
+        const auto p      = rtc::Point{ 0.0, 0.0, 0.0 };
+        const auto n      = rtc::Vector{ 0.0, 1.0, 0.0 };
+
+        WHEN("The lights are moved across the plane and refit <- light_tree(tree, lights)")
+        {
+            for (auto& light : lights)
+            {
+                const auto& position = light.GetPosition();
+                light                = rtc::PointLight{ rtc::Point{ position.GetX(), -position.GetY(), position.GetZ() }, light.GetIntensity() };
+            }
+
+            const auto refit = rtc::LightTree{ tree, lights };
+
+            auto samples = rtc::LightTree::Samples{};
+            refit.Select(p, n, rtc::LightTree::Seed(p), samples);
+
+            THEN("The refit tree keeps its structure and selects the lights now above the surface")
+            {
+                REQUIRE(refit.GetNodeCount() == tree.GetNodeCount());
+                REQUIRE(rtc::Color::Equal(refit.GetTotalIntensity(), tree.GetTotalIntensity()));
+                REQUIRE(samples.size() == 25u);
+
+                for (const auto& sample : samples)
+                {
+                    REQUIRE(lights[sample.GetLightIndex()].GetPosition().GetY() > 0.0);
+                }
+            }
+        }
+    }
+
+    GIVEN("w <- default_world() with a light tree")
+    {
+        auto w = rtc::World::GetDefault();
+        w.BuildLightTree();
+
+        const auto tree = w.GetLightTree();
+
+        WHEN("The light is moved and the tree is refit")
+        {
+            w.SetLightPosition(0u, rtc::Point{ 0.0, 10.0, 0.0 });
+            w.RefitLightTree();
+
+            THEN("w has a new light tree for the moved light, and the light keeps its intensity")
+            {
+                REQUIRE(w.GetLightTree() != nullptr);
+                REQUIRE(w.GetLightTree() != tree);
+                REQUIRE(rtc::PointLight::Equal(w.GetLight(0u), rtc::PointLight{ rtc::Point{ 0.0, 10.0, 0.0 }, rtc::Color{ 1.0, 1.0, 1.0 } }));
+
+                auto samples = rtc::LightTree::Samples{};
+                w.GetLightTree()->Select(rtc::Point{ 0.0, 0.0, 0.0 }, rtc::Vector{ 0.0, -1.0, 0.0 }, 0u, samples);
+                REQUIRE(samples.empty());
+            }
+        }
+    }
+}
@@ -30,9 +30,12 @@
 #include "material.h"
 #include "phong.h"
 #include "plane.h"
+#include "png_writer.h"
 #include "point.h"
 #include "point_light.h"
 #include "ppm_writer.h"
+#include "preview_protocol.h"
+#include "preview_renderer.h"
 #include "ray.h"
 #include "ring_pattern.h"
 #include "sphere.h"
@@ -43,6 +46,7 @@
 #include <chrono>
 #include <cstdio>
 #include <future>
+#include <iostream>
 #include <string>
 
 // Render the silhouette of a sphere (a circle), from Chapter 5 "Putting it together".
@@ -273,10 +277,10 @@ void RenderPlaneScene(const std::string& filename)
     rtc::PpmWriter::WriteFile(filename, canvas);
 }
 
-// Render a scene with a pattern, from Chapter 10 "Patterns".
-void RenderPatternScene(const std::string& filename)
+// Build the scene with patterns, from Chapter 10 "Patterns".
+rtc::World CreatePatternWorld()
 {
-    const auto world = rtc::World{
+    return rtc::World{
         {
             rtc::PointLight{ rtc::Point{ -10.0, 10.0, -10.0 }, rtc::Color{ 1.0, 1.0, 1.0 } },
             rtc::PointLight{ rtc::Point{ 10.0, 10.0, -10.0 }, rtc::Color{ 0.0, 0.0, 1.0 } }
@@ -331,11 +335,83 @@ void RenderPatternScene(const std::string& filename)
                         rtc::Material::GetDefaultShininess() },
                     rtc::Matrix44::Multiply(rtc::Matrix44::Translation(-1.5, 0.33, -0.75), rtc::Matrix44::Scaling(0.33, 0.33, 0.33)))
             } };
+}
 
-    // Construct the camera and render the world.
+// Construct the camera for the scene with patterns.
+rtc::Camera CreatePatternCamera()
+{
     const auto from = rtc::Point{ -1.5, 1.5, -5.0 };
     const auto to = rtc::Point{ 0.0, 1.0, 0.0 };
     const auto up = rtc::Vector{ 0.0, 1.0, 0.0 };
+    return rtc::Camera{ 1000u, 500u, rtc::kPi / 3.0, rtc::Matrix44::ViewTransform(from, to, up) };
+}
+
+// Render a scene with a pattern, from Chapter 10 "Patterns".
+void RenderPatternScene(const std::string& filename)
+{
+    const auto world  = CreatePatternWorld();
+    const auto camera = CreatePatternCamera();
+    const auto canvas = camera.Render(world);
+
+    rtc::PpmWriter::WriteFile(filename, canvas);
+}
+
+// Render a scene with reflective and transparent objects, from Chapter 11 "Reflection and Refraction".
+void RenderReflectionScene(const std::string& filename)
+{
+    auto floor_material = rtc::Material{
+        rtc::CheckersPattern::Create(rtc::Color{ 0.35, 0.35, 0.35 }, rtc::Color{ 0.65, 0.65, 0.65 }),
+        rtc::Material::GetDefaultAmbient(),
+        rtc::Material::GetDefaultDiffuse(),
+        0.0,
+        rtc::Material::GetDefaultShininess() };
+    floor_material.SetReflective(0.4);
+
+    auto mirror_material = rtc::Material{ rtc::Color{ 0.1, 0.1, 0.1 }, 0.0, 0.2, 1.0, 300.0 };
+    mirror_material.SetReflective(0.9);
+
+    auto glass_material = rtc::Material{ rtc::Color{ 0.1, 0.1, 0.1 }, 0.0, 0.1, 1.0, 300.0 };
+    glass_material.SetReflective(0.9);
+    glass_material.SetTransparency(0.9);
+    glass_material.SetRefractiveIndex(1.5);
+
+    const auto world = rtc::World{
+        {
+            rtc::PointLight{ rtc::Point{ -10.0, 10.0, -10.0 }, rtc::Color{ 1.0, 1.0, 1.0 } }
+        },
+        {
+            // Parameters for the floor, a reflective checkered plane.
+            rtc::Plane::Create(floor_material),
+
+            // Parameters for the wall behind the spheres.
+            rtc::Plane::Create(
+                rtc::Material{
+                    rtc::StripePattern::Create(rtc::Color{ 0.45, 0.45, 0.45 }, rtc::Color{ 0.55, 0.55, 0.55 }, rtc::Matrix44::Scaling(0.5, 0.5, 0.5)),
+                    rtc::Material::GetDefaultAmbient(),
+                    rtc::Material::GetDefaultDiffuse(),
+                    0.0,
+                    rtc::Material::GetDefaultShininess() },
+                rtc::Matrix44::Multiply(rtc::Matrix44::Translation(0.0, 0.0, 5.0), rtc::Matrix44::RotationX(rtc::DegreesToRadians(90.0)))),
+
+            // Parameters for the mirrored sphere on the left.
+            rtc::Sphere::Create(mirror_material, rtc::Matrix44::Translation(-1.5, 1.0, 0.5)),
+
+            // Parameters for the glass sphere in front, with an air bubble inside.
+            rtc::Sphere::Create(glass_material, rtc::Matrix44::Translation(0.5, 1.0, -0.5)),
+            rtc::Sphere::Create(
+                rtc::Material{ rtc::Color{ 1.0, 1.0, 1.0 }, 0.0, 0.0, 0.9, 300.0 },
+                rtc::Matrix44::Multiply(rtc::Matrix44::Translation(0.5, 1.0, -0.5), rtc::Matrix44::Scaling(0.5, 0.5, 0.5))),
+
+            // Parameters for the small red sphere on the right, seen through and in the other spheres.
+            rtc::Sphere::Create(
+                rtc::Material{ rtc::Color{ 0.8, 0.1, 0.1 }, rtc::Material::GetDefaultAmbient(), 0.7, 0.3, rtc::Material::GetDefaultShininess() },
+                rtc::Matrix44::Multiply(rtc::Matrix44::Translation(2.0, 0.5, 1.5), rtc::Matrix44::Scaling(0.5, 0.5, 0.5)))
+        } };
+
+    // Construct the camera and render the world.
+    const auto from = rtc::Point{ 0.0, 1.5, -5.0 };
+    const auto to = rtc::Point{ 0.0, 1.0, 0.0 };
+    const auto up = rtc::Vector{ 0.0, 1.0, 0.0 };
     const auto camera = rtc::Camera{ 1000u, 500u, rtc::kPi / 3.0, rtc::Matrix44::ViewTransform(from, to, up) };
     const auto canvas = camera.Render(world);
 
@@ -349,12 +425,14 @@ void RenderAsync(std::launch policy)
     auto render3 = std::async(policy, RenderScene, "scene.ppm");
     auto render4 = std::async(policy, RenderPlaneScene, "plane.ppm");
     auto render5 = std::async(policy, RenderPatternScene, "pattern.ppm");
+    auto render6 = std::async(policy, RenderReflectionScene, "reflection.ppm");
 
     render1.wait();
     render2.wait();
     render3.wait();
     render4.wait();
     render5.wait();
+    render6.wait();
 }
 
 void Render()
@@ -364,10 +442,57 @@ void Render()
     RenderScene("scene.ppm");
     RenderPlaneScene("plane.ppm");
     RenderPatternScene("pattern.ppm");
+    RenderReflectionScene("reflection.ppm");
 }
 
-int main()
+// Preview the scene with patterns, reading edits in the preview protocol from stdin, one per line, until the end of
+// the input or a line containing "quit". Each pass of the preview is written to the file, replacing the last.
+void RunPreview(const std::string& filename)
 {
+    auto preview = rtc::PreviewRenderer{
+        CreatePatternWorld(),
+        CreatePatternCamera(),
+        0u,
+        [&filename](uint64_t revision, uint32_t scale, std::chrono::microseconds latency, const rtc::Canvas& image) {
+            rtc::PngWriter::WriteFile(filename, image, 1u);
+
+            printf("frame %llu 1/%u %.1f ms\n", static_cast<unsigned long long>(revision), scale, static_cast<double>(latency.count()) / 1000.0);
+            fflush(stdout);
+        },
+        [](uint64_t revision, const std::string& error) {
+            fprintf(stderr, "Edit for revision %llu failed: %s\n", static_cast<unsigned long long>(revision), error.c_str());
+        }
+    };
+
+    preview.Start();
+
+    auto line = std::string{};
+
+    while (std::getline(std::cin, line) && (line != "quit"))
+    {
+        auto edit = rtc::PreviewRenderer::Edit{};
+
+        if (rtc::PreviewProtocol::Parse(line, edit))
+        {
+            preview.Update(edit);
+        }
+        else if (!line.empty())
+        {
+            fprintf(stderr, "Invalid command: %s\n", line.c_str());
+        }
+    }
+
+    preview.Stop();
+}
+
+int main(int argc, char* argv[])
+{
+    if ((argc > 1) && (std::string{ argv[1] } == "--preview"))
+    {
+        RunPreview((argc > 2) ? argv[2] : "preview.png");
+        return 0;
+    }
+
     const auto start = std::chrono::steady_clock::now();
 
     RenderAsync(std::launch::async);
@@ -0,0 +1,216 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "mapped_canvas.h"
+
+#include "double_util.h"
+#include "pfm_writer.h"
+
+#include <cstring>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace rtc
+{
+    MappedCanvas::MappedCanvas(uint32_t width, uint32_t height, Format format, Sync sync, int descriptor, uint8_t* mapping, size_t size, size_t data_offset) :
+        width_(width),
+        height_(height),
+        format_(format),
+        sync_(sync),
+        descriptor_(descriptor),
+        mapping_(mapping),
+        size_(size),
+        data_offset_(data_offset)
+    {
+    }
+
+    MappedCanvas::~MappedCanvas()
+    {
+        Close();
+    }
+
+    std::unique_ptr<MappedCanvas> MappedCanvas::Create(const std::string& filename, uint32_t width, uint32_t height, Format format, Sync sync)
+    {
+#if defined(_WIN32)
+        (void)filename;
+        (void)width;
+        (void)height;
+        (void)format;
+        (void)sync;
+        return nullptr;
+#else
+        if ((width == 0u) || (height == 0u))
+        {
+            return nullptr;
+        }
+
+        auto header = std::string{};
+        if (format == Format::kPpm)
+        {
+            header = "P6\n" + std::to_string(width) + ' ' + std::to_string(height) + "\n255\n";
+        }
+        else
+        {
+            header = PfmWriter::Header(width, height);
+        }
+
+        const auto pixel_size = (format == Format::kPpm) ? 3u : (3u * sizeof(float));
+        const auto size       = header.length() + (static_cast<size_t>(width) * height * pixel_size);
+
+        const auto descriptor = open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (descriptor < 0)
+        {
+            return nullptr;
+        }
+
+        // The file is extended with zeros, which are black in both formats.
+        void* mapping = MAP_FAILED;
+        if (ftruncate(descriptor, static_cast<off_t>(size)) == 0)
+        {
+            mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+        }
+
+        if (mapping == MAP_FAILED)
+        {
+            close(descriptor);
+            return nullptr;
+        }
+
+        std::memcpy(mapping, header.data(), header.length());
+
+        return std::unique_ptr<MappedCanvas>(new MappedCanvas(width, height, format, sync, descriptor, static_cast<uint8_t*>(mapping), size, header.length()));
+#endif
+    }
+
+    void MappedCanvas::WritePixel(uint32_t x, uint32_t y, const Color& color)
+    {
+        auto* pixel = PixelAddress(x, y);
+
+        if (format_ == Format::kPpm)
+        {
+            pixel[0] = rtc::ToByte(color.GetR());
+            pixel[1] = rtc::ToByte(color.GetG());
+            pixel[2] = rtc::ToByte(color.GetB());
+        }
+        else
+        {
+            const float rgb[3] = { static_cast<float>(color.GetR()), static_cast<float>(color.GetG()), static_cast<float>(color.GetB()) };
+            std::memcpy(pixel, rgb, sizeof(rgb));
+        }
+    }
+
+    Color MappedCanvas::PixelAt(uint32_t x, uint32_t y) const
+    {
+        const auto* pixel = PixelAddress(x, y);
+
+        if (format_ == Format::kPpm)
+        {
+            const auto scale = Scalar{ 1 } / Scalar{ 255 };
+            return Color{ pixel[0] * scale, pixel[1] * scale, pixel[2] * scale };
+        }
+
+        float rgb[3];
+        std::memcpy(rgb, pixel, sizeof(rgb));
+        return Color{ static_cast<Scalar>(rgb[0]), static_cast<Scalar>(rgb[1]), static_cast<Scalar>(rgb[2]) };
+    }
+
+    bool MappedCanvas::WriteBand(uint32_t first_row, const Canvas& band)
+    {
+        const auto row_count = band.GetHeight();
+
+        if (!IsOpen() || (band.GetWidth() != width_) || (first_row >= height_) || (row_count > (height_ - first_row)))
+        {
+            return false;
+        }
+
+        for (uint32_t y = 0u; y < row_count; ++y)
+        {
+            for (uint32_t x = 0u; x < width_; ++x)
+            {
+                WritePixel(x, first_row + y, band.PixelAt(x, y));
+            }
+        }
+
+#if !defined(_WIN32)
+        if ((sync_ == Sync::kIncremental) && (row_count > 0u))
+        {
+            // The band's rows are contiguous in the file, although PFM stores them from the bottom up.
+            const auto row_size  = static_cast<size_t>(width_) * GetPixelSize();
+            const auto last_row  = first_row + row_count - 1u;
+            const auto* first    = PixelAddress(0u, (format_ == Format::kPpm) ? first_row : last_row);
+            const auto  page     = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            const auto  offset   = static_cast<size_t>(first - mapping_);
+            const auto  start    = offset - (offset % page);
+            const auto  end      = offset + (row_size * row_count);
+
+            return msync(mapping_ + start, end - start, MS_ASYNC) == 0;
+        }
+#endif
+
+        return true;
+    }
+
+    bool MappedCanvas::Flush()
+    {
+#if defined(_WIN32)
+        return false;
+#else
+        return IsOpen() && (msync(mapping_, size_, MS_SYNC) == 0);
+#endif
+    }
+
+    bool MappedCanvas::Close()
+    {
+        if (!IsOpen())
+        {
+            return true;
+        }
+
+        auto success = true;
+
+#if !defined(_WIN32)
+        if (sync_ != Sync::kNone)
+        {
+            success = Flush();
+        }
+
+        success = (munmap(mapping_, size_) == 0) && success;
+        success = (close(descriptor_) == 0) && success;
+#endif
+
+        mapping_    = nullptr;
+        descriptor_ = -1;
+
+        return success;
+    }
+
+    uint8_t* MappedCanvas::PixelAddress(uint32_t x, uint32_t y) const
+    {
+        // PFM stores the rows from the bottom of the image up.
+        const auto row = (format_ == Format::kPpm) ? y : (height_ - 1u - y);
+        return mapping_ + data_offset_ + (((static_cast<size_t>(row) * width_) + x) * GetPixelSize());
+    }
+}
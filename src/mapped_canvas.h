@@ -0,0 +1,113 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#pragma once
+
+#include "canvas.h"
+#include "color.h"
+
+#include <cinttypes>
+#include <memory>
+#include <string>
+
+namespace rtc
+{
+    // Image whose pixels are stored in a memory-mapped file, encoded in the layout of the final image format
+    // after a precomputed header, so that rendered pixels are written directly to the file and the image is
+    // complete once the last pixel is written, without holding a canvas of the whole image or copying it
+    // through an OutputStream. Pixels and bands covering different pixels may be written from any number of
+    // threads at once. Unwritten pixels are black.
+    class MappedCanvas
+    {
+    public:
+        enum class Format
+        {
+            kPpm, ///< Binary (P6) PPM, with 8-bit channels.
+            kPfm  ///< Color PFM, with 32-bit float channels in the host byte order.
+        };
+
+        // When the mapped pages are written back to the file.
+        enum class Sync
+        {
+            kNone,        ///< Left to the operating system, which writes them back after the file is closed.
+            kIncremental, ///< Write back of each band is started as the band is written, and waited for on close.
+            kOnClose      ///< All pages are written back when the canvas is closed.
+        };
+
+    public:
+        MappedCanvas(const MappedCanvas&) = delete;
+
+        MappedCanvas& operator=(const MappedCanvas&) = delete;
+
+        ~MappedCanvas();
+
+        // Create the file, sized for the image, and map it. Returns nullptr when the file cannot be created or
+        // mapped, or on platforms without memory-mapped files.
+        static std::unique_ptr<MappedCanvas> Create(const std::string& filename, uint32_t width, uint32_t height, Format format, Sync sync = Sync::kOnClose);
+
+        uint32_t GetWidth() const { return width_; }
+
+        uint32_t GetHeight() const { return height_; }
+
+        Format GetFormat() const { return format_; }
+
+        Sync GetSync() const { return sync_; }
+
+        // Size of the file, including the header.
+        size_t GetFileSize() const { return size_; }
+
+        bool IsOpen() const { return mapping_ != nullptr; }
+
+        void WritePixel(uint32_t x, uint32_t y, const Color& color);
+
+        // The pixel as stored, after conversion to the file's format.
+        Color PixelAt(uint32_t x, uint32_t y) const;
+
+        // Write the band whose first row is the image row first_row. Returns false when the canvas is closed,
+        // or the band is not the image width or extends past the image.
+        bool WriteBand(uint32_t first_row, const Canvas& band);
+
+        // Write every mapped page back to the file, waiting for the writes to complete.
+        bool Flush();
+
+        // Write the pages back as the sync mode requires and unmap the file. Returns false when the pages could
+        // not be written back. The canvas may not be written after it is closed.
+        bool Close();
+
+    private:
+        MappedCanvas(uint32_t width, uint32_t height, Format format, Sync sync, int descriptor, uint8_t* mapping, size_t size, size_t data_offset);
+
+        uint8_t* PixelAddress(uint32_t x, uint32_t y) const;
+
+        size_t GetPixelSize() const { return (format_ == Format::kPpm) ? 3u : (3u * sizeof(float)); }
+
+    private:
+        uint32_t width_;       ///< Width of the image.
+        uint32_t height_;      ///< Height of the image.
+        Format   format_;      ///< Layout of the file.
+        Sync     sync_;        ///< When mapped pages are written back.
+        int      descriptor_;  ///< File descriptor of the mapped file, or -1 once closed.
+        uint8_t* mapping_;     ///< Start of the mapped file, or nullptr once closed.
+        size_t   size_;        ///< Size of the file and the mapping.
+        size_t   data_offset_; ///< Offset of the pixel data, following the header.
+    };
+}
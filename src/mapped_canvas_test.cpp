@@ -0,0 +1,180 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "catch2/catch.hpp"
+
+#include "camera.h"
+#include "canvas.h"
+#include "color.h"
+#include "double_util.h"
+#include "mapped_canvas.h"
+#include "matrix44.h"
+#include "memory_output_stream.h"
+#include "pfm_writer.h"
+#include "point.h"
+#include "ppm_reader.h"
+#include "vector.h"
+#include "world.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#if !defined(_WIN32)
+namespace
+{
+    std::string TestFilename(const char* name)
+    {
+        // Separate files for the double and float suites, which may run at the same time.
+        const auto filename = std::string{ name } + "_" + std::to_string(sizeof(rtc::Scalar));
+        return (std::filesystem::temp_directory_path() / filename).string();
+    }
+
+    std::string ReadFile(const std::string& filename)
+    {
+        auto file = std::ifstream{ filename, std::ios::binary };
+        return std::string{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+    }
+
+    std::string EncodePfm(const rtc::Canvas& canvas)
+    {
+        auto stream = rtc::MemoryOutputStream{};
+        rtc::PfmWriter::WriteStream(&stream, canvas);
+        return std::string{ reinterpret_cast<const char*>(stream.GetData()), stream.GetSize() };
+    }
+}
+
+SCENARIO("Writing pixels to a memory-mapped PPM", "[mapped_canvas]")
+{
+    GIVEN("c <- mapped_canvas(file, 4, 3, P6)")
+    {
+        const auto filename = TestFilename("rtc_mapped_canvas_test.ppm");
+        auto       c        = rtc::MappedCanvas::Create(filename, 4u, 3u, rtc::MappedCanvas::Format::kPpm);
+
+        REQUIRE(c != nullptr);
+        REQUIRE(c->GetFileSize() == (std::string{ "P6\n4 3\n255\n" }.size() + (4u * 3u * 3u)));
+
+        WHEN("pixels are written and the canvas is closed")
+        {
+            const auto red = rtc::Color{ 1.0, 0.0, 0.0 };
+            const auto mix = rtc::Color{ static_cast<rtc::Scalar>(1.5), static_cast<rtc::Scalar>(0.5), static_cast<rtc::Scalar>(-1.0) };
+
+            c->WritePixel(0u, 0u, red);
+            c->WritePixel(3u, 2u, mix);
+
+            REQUIRE(rtc::Color::Equal(c->PixelAt(0u, 0u), red));
+            REQUIRE(c->Close());
+            REQUIRE_FALSE(c->IsOpen());
+
+            THEN("the file is a complete PPM with the clamped pixels, and black elsewhere")
+            {
+                const auto image = rtc::PpmReader::ReadFile(filename);
+
+                REQUIRE(image != nullptr);
+                REQUIRE(image->GetWidth() == 4u);
+                REQUIRE(image->GetHeight() == 3u);
+                REQUIRE(rtc::Color::Equal(image->PixelAt(0u, 0u), red));
+                REQUIRE(rtc::Color::Equal(image->PixelAt(3u, 2u), rtc::Color{ 1.0, 127.0 / 255.0, 0.0 }));
+                REQUIRE(rtc::Color::Equal(image->PixelAt(1u, 1u), rtc::Color{ 0.0, 0.0, 0.0 }));
+            }
+        }
+
+        std::filesystem::remove(filename);
+    }
+}
+
+SCENARIO("Rendering into a memory-mapped PFM", "[mapped_canvas]")
+{
+    GIVEN("the default world and a 17x11 camera")
+    {
+        const auto w    = rtc::World::GetDefault();
+        const auto from = rtc::Point{ 0.0, 0.0, -5.0 };
+        const auto to   = rtc::Point{ 0.0, 0.0, 0.0 };
+        const auto up   = rtc::Vector{ 0.0, 1.0, 0.0 };
+        const auto cam  = rtc::Camera{ 17u, 11u, rtc::kPi / 2.0, rtc::Matrix44::ViewTransform(from, to, up) };
+
+        for (const auto sync : { rtc::MappedCanvas::Sync::kNone, rtc::MappedCanvas::Sync::kIncremental, rtc::MappedCanvas::Sync::kOnClose })
+        {
+            WHEN("bands of the image are rendered on 3 threads into the mapping")
+            {
+                const auto filename = TestFilename("rtc_mapped_canvas_test.pfm");
+                auto       c        = rtc::MappedCanvas::Create(filename, 17u, 11u, rtc::MappedCanvas::Format::kPfm, sync);
+                REQUIRE(c != nullptr);
+
+                const auto rendered = cam.RenderBands(w, 3u, 3u, [&](uint32_t first_row, const rtc::Canvas& band) { return c->WriteBand(first_row, band); });
+
+                REQUIRE(rendered);
+                REQUIRE(c->Close());
+
+                THEN("the file is identical to the PFM of the rendered image")
+                {
+                    REQUIRE(ReadFile(filename) == EncodePfm(cam.Render(w)));
+                }
+
+                std::filesystem::remove(filename);
+            }
+        }
+    }
+}
+
+SCENARIO("Rejecting invalid memory-mapped canvases and bands", "[mapped_canvas]")
+{
+    GIVEN("a file in a directory that does not exist")
+    {
+        const auto filename = (std::filesystem::temp_directory_path() / "rtc_missing_directory" / "image.pfm").string();
+
+        THEN("the canvas cannot be created")
+        {
+            REQUIRE(rtc::MappedCanvas::Create(filename, 4u, 4u, rtc::MappedCanvas::Format::kPfm) == nullptr);
+        }
+    }
+
+    GIVEN("c <- mapped_canvas(file, 4, 3, PFM)")
+    {
+        const auto filename = TestFilename("rtc_mapped_canvas_invalid_test.pfm");
+
+        REQUIRE(rtc::MappedCanvas::Create(filename, 0u, 3u, rtc::MappedCanvas::Format::kPfm) == nullptr);
+
+        auto c = rtc::MappedCanvas::Create(filename, 4u, 3u, rtc::MappedCanvas::Format::kPfm);
+        REQUIRE(c != nullptr);
+
+        THEN("bands of the wrong width or past the image are rejected")
+        {
+            REQUIRE_FALSE(c->WriteBand(0u, rtc::Canvas{ 3u, 1u }));
+            REQUIRE_FALSE(c->WriteBand(2u, rtc::Canvas{ 4u, 2u }));
+            REQUIRE(c->WriteBand(1u, rtc::Canvas{ 4u, 2u }));
+        }
+
+        THEN("a closed canvas rejects bands")
+        {
+            REQUIRE(c->Close());
+            REQUIRE(c->Close());
+            REQUIRE_FALSE(c->WriteBand(0u, rtc::Canvas{ 4u, 1u }));
+            REQUIRE_FALSE(c->Flush());
+        }
+
+        c.reset();
+        std::filesystem::remove(filename);
+    }
+}
+#endif
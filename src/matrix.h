@@ -31,15 +31,15 @@
 
 namespace rtc
 {
-    template <uint32_t Rows, uint32_t Columns>
-    class Matrix
+    template <typename T, uint32_t Rows, uint32_t Columns>
+    class BasicMatrix
     {
     public:
-        Matrix() : data_{}
+        constexpr BasicMatrix() : data_{}
         {
         }
 
-        Matrix(const double data[Rows][Columns])
+        constexpr BasicMatrix(const T data[Rows][Columns])
         {
             for (uint32_t row = 0u; row < Rows; ++row)
             {
@@ -50,24 +50,24 @@ namespace rtc
             }
         }
 
-        Matrix(std::array<std::array<double, Columns>, Rows>&& data) :
+        constexpr BasicMatrix(std::array<std::array<T, Columns>, Rows>&& data) :
             data_(std::move(data))
         {
         }
 
-        uint32_t NumRows() const { return Rows; }
+        constexpr uint32_t NumRows() const { return Rows; }
 
-        uint32_t NumColumns() const { return Columns; }
+        constexpr uint32_t NumColumns() const { return Columns; }
 
-        void Set(uint32_t row, uint32_t column, double value) { data_[row][column] = value; }
+        constexpr void Set(uint32_t row, uint32_t column, T value) { data_[row][column] = value; }
 
-        double Get(uint32_t row, uint32_t column) const { return data_[row][column]; }
+        constexpr T Get(uint32_t row, uint32_t column) const { return data_[row][column]; }
 
         //
         // Operations on the matrix object.
         //
 
-        bool Equal(const Matrix& rhs) const
+        constexpr bool Equal(const BasicMatrix& rhs) const
         {
             for (uint32_t row = 0u; row < Rows; ++row)
             {
@@ -83,7 +83,7 @@ namespace rtc
             return true;
         }
 
-        void Transpose()
+        constexpr void Transpose()
         {
             for (uint32_t row = 0u; row < Rows; ++row)
             {
@@ -101,11 +101,11 @@ namespace rtc
         }
 
         // Remove a row and column from the matrix.
-        Matrix<Rows - 1u, Columns - 1u> Submatrix(uint32_t row, uint32_t column) const
+        constexpr BasicMatrix<T, Rows - 1u, Columns - 1u> Submatrix(uint32_t row, uint32_t column) const
         {
             static_assert((Rows > 1u) && (Columns > 1u), "rtc::Matrix::Submatrix requires that both dimensions be greater than 1.");
 
-            auto submatrix = Matrix<Rows - 1u, Columns - 1u>{};
+            auto submatrix = BasicMatrix<T, Rows - 1u, Columns - 1u>{};
 
             for (uint32_t sub_row = 0u, current_row = 0u; sub_row < (Rows - 1u); ++sub_row, ++current_row)
             {
@@ -129,17 +129,17 @@ namespace rtc
         }
 
         template <uint32_t N = Rows, uint32_t M = Columns>
-        typename std::enable_if<((N == M) && (N == 2u)), double>::type Determinant() const
+        constexpr typename std::enable_if<((N == M) && (N == 2u)), T>::type Determinant() const
         {
             return (Get(0u, 0u) * Get(1u, 1u)) - (Get(0u, 1u) * Get(1u, 0u));
         }
 
         template <uint32_t N = Rows, uint32_t M = Columns>
-        typename std::enable_if<!((N == M) && (N == 2u)), double>::type Determinant() const
+        constexpr typename std::enable_if<!((N == M) && (N == 2u)), T>::type Determinant() const
         {
             static_assert((Rows == Columns) && (Rows >= 2u), "rtc::Matrix::Determinant is only implemented for square matrices with dimensions greater than 1x1.");
 
-            auto determinant = 0.0;
+            auto determinant = T{ 0 };
 
             for (uint32_t column = 0u; column < Columns; ++column)
             {
@@ -150,7 +150,7 @@ namespace rtc
         }
 
         // Determinant of the submatrix.
-        double Minor(uint32_t row, uint32_t column) const
+        constexpr T Minor(uint32_t row, uint32_t column) const
         {
             static_assert((Rows == Columns) && (Rows >= 3u), "rtc::Matrix::Determinant is only implemented for square matrices with dimensions greater than 2x2.");
 
@@ -159,7 +159,7 @@ namespace rtc
         }
 
         // Minor with a potential sign change.
-        double Cofactor(uint32_t row, uint32_t column) const
+        constexpr T Cofactor(uint32_t row, uint32_t column) const
         {
             static_assert((Rows == Columns) && (Rows >= 3u), "rtc::Matrix::Determinant is only implemented for square matrices with dimensions greater than 2x2.");
 
@@ -178,7 +178,7 @@ namespace rtc
         // Static operations that may create new matrix objects.
         //
 
-        static bool Equal(const Matrix& lhs, const Matrix& rhs)
+        static constexpr bool Equal(const BasicMatrix& lhs, const BasicMatrix& rhs)
         {
             for (uint32_t row = 0u; row < Rows; ++row)
             {
@@ -194,24 +194,24 @@ namespace rtc
             return true;
         }
 
-        static Matrix Identity()
+        static constexpr BasicMatrix Identity()
         {
-            auto identity = Matrix{};
+            auto identity = BasicMatrix{};
 
             for (uint32_t row = 0u; row < Rows; ++row)
             {
                 for (uint32_t column = 0u; column < Columns; ++column)
                 {
-                    identity.data_[row][column] = (row != column) ? 0.0 : 1.0;
+                    identity.data_[row][column] = (row != column) ? T{ 0 } : T{ 1 };
                 }
             }
 
             return identity;
         }
 
-        static Matrix Transpose(const Matrix& matrix)
+        static constexpr BasicMatrix Transpose(const BasicMatrix& matrix)
         {
-            auto transpose = Matrix{};
+            auto transpose = BasicMatrix{};
 
             for (uint32_t row = 0u; row < Rows; ++row)
             {
@@ -224,30 +224,33 @@ namespace rtc
             return transpose;
         }
 
-        static Matrix<Rows - 1u, Columns - 1u> Submatrix(const Matrix& matrix, uint32_t row, uint32_t column)
+        static constexpr BasicMatrix<T, Rows - 1u, Columns - 1u> Submatrix(const BasicMatrix& matrix, uint32_t row, uint32_t column)
         {
             return matrix.Submatrix(row, column);
         }
 
-        static double Minor(const Matrix& matrix, uint32_t row, uint32_t column)
+        static constexpr T Minor(const BasicMatrix& matrix, uint32_t row, uint32_t column)
         {
             return matrix.Minor(row, column);
         }
 
-        static double Cofactor(const Matrix& matrix, uint32_t row, uint32_t column)
+        static constexpr T Cofactor(const BasicMatrix& matrix, uint32_t row, uint32_t column)
         {
             return matrix.Cofactor(row, column);
         }
 
-        static double Determinant(const Matrix& matrix)
+        static constexpr T Determinant(const BasicMatrix& matrix)
         {
             return matrix.Determinant();
         }
 
     private:
-        using Row = std::array<double, Columns>;
+        using Row = std::array<T, Columns>;
 
     private:
         std::array<Row, Rows> data_;
     };
+
+    template <uint32_t Rows, uint32_t Columns>
+    using Matrix = BasicMatrix<Scalar, Rows, Columns>;
 }
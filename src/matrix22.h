@@ -26,37 +26,40 @@
 
 namespace rtc
 {
-    class Matrix22 : public Matrix<2, 2>
+    template <typename T>
+    class BasicMatrix22 : public BasicMatrix<T, 2, 2>
     {
     public:
-        Matrix22() = default;
+        constexpr BasicMatrix22() = default;
 
-        Matrix22(const Matrix& matrix) :
-            Matrix(matrix)
+        constexpr BasicMatrix22(const BasicMatrix<T, 2, 2>& matrix) :
+            BasicMatrix<T, 2, 2>(matrix)
         {
         }
 
-        Matrix22(Matrix&& matrix) :
-            Matrix(std::move(matrix))
+        constexpr BasicMatrix22(BasicMatrix<T, 2, 2>&& matrix) :
+            BasicMatrix<T, 2, 2>(std::move(matrix))
         {
         }
 
-        Matrix22(const double data[2][2]) :
-            Matrix(data)
+        constexpr BasicMatrix22(const T data[2][2]) :
+            BasicMatrix<T, 2, 2>(data)
         {
         }
 
-        Matrix22(std::array<std::array<double, 2>, 2>&& data) :
-            Matrix(std::move(data))
+        constexpr BasicMatrix22(std::array<std::array<T, 2>, 2>&& data) :
+            BasicMatrix<T, 2, 2>(std::move(data))
         {
         }
 
-        static Matrix22 Identity()
+        static constexpr BasicMatrix22 Identity()
         {
-            return Matrix22{ {{
-                    {{ 1.0, 0.0 }},
-                    {{ 0.0, 1.0 }}
+            return BasicMatrix22{ {{
+                    {{ T{ 1 }, T{ 0 } }},
+                    {{ T{ 0 }, T{ 1 } }}
                     }} };
         }
     };
+
+    using Matrix22 = BasicMatrix22<Scalar>;
 }
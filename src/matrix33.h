@@ -26,38 +26,41 @@
 
 namespace rtc
 {
-    class Matrix33 : public Matrix<3, 3>
+    template <typename T>
+    class BasicMatrix33 : public BasicMatrix<T, 3, 3>
     {
     public:
-        Matrix33() = default;
+        constexpr BasicMatrix33() = default;
 
-        Matrix33(const Matrix& matrix) :
-            Matrix(matrix)
+        constexpr BasicMatrix33(const BasicMatrix<T, 3, 3>& matrix) :
+            BasicMatrix<T, 3, 3>(matrix)
         {
         }
 
-        Matrix33(Matrix&& matrix) :
-            Matrix(std::move(matrix))
+        constexpr BasicMatrix33(BasicMatrix<T, 3, 3>&& matrix) :
+            BasicMatrix<T, 3, 3>(std::move(matrix))
         {
         }
 
-        Matrix33(const double data[3][3]) :
-            Matrix(data)
+        constexpr BasicMatrix33(const T data[3][3]) :
+            BasicMatrix<T, 3, 3>(data)
         {
         }
 
-        Matrix33(std::array<std::array<double, 3>, 3>&& data) :
-            Matrix(std::move(data))
+        constexpr BasicMatrix33(std::array<std::array<T, 3>, 3>&& data) :
+            BasicMatrix<T, 3, 3>(std::move(data))
         {
         }
 
-        static Matrix33 Identity()
+        static constexpr BasicMatrix33 Identity()
         {
-            return Matrix33{ {{
-                    {{ 1.0, 0.0, 0.0 }},
-                    {{ 0.0, 1.0, 0.0 }},
-                    {{ 0.0, 0.0, 1.0 }}
+            return BasicMatrix33{ {{
+                    {{ T{ 1 }, T{ 0 }, T{ 0 } }},
+                    {{ T{ 0 }, T{ 1 }, T{ 0 } }},
+                    {{ T{ 0 }, T{ 0 }, T{ 1 } }}
                     }} };
         }
     };
+
+    using Matrix33 = BasicMatrix33<Scalar>;
 }
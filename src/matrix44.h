@@ -34,42 +34,43 @@
 
 namespace rtc
 {
-    class Matrix44 : public Matrix<4, 4>
+    template <typename T>
+    class BasicMatrix44 : public BasicMatrix<T, 4, 4>
     {
     public:
-        Matrix44() = default;
+        constexpr BasicMatrix44() = default;
 
-        Matrix44(const Matrix& matrix) :
-            Matrix(matrix)
+        constexpr BasicMatrix44(const BasicMatrix<T, 4, 4>& matrix) :
+            BasicMatrix<T, 4, 4>(matrix)
         {
         }
 
-        Matrix44(Matrix&& matrix) :
-            Matrix(std::move(matrix))
+        constexpr BasicMatrix44(BasicMatrix<T, 4, 4>&& matrix) :
+            BasicMatrix<T, 4, 4>(std::move(matrix))
         {
         }
 
-        Matrix44(const double data[4][4]) :
-            Matrix(data)
+        constexpr BasicMatrix44(const T data[4][4]) :
+            BasicMatrix<T, 4, 4>(data)
         {
         }
 
-        Matrix44(std::array<std::array<double, 4>, 4>&& data) :
-            Matrix(std::move(data))
+        constexpr BasicMatrix44(std::array<std::array<T, 4>, 4>&& data) :
+            BasicMatrix<T, 4, 4>(std::move(data))
         {
         }
 
-        static Matrix44 Identity()
+        static constexpr BasicMatrix44 Identity()
         {
-            return Matrix44{ {{
-                    {{ 1.0, 0.0, 0.0, 0.0 }},
-                    {{ 0.0, 1.0, 0.0, 0.0 }},
-                    {{ 0.0, 0.0, 1.0, 0.0 }},
-                    {{ 0.0, 0.0, 0.0, 1.0 }}
+            return BasicMatrix44{ {{
+                    {{ T{ 1 }, T{ 0 }, T{ 0 }, T{ 0 } }},
+                    {{ T{ 0 }, T{ 1 }, T{ 0 }, T{ 0 } }},
+                    {{ T{ 0 }, T{ 0 }, T{ 1 }, T{ 0 } }},
+                    {{ T{ 0 }, T{ 0 }, T{ 0 }, T{ 1 } }}
                     }} };
         }
 
-        static Matrix44 Translation(double x, double y, double z)
+        static constexpr BasicMatrix44 Translation(T x, T y, T z)
         {
             auto transform = Identity();
             transform.Set(0u, 3u, x);
@@ -78,7 +79,7 @@ namespace rtc
             return transform;
         }
 
-        static Matrix44 Scaling(double x, double y, double z)
+        static constexpr BasicMatrix44 Scaling(T x, T y, T z)
         {
             auto transform = Identity();
             transform.Set(0u, 0u, x);
@@ -89,11 +90,11 @@ namespace rtc
 
         // Rotation will appear to be clockwise around the corresponding axis when
         // viewed along that axis, toward the negative end. (Left-hand rule).
-        static Matrix44 RotationX(double rad)
+        static constexpr BasicMatrix44 RotationX(T rad)
         {
             auto       transform = Identity();
-            const auto cos_r     = cos(rad);
-            const auto sin_r     = sin(rad);
+            const auto cos_r     = rtc::Cos(rad);
+            const auto sin_r     = rtc::Sin(rad);
             transform.Set(1u, 1u, cos_r);
             transform.Set(1u, 2u, -sin_r);
             transform.Set(2u, 1u, sin_r);
@@ -101,11 +102,11 @@ namespace rtc
             return transform;
         }
 
-        static Matrix44 RotationY(double rad)
+        static constexpr BasicMatrix44 RotationY(T rad)
         {
             auto       transform = Identity();
-            const auto cos_r     = cos(rad);
-            const auto sin_r     = sin(rad);
+            const auto cos_r     = rtc::Cos(rad);
+            const auto sin_r     = rtc::Sin(rad);
             transform.Set(0u, 0u, cos_r);
             transform.Set(0u, 2u, sin_r);
             transform.Set(2u, 0u, -sin_r);
@@ -113,11 +114,11 @@ namespace rtc
             return transform;
         }
 
-        static Matrix44 RotationZ(double rad)
+        static constexpr BasicMatrix44 RotationZ(T rad)
         {
             auto       transform = Identity();
-            const auto cos_r     = cos(rad);
-            const auto sin_r     = sin(rad);
+            const auto cos_r     = rtc::Cos(rad);
+            const auto sin_r     = rtc::Sin(rad);
             transform.Set(0u, 0u, cos_r);
             transform.Set(0u, 1u, -sin_r);
             transform.Set(1u, 0u, sin_r);
@@ -125,7 +126,7 @@ namespace rtc
             return transform;
         }
 
-        static Matrix44 Shearing(double xy, double xz, double yx, double yz, double zx, double zy)
+        static constexpr BasicMatrix44 Shearing(T xy, T xz, T yx, T yz, T zx, T zy)
         {
             auto transform = Identity();
             transform.Set(0u, 1u, xy);
@@ -137,25 +138,25 @@ namespace rtc
             return transform;
         }
 
-        static Matrix44 ViewTransform(const Point& from, const Point& to, const Vector& up)
+        static constexpr BasicMatrix44 ViewTransform(const BasicPoint<T>& from, const BasicPoint<T>& to, const BasicVector<T>& up)
         {
-            const auto forward     = Vector::Normalize(rtc::Vector::Subtract(to, from));
-            const auto up_norm     = Vector::Normalize(up);
-            const auto left        = Vector::Cross(forward, up_norm);
-            const auto true_up     = Vector::Cross(left, forward);
-            const auto orientation = Matrix44{ {{
-                {{ left.GetX(), left.GetY(), left.GetZ(), 0.0 }},
-                {{ true_up.GetX(), true_up.GetY(), true_up.GetZ(), 0.0 }},
-                {{ -forward.GetX(), -forward.GetY(), -forward.GetZ(), 0.0 }},
-                {{ 0.0, 0.0, 0.0, 1.0 }}
+            const auto forward     = BasicVector<T>::Normalize(BasicVector<T>::Subtract(to, from));
+            const auto up_norm     = BasicVector<T>::Normalize(up);
+            const auto left        = BasicVector<T>::Cross(forward, up_norm);
+            const auto true_up     = BasicVector<T>::Cross(left, forward);
+            const auto orientation = BasicMatrix44{ {{
+                {{ left.GetX(), left.GetY(), left.GetZ(), T{ 0 } }},
+                {{ true_up.GetX(), true_up.GetY(), true_up.GetZ(), T{ 0 } }},
+                {{ -forward.GetX(), -forward.GetY(), -forward.GetZ(), T{ 0 } }},
+                {{ T{ 0 }, T{ 0 }, T{ 0 }, T{ 1 } }}
                 }} };
 
-            return rtc::Matrix44::Multiply(orientation, rtc::Matrix44::Translation(-from.GetX(), -from.GetY(), -from.GetZ()));
+            return Multiply(orientation, Translation(-from.GetX(), -from.GetY(), -from.GetZ()));
         }
 
-        static Matrix44 Multiply(const Matrix44& lhs, const Matrix44& rhs)
+        static constexpr BasicMatrix44 Multiply(const BasicMatrix44& lhs, const BasicMatrix44& rhs)
         {
-            auto result = Matrix44{};
+            auto result = BasicMatrix44{};
 
             for (uint32_t row = 0u; row < 4u; ++row)
             {
@@ -174,14 +175,14 @@ namespace rtc
         }
 
         template <typename... Rest>
-        static Matrix44 Multiply(const Matrix44& first, const Matrix44& second, Rest... rest)
+        static constexpr BasicMatrix44 Multiply(const BasicMatrix44& first, const BasicMatrix44& second, Rest... rest)
         {
             return Multiply(Multiply(first, second), rest...);
         }
 
-        static Tuple Multiply(const Matrix44& lhs, const Tuple& rhs)
+        static constexpr BasicTuple<T> Multiply(const BasicMatrix44& lhs, const BasicTuple<T>& rhs)
         {
-            auto values = std::array<double, 4>{};
+            auto values = std::array<T, 4>{};
 
             for (uint32_t row = 0u; row < 4u; ++row)
             {
@@ -192,25 +193,25 @@ namespace rtc
                     (lhs.Get(row, 3u) * rhs.GetW());
             }
 
-            return Tuple(values[0], values[1], values[2], values[3]);
+            return BasicTuple<T>(values[0], values[1], values[2], values[3]);
         }
 
-        static Ray Transform(const Ray& ray, const Matrix44& m)
+        static constexpr BasicRay<T> Transform(const BasicRay<T>& ray, const BasicMatrix44& m)
         {
-            return Ray(Multiply(m, ray.GetOrigin()), Multiply(m, ray.GetDirection()));
+            return BasicRay<T>(Multiply(m, ray.GetOrigin()), Multiply(m, ray.GetDirection()));
         }
 
-        static bool IsInvertible(const Matrix44& matrix)
+        static constexpr bool IsInvertible(const BasicMatrix44& matrix)
         {
-            return !rtc::Equal(matrix.Determinant(), 0.0);
+            return !rtc::Equal(matrix.Determinant(), T{ 0 });
         }
 
-        static Matrix44 Inverse(const Matrix44& matrix)
+        static constexpr BasicMatrix44 Inverse(const BasicMatrix44& matrix)
         {
             const auto determinant = matrix.Determinant();
-            auto       inverse     = Matrix44{};
+            auto       inverse     = BasicMatrix44{};
 
-            if (!rtc::Equal(determinant, 0.0))
+            if (!rtc::Equal(determinant, T{ 0 }))
             {
                 // Create a matrix consisting of the cofactors of each of the original elements,
                 // transposed and divided by the determinant of the original matrix.
@@ -230,4 +231,6 @@ namespace rtc
             return inverse;
         }
     };
+
+    using Matrix44 = BasicMatrix44<Scalar>;
 }
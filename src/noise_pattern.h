@@ -0,0 +1,105 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#pragma once
+
+#include "color.h"
+#include "double_util.h"
+#include "matrix44.h"
+#include "pattern.h"
+#include "perlin_noise.h"
+#include "point.h"
+
+#include <algorithm>
+#include <cinttypes>
+
+namespace rtc
+{
+    // Blend between two colors by the value of fractal Perlin noise, for clouds, stone and other
+    // irregular surfaces.
+    class NoisePattern : public Pattern
+    {
+    public:
+        template <typename... Args>
+        static std::shared_ptr<NoisePattern> Create(Args... args)
+        {
+            return std::shared_ptr<NoisePattern>(new NoisePattern(args...));
+        }
+
+    public:
+        const Color& GetA() const { return a_; }
+
+        const Color& GetB() const { return b_; }
+
+        const PerlinNoise& GetNoise() const { return noise_; }
+
+        uint32_t GetOctaves() const { return octaves_; }
+
+        void SetOctaves(uint32_t octaves) { octaves_ = octaves; }
+
+        virtual Color PatternAt(const Point& point) const override
+        {
+            const auto t = std::clamp((noise_.Fractal(point, octaves_) + Scalar{ 1 }) * Scalar{ 0.5 }, Scalar{ 0 }, Scalar{ 1 });
+            return Color::Add(a_, Color::Multiply(distance_, t));
+        }
+
+    protected:
+        NoisePattern(const Color& a, const Color& b) :
+            a_(a),
+            b_(b),
+            distance_(Color::Subtract(b, a))
+        {
+        }
+
+        NoisePattern(const Color& a, const Color& b, uint32_t seed) :
+            a_(a),
+            b_(b),
+            distance_(Color::Subtract(b, a)),
+            noise_(seed)
+        {
+        }
+
+        NoisePattern(const Color& a, const Color& b, const Matrix44& transform) :
+            Pattern(transform),
+            a_(a),
+            b_(b),
+            distance_(Color::Subtract(b, a))
+        {
+        }
+
+        NoisePattern(const Color& a, const Color& b, uint32_t seed, const Matrix44& transform) :
+            Pattern(transform),
+            a_(a),
+            b_(b),
+            distance_(Color::Subtract(b, a)),
+            noise_(seed)
+        {
+        }
+
+    private:
+        Color       a_;
+        Color       b_;
+        Color       distance_;
+        PerlinNoise noise_;
+        uint32_t    octaves_{ 1u };
+    };
+}
@@ -0,0 +1,233 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "catch2/catch.hpp"
+
+#include "color.h"
+#include "double_util.h"
+#include "matrix44.h"
+#include "noise_pattern.h"
+#include "perlin_noise.h"
+#include "perturbed_pattern.h"
+#include "point.h"
+#include "stripe_pattern.h"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    // Points spread over positive and negative coordinates, including ones on lattice planes.
+    void MakePoints(size_t count, std::vector<rtc::Scalar>& x, std::vector<rtc::Scalar>& y, std::vector<rtc::Scalar>& z)
+    {
+        for (size_t i = 0u; i < count; ++i)
+        {
+            const auto t = static_cast<rtc::Scalar>(i);
+            x.push_back((t * rtc::Scalar{ 0.37 }) - rtc::Scalar{ 20 });
+            y.push_back((t * rtc::Scalar{ -0.61 }) + rtc::Scalar{ 13 });
+            z.push_back(((i % 5u) == 0u) ? rtc::Scalar{ -2 } : (t * rtc::Scalar{ 0.13 }) - rtc::Scalar{ 4.5 });
+        }
+    }
+}
+
+SCENARIO("The fast floor matches floor", "[noise]")
+{
+    GIVEN("Values around and between integers, including negative zero")
+    {
+        const rtc::Scalar values[] = { -0.0, 0.0, 0.5, -0.5, 1.0, -1.0, 2.5, -2.5, 0.99999, -0.99999, 1000.25, -1000.25, 3.0, -3.0 };
+
+        THEN("fast_floor(v) = floor(v)")
+        {
+            for (const auto value : values)
+            {
+                REQUIRE(rtc::FastFloor(value) == std::floor(value));
+                REQUIRE(!std::signbit(rtc::FastFloor(value)) == (value >= 0));
+            }
+        }
+    }
+}
+
+SCENARIO("Perlin noise is zero at lattice points", "[noise]")
+{
+    GIVEN("noise <- perlin_noise(7)")
+    {
+        const auto noise = rtc::PerlinNoise{ 7u };
+
+        THEN("noise(p) = 0 for points with integer coordinates")
+        {
+            REQUIRE(noise.Noise(rtc::Point{ 0.0, 0.0, 0.0 }) == 0.0);
+            REQUIRE(noise.Noise(rtc::Point{ 1.0, -2.0, 3.0 }) == 0.0);
+            REQUIRE(noise.Noise(rtc::Point{ -255.0, 256.0, 17.0 }) == 0.0);
+        }
+    }
+}
+
+SCENARIO("Perlin noise is bounded and continuous", "[noise]")
+{
+    GIVEN("noise <- perlin_noise(0)")
+    {
+        const auto noise = rtc::PerlinNoise{};
+
+        std::vector<rtc::Scalar> x;
+        std::vector<rtc::Scalar> y;
+        std::vector<rtc::Scalar> z;
+        MakePoints(200u, x, y, z);
+
+        THEN("Every value is in [-1, 1], not every value is 0, and a small step makes a small change")
+        {
+            auto nonzero = false;
+
+            for (size_t i = 0u; i < x.size(); ++i)
+            {
+                const auto value = noise.Noise(x[i], y[i], z[i]);
+                const auto step  = noise.Noise(x[i] + rtc::Scalar{ 0.001 }, y[i], z[i]);
+
+                REQUIRE(value >= -1.0);
+                REQUIRE(value <= 1.0);
+                REQUIRE(std::abs(step - value) < 0.01);
+
+                nonzero = nonzero || (std::abs(value) > 0.01);
+            }
+
+            REQUIRE(nonzero);
+        }
+    }
+}
+
+SCENARIO("Evaluating Perlin noise in batches", "[noise]")
+{
+    GIVEN("noise <- perlin_noise(3) and 150 points, more than two blocks")
+    {
+        const auto noise = rtc::PerlinNoise{ 3u };
+
+        std::vector<rtc::Scalar> x;
+        std::vector<rtc::Scalar> y;
+        std::vector<rtc::Scalar> z;
+        MakePoints(150u, x, y, z);
+
+        WHEN("result <- evaluate(noise, points)")
+        {
+            auto result = std::vector<rtc::Scalar>(x.size());
+            noise.Evaluate(x.data(), y.data(), z.data(), result.data(), x.size());
+
+            THEN("Each value equals noise(point)")
+            {
+                for (size_t i = 0u; i < x.size(); ++i)
+                {
+                    REQUIRE(rtc::Equal(result[i], noise.Noise(x[i], y[i], z[i])));
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("The seed selects the noise", "[noise]")
+{
+    GIVEN("a <- perlin_noise(1), b <- perlin_noise(1) and c <- perlin_noise(2)")
+    {
+        const auto a = rtc::PerlinNoise{ 1u };
+        const auto b = rtc::PerlinNoise{ 1u };
+        const auto c = rtc::PerlinNoise{ 2u };
+        const auto p = rtc::Point{ 0.3, 1.7, -2.2 };
+
+        THEN("a and b are the same noise and c is different")
+        {
+            REQUIRE(a.GetSeed() == 1u);
+            REQUIRE(a.Noise(p) == b.Noise(p));
+            REQUIRE(a.Noise(p) != c.Noise(p));
+        }
+    }
+}
+
+SCENARIO("A noise pattern blends between two colors", "[noise]")
+{
+    GIVEN("pattern <- noise_pattern(white, black) with 4 octaves")
+    {
+        const auto white   = rtc::Color{ 1.0, 1.0, 1.0 };
+        const auto black   = rtc::Color{ 0.0, 0.0, 0.0 };
+        const auto pattern = rtc::NoisePattern::Create(white, black);
+        pattern->SetOctaves(4u);
+
+        THEN("The pattern is halfway between the colors at the origin, and is gray everywhere")
+        {
+            REQUIRE(pattern->GetOctaves() == 4u);
+            REQUIRE(rtc::Color::Equal(pattern->PatternAt(rtc::Point{ 0.0, 0.0, 0.0 }), rtc::Color{ 0.5, 0.5, 0.5 }));
+
+            for (uint32_t i = 0u; i < 100u; ++i)
+            {
+                const auto t     = static_cast<rtc::Scalar>(i) * rtc::Scalar{ 0.17 };
+                const auto color = pattern->PatternAt(rtc::Point{ t, -t, t * rtc::Scalar{ 0.5 } });
+
+                REQUIRE(color.GetR() >= 0.0);
+                REQUIRE(color.GetR() <= 1.0);
+                REQUIRE(color.GetR() == color.GetG());
+                REQUIRE(color.GetR() == color.GetB());
+            }
+        }
+    }
+}
+
+SCENARIO("A perturbed pattern with no displacement is the wrapped pattern", "[noise]")
+{
+    GIVEN("stripes <- stripe_pattern(white, black) scaled by 0.5, and pattern <- perturbed_pattern(stripes, 0)")
+    {
+        const auto white   = rtc::Color{ 1.0, 1.0, 1.0 };
+        const auto black   = rtc::Color{ 0.0, 0.0, 0.0 };
+        const auto stripes = rtc::StripePattern::Create(white, black, rtc::Matrix44::Scaling(0.5, 0.5, 0.5));
+        const auto pattern = rtc::PerturbedPattern::Create(stripes, rtc::Scalar{ 0 });
+
+        THEN("pattern_at(pattern, p) = pattern_at(stripes, p transformed by the stripes' transform)")
+        {
+            REQUIRE(rtc::Color::Equal(pattern->PatternAt(rtc::Point{ 0.25, 0.0, 0.0 }), white));
+            REQUIRE(rtc::Color::Equal(pattern->PatternAt(rtc::Point{ 0.75, 0.0, 0.0 }), black));
+            REQUIRE(rtc::Color::Equal(pattern->PatternAt(rtc::Point{ 1.25, 0.0, 0.0 }), white));
+        }
+    }
+}
+
+SCENARIO("A perturbed pattern moves the edges of the wrapped pattern", "[noise]")
+{
+    GIVEN("stripes <- stripe_pattern(white, black) and pattern <- perturbed_pattern(stripes, 0.4)")
+    {
+        const auto white   = rtc::Color{ 1.0, 1.0, 1.0 };
+        const auto black   = rtc::Color{ 0.0, 0.0, 0.0 };
+        const auto stripes = rtc::StripePattern::Create(white, black);
+        const auto pattern = rtc::PerturbedPattern::Create(stripes, rtc::Scalar{ 0.4 });
+
+        THEN("Along a line, the pattern only uses the stripe colors but changes at different points")
+        {
+            auto differences = 0u;
+
+            for (uint32_t i = 0u; i < 200u; ++i)
+            {
+                const auto p         = rtc::Point{ static_cast<rtc::Scalar>(i) * rtc::Scalar{ 0.05 }, 0.3, 0.7 };
+                const auto perturbed = pattern->PatternAt(p);
+
+                REQUIRE((rtc::Color::Equal(perturbed, white) || rtc::Color::Equal(perturbed, black)));
+
+                differences += rtc::Color::Equal(perturbed, stripes->PatternAt(p)) ? 0u : 1u;
+            }
+
+            REQUIRE(differences > 0u);
+        }
+    }
+}
@@ -0,0 +1,96 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cinttypes>
+#include <thread>
+#include <vector>
+
+namespace rtc
+{
+    // Runs work over the bands of rows of an image on several threads. Bands are claimed one at a time, in order
+    // from the top of the image, so threads that finish early take more of them, and the calling thread works
+    // alongside the threads it starts.
+    namespace ParallelBands
+    {
+        // Number of threads that ForEachBand() runs for an image of height rows, where a thread_count of 0 selects
+        // one for each hardware thread. There is at least one thread, and no more threads than bands.
+        inline uint32_t GetWorkerCount(uint32_t height, uint32_t band_height, uint32_t thread_count)
+        {
+            assert((band_height > 0u) && "rtc::ParallelBands requires a band height of at least one row");
+
+            if (thread_count == 0u)
+            {
+                thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+            }
+
+            const auto band_count = (height + band_height - 1u) / band_height;
+
+            return std::max(std::min(thread_count, band_count), 1u);
+        }
+
+        // Call function(worker, first_row, last_row) for each band of band_height rows, where worker is the index
+        // of the calling thread, from 0 for the thread that called ForEachBand() to GetWorkerCount() - 1, so that
+        // it can select per-thread state. When the function returns false, no more bands are started, and false
+        // is returned after the bands in progress have finished.
+        template <typename Function>
+        bool ForEachBand(uint32_t height, uint32_t band_height, uint32_t thread_count, Function function)
+        {
+            const auto worker_count = GetWorkerCount(height, band_height, thread_count);
+            const auto band_count   = (height + band_height - 1u) / band_height;
+
+            auto next_band = std::atomic<uint32_t>{ 0u };
+            auto failed    = std::atomic<bool>{ false };
+
+            const auto run = [&](uint32_t worker) {
+                for (auto band = next_band++; (band < band_count) && !failed; band = next_band++)
+                {
+                    const auto first_row = band * band_height;
+
+                    if (!function(worker, first_row, first_row + std::min(band_height, height - first_row)))
+                    {
+                        failed = true;
+                    }
+                }
+            };
+
+            auto threads = std::vector<std::thread>{};
+            for (uint32_t worker = 1u; worker < worker_count; ++worker)
+            {
+                threads.emplace_back(run, worker);
+            }
+
+            run(0u);
+
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+
+            return !failed;
+        }
+    }
+}
@@ -0,0 +1,97 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "catch2/catch.hpp"
+
+#include "parallel_bands.h"
+
+#include <atomic>
+#include <vector>
+
+SCENARIO("Running a function over bands of rows", "[parallel]")
+{
+    GIVEN("an image of 37 rows in bands of 4 rows")
+    {
+        constexpr uint32_t kHeight     = 37u;
+        constexpr uint32_t kBandHeight = 4u;
+
+        THEN("the number of workers is limited by the number of bands, and is at least one")
+        {
+            REQUIRE(rtc::ParallelBands::GetWorkerCount(kHeight, kBandHeight, 3u) == 3u);
+            REQUIRE(rtc::ParallelBands::GetWorkerCount(kHeight, kBandHeight, 64u) == 10u);
+            REQUIRE(rtc::ParallelBands::GetWorkerCount(0u, kBandHeight, 3u) == 1u);
+            REQUIRE(rtc::ParallelBands::GetWorkerCount(kHeight, kBandHeight, 0u) >= 1u);
+        }
+
+        WHEN("a function counts the rows of each band on 3 threads")
+        {
+            auto rows    = std::vector<std::atomic<uint32_t>>(kHeight);
+            auto workers = std::vector<std::atomic<uint32_t>>(3u);
+            auto invalid = std::atomic<bool>{ false };
+
+            const auto result = rtc::ParallelBands::ForEachBand(kHeight, kBandHeight, 3u, [&](uint32_t worker, uint32_t first_row, uint32_t last_row) {
+                if ((worker >= 3u) || ((first_row % kBandHeight) != 0u) || (last_row > kHeight) || ((last_row - first_row) > kBandHeight))
+                {
+                    invalid = true;
+                    return true;
+                }
+
+                ++workers[worker];
+
+                for (auto y = first_row; y < last_row; ++y)
+                {
+                    ++rows[y];
+                }
+
+                return true;
+            });
+
+            THEN("every row is in exactly one band")
+            {
+                REQUIRE(result);
+                REQUIRE(!invalid);
+                REQUIRE((workers[0] + workers[1] + workers[2]) == 10u);
+
+                for (const auto& count : rows)
+                {
+                    REQUIRE(count == 1u);
+                }
+            }
+        }
+
+        WHEN("the function fails for the first band on one thread")
+        {
+            auto bands = 0u;
+
+            const auto result = rtc::ParallelBands::ForEachBand(kHeight, kBandHeight, 1u, [&](uint32_t, uint32_t first_row, uint32_t) {
+                ++bands;
+                return first_row != 0u;
+            });
+
+            THEN("no more bands are started and the run fails")
+            {
+                REQUIRE(!result);
+                REQUIRE(bands == 1u);
+            }
+        }
+    }
+}
@@ -22,10 +22,12 @@
 
 #pragma once
 
+#include "affine34.h"
 #include "color.h"
 #include "matrix44.h"
 #include "point.h"
 
+#include <cinttypes>
 #include <memory>
 
 namespace rtc
@@ -35,50 +37,46 @@ namespace rtc
     public:
         virtual ~Pattern() = default;
 
-        const Matrix44& GetTransform() const { return transform_; }
+        Matrix44 GetTransform() const { return transform_.ToMatrix44(); }
+
+        const Affine34& GetInverseTransform() const { return inverse_transform_; }
 
         void SetTransform(const Matrix44& transform)
         {
             transform_ = transform;
-            inverse_transform_ = Matrix44::Inverse(transform_);
+            inverse_transform_ = Affine34::Inverse(transform_);
+            ++version_;
         }
 
-        void SetTransform(Matrix44&& transform)
-        {
-            transform_ = std::move(transform);
-            inverse_transform_ = Matrix44::Inverse(transform_);
-        }
+        // Incremented each time the transform changes, so that shapes caching a transform combined with
+        // the pattern's inverse transform can detect that it is stale.
+        uint64_t GetVersion() const { return version_; }
 
         virtual Color PatternAt(const Point& point) const = 0;
 
-        Color PatternAtObject(const Matrix44& object_inverse_transform, const Point& world_point) const
+        Color PatternAtObject(const Affine34& object_inverse_transform, const Point& world_point) const
         {
-            const auto object_point  = Matrix44::Multiply(object_inverse_transform, world_point);
-            const auto pattern_point = Matrix44::Multiply(inverse_transform_, object_point);
+            const auto object_point  = Affine34::TransformPoint(object_inverse_transform, world_point);
+            const auto pattern_point = Affine34::TransformPoint(inverse_transform_, object_point);
             return PatternAt(pattern_point);
         }
 
     protected:
         Pattern() :
-            transform_(Matrix44::Identity()),
-            inverse_transform_(Matrix44::Identity())
+            transform_(Affine34::Identity()),
+            inverse_transform_(Affine34::Identity())
         {
         }
 
         Pattern(const Matrix44& transform) :
             transform_(transform),
-            inverse_transform_(Matrix44::Inverse(transform))
-        {
-        }
-
-        Pattern(Matrix44&& transform) :
-            transform_(std::move(transform))
+            inverse_transform_(Affine34::Inverse(transform_))
         {
-            inverse_transform_ = Matrix44::Inverse(transform_);
         }
 
     private:
-        Matrix44 transform_;
-        Matrix44 inverse_transform_;
+        Affine34 transform_;
+        Affine34 inverse_transform_;
+        uint64_t version_{ 0u };
     };
 }
@@ -0,0 +1,227 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "perlin_noise.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace rtc
+{
+    namespace
+    {
+        // Hash values are stored in integers of the same width as the scalar type, so that selections
+        // between scalars based on the hash can be vectorized without conversions.
+        using Hash = std::conditional<sizeof(Scalar) == sizeof(uint64_t), uint64_t, uint32_t>::type;
+
+        // SplitMix64, used to shuffle the permutation.
+        uint64_t Next(uint64_t& state)
+        {
+            state += 0x9e3779b97f4a7c15ull;
+            auto value = state;
+            value      = (value ^ (value >> 30u)) * 0xbf58476d1ce4e5b9ull;
+            value      = (value ^ (value >> 27u)) * 0x94d049bb133111ebull;
+            return value ^ (value >> 31u);
+        }
+
+        // Lattice coordinate for the permutation, from a floored coordinate.
+        uint32_t Cell(Scalar value)
+        {
+            return static_cast<uint32_t>(static_cast<int64_t>(value)) & 255u;
+        }
+
+        // Quintic fade curve 6t^5 - 15t^4 + 10t^3, which has zero first and second derivatives at 0 and 1.
+        Scalar Fade(Scalar t)
+        {
+            return t * t * t * (t * (t * Scalar{ 6 } - Scalar{ 15 }) + Scalar{ 10 });
+        }
+
+        Scalar Lerp(Scalar t, Scalar a, Scalar b)
+        {
+            return a + t * (b - a);
+        }
+
+        // Dot product of the offset from a lattice corner with one of the 12 gradients (1, 1, 0), (1, 0, 1),
+        // (0, 1, 1) and their negations, selected by the corner's hash. Four of the 16 hash values repeat
+        // gradients so the selection is a bit mask.
+        Scalar Gradient(Hash hash, Scalar x, Scalar y, Scalar z)
+        {
+            const auto h = hash & Hash{ 15 };
+            const auto u = (h < Hash{ 8 }) ? x : y;
+            const auto v = (h < Hash{ 4 }) ? y : (((h == Hash{ 12 }) || (h == Hash{ 14 })) ? x : z);
+            return (((h & Hash{ 1 }) == Hash{ 0 }) ? u : -u) + (((h & Hash{ 2 }) == Hash{ 0 }) ? v : -v);
+        }
+    }
+
+    PerlinNoise::PerlinNoise(uint32_t seed) :
+        seed_(seed)
+    {
+        for (uint32_t i = 0u; i < 256u; ++i)
+        {
+            permutation_[i] = static_cast<uint8_t>(i);
+        }
+
+        auto state = static_cast<uint64_t>(seed);
+        for (uint32_t i = 255u; i > 0u; --i)
+        {
+            std::swap(permutation_[i], permutation_[Next(state) % (i + 1u)]);
+        }
+
+        std::copy(permutation_, permutation_ + 256, permutation_ + 256);
+    }
+
+    Scalar PerlinNoise::Noise(Scalar x, Scalar y, Scalar z) const
+    {
+        // Find the unit cube containing the point, and the point's position within it.
+        const auto floor_x = FastFloor(x);
+        const auto floor_y = FastFloor(y);
+        const auto floor_z = FastFloor(z);
+
+        x -= floor_x;
+        y -= floor_y;
+        z -= floor_z;
+
+        // Hash the coordinates of the cube's corners.
+        const auto a  = permutation_[Cell(floor_x)] + Cell(floor_y);
+        const auto aa = permutation_[a] + Cell(floor_z);
+        const auto ab = permutation_[a + 1u] + Cell(floor_z);
+        const auto b  = permutation_[Cell(floor_x) + 1u] + Cell(floor_y);
+        const auto ba = permutation_[b] + Cell(floor_z);
+        const auto bb = permutation_[b + 1u] + Cell(floor_z);
+
+        // Blend the gradients of the corners.
+        const auto u = Fade(x);
+        const auto v = Fade(y);
+        const auto w = Fade(z);
+
+        const auto x1 = x - Scalar{ 1 };
+        const auto y1 = y - Scalar{ 1 };
+        const auto z1 = z - Scalar{ 1 };
+
+        return Lerp(
+            w,
+            Lerp(v,
+                 Lerp(u, Gradient(permutation_[aa], x, y, z), Gradient(permutation_[ba], x1, y, z)),
+                 Lerp(u, Gradient(permutation_[ab], x, y1, z), Gradient(permutation_[bb], x1, y1, z))),
+            Lerp(v,
+                 Lerp(u, Gradient(permutation_[aa + 1], x, y, z1), Gradient(permutation_[ba + 1], x1, y, z1)),
+                 Lerp(u, Gradient(permutation_[ab + 1], x, y1, z1), Gradient(permutation_[bb + 1], x1, y1, z1))));
+    }
+
+    void PerlinNoise::Evaluate(const Scalar* x, const Scalar* y, const Scalar* z, Scalar* result, size_t count) const
+    {
+        for (size_t i = 0u; i < count; i += kBlockSize)
+        {
+            EvaluateBlock(x + i, y + i, z + i, result + i, std::min(kBlockSize, count - i));
+        }
+    }
+
+    void PerlinNoise::EvaluateBlock(const Scalar* x, const Scalar* y, const Scalar* z, Scalar* result, size_t count) const
+    {
+        Scalar floor_x[kBlockSize];
+        Scalar floor_y[kBlockSize];
+        Scalar floor_z[kBlockSize];
+        Scalar fx[kBlockSize];
+        Scalar fy[kBlockSize];
+        Scalar fz[kBlockSize];
+
+        for (size_t i = 0u; i < count; ++i)
+        {
+            floor_x[i] = FastFloor(x[i]);
+            floor_y[i] = FastFloor(y[i]);
+            floor_z[i] = FastFloor(z[i]);
+            fx[i]      = x[i] - floor_x[i];
+            fy[i]      = y[i] - floor_y[i];
+            fz[i]      = z[i] - floor_z[i];
+        }
+
+        // Corner hashes, indexed by the corner's offsets in x, y and z as the bits 1, 2 and 4.
+        Hash hashes[8][kBlockSize];
+
+        for (size_t i = 0u; i < count; ++i)
+        {
+            const auto cx = Cell(floor_x[i]);
+            const auto cy = Cell(floor_y[i]);
+            const auto cz = Cell(floor_z[i]);
+            const auto a  = permutation_[cx] + cy;
+            const auto aa = permutation_[a] + cz;
+            const auto ab = permutation_[a + 1u] + cz;
+            const auto b  = permutation_[cx + 1u] + cy;
+            const auto ba = permutation_[b] + cz;
+            const auto bb = permutation_[b + 1u] + cz;
+
+            hashes[0][i] = permutation_[aa];
+            hashes[1][i] = permutation_[ba];
+            hashes[2][i] = permutation_[ab];
+            hashes[3][i] = permutation_[bb];
+            hashes[4][i] = permutation_[aa + 1u];
+            hashes[5][i] = permutation_[ba + 1u];
+            hashes[6][i] = permutation_[ab + 1u];
+            hashes[7][i] = permutation_[bb + 1u];
+        }
+
+        for (size_t i = 0u; i < count; ++i)
+        {
+            const auto x0 = fx[i];
+            const auto y0 = fy[i];
+            const auto z0 = fz[i];
+            const auto x1 = x0 - Scalar{ 1 };
+            const auto y1 = y0 - Scalar{ 1 };
+            const auto z1 = z0 - Scalar{ 1 };
+
+            const auto u = Fade(x0);
+            const auto v = Fade(y0);
+            const auto w = Fade(z0);
+
+            result[i] = Lerp(
+                w,
+                Lerp(v,
+                     Lerp(u, Gradient(hashes[0][i], x0, y0, z0), Gradient(hashes[1][i], x1, y0, z0)),
+                     Lerp(u, Gradient(hashes[2][i], x0, y1, z0), Gradient(hashes[3][i], x1, y1, z0))),
+                Lerp(v,
+                     Lerp(u, Gradient(hashes[4][i], x0, y0, z1), Gradient(hashes[5][i], x1, y0, z1)),
+                     Lerp(u, Gradient(hashes[6][i], x0, y1, z1), Gradient(hashes[7][i], x1, y1, z1))));
+        }
+    }
+
+    Scalar PerlinNoise::Fractal(const Point& point, uint32_t octaves) const
+    {
+        auto x         = point.GetX();
+        auto y         = point.GetY();
+        auto z         = point.GetZ();
+        auto sum       = Scalar{ 0 };
+        auto amplitude = Scalar{ 1 };
+        auto total     = Scalar{ 0 };
+
+        for (uint32_t octave = 0u; octave < std::max(octaves, 1u); ++octave)
+        {
+            sum += Noise(x, y, z) * amplitude;
+            total += amplitude;
+            amplitude *= Scalar{ 0.5 };
+            x *= Scalar{ 2 };
+            y *= Scalar{ 2 };
+            z *= Scalar{ 2 };
+        }
+
+        return sum / total;
+    }
+}
@@ -0,0 +1,102 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#pragma once
+
+#include "affine34.h"
+#include "double_util.h"
+#include "matrix44.h"
+#include "pattern.h"
+#include "perlin_noise.h"
+#include "point.h"
+
+#include <cassert>
+#include <memory>
+
+namespace rtc
+{
+    // Jitter the points passed to another pattern by a displacement from Perlin noise, so that stripes,
+    // rings and checkers become irregular. The three components of the displacement are noise values at
+    // offsets from the point. The wrapped pattern's own transform is applied to the displaced point.
+    class PerturbedPattern : public Pattern
+    {
+    public:
+        template <typename... Args>
+        static std::shared_ptr<PerturbedPattern> Create(Args... args)
+        {
+            return std::shared_ptr<PerturbedPattern>(new PerturbedPattern(args...));
+        }
+
+    public:
+        const std::shared_ptr<const Pattern>& GetPattern() const { return pattern_; }
+
+        Scalar GetScale() const { return scale_; }
+
+        const PerlinNoise& GetNoise() const { return noise_; }
+
+        virtual Color PatternAt(const Point& point) const override
+        {
+            // Offsets between the samples for each component, chosen so the components are uncorrelated.
+            // Three points are too few for the batched kernel to pay off, so the noise is evaluated separately.
+            const auto x = point.GetX();
+            const auto y = point.GetY();
+            const auto z = point.GetZ();
+
+            const auto dx = noise_.Noise(x, y, z);
+            const auto dy = noise_.Noise(x + Scalar{ 31.416 }, y - Scalar{ 12.793 }, z + Scalar{ 57.648 });
+            const auto dz = noise_.Noise(x - Scalar{ 47.853 }, y + Scalar{ 73.156 }, z - Scalar{ 27.719 });
+
+            const auto perturbed = Point{ x + (dx * scale_), y + (dy * scale_), z + (dz * scale_) };
+
+            return pattern_->PatternAt(Affine34::TransformPoint(pattern_->GetInverseTransform(), perturbed));
+        }
+
+    protected:
+        PerturbedPattern(const std::shared_ptr<const Pattern>& pattern, Scalar scale) :
+            pattern_(pattern),
+            scale_(scale)
+        {
+            assert(pattern_ && "rtc::PerturbedPattern was initialized with an invalid pattern");
+        }
+
+        PerturbedPattern(const std::shared_ptr<const Pattern>& pattern, Scalar scale, uint32_t seed) :
+            pattern_(pattern),
+            scale_(scale),
+            noise_(seed)
+        {
+            assert(pattern_ && "rtc::PerturbedPattern was initialized with an invalid pattern");
+        }
+
+        PerturbedPattern(const std::shared_ptr<const Pattern>& pattern, Scalar scale, const Matrix44& transform) :
+            Pattern(transform),
+            pattern_(pattern),
+            scale_(scale)
+        {
+            assert(pattern_ && "rtc::PerturbedPattern was initialized with an invalid pattern");
+        }
+
+    private:
+        std::shared_ptr<const Pattern> pattern_;  ///< Pattern evaluated at the perturbed point.
+        Scalar                         scale_;    ///< Maximum displacement of a point along each axis.
+        PerlinNoise                    noise_;    ///< Noise providing the displacement.
+    };
+}
@@ -0,0 +1,106 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "pfm_writer.h"
+
+#include "color.h"
+#include "file_output_stream.h"
+
+#include <bit>
+#include <cstring>
+#include <vector>
+
+namespace rtc
+{
+    namespace PfmWriter
+    {
+        namespace
+        {
+            constexpr auto kChannels = 3u;
+        }
+
+        bool WriteFile(const std::string& filename, const Canvas& canvas)
+        {
+            auto stream = FileOutputStream{ filename };
+
+            if (stream.IsValid())
+            {
+                return WriteStream(&stream, canvas);
+            }
+
+            return false;
+        }
+
+        bool WriteStream(OutputStream* stream, const Canvas& canvas)
+        {
+            if (stream == nullptr)
+            {
+                return false;
+            }
+
+            const auto width  = canvas.GetWidth();
+            const auto height = canvas.GetHeight();
+            const auto header = Header(width, height);
+
+            // Colors hold a fourth component, and may be double precision, so their pixels are packed into the
+            // output buffer. Float canvases already hold packed rows, which are copied in place.
+            const auto row_size = static_cast<size_t>(width) * kChannels * sizeof(float);
+
+            auto buffer = std::vector<char>(header.length() + (row_size * height));
+            std::memcpy(buffer.data(), header.data(), header.length());
+
+            auto* output = buffer.data() + header.length();
+
+            for (auto y = height; y-- > 0u;)
+            {
+                if (const auto* row = canvas.GetFloatRow(y))
+                {
+                    std::memcpy(output, row, row_size);
+                    output += row_size;
+                    continue;
+                }
+
+                for (uint32_t x = 0u; x < width; ++x)
+                {
+                    const auto& pixel = canvas.PixelAt(x, y);
+                    const float rgb[kChannels] = { static_cast<float>(pixel.GetR()), static_cast<float>(pixel.GetG()), static_cast<float>(pixel.GetB()) };
+
+                    std::memcpy(output, rgb, sizeof(rgb));
+                    output += sizeof(rgb);
+                }
+            }
+
+            return stream->Write(buffer.data(), buffer.size());
+        }
+
+        std::string Header(uint32_t width, uint32_t height)
+        {
+            // The sign of the scale factor gives the byte order: negative for little endian.
+            auto header = std::string{ "PF\n" };
+            header += std::to_string(width);
+            header += ' ';
+            header += std::to_string(height);
+            header += (std::endian::native == std::endian::little) ? "\n-1.0\n" : "\n1.0\n";
+            return header;
+        }
+    }
+}
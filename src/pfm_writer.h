@@ -0,0 +1,45 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#pragma once
+
+#include "canvas.h"
+#include "output_stream.h"
+
+#include <string>
+
+namespace rtc
+{
+    namespace PfmWriter
+    {
+        // Write the canvas as a color PFM (portable float map) image, preserving the linear color values
+        // without clamping or quantizing them. The values are written as 32-bit floats in the host byte order,
+        // with the rows from bottom to top as the format requires. The header and pixels are encoded into one
+        // buffer and written with a single write.
+        bool WriteFile(const std::string& filename, const Canvas& canvas);
+
+        bool WriteStream(OutputStream* stream, const Canvas& canvas);
+
+        // The header for an image of the size, ending with the scale line that gives the host byte order.
+        std::string Header(uint32_t width, uint32_t height);
+    };
+}
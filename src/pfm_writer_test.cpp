@@ -0,0 +1,146 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "catch2/catch.hpp"
+
+#include "canvas.h"
+#include "color.h"
+#include "output_stream.h"
+#include "pfm_writer.h"
+
+#include <bit>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Memory stream that counts the writes made to it.
+    class CountingOutputStream : public rtc::OutputStream
+    {
+    public:
+        virtual bool IsValid() override { return true; }
+
+        virtual bool Fail() override { return false; }
+
+        virtual bool Write(const char* data, size_t size) override
+        {
+            data_.append(data, size);
+            ++write_count_;
+            return true;
+        }
+
+        const std::string& GetData() const { return data_; }
+
+        uint32_t GetWriteCount() const { return write_count_; }
+
+    private:
+        std::string data_;
+        uint32_t    write_count_{ 0u };
+    };
+
+    float FloatAt(const std::string& data, size_t offset)
+    {
+        auto value = 0.0f;
+        std::memcpy(&value, data.data() + offset, sizeof(value));
+        return value;
+    }
+}
+
+SCENARIO("Writing a canvas as a PFM image", "[pfm]")
+{
+    GIVEN("c <- canvas(3, 2) with values outside the displayable range")
+    {
+        auto c = rtc::Canvas{ 3u, 2u };
+        c.WritePixel(0u, 0u, rtc::Color{ static_cast<rtc::Scalar>(1.5), static_cast<rtc::Scalar>(0.25), static_cast<rtc::Scalar>(-0.5) });
+        c.WritePixel(2u, 0u, rtc::Color{ static_cast<rtc::Scalar>(0.125), static_cast<rtc::Scalar>(1000.0), static_cast<rtc::Scalar>(0.0) });
+        c.WritePixel(1u, 1u, rtc::Color{ static_cast<rtc::Scalar>(2.0), static_cast<rtc::Scalar>(3.0), static_cast<rtc::Scalar>(4.0) });
+
+        WHEN("stream <- pfm_writer(c)")
+        {
+            auto stream = CountingOutputStream{};
+            REQUIRE(rtc::PfmWriter::WriteStream(&stream, c));
+
+            const auto& data   = stream.GetData();
+            const auto  header = std::string{ "PF\n3 2\n" } + ((std::endian::native == std::endian::little) ? "-1.0\n" : "1.0\n");
+
+            THEN("the image is written with a single write")
+            {
+                REQUIRE(stream.GetWriteCount() == 1u);
+                REQUIRE(data.size() == (header.size() + (3u * 2u * 3u * sizeof(float))));
+            }
+
+            THEN("the header gives the size and the host byte order")
+            {
+                REQUIRE(data.compare(0u, header.size(), header) == 0);
+            }
+
+            THEN("the rows are written from bottom to top without clamping")
+            {
+                // The bottom row comes first, so the top row starts after 3 pixels.
+                const auto top    = header.size() + (3u * 3u * sizeof(float));
+                const auto bottom = header.size();
+
+                REQUIRE(FloatAt(data, top) == 1.5f);
+                REQUIRE(FloatAt(data, top + 4u) == 0.25f);
+                REQUIRE(FloatAt(data, top + 8u) == -0.5f);
+                REQUIRE(FloatAt(data, top + 24u) == 0.125f);
+                REQUIRE(FloatAt(data, top + 28u) == 1000.0f);
+                REQUIRE(FloatAt(data, bottom + 12u) == 2.0f);
+                REQUIRE(FloatAt(data, bottom + 16u) == 3.0f);
+                REQUIRE(FloatAt(data, bottom + 20u) == 4.0f);
+                REQUIRE(FloatAt(data, bottom) == 0.0f);
+            }
+        }
+
+        WHEN("f <- c copied to a float canvas and stream <- pfm_writer(f)")
+        {
+            auto f = rtc::Canvas{ 3u, 2u, rtc::Canvas::PixelFormat::kFloat };
+            for (uint32_t y = 0u; y < 2u; ++y)
+            {
+                for (uint32_t x = 0u; x < 3u; ++x)
+                {
+                    f.WritePixel(x, y, c.PixelAt(x, y));
+                }
+            }
+
+            auto color_stream = CountingOutputStream{};
+            auto float_stream = CountingOutputStream{};
+            REQUIRE(rtc::PfmWriter::WriteStream(&color_stream, c));
+            REQUIRE(rtc::PfmWriter::WriteStream(&float_stream, f));
+
+            THEN("the image matches the image written from c")
+            {
+                REQUIRE(float_stream.GetWriteCount() == 1u);
+                REQUIRE(float_stream.GetData() == color_stream.GetData());
+            }
+        }
+    }
+
+    GIVEN("no stream")
+    {
+        THEN("the canvas is not written")
+        {
+            REQUIRE_FALSE(rtc::PfmWriter::WriteStream(nullptr, rtc::Canvas{ 1u, 1u }));
+        }
+    }
+}
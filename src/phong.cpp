@@ -24,60 +24,195 @@
 
 #include "pattern.h"
 
+#include <cassert>
 #include <cmath>
 
 namespace rtc
 {
     namespace Phong
     {
-        Color Lighting(const Material& material, const Matrix44& object_inverse_transform, const PointLight& light, const Point& point, const Vector& eyev, const Vector& normalv, bool in_shadow)
+        namespace
         {
-            // Combine the surface color with the light's color/intensity.
-            const auto& pattern         = material.GetPattern();
-            const auto  effective_color = Color::HadamardProduct(pattern ? pattern->PatternAtObject(object_inverse_transform, point) : material.GetColor(), light.GetIntensity());
+            Color ComputeDiffuseSpecular(const Material& material, const Color& effective_color, const PointLight& light, const Point& point, const Vector& eyev, const Vector& normalv)
+            {
+                // Find the direction to the light source.
+                auto lightv = Vector{ Vector::Subtract(light.GetPosition(), point) };
+                lightv.Normalize();
 
-            // Compute the ambient contribution.
-            auto ambient = Color{ Color::Multiply(effective_color, material.GetAmbient()) };
+                // The light_dot_normal value represents the cosine of the angle between the
+                // light vector and the normal vector.  A negative number means the light is
+                // on the other side of the surface.
+                const auto light_dot_normal = Vector::Dot(lightv, normalv);
 
-            if (in_shadow)
-            {
-                return ambient;
-            }
+                auto diffuse  = Color{};
+                auto specular = Color{};
 
-            // Find the direction to the light source.
-            auto lightv = Vector{ Vector::Subtract(light.GetPosition(), point) };
-            lightv.Normalize();
+                if (light_dot_normal >= 0)
+                {
+                    // Compute the diffuse contribution.
+                    diffuse = Color::Multiply(effective_color, (material.GetDiffuse() * light_dot_normal));
+
+                    // The reflect_dot_eye value represents the cosine of the angle between the
+                    // reflection vector and the eye vector.  A negative number means the light
+                    // reflects away from the eye.
+                    const auto reflectv        = Vector::Reflect(Vector::Negate(lightv), normalv);
+                    const auto reflect_dot_eye = Vector::Dot(reflectv, eyev);
+
+                    if (reflect_dot_eye > 0)
+                    {
+                        // Compute the specular contribution.
+                        const auto factor = material.IsFastSpecular() ? FastPow(reflect_dot_eye, material.GetShininess()) : std::pow(reflect_dot_eye, material.GetShininess());
+
+                        specular = Vector::Multiply(light.GetIntensity(), (material.GetSpecular() * factor));
+                    }
+                }
+
+                return Color::Add(diffuse, specular);
+            }
 
-            // The light_dot_normal value represents the cosine of the angle between the
-            // light vector and the normal vector.  A negative number means the light is
-            // on the other side of the surface.
-            const auto light_dot_normal = Vector::Dot(lightv, normalv);
+            // Fraction of a light that reaches the surface, from a shadow flag or a visibility value.
+            inline Scalar Visibility(uint8_t in_shadow) { return (in_shadow == 0u) ? Scalar{ 1 } : Scalar{ 0 }; }
 
-            auto diffuse  = Color{};
-            auto specular = Color{};
+            inline Scalar Visibility(Scalar visibility) { return visibility; }
 
-            if (light_dot_normal >= 0)
+            // Sum the diffuse and specular intensity of the lights in the batch, before they are scaled by
+            // the surface color and material.
+            template <bool kFastSpecular, typename VisibilityType>
+            void AccumulateLights(const LightBatch& lights, const VisibilityType* visibility, Scalar shininess, const Point& point, const Vector& eyev, const Vector& normalv, Color& diffuse, Color& specular)
             {
-                // Compute the diffuse contribution.
-                diffuse = Color::Multiply(effective_color, (material.GetDiffuse() * light_dot_normal));
+                const auto px = point.GetX();
+                const auto py = point.GetY();
+                const auto pz = point.GetZ();
+                const auto nx = normalv.GetX();
+                const auto ny = normalv.GetY();
+                const auto nz = normalv.GetZ();
+                const auto ex = eyev.GetX();
+                const auto ey = eyev.GetY();
+                const auto ez = eyev.GetZ();
 
-                // The reflect_dot_eye value represents the cosine of the angle between the
-                // reflection vector and the eye vector.  A negative number means the light
-                // reflects away from the eye.
-                const auto reflectv        = Vector::Reflect(Vector::Negate(lightv), normalv);
-                const auto reflect_dot_eye = Vector::Dot(reflectv, eyev);
+                // With the reflection vector r = 2(l.n)n - l, the cosine between the reflection and the eye
+                // is 2(l.n)(n.e) - l.e, so the reflection vector does not need to be computed per light.
+                const auto normal_dot_eye = (nx * ex) + (ny * ey) + (nz * ez);
 
-                if (reflect_dot_eye > 0)
+                const auto count = lights.GetCount();
+                const auto x     = lights.GetX();
+                const auto y     = lights.GetY();
+                const auto z     = lights.GetZ();
+                const auto r     = lights.GetR();
+                const auto g     = lights.GetG();
+                const auto b     = lights.GetB();
+
+                auto diffuse_r  = Scalar{ 0 };
+                auto diffuse_g  = Scalar{ 0 };
+                auto diffuse_b  = Scalar{ 0 };
+                auto specular_r = Scalar{ 0 };
+                auto specular_g = Scalar{ 0 };
+                auto specular_b = Scalar{ 0 };
+
+                for (size_t i = 0u; i < count; ++i)
                 {
-                    // Compute the specular contribution.
-                    const auto factor = pow(reflect_dot_eye, material.GetShininess());
+                    const auto lx      = x[i] - px;
+                    const auto ly      = y[i] - py;
+                    const auto lz      = z[i] - pz;
+                    const auto inverse = Scalar{ 1 } / std::sqrt((lx * lx) + (ly * ly) + (lz * lz));
+
+                    const auto light_dot_normal = ((lx * nx) + (ly * ny) + (lz * nz)) * inverse;
+                    const auto light_dot_eye    = ((lx * ex) + (ly * ey) + (lz * ez)) * inverse;
+                    const auto reflect_dot_eye  = (Scalar{ 2 } * light_dot_normal * normal_dot_eye) - light_dot_eye;
+
+                    const auto scale    = Visibility(visibility[i]);
+                    const auto lit      = (scale > 0) && (light_dot_normal >= 0);
+                    const auto specular = lit && (reflect_dot_eye > 0);
 
-                    specular = Vector::Multiply(light.GetIntensity(), (material.GetSpecular() * factor));
+                    // Keep the exponent's base in its domain for lights that do not contribute.
+                    const auto base   = specular ? reflect_dot_eye : Scalar{ 1 };
+                    const auto factor = kFastSpecular ? FastPow(base, shininess) : std::pow(base, shininess);
+
+                    const auto diffuse_factor  = lit ? (light_dot_normal * scale) : Scalar{ 0 };
+                    const auto specular_factor = specular ? (factor * scale) : Scalar{ 0 };
+
+                    diffuse_r += r[i] * diffuse_factor;
+                    diffuse_g += g[i] * diffuse_factor;
+                    diffuse_b += b[i] * diffuse_factor;
+                    specular_r += r[i] * specular_factor;
+                    specular_g += g[i] * specular_factor;
+                    specular_b += b[i] * specular_factor;
                 }
+
+                diffuse  = Color{ diffuse_r, diffuse_g, diffuse_b };
+                specular = Color{ specular_r, specular_g, specular_b };
+            }
+
+            // Batched lighting shared by the shadow flag and visibility forms of Lighting().
+            template <typename VisibilityType>
+            Color LightingBatch(const Material& material, const Color& surface_color, const LightBatch& lights, const VisibilityType* visibility, const Point& point, const Vector& eyev, const Vector& normalv)
+            {
+                auto diffuse  = Color{};
+                auto specular = Color{};
+
+                if (material.IsFastSpecular())
+                {
+                    AccumulateLights<true>(lights, visibility, material.GetShininess(), point, eyev, normalv, diffuse, specular);
+                }
+                else
+                {
+                    AccumulateLights<false>(lights, visibility, material.GetShininess(), point, eyev, normalv, diffuse, specular);
+                }
+
+                // Every light contributes ambient light, whether it is shadowed or not.
+                const auto ambient = Color::Multiply(Color::HadamardProduct(surface_color, lights.GetTotalIntensity()), material.GetAmbient());
+
+                return Color::Add(
+                    ambient,
+                    Color::Multiply(Color::HadamardProduct(surface_color, diffuse), material.GetDiffuse()),
+                    Color::Multiply(specular, material.GetSpecular()));
+            }
+        }
+
+        Color Lighting(const Material& material, const Affine34& object_inverse_transform, const PointLight& light, const Point& point, const Vector& eyev, const Vector& normalv, bool in_shadow)
+        {
+            const auto& pattern       = material.GetPattern();
+            const auto  surface_color = pattern ? pattern->PatternAtObject(object_inverse_transform, point) : material.GetColor();
+            return Lighting(material, surface_color, light, point, eyev, normalv, in_shadow);
+        }
+
+        Color Lighting(const Material& material, const Color& surface_color, const PointLight& light, const Point& point, const Vector& eyev, const Vector& normalv, bool in_shadow)
+        {
+            // Combine the surface color with the light's color/intensity.
+            const auto effective_color = Color::HadamardProduct(surface_color, light.GetIntensity());
+
+            // Compute the ambient contribution.
+            auto ambient = Color{ Color::Multiply(effective_color, material.GetAmbient()) };
+
+            if (in_shadow)
+            {
+                return ambient;
             }
 
             // Add the three contributions together to get the final shading.
-            return Color::Add(ambient, diffuse, specular);
+            return Color::Add(ambient, ComputeDiffuseSpecular(material, effective_color, light, point, eyev, normalv));
+        }
+
+        Color Lighting(const Material& material, const Color& surface_color, const LightBatch& lights, const std::vector<uint8_t>& in_shadow, const Point& point, const Vector& eyev, const Vector& normalv)
+        {
+            assert((in_shadow.size() == lights.GetCount()) && "rtc::Phong::Lighting requires a shadow flag for each light");
+            return LightingBatch(material, surface_color, lights, in_shadow.data(), point, eyev, normalv);
+        }
+
+        Color Lighting(const Material& material, const Color& surface_color, const LightBatch& lights, const std::vector<Scalar>& visibility, const Point& point, const Vector& eyev, const Vector& normalv)
+        {
+            assert((visibility.size() == lights.GetCount()) && "rtc::Phong::Lighting requires a visibility value for each light");
+            return LightingBatch(material, surface_color, lights, visibility.data(), point, eyev, normalv);
+        }
+
+        Color Ambient(const Material& material, const Color& surface_color, const Color& intensity)
+        {
+            return Color::Multiply(Color::HadamardProduct(surface_color, intensity), material.GetAmbient());
+        }
+
+        Color DiffuseSpecular(const Material& material, const Color& surface_color, const PointLight& light, const Point& point, const Vector& eyev, const Vector& normalv)
+        {
+            return ComputeDiffuseSpecular(material, Color::HadamardProduct(surface_color, light.GetIntensity()), light, point, eyev, normalv);
         }
     }
 }
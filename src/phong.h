@@ -22,17 +22,45 @@
 
 #pragma once
 
+#include "affine34.h"
 #include "color.h"
+#include "light_batch.h"
 #include "material.h"
 #include "matrix44.h"
 #include "point.h"
 #include "point_light.h"
 #include "vector.h"
 
+#include <cinttypes>
+#include <vector>
+
 namespace rtc
 {
     namespace Phong
     {
-        Color Lighting(const Material& material, const Matrix44& object_inverse_transform, const PointLight& light, const Point& point, const Vector& eye, const Vector& normal, bool in_shadow);
+        Color Lighting(const Material& material, const Affine34& object_inverse_transform, const PointLight& light, const Point& point, const Vector& eye, const Vector& normal, bool in_shadow);
+
+        // Lighting for a surface color that has already been evaluated from the material's pattern or color,
+        // so that a pattern is evaluated once per hit instead of once per light.
+        Color Lighting(const Material& material, const Color& surface_color, const PointLight& light, const Point& point, const Vector& eye, const Vector& normal, bool in_shadow);
+
+        // Lighting from every light in a batch, where in_shadow holds a non-zero flag for each light that is
+        // shadowed. Terms that depend only on the surface are computed once, and the lights are evaluated in
+        // a branch free loop over the batch's arrays. The result matches the sum of Lighting() over the
+        // lights to within rounding error; a material that selects fast specular adds the FastPow() error
+        // to the specular term.
+        Color Lighting(const Material& material, const Color& surface_color, const LightBatch& lights, const std::vector<uint8_t>& in_shadow, const Point& point, const Vector& eye, const Vector& normal);
+
+        // Lighting from every light in a batch, where visibility holds the fraction of each light that reaches
+        // the point, e.g. after passing through transparent occluders. Diffuse and specular light from each
+        // light is scaled by its visibility; ambient light is not.
+        Color Lighting(const Material& material, const Color& surface_color, const LightBatch& lights, const std::vector<Scalar>& visibility, const Point& point, const Vector& eye, const Vector& normal);
+
+        // Ambient contribution of a light with the specified intensity. The ambient term is linear in the
+        // intensity, so the ambient light from a group of lights can be computed from their total intensity.
+        Color Ambient(const Material& material, const Color& surface_color, const Color& intensity);
+
+        // Diffuse and specular contribution of an unshadowed light.
+        Color DiffuseSpecular(const Material& material, const Color& surface_color, const PointLight& light, const Point& point, const Vector& eye, const Vector& normal);
     };
 }
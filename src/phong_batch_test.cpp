@@ -0,0 +1,201 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "catch2/catch.hpp"
+
+#include "color.h"
+#include "double_util.h"
+#include "light_batch.h"
+#include "material.h"
+#include "phong.h"
+#include "point.h"
+#include "point_light.h"
+#include "vector.h"
+#include "world.h"
+
+#include <cinttypes>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    const std::vector<rtc::PointLight> kLights{
+        rtc::PointLight{ rtc::Point{ -10.0, 10.0, -10.0 }, rtc::Color{ 1.0, 1.0, 1.0 } },
+        rtc::PointLight{ rtc::Point{ 0.0, 0.0, -10.0 }, rtc::Color{ 0.5, 0.25, 1.0 } },
+        rtc::PointLight{ rtc::Point{ 2.0, -1.0, -3.0 }, rtc::Color{ 0.2, 0.9, 0.4 } },
+        rtc::PointLight{ rtc::Point{ 0.0, 0.0, 10.0 }, rtc::Color{ 1.0, 1.0, 1.0 } }
+    };
+}
+
+SCENARIO("FastPow approximates pow", "[lighting]")
+{
+    GIVEN("Bases in (0, 1] and exponents up to 1000")
+    {
+        THEN("fast_pow(base, exponent) is within the documented relative tolerance of pow(base, exponent)")
+        {
+            const auto tolerance = (sizeof(rtc::Scalar) == sizeof(double)) ? 1e-6 : 1e-4;
+
+            for (const auto exponent : { 1.0, 10.0, 200.0, 1000.0 })
+            {
+                for (auto base = 0.0005; base <= 1.0; base += 0.0005)
+                {
+                    const auto exact       = std::pow(base, exponent);
+                    const auto approximate = rtc::FastPow(static_cast<rtc::Scalar>(base), static_cast<rtc::Scalar>(exponent));
+
+                    if (exact > 1e-30)
+                    {
+                        REQUIRE(std::abs(approximate - exact) <= (tolerance * exact));
+                    }
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Lighting a batch of lights matches lighting each light", "[lighting]")
+{
+    GIVEN("m <- material() and lights <- light_batch(lights) and position <- point(0, 0, 0)")
+    {
+        const auto m         = rtc::Material{};
+        const auto lights    = rtc::LightBatch{ kLights };
+        const auto position  = rtc::Point{ 0.0, 0.0, 0.0 };
+        const auto eyev      = rtc::Vector{ 0.0, 0.0, -1.0 };
+        const auto normalv   = rtc::Vector{ 0.0, 0.0, -1.0 };
+        const auto in_shadow = std::vector<uint8_t>{ 0u, 0u, 1u, 0u };
+
+        WHEN("result <- lighting(m, color(1, 1, 1), lights, in_shadow, position, eyev, normalv)")
+        {
+            const auto result = rtc::Phong::Lighting(m, rtc::Color{ 1.0, 1.0, 1.0 }, lights, in_shadow, position, eyev, normalv);
+
+            THEN("result = the sum of lighting(m, color(1, 1, 1), light, position, eyev, normalv, shadowed) over the lights")
+            {
+                auto expected = rtc::Color{};
+
+                for (size_t i = 0u; i < kLights.size(); ++i)
+                {
+                    expected.Add(rtc::Phong::Lighting(m, rtc::Color{ 1.0, 1.0, 1.0 }, kLights[i], position, eyev, normalv, in_shadow[i] != 0u));
+                }
+
+                REQUIRE(rtc::Color::Equal(result, expected));
+            }
+        }
+    }
+}
+
+SCENARIO("Lighting a batch of partially visible lights scales their diffuse and specular light", "[lighting]")
+{
+    GIVEN("m <- material() and lights <- light_batch(lights) and visibility <- [1, 0.5, 0, 0.25]")
+    {
+        const auto m          = rtc::Material{};
+        const auto lights     = rtc::LightBatch{ kLights };
+        const auto position   = rtc::Point{ 0.0, 0.0, 0.0 };
+        const auto eyev       = rtc::Vector{ 0.0, 0.0, -1.0 };
+        const auto normalv    = rtc::Vector{ 0.0, 0.0, -1.0 };
+        const auto visibility = std::vector<rtc::Scalar>{ 1.0, 0.5, 0.0, 0.25 };
+
+        WHEN("result <- lighting(m, color(1, 1, 1), lights, visibility, position, eyev, normalv)")
+        {
+            const auto result = rtc::Phong::Lighting(m, rtc::Color{ 1.0, 1.0, 1.0 }, lights, visibility, position, eyev, normalv);
+
+            THEN("result = the sum of the ambient light and the visible fraction of the other light from each light")
+            {
+                auto expected = rtc::Color{};
+
+                for (size_t i = 0u; i < kLights.size(); ++i)
+                {
+                    const auto& light = kLights[i];
+                    expected.Add(rtc::Phong::Ambient(m, rtc::Color{ 1.0, 1.0, 1.0 }, light.GetIntensity()));
+                    expected.Add(rtc::Color::Multiply(rtc::Phong::DiffuseSpecular(m, rtc::Color{ 1.0, 1.0, 1.0 }, light, position, eyev, normalv), visibility[i]));
+                }
+
+                REQUIRE(rtc::Color::Equal(result, expected));
+            }
+        }
+    }
+}
+
+SCENARIO("Lighting with fast specular stays within tolerance", "[lighting]")
+{
+    GIVEN("m <- material() with fast specular and lights <- light_batch(lights) and an eye along the reflection of the first light")
+    {
+        auto m = rtc::Material{};
+        m.SetFastSpecular(true);
+
+        const auto lights    = rtc::LightBatch{ kLights };
+        const auto position  = rtc::Point{ 0.0, 0.0, 0.0 };
+        const auto eyev      = rtc::Vector{ 0.5773502691896258, -0.5773502691896258, -0.5773502691896258 };
+        const auto normalv   = rtc::Vector{ 0.0, 0.0, -1.0 };
+        const auto in_shadow = std::vector<uint8_t>(kLights.size());
+
+        WHEN("fast <- lighting(m, color(1, 1, 1), lights, ...) and exact <- lighting(material(), color(1, 1, 1), lights, ...)")
+        {
+            const auto fast  = rtc::Phong::Lighting(m, rtc::Color{ 1.0, 1.0, 1.0 }, lights, in_shadow, position, eyev, normalv);
+            const auto exact = rtc::Phong::Lighting(rtc::Material{}, rtc::Color{ 1.0, 1.0, 1.0 }, lights, in_shadow, position, eyev, normalv);
+
+            THEN("fast = exact")
+            {
+                REQUIRE(rtc::Color::Equal(fast, exact));
+            }
+        }
+    }
+}
+
+SCENARIO("Changing a light updates the world's light batch", "[lighting]")
+{
+    GIVEN("w <- default_world()")
+    {
+        auto w = rtc::World::GetDefault();
+
+        WHEN("set_light(w, 0, point_light(point(1, 2, 3), color(0.5, 0.5, 0.5))) and add_light(w, point_light(point(0, 0, 0), color(1, 0, 0)))")
+        {
+            w.SetLight(0u, rtc::PointLight{ rtc::Point{ 1.0, 2.0, 3.0 }, rtc::Color{ 0.5, 0.5, 0.5 } });
+            w.AppendLight(rtc::PointLight{ rtc::Point{ 0.0, 0.0, 0.0 }, rtc::Color{ 1.0, 0.0, 0.0 } });
+
+            THEN("The batch holds both lights and their total intensity")
+            {
+                const auto& batch = w.GetLightBatch();
+
+                REQUIRE(batch.GetCount() == 2u);
+                REQUIRE(rtc::Equal(batch.GetX()[0], 1.0));
+                REQUIRE(rtc::Equal(batch.GetZ()[0], 3.0));
+                REQUIRE(rtc::Equal(batch.GetR()[1], 1.0));
+                REQUIRE(rtc::Color::Equal(batch.GetTotalIntensity(), rtc::Color{ 1.5, 0.5, 0.5 }));
+            }
+
+            AND_WHEN("set_light_position(w, 1, point(4, 5, 6))")
+            {
+                w.SetLightPosition(1u, rtc::Point{ 4.0, 5.0, 6.0 });
+
+                THEN("The batch holds the new position and the same total intensity")
+                {
+                    const auto& batch = w.GetLightBatch();
+
+                    REQUIRE(rtc::Equal(batch.GetX()[1], 4.0));
+                    REQUIRE(rtc::Equal(batch.GetY()[1], 5.0));
+                    REQUIRE(rtc::Equal(batch.GetZ()[1], 6.0));
+                    REQUIRE(rtc::Equal(batch.GetR()[1], 1.0));
+                    REQUIRE(rtc::Color::Equal(batch.GetTotalIntensity(), rtc::Color{ 1.5, 0.5, 0.5 }));
+                }
+            }
+        }
+    }
+}
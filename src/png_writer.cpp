@@ -0,0 +1,299 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "png_writer.h"
+
+#include "color.h"
+#include "double_util.h"
+#include "file_output_stream.h"
+#include "parallel_bands.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+namespace rtc
+{
+    namespace PngWriter
+    {
+        namespace
+        {
+            constexpr uint8_t  kSignature[8]  = { 0x89u, 'P', 'N', 'G', '\r', '\n', 0x1au, '\n' };
+            constexpr uint32_t kBytesPerPixel = 3u;
+            constexpr size_t   kChunkSize     = 256u * 1024u; ///< Filtered bytes compressed by each task.
+
+            // Row filter types, which predict each byte from its neighbors.
+            enum class Filter : uint8_t
+            {
+                kNone,
+                kSub,
+                kUp,
+                kAverage,
+                kPaeth
+            };
+
+            constexpr Filter kFilters[] = { Filter::kNone, Filter::kSub, Filter::kUp, Filter::kAverage, Filter::kPaeth };
+
+            // Rows of filtered image data, compressed as one segment of the zlib stream.
+            struct CompressedChunk
+            {
+                std::vector<uint8_t> data;           ///< Deflate blocks.
+                size_t               size{ 0u };     ///< Number of filtered bytes compressed.
+                uint32_t             adler{ 1u };    ///< Adler-32 of the filtered bytes.
+            };
+
+            void ConvertRow(const Canvas& canvas, uint32_t y, uint8_t* row)
+            {
+                for (uint32_t x = 0u; x < canvas.GetWidth(); ++x)
+                {
+                    const auto& pixel = canvas.PixelAt(x, y);
+
+                    *row++ = rtc::ToByte(pixel.GetR());
+                    *row++ = rtc::ToByte(pixel.GetG());
+                    *row++ = rtc::ToByte(pixel.GetB());
+                }
+            }
+
+            uint8_t Paeth(int32_t left, int32_t up, int32_t up_left)
+            {
+                const auto estimate  = left + up - up_left;
+                const auto to_left   = std::abs(estimate - left);
+                const auto to_up     = std::abs(estimate - up);
+                const auto to_corner = std::abs(estimate - up_left);
+
+                if ((to_left <= to_up) && (to_left <= to_corner))
+                {
+                    return static_cast<uint8_t>(left);
+                }
+
+                return static_cast<uint8_t>((to_up <= to_corner) ? up : up_left);
+            }
+
+            void FilterRow(Filter filter, const uint8_t* row, const uint8_t* prior, size_t size, uint8_t* output)
+            {
+                for (size_t i = 0u; i < size; ++i)
+                {
+                    const auto left    = (i >= kBytesPerPixel) ? row[i - kBytesPerPixel] : uint8_t{ 0u };
+                    const auto up      = prior[i];
+                    const auto up_left = (i >= kBytesPerPixel) ? prior[i - kBytesPerPixel] : uint8_t{ 0u };
+
+                    auto prediction = uint8_t{ 0u };
+                    switch (filter)
+                    {
+                    case Filter::kNone:
+                        break;
+                    case Filter::kSub:
+                        prediction = left;
+                        break;
+                    case Filter::kUp:
+                        prediction = up;
+                        break;
+                    case Filter::kAverage:
+                        prediction = static_cast<uint8_t>((left + up) / 2);
+                        break;
+                    case Filter::kPaeth:
+                        prediction = Paeth(left, up, up_left);
+                        break;
+                    }
+
+                    output[i] = static_cast<uint8_t>(row[i] - prediction);
+                }
+            }
+
+            // Sum of the filtered bytes as signed values, which is smaller for rows that compress well.
+            uint64_t FilterCost(const uint8_t* filtered, size_t size)
+            {
+                auto cost = uint64_t{ 0u };
+                for (size_t i = 0u; i < size; ++i)
+                {
+                    cost += static_cast<uint64_t>(std::abs(static_cast<int32_t>(static_cast<int8_t>(filtered[i]))));
+                }
+
+                return cost;
+            }
+
+            // Append the filtered rows [first_row, last_row) of the canvas, each preceded by its filter type. An
+            // adaptive filter chooses the filter with the smallest cost for each row; otherwise rows are not
+            // filtered. The filtered bytes depend only on the canvas, so chunks filtered separately agree on
+            // the rows they share.
+            void FilterRows(const Canvas& canvas, uint32_t first_row, uint32_t last_row, bool adaptive, std::vector<uint8_t>& output)
+            {
+                const auto size = static_cast<size_t>(canvas.GetWidth()) * kBytesPerPixel;
+
+                auto prior    = std::vector<uint8_t>(size, 0u);
+                auto row      = std::vector<uint8_t>(size, 0u);
+                auto filtered = std::vector<uint8_t>(size, 0u);
+                auto best     = std::vector<uint8_t>(size, 0u);
+
+                if (adaptive && (first_row > 0u))
+                {
+                    ConvertRow(canvas, first_row - 1u, prior.data());
+                }
+
+                for (auto y = first_row; y < last_row; ++y)
+                {
+                    ConvertRow(canvas, y, row.data());
+
+                    if (!adaptive)
+                    {
+                        output.push_back(static_cast<uint8_t>(Filter::kNone));
+                        output.insert(output.end(), row.begin(), row.end());
+                        continue;
+                    }
+
+                    auto best_filter = Filter::kNone;
+                    auto best_cost   = UINT64_MAX;
+
+                    for (const auto filter : kFilters)
+                    {
+                        FilterRow(filter, row.data(), prior.data(), size, filtered.data());
+
+                        const auto cost = FilterCost(filtered.data(), size);
+                        if (cost < best_cost)
+                        {
+                            best_cost   = cost;
+                            best_filter = filter;
+                            std::swap(best, filtered);
+                        }
+                    }
+
+                    output.push_back(static_cast<uint8_t>(best_filter));
+                    output.insert(output.end(), best.begin(), best.end());
+
+                    std::swap(prior, row);
+                }
+            }
+
+            void PutUint32(uint32_t value, uint8_t* bytes)
+            {
+                bytes[0] = static_cast<uint8_t>(value >> 24u);
+                bytes[1] = static_cast<uint8_t>(value >> 16u);
+                bytes[2] = static_cast<uint8_t>(value >> 8u);
+                bytes[3] = static_cast<uint8_t>(value);
+            }
+
+            bool WriteChunk(OutputStream* stream, const char* type, const uint8_t* data, size_t size)
+            {
+                uint8_t header[8];
+                PutUint32(static_cast<uint32_t>(size), header);
+                std::copy(type, type + 4, header + 4);
+
+                uint8_t crc[4];
+                PutUint32(Deflate::Crc32(data, size, Deflate::Crc32(header + 4, 4u)), crc);
+
+                auto success = stream->Write(reinterpret_cast<const char*>(header), sizeof(header));
+                success      = success && ((size == 0u) || stream->Write(reinterpret_cast<const char*>(data), size));
+                success      = success && stream->Write(reinterpret_cast<const char*>(crc), sizeof(crc));
+
+                return success;
+            }
+        }
+
+        bool WriteFile(const std::string& filename, const Canvas& canvas, uint32_t level, uint32_t thread_count)
+        {
+            if ((level > Deflate::kMaxLevel) || (canvas.GetWidth() == 0u) || (canvas.GetHeight() == 0u))
+            {
+                return false;
+            }
+
+            auto stream = FileOutputStream{ filename };
+
+            if (stream.IsValid())
+            {
+                return WriteStream(&stream, canvas, level, thread_count);
+            }
+
+            return false;
+        }
+
+        bool WriteStream(OutputStream* stream, const Canvas& canvas, uint32_t level, uint32_t thread_count)
+        {
+            const auto width  = canvas.GetWidth();
+            const auto height = canvas.GetHeight();
+
+            if ((stream == nullptr) || (level > Deflate::kMaxLevel) || (width == 0u) || (height == 0u))
+            {
+                return false;
+            }
+
+            // Each chunk starts with the rows before it that cover the deflate window, which prime its dictionary.
+            const auto adaptive        = level > 0u;
+            const auto row_size        = 1u + (static_cast<size_t>(width) * kBytesPerPixel);
+            const auto chunk_rows      = static_cast<uint32_t>(std::max(kChunkSize / row_size, size_t{ 1u }));
+            const auto dictionary_rows = adaptive ? static_cast<uint32_t>((Deflate::kWindowSize + row_size - 1u) / row_size) : 0u;
+            const auto chunk_count     = (height + chunk_rows - 1u) / chunk_rows;
+
+            auto chunks   = std::vector<CompressedChunk>(chunk_count);
+            auto filtered = std::vector<std::vector<uint8_t>>(ParallelBands::GetWorkerCount(height, chunk_rows, thread_count));
+
+            ParallelBands::ForEachBand(height, chunk_rows, thread_count, [&](uint32_t worker, uint32_t first_row, uint32_t last_row) {
+                const auto index          = first_row / chunk_rows;
+                const auto dictionary_row = first_row - std::min(first_row, dictionary_rows);
+
+                auto& rows = filtered[worker];
+                rows.clear();
+                FilterRows(canvas, dictionary_row, last_row, adaptive, rows);
+
+                const auto dictionary_size = static_cast<size_t>(first_row - dictionary_row) * row_size;
+                const auto* data            = rows.data() + dictionary_size;
+
+                auto& chunk = chunks[index];
+                chunk.size  = rows.size() - dictionary_size;
+                chunk.adler = Deflate::Adler32(data, chunk.size);
+                Deflate::Compress(data, chunk.size, dictionary_size, level, (index + 1u) == chunk_count, chunk.data);
+
+                return true;
+            });
+
+            // 8-bit depth, RGB color, deflate compression, adaptive filtering, no interlace.
+            uint8_t header[13] = { 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 8u, 2u, 0u, 0u, 0u };
+            PutUint32(width, header);
+            PutUint32(height, header + 4);
+
+            auto success = stream->Write(reinterpret_cast<const char*>(kSignature), sizeof(kSignature));
+            success      = success && WriteChunk(stream, "IHDR", header, sizeof(header));
+
+            // Join the chunks into one zlib stream, with one IDAT chunk for each.
+            const auto zlib_header = Deflate::ZlibHeader(level);
+            chunks.front().data.insert(chunks.front().data.begin(), { static_cast<uint8_t>(zlib_header >> 8u), static_cast<uint8_t>(zlib_header) });
+
+            auto adler = uint32_t{ 1u };
+            for (const auto& chunk : chunks)
+            {
+                adler = Deflate::Adler32Combine(adler, chunk.adler, chunk.size);
+            }
+
+            uint8_t trailer[4];
+            PutUint32(adler, trailer);
+            chunks.back().data.insert(chunks.back().data.end(), trailer, trailer + sizeof(trailer));
+
+            for (const auto& chunk : chunks)
+            {
+                success = success && WriteChunk(stream, "IDAT", chunk.data.data(), chunk.data.size());
+            }
+
+            success = success && WriteChunk(stream, "IEND", nullptr, 0u);
+
+            return success;
+        }
+    }
+}
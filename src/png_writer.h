@@ -0,0 +1,44 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#pragma once
+
+#include "canvas.h"
+#include "deflate.h"
+#include "output_stream.h"
+
+#include <cinttypes>
+#include <string>
+
+namespace rtc
+{
+    namespace PngWriter
+    {
+        // Write the canvas as an 8-bit RGB PNG, compressed at a level from 0 to Deflate::kMaxLevel. The rows are
+        // filtered and compressed in independent chunks on thread_count threads, or one thread for each hardware
+        // thread when thread_count is 0, and the compressed chunks are joined into a single zlib stream. Returns
+        // false for an invalid level, an empty canvas, or a failed write.
+        bool WriteFile(const std::string& filename, const Canvas& canvas, uint32_t level = Deflate::kDefaultLevel, uint32_t thread_count = 0u);
+
+        bool WriteStream(OutputStream* stream, const Canvas& canvas, uint32_t level = Deflate::kDefaultLevel, uint32_t thread_count = 0u);
+    };
+}
@@ -0,0 +1,631 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "catch2/catch.hpp"
+
+#include "canvas.h"
+#include "color.h"
+#include "deflate.h"
+#include "double_util.h"
+#include "memory_output_stream.h"
+#include "png_writer.h"
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Minimal inflate, following the RFC 1951 decoding algorithm, to check the encoder's output.
+    class Inflater
+    {
+    public:
+        Inflater(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+        bool Inflate(std::vector<uint8_t>& output)
+        {
+            auto final = 0u;
+
+            do
+            {
+                final           = Bits(1u);
+                const auto type = Bits(2u);
+
+                auto success = false;
+                if (type == 0u)
+                {
+                    success = Stored(output);
+                }
+                else if (type == 1u)
+                {
+                    auto lengths = std::vector<uint8_t>(288u, 8u);
+                    std::fill(lengths.begin() + 144, lengths.begin() + 256, uint8_t{ 9u });
+                    std::fill(lengths.begin() + 256, lengths.begin() + 280, uint8_t{ 7u });
+                    success = Codes(Huffman{ lengths }, Huffman{ std::vector<uint8_t>(30u, 5u) }, output);
+                }
+                else if (type == 2u)
+                {
+                    success = Dynamic(output);
+                }
+
+                if (!success || error_)
+                {
+                    return false;
+                }
+            } while (final == 0u);
+
+            return true;
+        }
+
+        // Bytes consumed, including the final partial byte.
+        size_t GetPosition() const { return (bit_ + 7u) / 8u; }
+
+    private:
+        struct Huffman
+        {
+            explicit Huffman(const std::vector<uint8_t>& lengths) : counts(16u, 0u)
+            {
+                for (auto length : lengths)
+                {
+                    ++counts[length];
+                }
+
+                auto offsets = std::vector<uint16_t>(16u, 0u);
+                for (size_t length = 1u; length < 15u; ++length)
+                {
+                    offsets[length + 1u] = static_cast<uint16_t>(offsets[length] + counts[length]);
+                }
+
+                symbols.resize(lengths.size());
+                for (size_t symbol = 0u; symbol < lengths.size(); ++symbol)
+                {
+                    if (lengths[symbol] != 0u)
+                    {
+                        symbols[offsets[lengths[symbol]]++] = static_cast<uint16_t>(symbol);
+                    }
+                }
+            }
+
+            std::vector<uint16_t> counts;
+            std::vector<uint16_t> symbols;
+        };
+
+        uint32_t Bits(uint32_t count)
+        {
+            auto value = 0u;
+            for (uint32_t i = 0u; i < count; ++i, ++bit_)
+            {
+                if ((bit_ / 8u) >= size_)
+                {
+                    error_ = true;
+                    return 0u;
+                }
+
+                value |= ((data_[bit_ / 8u] >> (bit_ % 8u)) & 1u) << i;
+            }
+
+            return value;
+        }
+
+        int32_t Decode(const Huffman& huffman)
+        {
+            auto code  = 0;
+            auto first = 0;
+            auto index = 0;
+
+            for (size_t length = 1u; length < 16u; ++length)
+            {
+                code |= static_cast<int>(Bits(1u));
+
+                const auto count = static_cast<int>(huffman.counts[length]);
+                if ((code - count) < first)
+                {
+                    return huffman.symbols[static_cast<size_t>(index + (code - first))];
+                }
+
+                index += count;
+                first += count;
+                first <<= 1;
+                code <<= 1;
+            }
+
+            error_ = true;
+            return -1;
+        }
+
+        bool Stored(std::vector<uint8_t>& output)
+        {
+            bit_ = ((bit_ + 7u) / 8u) * 8u;
+
+            const auto length = Bits(16u);
+            const auto check  = Bits(16u);
+            if ((length != (~check & 0xffffu)) || (((bit_ / 8u) + length) > size_))
+            {
+                return false;
+            }
+
+            output.insert(output.end(), data_ + (bit_ / 8u), data_ + (bit_ / 8u) + length);
+            bit_ += 8u * length;
+
+            return true;
+        }
+
+        bool Dynamic(std::vector<uint8_t>& output)
+        {
+            static const uint8_t order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+            const auto literal_count  = Bits(5u) + 257u;
+            const auto distance_count = Bits(5u) + 1u;
+            const auto code_count     = Bits(4u) + 4u;
+
+            auto code_lengths = std::vector<uint8_t>(19u, 0u);
+            for (uint32_t i = 0u; i < code_count; ++i)
+            {
+                code_lengths[order[i]] = static_cast<uint8_t>(Bits(3u));
+            }
+
+            const auto code_huffman = Huffman{ code_lengths };
+
+            auto lengths = std::vector<uint8_t>{};
+            while (!error_ && (lengths.size() < (literal_count + distance_count)))
+            {
+                const auto symbol = Decode(code_huffman);
+                if (symbol < 16)
+                {
+                    lengths.push_back(static_cast<uint8_t>(symbol));
+                }
+                else if (symbol == 16)
+                {
+                    if (lengths.empty())
+                    {
+                        return false;
+                    }
+
+                    lengths.insert(lengths.end(), 3u + Bits(2u), lengths.back());
+                }
+                else
+                {
+                    lengths.insert(lengths.end(), (symbol == 17) ? (3u + Bits(3u)) : (11u + Bits(7u)), uint8_t{ 0u });
+                }
+            }
+
+            if (lengths.size() != (literal_count + distance_count))
+            {
+                return false;
+            }
+
+            return Codes(Huffman{ std::vector<uint8_t>(lengths.begin(), lengths.begin() + literal_count) },
+                         Huffman{ std::vector<uint8_t>(lengths.begin() + literal_count, lengths.end()) },
+                         output);
+        }
+
+        bool Codes(const Huffman& literals, const Huffman& distances, std::vector<uint8_t>& output)
+        {
+            static const uint16_t length_base[29]    = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+            static const uint8_t  length_extra[29]   = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+            static const uint16_t distance_base[30]  = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+            static const uint8_t  distance_extra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+            for (;;)
+            {
+                const auto symbol = Decode(literals);
+                if ((symbol < 0) || (symbol > 285))
+                {
+                    return false;
+                }
+
+                if (symbol < 256)
+                {
+                    output.push_back(static_cast<uint8_t>(symbol));
+                }
+                else if (symbol == 256)
+                {
+                    return true;
+                }
+                else
+                {
+                    const auto length_code   = static_cast<size_t>(symbol - 257);
+                    const auto length        = length_base[length_code] + Bits(length_extra[length_code]);
+                    const auto distance_code = Decode(distances);
+                    if ((distance_code < 0) || (distance_code > 29))
+                    {
+                        return false;
+                    }
+
+                    const auto distance = distance_base[distance_code] + Bits(distance_extra[distance_code]);
+                    if (distance > output.size())
+                    {
+                        return false;
+                    }
+
+                    for (uint32_t i = 0u; i < length; ++i)
+                    {
+                        output.push_back(output[output.size() - distance]);
+                    }
+                }
+            }
+        }
+
+    private:
+        const uint8_t* data_;
+        size_t         size_;
+        size_t         bit_{ 0u };
+        bool           error_{ false };
+    };
+
+    bool Inflate(const std::vector<uint8_t>& compressed, std::vector<uint8_t>& output)
+    {
+        auto inflater = Inflater{ compressed.data(), compressed.size() };
+        return inflater.Inflate(output) && (inflater.GetPosition() == compressed.size());
+    }
+
+    // Text with repeats, a run, and pseudo-random bytes that do not compress.
+    std::vector<uint8_t> TestData()
+    {
+        auto data = std::vector<uint8_t>{};
+
+        const auto text = std::string{ "The ray tracer challenge: a test-driven guide to your first 3D renderer. " };
+        for (auto i = 0; i < 200; ++i)
+        {
+            data.insert(data.end(), text.begin(), text.begin() + static_cast<ptrdiff_t>(10 + (i % 50)));
+        }
+
+        data.insert(data.end(), 5000u, uint8_t{ 'x' });
+
+        auto seed = 12345u;
+        for (auto i = 0; i < 20000; ++i)
+        {
+            seed = (seed * 1103515245u) + 12345u;
+            data.push_back(static_cast<uint8_t>(seed >> 16u));
+        }
+
+        data.insert(data.end(), data.begin(), data.begin() + 8000);
+
+        return data;
+    }
+
+    uint32_t GetUint32(const uint8_t* bytes)
+    {
+        return (static_cast<uint32_t>(bytes[0]) << 24u) | (static_cast<uint32_t>(bytes[1]) << 16u) | (static_cast<uint32_t>(bytes[2]) << 8u) | bytes[3];
+    }
+
+    // A decoded 8-bit RGB PNG.
+    struct DecodedPng
+    {
+        uint32_t             width{ 0u };
+        uint32_t             height{ 0u };
+        size_t               idat_count{ 0u };
+        std::vector<uint8_t> pixels;
+    };
+
+    // Decode a PNG written by the encoder, checking its structure and checksums.
+    bool DecodePng(const rtc::MemoryOutputStream& stream, DecodedPng& png)
+    {
+        static const uint8_t signature[8] = { 0x89u, 'P', 'N', 'G', '\r', '\n', 0x1au, '\n' };
+
+        const auto* bytes = stream.GetData();
+        const auto  size  = stream.GetSize();
+
+        if ((size < 8u) || !std::equal(signature, signature + 8, bytes))
+        {
+            return false;
+        }
+
+        auto zlib     = std::vector<uint8_t>{};
+        auto position = size_t{ 8u };
+        auto ended    = false;
+
+        while (!ended && ((position + 12u) <= size))
+        {
+            const auto length = GetUint32(bytes + position);
+            const auto type   = std::string{ reinterpret_cast<const char*>(bytes + position + 4u), 4u };
+            const auto* data  = bytes + position + 8u;
+
+            if ((position + 12u + length) > size)
+            {
+                return false;
+            }
+
+            if (rtc::Deflate::Crc32(bytes + position + 4u, length + 4u) != GetUint32(data + length))
+            {
+                return false;
+            }
+
+            if (type == "IHDR")
+            {
+                png.width  = GetUint32(data);
+                png.height = GetUint32(data + 4u);
+                if ((length != 13u) || (data[8] != 8u) || (data[9] != 2u) || (data[10] != 0u) || (data[11] != 0u) || (data[12] != 0u))
+                {
+                    return false;
+                }
+            }
+            else if (type == "IDAT")
+            {
+                zlib.insert(zlib.end(), data, data + length);
+                ++png.idat_count;
+            }
+            else if (type == "IEND")
+            {
+                ended = true;
+            }
+
+            position += 12u + length;
+        }
+
+        if (!ended || (position != size) || (zlib.size() < 6u) || (zlib[0] != 0x78u) || ((((zlib[0] << 8u) | zlib[1]) % 31u) != 0u))
+        {
+            return false;
+        }
+
+        auto filtered = std::vector<uint8_t>{};
+        auto inflater = Inflater{ zlib.data() + 2u, zlib.size() - 6u };
+        if (!inflater.Inflate(filtered) || (rtc::Deflate::Adler32(filtered.data(), filtered.size()) != GetUint32(zlib.data() + zlib.size() - 4u)))
+        {
+            return false;
+        }
+
+        const auto row_size = static_cast<size_t>(png.width) * 3u;
+        if (filtered.size() != ((row_size + 1u) * png.height))
+        {
+            return false;
+        }
+
+        png.pixels.assign(row_size * png.height, 0u);
+
+        for (size_t y = 0u; y < png.height; ++y)
+        {
+            const auto  filter = filtered[y * (row_size + 1u)];
+            const auto* in     = filtered.data() + (y * (row_size + 1u)) + 1u;
+            auto*       out    = png.pixels.data() + (y * row_size);
+            const auto* prior  = (y > 0u) ? (out - row_size) : nullptr;
+
+            for (size_t i = 0u; i < row_size; ++i)
+            {
+                const int a = (i >= 3u) ? out[i - 3u] : 0;
+                const int b = prior ? prior[i] : 0;
+                const int c = (prior && (i >= 3u)) ? prior[i - 3u] : 0;
+
+                auto prediction = 0;
+                switch (filter)
+                {
+                case 0: prediction = 0; break;
+                case 1: prediction = a; break;
+                case 2: prediction = b; break;
+                case 3: prediction = (a + b) / 2; break;
+                case 4:
+                {
+                    const auto p  = a + b - c;
+                    const auto pa = std::abs(p - a);
+                    const auto pb = std::abs(p - b);
+                    const auto pc = std::abs(p - c);
+                    prediction    = ((pa <= pb) && (pa <= pc)) ? a : ((pb <= pc) ? b : c);
+                    break;
+                }
+                default: return false;
+                }
+
+                out[i] = static_cast<uint8_t>(in[i] + prediction);
+            }
+        }
+
+        return true;
+    }
+
+    rtc::Canvas TestCanvas(uint32_t width, uint32_t height)
+    {
+        auto canvas = rtc::Canvas{ width, height };
+
+        for (uint32_t y = 0u; y < height; ++y)
+        {
+            for (uint32_t x = 0u; x < width; ++x)
+            {
+                const auto r = static_cast<rtc::Scalar>(x) / static_cast<rtc::Scalar>(width);
+                const auto g = static_cast<rtc::Scalar>((x / 8u + y / 8u) % 2u);
+                const auto b = static_cast<rtc::Scalar>((x * y) % 7u) / static_cast<rtc::Scalar>(6.0);
+                canvas.WritePixel(x, y, rtc::Color{ r, g, b });
+            }
+        }
+
+        return canvas;
+    }
+
+    bool MatchesCanvas(const DecodedPng& png, const rtc::Canvas& canvas)
+    {
+        if ((png.width != canvas.GetWidth()) || (png.height != canvas.GetHeight()))
+        {
+            return false;
+        }
+
+        for (uint32_t y = 0u; y < png.height; ++y)
+        {
+            for (uint32_t x = 0u; x < png.width; ++x)
+            {
+                const auto& pixel = canvas.PixelAt(x, y);
+                const auto* rgb   = png.pixels.data() + ((static_cast<size_t>(y) * png.width) + x) * 3u;
+
+                if ((rgb[0] != rtc::ToByte(pixel.GetR())) || (rgb[1] != rtc::ToByte(pixel.GetG())) || (rgb[2] != rtc::ToByte(pixel.GetB())))
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+}
+
+SCENARIO("Computing checksums", "[png]")
+{
+    GIVEN("data <- \"123456789\"")
+    {
+        const auto data = std::string{ "123456789" };
+        const auto* bytes = reinterpret_cast<const uint8_t*>(data.data());
+
+        THEN("the checksums match the reference values")
+        {
+            REQUIRE(rtc::Deflate::Crc32(bytes, data.size()) == 0xcbf43926u);
+            REQUIRE(rtc::Deflate::Adler32(bytes, data.size()) == 0x091e01deu);
+        }
+
+        THEN("checksums of parts combine into the checksum of the whole")
+        {
+            const auto first  = rtc::Deflate::Adler32(bytes, 4u);
+            const auto second = rtc::Deflate::Adler32(bytes + 4u, 5u);
+
+            REQUIRE(rtc::Deflate::Adler32Combine(first, second, 5u) == rtc::Deflate::Adler32(bytes, data.size()));
+            REQUIRE(rtc::Deflate::Crc32(bytes + 4u, 5u, rtc::Deflate::Crc32(bytes, 4u)) == 0xcbf43926u);
+        }
+    }
+}
+
+SCENARIO("Compressing data at each level", "[png]")
+{
+    GIVEN("data with repeated text, a run, and random bytes")
+    {
+        const auto data = TestData();
+
+        THEN("the data decompresses unchanged at every level, and compresses at every level above 0")
+        {
+            for (uint32_t level = 0u; level <= rtc::Deflate::kMaxLevel; ++level)
+            {
+                auto compressed = std::vector<uint8_t>{};
+                REQUIRE(rtc::Deflate::Compress(data.data(), data.size(), 0u, level, true, compressed));
+
+                auto decompressed = std::vector<uint8_t>{};
+                REQUIRE(Inflate(compressed, decompressed));
+                REQUIRE(decompressed == data);
+
+                if (level > 0u)
+                {
+                    REQUIRE(compressed.size() < (data.size() * 2u / 3u));
+                }
+            }
+        }
+
+        THEN("an invalid level is rejected")
+        {
+            auto compressed = std::vector<uint8_t>{};
+            REQUIRE_FALSE(rtc::Deflate::Compress(data.data(), data.size(), 0u, rtc::Deflate::kMaxLevel + 1u, true, compressed));
+        }
+
+        THEN("empty data compresses to a final block")
+        {
+            auto compressed   = std::vector<uint8_t>{};
+            auto decompressed = std::vector<uint8_t>{};
+            REQUIRE(rtc::Deflate::Compress(data.data(), 0u, 0u, 6u, true, compressed));
+            REQUIRE(Inflate(compressed, decompressed));
+            REQUIRE(decompressed.empty());
+        }
+    }
+}
+
+SCENARIO("Compressing data as separate segments", "[png]")
+{
+    GIVEN("data split into three segments")
+    {
+        const auto data = TestData();
+        const auto split1 = size_t{ 7000u };
+        const auto split2 = size_t{ 30000u };
+
+        WHEN("each segment is compressed with the data before it as its dictionary")
+        {
+            auto compressed = std::vector<uint8_t>{};
+            REQUIRE(rtc::Deflate::Compress(data.data(), split1, 0u, 6u, false, compressed));
+            REQUIRE(rtc::Deflate::Compress(data.data() + split1, split2 - split1, split1, 6u, false, compressed));
+            REQUIRE(rtc::Deflate::Compress(data.data() + split2, data.size() - split2, split2, 6u, true, compressed));
+
+            THEN("the joined segments decompress to the data")
+            {
+                auto decompressed = std::vector<uint8_t>{};
+                REQUIRE(Inflate(compressed, decompressed));
+                REQUIRE(decompressed == data);
+            }
+
+            THEN("the dictionaries let segments match the data before them")
+            {
+                auto independent = std::vector<uint8_t>{};
+                rtc::Deflate::Compress(data.data(), split1, 0u, 6u, false, independent);
+                rtc::Deflate::Compress(data.data() + split1, split2 - split1, 0u, 6u, false, independent);
+                rtc::Deflate::Compress(data.data() + split2, data.size() - split2, 0u, 6u, true, independent);
+
+                REQUIRE(compressed.size() < independent.size());
+            }
+        }
+    }
+}
+
+SCENARIO("Writing a canvas as a PNG", "[png]")
+{
+    GIVEN("c <- canvas(37, 23) with a pattern")
+    {
+        const auto c = TestCanvas(37u, 23u);
+
+        THEN("the PNG decodes to the canvas bytes at every level")
+        {
+            for (uint32_t level = 0u; level <= rtc::Deflate::kMaxLevel; ++level)
+            {
+                auto stream = rtc::MemoryOutputStream{};
+                REQUIRE(rtc::PngWriter::WriteStream(&stream, c, level, 1u));
+
+                auto png = DecodedPng{};
+                REQUIRE(DecodePng(stream, png));
+                REQUIRE(MatchesCanvas(png, c));
+            }
+        }
+
+        THEN("invalid levels and empty canvases are rejected")
+        {
+            auto stream = rtc::MemoryOutputStream{};
+            REQUIRE_FALSE(rtc::PngWriter::WriteStream(&stream, c, rtc::Deflate::kMaxLevel + 1u, 1u));
+            REQUIRE_FALSE(rtc::PngWriter::WriteStream(&stream, rtc::Canvas{ 0u, 0u }, 6u, 1u));
+            REQUIRE_FALSE(rtc::PngWriter::WriteStream(nullptr, c, 6u, 1u));
+        }
+    }
+}
+
+SCENARIO("Writing a PNG on several threads", "[png]")
+{
+    GIVEN("c <- canvas(160, 1200), which is compressed in several chunks")
+    {
+        const auto c = TestCanvas(160u, 1200u);
+
+        WHEN("the canvas is written on 1 and 4 threads")
+        {
+            auto single   = rtc::MemoryOutputStream{};
+            auto multiple = rtc::MemoryOutputStream{};
+            REQUIRE(rtc::PngWriter::WriteStream(&single, c, 6u, 1u));
+            REQUIRE(rtc::PngWriter::WriteStream(&multiple, c, 6u, 4u));
+
+            THEN("the files are identical and decode to the canvas")
+            {
+                auto png = DecodedPng{};
+                REQUIRE(DecodePng(multiple, png));
+                REQUIRE(png.idat_count > 1u);
+                REQUIRE(MatchesCanvas(png, c));
+
+                REQUIRE(single.GetSize() == multiple.GetSize());
+                REQUIRE(std::equal(single.GetData(), single.GetData() + single.GetSize(), multiple.GetData()));
+            }
+        }
+    }
+}
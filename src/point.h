@@ -28,15 +28,18 @@
 
 namespace rtc
 {
-    class Point : public Tuple
+    template <typename T>
+    class BasicPoint : public BasicTuple<T>
     {
     public:
-        Point() : Tuple(0.0, 0.0, 0.0, 1.0) {}
+        constexpr BasicPoint() : BasicTuple<T>(T{ 0 }, T{ 0 }, T{ 0 }, T{ 1 }) {}
 
-        Point(const Tuple& tuple) : Tuple(tuple) { assert(IsPoint()); }
+        constexpr BasicPoint(const BasicTuple<T>& tuple) : BasicTuple<T>(tuple) { assert(this->IsPoint()); }
 
-        Point(Tuple&& tuple) : Tuple(std::move(tuple)) { assert(IsPoint()); }
+        constexpr BasicPoint(BasicTuple<T>&& tuple) : BasicTuple<T>(std::move(tuple)) { assert(this->IsPoint()); }
 
-        Point(double x, double y, double z) : Tuple(x, y, z, 1.0) {}
+        constexpr BasicPoint(T x, T y, T z) : BasicTuple<T>(x, y, z, T{ 1 }) {}
     };
+
+    using Point = BasicPoint<Scalar>;
 }
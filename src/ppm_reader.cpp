@@ -0,0 +1,208 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "ppm_reader.h"
+
+#include "color.h"
+#include "double_util.h"
+
+#include <cctype>
+#include <cinttypes>
+#include <fstream>
+
+namespace rtc
+{
+    namespace PpmReader
+    {
+        namespace
+        {
+            constexpr auto kMaxDimension  = 65535u;
+            constexpr auto kMaxColorValue = 65535u;
+
+            // Skip whitespace and comments, which extend from a '#' to the end of the line.
+            void SkipSeparators(std::istream& stream)
+            {
+                for (auto c = stream.peek(); c != std::char_traits<char>::eof(); c = stream.peek())
+                {
+                    if (c == '#')
+                    {
+                        while ((c != std::char_traits<char>::eof()) && (c != '\n'))
+                        {
+                            c = stream.get();
+                        }
+                    }
+                    else if (std::isspace(c))
+                    {
+                        stream.get();
+                    }
+                    else
+                    {
+                        break;
+                    }
+                }
+            }
+
+            bool ReadValue(std::istream& stream, uint32_t max, uint32_t& value)
+            {
+                SkipSeparators(stream);
+
+                auto digits = 0u;
+                value       = 0u;
+
+                for (auto c = stream.peek(); (c != std::char_traits<char>::eof()) && std::isdigit(c); c = stream.peek())
+                {
+                    value = (value * 10u) + static_cast<uint32_t>(c - '0');
+                    stream.get();
+
+                    if ((++digits > 5u) || (value > max))
+                    {
+                        return false;
+                    }
+                }
+
+                return digits > 0u;
+            }
+
+            bool ReadRawValue(std::istream& stream, uint32_t max_color_value, uint32_t& value)
+            {
+                const auto high = stream.get();
+                if (high == std::char_traits<char>::eof())
+                {
+                    return false;
+                }
+
+                value = static_cast<uint32_t>(high);
+
+                if (max_color_value > 255u)
+                {
+                    // Two byte values are most significant byte first.
+                    const auto low = stream.get();
+                    if (low == std::char_traits<char>::eof())
+                    {
+                        return false;
+                    }
+
+                    value = (value << 8u) | static_cast<uint32_t>(low);
+                }
+
+                return value <= max_color_value;
+            }
+
+            // Returns false when the stream is known to hold fewer than size more bytes, so that a header cannot
+            // make the reader allocate a canvas larger than the file. The size of a stream that cannot seek is not
+            // known, and true is returned.
+            bool HasBytes(std::istream& stream, uint64_t size)
+            {
+                const auto position = stream.tellg();
+                if (position < 0)
+                {
+                    return true;
+                }
+
+                if (!stream.seekg(0, std::ios_base::end))
+                {
+                    stream.clear();
+                    stream.seekg(position);
+                    return true;
+                }
+
+                const auto end = stream.tellg();
+                stream.seekg(position);
+
+                return stream && (end >= position) && (static_cast<uint64_t>(end - position) >= size);
+            }
+        }
+
+        std::unique_ptr<Canvas> ReadFile(const std::string& filename)
+        {
+            auto stream = std::ifstream{ filename, std::ios_base::in | std::ios_base::binary };
+
+            if (stream.is_open())
+            {
+                return ReadStream(stream);
+            }
+
+            return nullptr;
+        }
+
+        std::unique_ptr<Canvas> ReadStream(std::istream& stream)
+        {
+            char magic[2] = {};
+            if (!stream.read(magic, 2) || (magic[0] != 'P') || ((magic[1] != '3') && (magic[1] != '6')))
+            {
+                return nullptr;
+            }
+
+            const auto raw = (magic[1] == '6');
+
+            auto width           = 0u;
+            auto height          = 0u;
+            auto max_color_value = 0u;
+
+            if (!ReadValue(stream, kMaxDimension, width) ||
+                !ReadValue(stream, kMaxDimension, height) ||
+                !ReadValue(stream, kMaxColorValue, max_color_value) ||
+                (width == 0u) || (height == 0u) || (max_color_value == 0u))
+            {
+                return nullptr;
+            }
+
+            if (raw && !std::isspace(stream.get()))
+            {
+                // Raw data follows a single whitespace character.
+                return nullptr;
+            }
+
+            // Raw values take one or two bytes, and plain values take a digit and the separator before it.
+            const auto value_count     = static_cast<uint64_t>(width) * height * 3u;
+            const auto bytes_per_value = raw ? ((max_color_value > 255u) ? 2u : 1u) : 2u;
+
+            if (!HasBytes(stream, value_count * bytes_per_value))
+            {
+                return nullptr;
+            }
+
+            auto       canvas = std::make_unique<Canvas>(width, height);
+            const auto scale  = Scalar{ 1 } / static_cast<Scalar>(max_color_value);
+
+            for (uint32_t y = 0u; y < height; ++y)
+            {
+                for (uint32_t x = 0u; x < width; ++x)
+                {
+                    uint32_t rgb[3] = {};
+
+                    for (auto& value : rgb)
+                    {
+                        if (!(raw ? ReadRawValue(stream, max_color_value, value) : ReadValue(stream, max_color_value, value)))
+                        {
+                            return nullptr;
+                        }
+                    }
+
+                    canvas->WritePixel(x, y, Color{ static_cast<Scalar>(rgb[0]) * scale, static_cast<Scalar>(rgb[1]) * scale, static_cast<Scalar>(rgb[2]) * scale });
+                }
+            }
+
+            return canvas;
+        }
+    }
+}
@@ -0,0 +1,140 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "ppm_stream_writer.h"
+
+#include "ppm_writer.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace rtc
+{
+    PpmStreamWriter::PpmStreamWriter(OutputStream* stream, uint32_t width, uint32_t height, uint32_t max_pending_rows) :
+        stream_(stream),
+        width_(width),
+        height_(height),
+        max_pending_rows_(max_pending_rows)
+    {
+    }
+
+    uint32_t PpmStreamWriter::GetPeakPendingRowCount() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return peak_pending_rows_;
+    }
+
+    uint32_t PpmStreamWriter::GetNextRow() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return next_row_;
+    }
+
+    bool PpmStreamWriter::WriteBand(uint32_t first_row, const Canvas& band)
+    {
+        const auto row_count = band.GetHeight();
+
+        if ((stream_ == nullptr) || (band.GetWidth() != width_) || (row_count == 0u) || (first_row >= height_) || (row_count > (height_ - first_row)))
+        {
+            return false;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        condition_.wait(lock, [&]() { return failed_ || (first_row <= next_row_) || ((pending_rows_ + row_count) <= max_pending_rows_); });
+
+        if (failed_ || (first_row < next_row_) || Overlaps(first_row, row_count))
+        {
+            return false;
+        }
+
+        if (first_row != next_row_)
+        {
+            pending_.emplace(first_row, band);
+            pending_rows_ += row_count;
+            peak_pending_rows_ = std::max(peak_pending_rows_, pending_rows_);
+            return true;
+        }
+
+        auto success = WriteRows(first_row, band);
+
+        // Write the held bands that follow the band without a gap.
+        auto held = pending_.begin();
+        while (success && (held != pending_.end()) && (held->first == next_row_))
+        {
+            success = WriteRows(held->first, held->second);
+            pending_rows_ -= held->second.GetHeight();
+            held = pending_.erase(held);
+        }
+
+        if (success && (next_row_ == height_))
+        {
+            success = stream_->Write("\n", 1);
+        }
+
+        failed_ = !success;
+
+        lock.unlock();
+        condition_.notify_all();
+
+        return success;
+    }
+
+    void PpmStreamWriter::Abort()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            failed_ = true;
+        }
+
+        condition_.notify_all();
+    }
+
+    bool PpmStreamWriter::WriteRows(uint32_t first_row, const Canvas& band)
+    {
+        if ((first_row == 0u) && !PpmWriter::WriteHeader(stream_, width_, height_))
+        {
+            return false;
+        }
+
+        next_row_ = first_row + band.GetHeight();
+        return PpmWriter::WriteRows(stream_, band, width_, 0u, band.GetHeight());
+    }
+
+    bool PpmStreamWriter::Overlaps(uint32_t first_row, uint32_t row_count) const
+    {
+        // The held band starting at or after first_row, and the one before it.
+        const auto after = pending_.lower_bound(first_row);
+        if ((after != pending_.end()) && (after->first < (first_row + row_count)))
+        {
+            return true;
+        }
+
+        if (after != pending_.begin())
+        {
+            const auto before = std::prev(after);
+            return (before->first + before->second.GetHeight()) > first_row;
+        }
+
+        return false;
+    }
+}
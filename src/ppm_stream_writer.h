@@ -0,0 +1,86 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#pragma once
+
+#include "canvas.h"
+#include "output_stream.h"
+
+#include <cinttypes>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+
+namespace rtc
+{
+    // Incremental PPM encoder for an image delivered as bands of rows, so that an image can be written without
+    // holding all of its pixels. Bands may arrive in any order, from any thread. A band that starts at the
+    // next row to write is written at once, followed by any held bands that it makes contiguous; other bands
+    // are held until the rows before them arrive. A band that would exceed the limit on held rows waits for
+    // earlier rows to be written, unless it starts at the next row, so the limit cannot deadlock writers that
+    // deliver the bands they claim in order.
+    class PpmStreamWriter
+    {
+    public:
+        PpmStreamWriter(OutputStream* stream, uint32_t width, uint32_t height, uint32_t max_pending_rows);
+
+        uint32_t GetWidth() const { return width_; }
+
+        uint32_t GetHeight() const { return height_; }
+
+        uint32_t GetMaxPendingRowCount() const { return max_pending_rows_; }
+
+        // Largest number of rows held at once.
+        uint32_t GetPeakPendingRowCount() const;
+
+        // Index of the first row that has not been written.
+        uint32_t GetNextRow() const;
+
+        bool IsComplete() const { return GetNextRow() == height_; }
+
+        // Write, or hold, the band whose first row is the image row first_row. Returns false when the band is
+        // not the image width, extends past the image, overlaps rows already delivered, or a write failed.
+        bool WriteBand(uint32_t first_row, const Canvas& band);
+
+        // Fail the image, so that waiting and later calls to WriteBand() return false. Called when a band will
+        // never be delivered, such as when a render is cancelled, to release the writers waiting for it.
+        void Abort();
+
+    private:
+        bool WriteRows(uint32_t first_row, const Canvas& band);
+
+        bool Overlaps(uint32_t first_row, uint32_t row_count) const;
+
+    private:
+        OutputStream*              stream_;                  ///< Destination of the encoded image.
+        uint32_t                   width_;                   ///< Width of the image and each band.
+        uint32_t                   height_;                  ///< Height of the image.
+        uint32_t                   max_pending_rows_;        ///< Limit on the number of rows held.
+        mutable std::mutex         mutex_;                   ///< Guards the members below.
+        std::condition_variable    condition_;               ///< Signaled when rows are written.
+        std::map<uint32_t, Canvas> pending_;                 ///< Held bands, by first row.
+        uint32_t                   pending_rows_{ 0u };      ///< Number of rows held.
+        uint32_t                   peak_pending_rows_{ 0u }; ///< Largest number of rows held.
+        uint32_t                   next_row_{ 0u };          ///< First row that has not been written.
+        bool                       failed_{ false };         ///< A write to the stream failed, or the image was aborted.
+    };
+}
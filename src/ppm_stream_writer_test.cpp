@@ -0,0 +1,263 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "catch2/catch.hpp"
+
+#include "camera.h"
+#include "cancellation_token.h"
+#include "canvas.h"
+#include "color.h"
+#include "double_util.h"
+#include "matrix44.h"
+#include "memory_output_stream.h"
+#include "point.h"
+#include "ppm_stream_writer.h"
+#include "ppm_writer.h"
+#include "vector.h"
+#include "world.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    rtc::Canvas TestCanvas(uint32_t width, uint32_t height)
+    {
+        auto canvas = rtc::Canvas{ width, height };
+
+        for (uint32_t y = 0u; y < height; ++y)
+        {
+            for (uint32_t x = 0u; x < width; ++x)
+            {
+                const auto r = static_cast<rtc::Scalar>(x) / static_cast<rtc::Scalar>(width);
+                const auto g = static_cast<rtc::Scalar>(y) / static_cast<rtc::Scalar>(height);
+                canvas.WritePixel(x, y, rtc::Color{ r, g, static_cast<rtc::Scalar>(0.5) });
+            }
+        }
+
+        return canvas;
+    }
+
+    rtc::Canvas Band(const rtc::Canvas& canvas, uint32_t first_row, uint32_t row_count)
+    {
+        auto band = rtc::Canvas{ canvas.GetWidth(), row_count };
+
+        for (uint32_t y = 0u; y < row_count; ++y)
+        {
+            for (uint32_t x = 0u; x < canvas.GetWidth(); ++x)
+            {
+                band.WritePixel(x, y, canvas.PixelAt(x, first_row + y));
+            }
+        }
+
+        return band;
+    }
+
+    std::string ToString(const rtc::MemoryOutputStream& stream)
+    {
+        return std::string{ reinterpret_cast<const char*>(stream.GetData()), stream.GetSize() };
+    }
+
+    std::string EncodePpm(const rtc::Canvas& canvas)
+    {
+        auto stream = rtc::MemoryOutputStream{};
+        rtc::PpmWriter::WriteStream(&stream, canvas);
+        return ToString(stream);
+    }
+}
+
+SCENARIO("Writing bands of rows out of order", "[ppm_stream]")
+{
+    GIVEN("c <- canvas(5, 9) and writer <- ppm_stream_writer(stream, 5, 9, 9)")
+    {
+        const auto c      = TestCanvas(5u, 9u);
+        auto       stream = rtc::MemoryOutputStream{};
+        auto       writer = rtc::PpmStreamWriter{ &stream, 5u, 9u, 9u };
+
+        WHEN("the bands are written bottom to top")
+        {
+            REQUIRE(writer.WriteBand(6u, Band(c, 6u, 3u)));
+            REQUIRE(writer.WriteBand(3u, Band(c, 3u, 3u)));
+
+            THEN("nothing is written until the first row arrives")
+            {
+                REQUIRE(stream.GetSize() == 0u);
+                REQUIRE(writer.GetNextRow() == 0u);
+                REQUIRE(writer.GetPeakPendingRowCount() == 6u);
+            }
+
+            AND_WHEN("the first band is written")
+            {
+                REQUIRE(writer.WriteBand(0u, Band(c, 0u, 3u)));
+
+                THEN("the stream matches the PPM of the whole canvas")
+                {
+                    REQUIRE(writer.IsComplete());
+                    REQUIRE(ToString(stream) == EncodePpm(c));
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Rejecting bands that do not fit the image", "[ppm_stream]")
+{
+    GIVEN("writer <- ppm_stream_writer(stream, 5, 9, 9)")
+    {
+        const auto c      = TestCanvas(5u, 9u);
+        auto       stream = rtc::MemoryOutputStream{};
+        auto       writer = rtc::PpmStreamWriter{ &stream, 5u, 9u, 9u };
+
+        THEN("bands of the wrong width, past the image, or overlapping other bands are rejected")
+        {
+            REQUIRE_FALSE(writer.WriteBand(0u, rtc::Canvas{ 4u, 3u }));
+            REQUIRE_FALSE(writer.WriteBand(7u, Band(c, 6u, 3u)));
+            REQUIRE_FALSE(writer.WriteBand(9u, Band(c, 0u, 1u)));
+
+            REQUIRE(writer.WriteBand(4u, Band(c, 4u, 2u)));
+            REQUIRE_FALSE(writer.WriteBand(5u, Band(c, 5u, 2u)));
+            REQUIRE_FALSE(writer.WriteBand(3u, Band(c, 3u, 2u)));
+
+            REQUIRE(writer.WriteBand(0u, Band(c, 0u, 4u)));
+            REQUIRE_FALSE(writer.WriteBand(2u, Band(c, 2u, 1u)));
+            REQUIRE(writer.GetNextRow() == 6u);
+        }
+    }
+}
+
+SCENARIO("Limiting the rows held by the writer", "[ppm_stream]")
+{
+    GIVEN("c <- canvas(4, 64) and writer <- ppm_stream_writer(stream, 4, 64, 8)")
+    {
+        const auto c      = TestCanvas(4u, 64u);
+        auto       stream = rtc::MemoryOutputStream{};
+        auto       writer = rtc::PpmStreamWriter{ &stream, 4u, 64u, 8u };
+
+        WHEN("four threads write interleaved bands of 2 rows in reverse pairs")
+        {
+            auto threads = std::vector<std::thread>{};
+            auto results = std::vector<int>(4u, 1);
+
+            for (uint32_t t = 0u; t < 4u; ++t)
+            {
+                threads.emplace_back([&, t]() {
+                    // Each thread writes bands t, t + 4, t + 8, ... of the 32 bands.
+                    for (uint32_t band = t; band < 32u; band += 4u)
+                    {
+                        if (!writer.WriteBand(band * 2u, Band(c, band * 2u, 2u)))
+                        {
+                            results[t] = 0;
+                        }
+                    }
+                });
+            }
+
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+
+            THEN("every band is written and the held rows never exceed the limit")
+            {
+                REQUIRE(results == std::vector<int>(4u, 1));
+                REQUIRE(writer.IsComplete());
+                REQUIRE(writer.GetPeakPendingRowCount() <= 8u);
+                REQUIRE(ToString(stream) == EncodePpm(c));
+            }
+        }
+    }
+}
+
+SCENARIO("Rendering an image in bands to a streaming writer", "[ppm_stream]")
+{
+    GIVEN("the default world and a 21x13 camera")
+    {
+        const auto w    = rtc::World::GetDefault();
+        const auto from = rtc::Point{ 0.0, 0.0, -5.0 };
+        const auto to   = rtc::Point{ 0.0, 0.0, 0.0 };
+        const auto up   = rtc::Vector{ 0.0, 1.0, 0.0 };
+        const auto c    = rtc::Camera{ 21u, 13u, rtc::kPi / 2.0, rtc::Matrix44::ViewTransform(from, to, up) };
+
+        WHEN("the image is rendered in bands of 2 rows on 3 threads")
+        {
+            auto stream = rtc::MemoryOutputStream{};
+            auto writer = rtc::PpmStreamWriter{ &stream, 21u, 13u, 6u };
+
+            const auto rendered = c.RenderBands(w, 2u, 3u, [&](uint32_t first_row, const rtc::Canvas& band) { return writer.WriteBand(first_row, band); });
+
+            THEN("the stream matches the PPM of the whole image")
+            {
+                REQUIRE(rendered);
+                REQUIRE(writer.IsComplete());
+                REQUIRE(writer.GetPeakPendingRowCount() <= 6u);
+                REQUIRE(ToString(stream) == EncodePpm(c.Render(w)));
+            }
+        }
+
+        WHEN("the render is cancelled while the first band is missing and later bands wait for it")
+        {
+            auto stream = rtc::MemoryOutputStream{};
+            auto writer = rtc::PpmStreamWriter{ &stream, 21u, 13u, 1u };
+            auto token  = rtc::CancellationToken{};
+
+            const auto write_band = [&](uint32_t first_row, const rtc::Canvas& band) {
+                if (first_row != 0u)
+                {
+                    return writer.WriteBand(first_row, band);
+                }
+
+                // Hold the first band back until a later band is held and the writers after it wait on the limit,
+                // then drop it, as the render of a cancelled band would.
+                const auto start = std::chrono::steady_clock::now();
+                while ((writer.GetPeakPendingRowCount() == 0u) && ((std::chrono::steady_clock::now() - start) < std::chrono::seconds{ 5 }))
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+                }
+
+                std::this_thread::sleep_for(std::chrono::milliseconds{ 20 });
+                token.Cancel();
+                return false;
+            };
+
+            const auto rendered = c.RenderBands(w, 1u, 3u, write_band, &token, [&writer]() { writer.Abort(); });
+
+            THEN("aborting the writer releases the waiting threads and the render fails")
+            {
+                REQUIRE_FALSE(rendered);
+                REQUIRE_FALSE(writer.IsComplete());
+                REQUIRE_FALSE(writer.WriteBand(0u, rtc::Canvas{ 21u, 1u }));
+            }
+        }
+
+        WHEN("the writer rejects a band")
+        {
+            const auto rendered = c.RenderBands(w, 4u, 2u, [](uint32_t first_row, const rtc::Canvas&) { return first_row != 4u; });
+
+            THEN("the render fails")
+            {
+                REQUIRE_FALSE(rendered);
+            }
+        }
+    }
+}
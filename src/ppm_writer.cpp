@@ -22,11 +22,13 @@
 
 #include "ppm_writer.h"
 
+#include "async_file_output_stream.h"
 #include "color.h"
 #include "double_util.h"
 #include "file_output_stream.h"
 
 #include <cassert>
+#include <memory>
 
 namespace rtc
 {
@@ -48,6 +50,19 @@ namespace rtc
             return false;
         }
 
+        std::future<bool> WriteFileAsync(const std::string& filename, const Canvas& canvas)
+        {
+            auto stream  = std::make_shared<AsyncFileOutputStream>(filename);
+            auto written = stream->IsValid() && WriteStream(stream.get(), canvas);
+            auto closed  = stream->Close();
+
+            // The deferred function holds the stream, which is closed and destroyed after the write completes.
+            return std::async(std::launch::deferred, [stream, written, closed = std::move(closed)]() mutable {
+                const auto success = closed.get();
+                return written && success;
+            });
+        }
+
         bool WriteStream(OutputStream* stream, const Canvas& canvas)
         {
             auto success = false;
@@ -86,6 +101,11 @@ namespace rtc
         }
 
         bool WriteData(OutputStream* stream, const Canvas& canvas, uint32_t width, uint32_t height)
+        {
+            return WriteRows(stream, canvas, width, 0u, height);
+        }
+
+        bool WriteRows(OutputStream* stream, const Canvas& canvas, uint32_t width, uint32_t first_row, uint32_t row_count)
         {
             auto success = false;
 
@@ -96,7 +116,7 @@ namespace rtc
 
                 success = true;
 
-                for (uint32_t y = 0u; y < height; ++y)
+                for (uint32_t y = first_row; y < (first_row + row_count); ++y)
                 {
                     for (uint32_t x = 0u; x < width; ++x)
                     {
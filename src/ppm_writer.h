@@ -26,6 +26,7 @@
 #include "output_stream.h"
 
 #include <cinttypes>
+#include <future>
 #include <string>
 
 namespace rtc
@@ -34,10 +35,19 @@ namespace rtc
     {
         bool WriteFile(const std::string& filename, const Canvas& canvas);
 
+        // Encode the canvas on the calling thread and write the file from a background thread, returning when
+        // the canvas may be reused. The future reports whether the file was written; destroying it waits for
+        // the write to complete.
+        std::future<bool> WriteFileAsync(const std::string& filename, const Canvas& canvas);
+
         bool WriteStream(OutputStream* stream, const Canvas& canvas);
 
         bool WriteHeader(OutputStream* stream, uint32_t width, uint32_t height);
 
         bool WriteData(OutputStream* stream, const Canvas& canvas, uint32_t width, uint32_t height);
+
+        // Write the pixel data of rows [first_row, first_row + row_count) of the canvas. Each row is encoded on
+        // its own lines, so an image can be written as a sequence of row chunks after its header.
+        bool WriteRows(OutputStream* stream, const Canvas& canvas, uint32_t width, uint32_t first_row, uint32_t row_count);
     };
 }
@@ -0,0 +1,246 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "preview_protocol.h"
+
+#include <sstream>
+
+namespace rtc
+{
+    namespace PreviewProtocol
+    {
+        namespace
+        {
+            // Returns true when the remainder of the stream is whitespace.
+            bool IsAtEnd(std::istringstream& stream)
+            {
+                stream >> std::ws;
+                return stream.eof();
+            }
+
+            bool ParseMaterial(size_t index, std::istringstream& stream, PreviewRenderer::Edit& edit)
+            {
+                auto property = std::string{};
+                stream >> property;
+
+                if (property == "color")
+                {
+                    auto r = Scalar{ 0 };
+                    auto g = Scalar{ 0 };
+                    auto b = Scalar{ 0 };
+
+                    if (!(stream >> r >> g >> b) || !IsAtEnd(stream))
+                    {
+                        return false;
+                    }
+
+                    const auto color = Color{ r, g, b };
+                    edit             = [index, color](World& world, Camera&) {
+                        if (index < world.GetObjectCount())
+                        {
+                            const auto& object   = world.GetObject(index);
+                            auto        material = object->GetMaterial();
+                            material.SetColor(color);
+                            object->SetMaterial(std::move(material));
+                        }
+                    };
+
+                    return true;
+                }
+
+                using Setter = void (Material::*)(Scalar);
+
+                auto setter = Setter{ nullptr };
+
+                if (property == "ambient")
+                {
+                    setter = &Material::SetAmbient;
+                }
+                else if (property == "diffuse")
+                {
+                    setter = &Material::SetDiffuse;
+                }
+                else if (property == "specular")
+                {
+                    setter = &Material::SetSpecular;
+                }
+                else if (property == "shininess")
+                {
+                    setter = &Material::SetShininess;
+                }
+                else if (property == "reflective")
+                {
+                    setter = &Material::SetReflective;
+                }
+                else if (property == "transparency")
+                {
+                    setter = &Material::SetTransparency;
+                }
+                else if (property == "refractive_index")
+                {
+                    setter = &Material::SetRefractiveIndex;
+                }
+                else
+                {
+                    return false;
+                }
+
+                auto value = Scalar{ 0 };
+
+                if (!(stream >> value) || !IsAtEnd(stream))
+                {
+                    return false;
+                }
+
+                edit = [index, setter, value](World& world, Camera&) {
+                    if (index < world.GetObjectCount())
+                    {
+                        const auto& object   = world.GetObject(index);
+                        auto        material = object->GetMaterial();
+                        (material.*setter)(value);
+                        object->SetMaterial(std::move(material));
+                    }
+                };
+
+                return true;
+            }
+        }
+
+        bool Parse(const std::string& line, PreviewRenderer::Edit& edit)
+        {
+            auto stream  = std::istringstream{ line };
+            auto command = std::string{};
+
+            if (!(stream >> command))
+            {
+                return false;
+            }
+
+            if (command == "camera")
+            {
+                auto fx = Scalar{ 0 };
+                auto fy = Scalar{ 0 };
+                auto fz = Scalar{ 0 };
+                auto tx = Scalar{ 0 };
+                auto ty = Scalar{ 0 };
+                auto tz = Scalar{ 0 };
+
+                if (!(stream >> fx >> fy >> fz >> tx >> ty >> tz) || !IsAtEnd(stream))
+                {
+                    return false;
+                }
+
+                const auto from    = Point{ fx, fy, fz };
+                const auto to      = Point{ tx, ty, tz };
+                const auto up      = Vector{ 0, 1, 0 };
+                const auto forward = Vector{ Vector::Subtract(to, from) };
+
+                // The view is undefined when the camera looks at its own position, or straight along the up vector.
+                if (!(forward.Magnitude() > kEpsilon) || !(Vector::Cross(Vector::Normalize(forward), up).Magnitude() > kEpsilon))
+                {
+                    return false;
+                }
+
+                const auto transform = Matrix44::ViewTransform(from, to, up);
+                edit                 = [transform](World&, Camera& camera) { camera.SetTransform(transform); };
+
+                return true;
+            }
+            else if (command == "fov")
+            {
+                auto field_of_view = Scalar{ 0 };
+
+                if (!(stream >> field_of_view) || !IsAtEnd(stream) || !(field_of_view > 0) || !(field_of_view < kPi))
+                {
+                    return false;
+                }
+
+                edit = [field_of_view](World&, Camera& camera) {
+                    camera = Camera{ camera.GetHSize(), camera.GetVSize(), field_of_view, camera.GetTransform() };
+                };
+
+                return true;
+            }
+            else if (command == "light")
+            {
+                auto index = size_t{ 0u };
+                auto x     = Scalar{ 0 };
+                auto y     = Scalar{ 0 };
+                auto z     = Scalar{ 0 };
+                auto r     = Scalar{ 0 };
+                auto g     = Scalar{ 0 };
+                auto b     = Scalar{ 0 };
+
+                if (!(stream >> index >> x >> y >> z >> r >> g >> b) || !IsAtEnd(stream))
+                {
+                    return false;
+                }
+
+                const auto light = PointLight{ Point{ x, y, z }, Color{ r, g, b } };
+                edit             = [index, light](World& world, Camera&) {
+                    if (index < world.GetLightCount())
+                    {
+                        world.SetLight(index, light);
+                    }
+                };
+
+                return true;
+            }
+            else if (command == "translate")
+            {
+                auto index = size_t{ 0u };
+                auto x     = Scalar{ 0 };
+                auto y     = Scalar{ 0 };
+                auto z     = Scalar{ 0 };
+
+                if (!(stream >> index >> x >> y >> z) || !IsAtEnd(stream))
+                {
+                    return false;
+                }
+
+                const auto translation = Matrix44::Translation(x, y, z);
+                edit                   = [index, translation](World& world, Camera&) {
+                    if (index < world.GetObjectCount())
+                    {
+                        const auto& object = world.GetObject(index);
+                        object->SetTransform(Matrix44::Multiply(translation, object->GetTransform()));
+                    }
+                };
+
+                return true;
+            }
+            else if (command == "material")
+            {
+                auto index = size_t{ 0u };
+
+                if (!(stream >> index))
+                {
+                    return false;
+                }
+
+                return ParseMaterial(index, stream, edit);
+            }
+
+            return false;
+        }
+    }
+}
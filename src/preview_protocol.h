@@ -0,0 +1,46 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#pragma once
+
+#include "preview_renderer.h"
+
+#include <string>
+
+namespace rtc
+{
+    namespace PreviewProtocol
+    {
+        // Parse a line of the preview protocol into an edit, returning false when the line is not a valid command.
+        // Objects and lights are referenced by their index in the world, and edits of an index outside of the
+        // world are ignored. Angles are in radians. The commands are:
+        //   camera <from x> <from y> <from z> <to x> <to y> <to z>   Point the camera, with up along y. The camera
+        //                                                             cannot look straight up or down, or at itself.
+        //   fov <angle>                                               Set the camera's field of view, below pi.
+        //   light <index> <x> <y> <z> <r> <g> <b>                     Set a light's position and intensity.
+        //   translate <index> <x> <y> <z>                             Move an object by an offset.
+        //   material <index> color <r> <g> <b>                        Set a material's color.
+        //   material <index> <property> <value>                       Set ambient, diffuse, specular, shininess,
+        //                                                             reflective, transparency or refractive_index.
+        bool Parse(const std::string& line, PreviewRenderer::Edit& edit);
+    }
+}
@@ -0,0 +1,227 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "preview_renderer.h"
+
+#include <algorithm>
+#include <exception>
+
+namespace rtc
+{
+    namespace
+    {
+        // Rows rendered by a thread at a time, small enough that the passes at a fraction of the image size are
+        // divided between several threads.
+        constexpr uint32_t kBandHeight = 4u;
+    }
+
+    PreviewRenderer::PreviewRenderer(World&& world, const Camera& camera, uint32_t thread_count, const FrameWriter& writer) :
+        PreviewRenderer(std::move(world), camera, thread_count, writer, nullptr)
+    {
+    }
+
+    PreviewRenderer::PreviewRenderer(World&& world, const Camera& camera, uint32_t thread_count, const FrameWriter& writer, const ErrorWriter& error_writer) :
+        world_(std::move(world)),
+        camera_(camera),
+        thread_count_(thread_count),
+        writer_(writer),
+        error_writer_(error_writer)
+    {
+    }
+
+    PreviewRenderer::~PreviewRenderer()
+    {
+        Stop();
+    }
+
+    bool PreviewRenderer::Start()
+    {
+        auto lock = std::lock_guard<std::mutex>{ mutex_ };
+
+        if (thread_.joinable() || stopping_)
+        {
+            return false;
+        }
+
+        edit_time_ = std::chrono::steady_clock::now();
+        thread_    = std::thread{ &PreviewRenderer::Run, this };
+
+        return true;
+    }
+
+    uint64_t PreviewRenderer::Update(const Edit& edit)
+    {
+        auto revision = uint64_t{ 0u };
+
+        {
+            auto lock = std::lock_guard<std::mutex>{ mutex_ };
+
+            edits_.push_back(edit);
+            revision   = ++revision_;
+            edit_time_ = std::chrono::steady_clock::now();
+            cancellation_.Cancel();
+        }
+
+        condition_.notify_all();
+
+        return revision;
+    }
+
+    void PreviewRenderer::Wait()
+    {
+        auto lock = std::unique_lock<std::mutex>{ mutex_ };
+        condition_.wait(lock, [this]() { return stopping_ || (rendered_revision_ == revision_); });
+    }
+
+    void PreviewRenderer::Stop()
+    {
+        {
+            auto lock = std::lock_guard<std::mutex>{ mutex_ };
+
+            stopping_ = true;
+            edits_.clear();
+            cancellation_.Cancel();
+        }
+
+        condition_.notify_all();
+
+        if (thread_.joinable())
+        {
+            thread_.join();
+        }
+    }
+
+    uint64_t PreviewRenderer::GetRevision() const
+    {
+        auto lock = std::lock_guard<std::mutex>{ mutex_ };
+        return revision_;
+    }
+
+    void PreviewRenderer::Run()
+    {
+        for (;;)
+        {
+            auto edits     = std::vector<Edit>{};
+            auto revision  = uint64_t{ 0u };
+            auto edit_time = std::chrono::steady_clock::time_point{};
+
+            {
+                auto lock = std::unique_lock<std::mutex>{ mutex_ };
+                condition_.wait(lock, [this]() { return stopping_ || (rendered_revision_ != revision_); });
+
+                if (stopping_)
+                {
+                    return;
+                }
+
+                // Edits made after this point cancel the render of this revision.
+                edits.swap(edits_);
+                revision  = revision_;
+                edit_time = edit_time_;
+                cancellation_.Reset();
+            }
+
+            for (const auto& edit : edits)
+            {
+                // An edit that fails is skipped, instead of ending the render thread, so that a client cannot
+                // stop the preview with an invalid edit.
+                try
+                {
+                    edit(world_, camera_);
+                }
+                catch (const std::exception& exception)
+                {
+                    if (error_writer_)
+                    {
+                        error_writer_(revision, exception.what());
+                    }
+                }
+            }
+
+            if (RenderRevision(revision, edit_time))
+            {
+                {
+                    auto lock          = std::lock_guard<std::mutex>{ mutex_ };
+                    rendered_revision_ = revision;
+                }
+
+                condition_.notify_all();
+            }
+        }
+    }
+
+    bool PreviewRenderer::RenderRevision(uint64_t revision, std::chrono::steady_clock::time_point edit_time)
+    {
+        const auto hsize = camera_.GetHSize();
+        const auto vsize = camera_.GetVSize();
+
+        auto image = Canvas{ hsize, vsize };
+
+        for (auto scale = kMaxScale; scale > 0u; scale /= 2u)
+        {
+            const auto width  = std::max(hsize / scale, 1u);
+            const auto height = std::max(vsize / scale, 1u);
+            const auto camera = (scale == 1u) ? camera_ : Camera{ width, height, camera_.GetFieldOfView(), camera_.GetTransform() };
+
+            auto pass = Canvas{ width, height };
+
+            const auto copy_band = [&pass, width](uint32_t first_row, const Canvas& band) {
+                for (uint32_t y = 0u; y < band.GetHeight(); ++y)
+                {
+                    for (uint32_t x = 0u; x < width; ++x)
+                    {
+                        pass.WritePixel(x, first_row + y, band.PixelAt(x, y));
+                    }
+                }
+
+                return true;
+            };
+
+            if (!camera.RenderBands(world_, kBandHeight, thread_count_, copy_band, &cancellation_))
+            {
+                return false;
+            }
+
+            if (scale > 1u)
+            {
+                // Scale the pass up to the full size, repeating each pixel.
+                for (uint32_t y = 0u; y < vsize; ++y)
+                {
+                    for (uint32_t x = 0u; x < hsize; ++x)
+                    {
+                        image.WritePixel(x, y, pass.PixelAt(std::min(x / scale, width - 1u), std::min(y / scale, height - 1u)));
+                    }
+                }
+            }
+
+            const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - edit_time);
+            writer_(revision, scale, latency, (scale > 1u) ? image : pass);
+
+            if (cancellation_.IsCancelled())
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
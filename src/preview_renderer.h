@@ -0,0 +1,115 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#pragma once
+
+#include "camera.h"
+#include "cancellation_token.h"
+#include "canvas.h"
+#include "world.h"
+
+#include <chrono>
+#include <cinttypes>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace rtc
+{
+    // Renders a scene in the background for interactive previews, restarting whenever the scene is edited. Each
+    // revision of the scene is rendered in passes of increasing resolution, from an eighth of the image size to
+    // the full size, and each pass is handed to the writer scaled up to the full size. An edit cancels the render
+    // in flight, which stops within a pixel, so the first pass of the edited scene follows the edit by about the
+    // time to render an image 1/64 of the size.
+    //
+    // The world and camera are owned by the renderer and only accessed by its render thread, which applies edits
+    // between renders.
+    class PreviewRenderer
+    {
+    public:
+        // Change to the scene, applied on the render thread.
+        using Edit = std::function<void(World& world, Camera& camera)>;
+
+        // Receive a pass of the render of a revision, at 1/scale of the image size, and the time since the edit
+        // that started the revision. Called from the render thread, which may call Update().
+        using FrameWriter = std::function<void(uint64_t revision, uint32_t scale, std::chrono::microseconds latency, const Canvas& image)>;
+
+        // Receive the message of an exception thrown by an edit, which was skipped when the scene was updated for
+        // the revision. Called from the render thread, which may call Update().
+        using ErrorWriter = std::function<void(uint64_t revision, const std::string& error)>;
+
+        // Scale of the first pass; each following pass halves the scale.
+        static constexpr uint32_t kMaxScale = 8u;
+
+    public:
+        PreviewRenderer(World&& world, const Camera& camera, uint32_t thread_count, const FrameWriter& writer);
+
+        PreviewRenderer(World&& world, const Camera& camera, uint32_t thread_count, const FrameWriter& writer, const ErrorWriter& error_writer);
+
+        ~PreviewRenderer();
+
+        PreviewRenderer(const PreviewRenderer&) = delete;
+
+        PreviewRenderer& operator=(const PreviewRenderer&) = delete;
+
+        // Start rendering the first revision, of the scene as constructed. Returns false when already started.
+        bool Start();
+
+        // Queue an edit and cancel the render in flight, starting a render of the next revision, whose number is
+        // returned.
+        uint64_t Update(const Edit& edit);
+
+        // Block until the last revision has been rendered at the full size, or rendering has stopped.
+        void Wait();
+
+        // Cancel the render in flight and stop the render thread. Queued edits are discarded.
+        void Stop();
+
+        // Number of the latest revision; the scene as constructed is revision 1.
+        uint64_t GetRevision() const;
+
+    private:
+        void Run();
+
+        // Render passes of the revision until the full size pass is complete, returning false when cancelled.
+        bool RenderRevision(uint64_t revision, std::chrono::steady_clock::time_point edit_time);
+
+    private:
+        World                                 world_;                   ///< Scene rendered by the render thread.
+        Camera                                camera_;                  ///< Camera of the full size image.
+        uint32_t                              thread_count_;            ///< Number of threads to render with; 0 for one for each hardware thread.
+        FrameWriter                           writer_;                  ///< Receives each completed pass.
+        ErrorWriter                           error_writer_;            ///< Receives the errors of failed edits; may be empty.
+        CancellationToken                     cancellation_;            ///< Cancels the render in flight when the scene is edited or the renderer stops.
+        mutable std::mutex                    mutex_;                   ///< Protects the state below.
+        std::condition_variable               condition_;               ///< Signals edits, stopping, and completed revisions.
+        std::vector<Edit>                     edits_;                   ///< Edits not yet applied to the scene.
+        uint64_t                              revision_{ 1u };          ///< Latest revision.
+        uint64_t                              rendered_revision_{ 0u }; ///< Latest revision rendered at the full size.
+        std::chrono::steady_clock::time_point edit_time_;               ///< Time of the latest edit, or of the start.
+        bool                                  stopping_{ false };       ///< Indicates that the render thread should exit.
+        std::thread                           thread_;                  ///< Render thread.
+    };
+}
@@ -0,0 +1,433 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "catch2/catch.hpp"
+
+#include "camera.h"
+#include "cancellation_token.h"
+#include "canvas.h"
+#include "color.h"
+#include "double_util.h"
+#include "matrix44.h"
+#include "point.h"
+#include "point_light.h"
+#include "preview_protocol.h"
+#include "preview_renderer.h"
+#include "vector.h"
+#include "world.h"
+
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr auto kThirdPi = static_cast<rtc::Scalar>(rtc::kPi / 3.0);
+
+    struct Frame
+    {
+        uint64_t    revision;
+        uint32_t    scale;
+        rtc::Canvas image;
+    };
+
+    rtc::Camera PreviewCamera()
+    {
+        return rtc::Camera{ 32u, 16u, kThirdPi, rtc::Matrix44::ViewTransform(rtc::Point{ 0.0, 1.5, -5.0 }, rtc::Point{ 0.0, 0.0, 0.0 }, rtc::Vector{ 0.0, 1.0, 0.0 }) };
+    }
+
+    bool CanvasEqual(const rtc::Canvas& lhs, const rtc::Canvas& rhs)
+    {
+        if ((lhs.GetWidth() != rhs.GetWidth()) || (lhs.GetHeight() != rhs.GetHeight()))
+        {
+            return false;
+        }
+
+        for (uint32_t y = 0u; y < lhs.GetHeight(); ++y)
+        {
+            for (uint32_t x = 0u; x < lhs.GetWidth(); ++x)
+            {
+                if (!rtc::Color::Equal(lhs.PixelAt(x, y), rhs.PixelAt(x, y)))
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+}
+
+SCENARIO("A cancellation token", "[preview]")
+{
+    GIVEN("token = cancellation_token()")
+    {
+        auto token = rtc::CancellationToken{};
+
+        THEN("token is not cancelled")
+        {
+            REQUIRE(!token.IsCancelled());
+        }
+
+        WHEN("token.cancel()")
+        {
+            token.Cancel();
+
+            THEN("token is cancelled")
+            {
+                REQUIRE(token.IsCancelled());
+            }
+
+            AND_WHEN("token.reset()")
+            {
+                token.Reset();
+
+                THEN("token is not cancelled")
+                {
+                    REQUIRE(!token.IsCancelled());
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Rendering bands with a cancelled token", "[preview]")
+{
+    GIVEN("w = default_world()")
+    {
+        const auto w = rtc::World::GetDefault();
+
+        AND_GIVEN("c = camera(32, 16, π/3) with a cancelled token")
+        {
+            const auto c     = PreviewCamera();
+            auto       token = rtc::CancellationToken{};
+            token.Cancel();
+
+            WHEN("the image is rendered in bands")
+            {
+                auto band_count = 0u;
+
+                const auto result = c.RenderBands(
+                    w, 4u, 2u,
+                    [&band_count](uint32_t, const rtc::Canvas&) {
+                        ++band_count;
+                        return true;
+                    },
+                    &token);
+
+                THEN("the render fails without writing a band")
+                {
+                    REQUIRE(!result);
+                    REQUIRE(band_count == 0u);
+                }
+            }
+        }
+
+        AND_GIVEN("c = camera(32, 16, π/3) with a token that is not cancelled")
+        {
+            const auto c     = PreviewCamera();
+            const auto token = rtc::CancellationToken{};
+
+            WHEN("the image is rendered in bands")
+            {
+                auto image = rtc::Canvas{ c.GetHSize(), c.GetVSize() };
+
+                const auto result = c.RenderBands(
+                    w, 4u, 2u,
+                    [&image](uint32_t first_row, const rtc::Canvas& band) {
+                        for (uint32_t y = 0u; y < band.GetHeight(); ++y)
+                        {
+                            for (uint32_t x = 0u; x < band.GetWidth(); ++x)
+                            {
+                                image.WritePixel(x, first_row + y, band.PixelAt(x, y));
+                            }
+                        }
+
+                        return true;
+                    },
+                    &token);
+
+                THEN("the image matches a render without a token")
+                {
+                    REQUIRE(result);
+                    REQUIRE(CanvasEqual(image, c.Render(w)));
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Previewing a scene", "[preview]")
+{
+    GIVEN("a preview renderer for the default world")
+    {
+        const auto c = PreviewCamera();
+
+        auto frames  = std::vector<Frame>{};
+        auto preview = rtc::PreviewRenderer{ rtc::World::GetDefault(), c, 2u, [&frames](uint64_t revision, uint32_t scale, std::chrono::microseconds, const rtc::Canvas& image) {
+                                                frames.push_back(Frame{ revision, scale, image });
+                                            } };
+
+        WHEN("the first revision is rendered")
+        {
+            REQUIRE(preview.Start());
+            preview.Wait();
+
+            THEN("passes from 1/8 to full size are written in order")
+            {
+                REQUIRE(preview.GetRevision() == 1u);
+                REQUIRE(frames.size() == 4u);
+                REQUIRE(frames[0].scale == 8u);
+                REQUIRE(frames[1].scale == 4u);
+                REQUIRE(frames[2].scale == 2u);
+                REQUIRE(frames[3].scale == 1u);
+
+                for (const auto& frame : frames)
+                {
+                    REQUIRE(frame.revision == 1u);
+                    REQUIRE(frame.image.GetWidth() == c.GetHSize());
+                    REQUIRE(frame.image.GetHeight() == c.GetVSize());
+                }
+            }
+
+            AND_THEN("the first pass repeats each pixel over an 8x8 block")
+            {
+                REQUIRE(rtc::Color::Equal(frames[0].image.PixelAt(8u, 0u), frames[0].image.PixelAt(15u, 7u)));
+            }
+
+            AND_THEN("the last pass matches a render of the world")
+            {
+                REQUIRE(CanvasEqual(frames.back().image, c.Render(rtc::World::GetDefault())));
+            }
+
+            AND_THEN("starting again fails")
+            {
+                REQUIRE(!preview.Start());
+            }
+        }
+
+        WHEN("the light is moved")
+        {
+            REQUIRE(preview.Start());
+            preview.Wait();
+            frames.clear();
+
+            const auto light    = rtc::PointLight{ rtc::Point{ 10.0, 10.0, -10.0 }, rtc::Color{ 1.0, 1.0, 1.0 } };
+            const auto revision = preview.Update([&light](rtc::World& world, rtc::Camera&) { world.SetLight(0u, light); });
+            preview.Wait();
+
+            THEN("the last pass of the revision matches a render of the edited world")
+            {
+                auto w = rtc::World::GetDefault();
+                w.SetLight(0u, light);
+
+                REQUIRE(revision == 2u);
+                REQUIRE(frames.size() == 4u);
+                REQUIRE(frames.back().revision == 2u);
+                REQUIRE(frames.back().scale == 1u);
+                REQUIRE(CanvasEqual(frames.back().image, c.Render(w)));
+            }
+        }
+    }
+
+    GIVEN("a preview renderer that reports the errors of edits")
+    {
+        const auto c = PreviewCamera();
+
+        auto frames  = std::vector<Frame>{};
+        auto errors  = std::vector<uint64_t>{};
+        auto preview = rtc::PreviewRenderer{
+            rtc::World::GetDefault(),
+            c,
+            2u,
+            [&frames](uint64_t revision, uint32_t scale, std::chrono::microseconds, const rtc::Canvas& image) { frames.push_back(Frame{ revision, scale, image }); },
+            [&errors](uint64_t revision, const std::string&) { errors.push_back(revision); }
+        };
+
+        WHEN("an edit sets a camera transform that cannot be inverted")
+        {
+            REQUIRE(preview.Start());
+            preview.Wait();
+            frames.clear();
+
+            preview.Update([](rtc::World&, rtc::Camera& camera) { camera.SetTransform(rtc::Matrix44::Scaling(0.0, 1.0, 1.0)); });
+            preview.Wait();
+
+            THEN("the error is reported and the revision is rendered without the edit")
+            {
+                REQUIRE(errors == std::vector<uint64_t>{ 2u });
+                REQUIRE(frames.size() == 4u);
+                REQUIRE(frames.back().revision == 2u);
+                REQUIRE(CanvasEqual(frames.back().image, c.Render(rtc::World::GetDefault())));
+            }
+        }
+    }
+
+    GIVEN("a preview renderer that edits the scene when the first pass is written")
+    {
+        const auto c = PreviewCamera();
+
+        auto  frames  = std::vector<Frame>{};
+        auto* preview = static_cast<rtc::PreviewRenderer*>(nullptr);
+
+        auto renderer = rtc::PreviewRenderer{ rtc::World::GetDefault(), c, 2u, [&frames, &preview](uint64_t revision, uint32_t scale, std::chrono::microseconds, const rtc::Canvas& image) {
+                                                 frames.push_back(Frame{ revision, scale, image });
+
+                                                 if (revision == 1u)
+                                                 {
+                                                     preview->Update([](rtc::World&, rtc::Camera& camera) { camera.SetTransform(rtc::Matrix44::Identity()); });
+                                                 }
+                                             } };
+        preview       = &renderer;
+
+        WHEN("the preview is rendered")
+        {
+            REQUIRE(renderer.Start());
+            renderer.Wait();
+
+            THEN("the edit cancels the render of the first revision")
+            {
+                REQUIRE(renderer.GetRevision() == 2u);
+                REQUIRE(frames.size() == 5u);
+                REQUIRE(frames[0].revision == 1u);
+                REQUIRE(frames[0].scale == 8u);
+
+                for (size_t i = 1u; i < frames.size(); ++i)
+                {
+                    REQUIRE(frames[i].revision == 2u);
+                }
+
+                const auto edited = rtc::Camera{ c.GetHSize(), c.GetVSize(), c.GetFieldOfView() };
+                REQUIRE(CanvasEqual(frames.back().image, edited.Render(rtc::World::GetDefault())));
+            }
+        }
+    }
+}
+
+SCENARIO("Parsing preview commands", "[preview]")
+{
+    GIVEN("w = default_world() and c = camera(32, 16, π/3)")
+    {
+        auto w = rtc::World::GetDefault();
+        auto c = PreviewCamera();
+
+        auto edit = rtc::PreviewRenderer::Edit{};
+
+        WHEN("the camera is pointed")
+        {
+            REQUIRE(rtc::PreviewProtocol::Parse("camera 0 0 -8 0 1 0", edit));
+            edit(w, c);
+
+            THEN("the camera transform is the view transform")
+            {
+                const auto expected = rtc::Matrix44::ViewTransform(rtc::Point{ 0.0, 0.0, -8.0 }, rtc::Point{ 0.0, 1.0, 0.0 }, rtc::Vector{ 0.0, 1.0, 0.0 });
+                REQUIRE(rtc::Matrix44::Equal(c.GetTransform(), expected));
+            }
+        }
+
+        WHEN("the field of view is set")
+        {
+            REQUIRE(rtc::PreviewProtocol::Parse("fov 1.5", edit));
+            edit(w, c);
+
+            THEN("the camera keeps its size and transform")
+            {
+                REQUIRE(rtc::Equal(c.GetFieldOfView(), static_cast<rtc::Scalar>(1.5)));
+                REQUIRE(c.GetHSize() == 32u);
+                REQUIRE(c.GetVSize() == 16u);
+                REQUIRE(rtc::Matrix44::Equal(c.GetTransform(), PreviewCamera().GetTransform()));
+            }
+        }
+
+        WHEN("a light is set")
+        {
+            REQUIRE(rtc::PreviewProtocol::Parse("light 0 1 2 3 0.5 0.5 0.5", edit));
+            edit(w, c);
+
+            THEN("the light has the position and intensity")
+            {
+                REQUIRE(rtc::Point::Equal(w.GetLight(0u).GetPosition(), rtc::Point{ 1.0, 2.0, 3.0 }));
+                REQUIRE(rtc::Color::Equal(w.GetLight(0u).GetIntensity(), rtc::Color{ 0.5, 0.5, 0.5 }));
+            }
+        }
+
+        WHEN("an object is translated")
+        {
+            const auto transform = w.GetObject(1u)->GetTransform();
+
+            REQUIRE(rtc::PreviewProtocol::Parse("translate 1 0 2 0", edit));
+            edit(w, c);
+
+            THEN("the translation is applied after the object's transform")
+            {
+                REQUIRE(rtc::Matrix44::Equal(w.GetObject(1u)->GetTransform(), rtc::Matrix44::Multiply(rtc::Matrix44::Translation(0.0, 2.0, 0.0), transform)));
+            }
+        }
+
+        WHEN("a material's color and reflectivity are set")
+        {
+            REQUIRE(rtc::PreviewProtocol::Parse("material 0 color 1 0 0", edit));
+            edit(w, c);
+            REQUIRE(rtc::PreviewProtocol::Parse("material 0 reflective 0.25", edit));
+            edit(w, c);
+
+            THEN("the object's material has the color and reflectivity")
+            {
+                REQUIRE(rtc::Color::Equal(w.GetObject(0u)->GetMaterial().GetColor(), rtc::Color{ 1.0, 0.0, 0.0 }));
+                REQUIRE(rtc::Equal(w.GetObject(0u)->GetMaterial().GetReflective(), static_cast<rtc::Scalar>(0.25)));
+            }
+        }
+
+        WHEN("an edit references an object outside of the world")
+        {
+            REQUIRE(rtc::PreviewProtocol::Parse("material 5 ambient 1", edit));
+            edit(w, c);
+
+            THEN("the world is unchanged")
+            {
+                REQUIRE(w.GetObjectCount() == 2u);
+                REQUIRE(rtc::Equal(w.GetObject(0u)->GetMaterial().GetAmbient(), static_cast<rtc::Scalar>(0.1)));
+                REQUIRE(rtc::Equal(w.GetObject(1u)->GetMaterial().GetAmbient(), static_cast<rtc::Scalar>(0.1)));
+            }
+        }
+
+        THEN("a camera that looks straight down or up, or at its own position, is rejected")
+        {
+            REQUIRE(!rtc::PreviewProtocol::Parse("camera 0 5 0 0 0 0", edit));
+            REQUIRE(!rtc::PreviewProtocol::Parse("camera 1 -2 3 1 4 3", edit));
+            REQUIRE(!rtc::PreviewProtocol::Parse("camera 1 2 3 1 2 3", edit));
+        }
+
+        THEN("malformed commands are rejected")
+        {
+            REQUIRE(!rtc::PreviewProtocol::Parse("", edit));
+            REQUIRE(!rtc::PreviewProtocol::Parse("zoom 2", edit));
+            REQUIRE(!rtc::PreviewProtocol::Parse("camera 0 0 -8 0 1", edit));
+            REQUIRE(!rtc::PreviewProtocol::Parse("fov 0", edit));
+            REQUIRE(!rtc::PreviewProtocol::Parse("fov 3.2", edit));
+            REQUIRE(!rtc::PreviewProtocol::Parse("fov 1 2", edit));
+            REQUIRE(!rtc::PreviewProtocol::Parse("light 0 1 2 3 red", edit));
+            REQUIRE(!rtc::PreviewProtocol::Parse("translate 1 0 2", edit));
+            REQUIRE(!rtc::PreviewProtocol::Parse("material 0 roughness 1", edit));
+            REQUIRE(!rtc::PreviewProtocol::Parse("material 0 color 1 0", edit));
+        }
+    }
+}
@@ -27,29 +27,32 @@
 
 namespace rtc
 {
-    class Ray
+    template <typename T>
+    class BasicRay
     {
     public:
-        Ray(const Point& origin, const Vector& direction) :
+        constexpr BasicRay(const BasicPoint<T>& origin, const BasicVector<T>& direction) :
             origin_(origin),
             direction_(direction)
         {
         }
 
-        Ray(Point&& origin, Vector&& direction) :
+        constexpr BasicRay(BasicPoint<T>&& origin, BasicVector<T>&& direction) :
             origin_(std::move(origin)),
             direction_(std::move(direction))
         {
         }
 
-        const Point& GetOrigin() const { return origin_; }
+        const BasicPoint<T>& GetOrigin() const { return origin_; }
 
-        const Vector& GetDirection() const { return direction_; }
+        const BasicVector<T>& GetDirection() const { return direction_; }
 
-        Point GetPosition(double t) const { return rtc::Tuple::Add(origin_, rtc::Tuple::Multiply(direction_, t)); }
+        constexpr BasicPoint<T> GetPosition(T t) const { return BasicTuple<T>::Add(origin_, BasicTuple<T>::Multiply(direction_, t)); }
 
     private:
-        Point  origin_;
-        Vector direction_;
+        BasicPoint<T>  origin_;
+        BasicVector<T> direction_;
     };
+
+    using Ray = BasicRay<Scalar>;
 }
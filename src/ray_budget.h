@@ -0,0 +1,126 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#pragma once
+
+#include "double_util.h"
+
+#include <algorithm>
+#include <array>
+#include <cinttypes>
+
+namespace rtc
+{
+    // Limits on the reflected and refracted rays traced for a render, and counters of the rays traced
+    // at each depth. Primary rays have depth 0, and each reflection or refraction adds one.
+    //
+    // A secondary ray is traced only when its depth is within the maximum depth, and when its weight,
+    // the product of the reflective, transparency and Fresnel factors along its path, is at least the
+    // minimum contribution. The weight bounds the ray's share of the pixel, so rays below the cutoff
+    // change the image by at most the cutoff times their radiance. Together the limits keep the cost of
+    // scenes with nested glass from growing with 2^depth. A budget is not thread safe; each render
+    // thread should own its own.
+    class RayBudget
+    {
+    public:
+        static constexpr uint32_t kDefaultMaxDepth = 5u;   ///< Maximum depth used by the Ray Tracer Challenge.
+        static constexpr uint32_t kCountedDepths   = 16u;  ///< Depths with separate counters; deeper rays share the last.
+
+        // Default cutoff for renders, below the 1/255 quantization of 8-bit output for radiance up to 1.
+        static constexpr Scalar kDefaultMinContribution = Scalar{ 0.001 };
+
+    public:
+        RayBudget() :
+            RayBudget(kDefaultMaxDepth, kDefaultMinContribution)
+        {
+        }
+
+        RayBudget(uint32_t max_depth, Scalar min_contribution) :
+            max_depth_(max_depth),
+            min_contribution_(min_contribution)
+        {
+        }
+
+        uint32_t GetMaxDepth() const { return max_depth_; }
+
+        Scalar GetMinContribution() const { return min_contribution_; }
+
+        void SetMaxDepth(uint32_t max_depth) { max_depth_ = max_depth; }
+
+        void SetMinContribution(Scalar min_contribution) { min_contribution_ = min_contribution; }
+
+        // Returns true when a secondary ray with the specified depth and weight should be traced,
+        // counting the rays that are skipped.
+        bool Admit(uint32_t depth, Scalar weight)
+        {
+            if (depth > max_depth_)
+            {
+                ++depth_limited_;
+                return false;
+            }
+
+            if (weight < min_contribution_)
+            {
+                ++culled_;
+                return false;
+            }
+
+            return true;
+        }
+
+        void CountRay(uint32_t depth) { ++rays_[std::min(depth, kCountedDepths - 1u)]; }
+
+        // Number of rays traced at the depth, or at any depth from kCountedDepths - 1 for the last counter.
+        uint64_t GetRayCount(uint32_t depth) const { return (depth < kCountedDepths) ? rays_[depth] : 0u; }
+
+        uint64_t GetTotalRayCount() const
+        {
+            auto total = uint64_t{ 0u };
+            for (const auto count : rays_)
+            {
+                total += count;
+            }
+
+            return total;
+        }
+
+        // Number of secondary rays skipped for exceeding the maximum depth.
+        uint64_t GetDepthLimitedCount() const { return depth_limited_; }
+
+        // Number of secondary rays skipped for a weight below the minimum contribution.
+        uint64_t GetCulledCount() const { return culled_; }
+
+        void ResetCounters()
+        {
+            rays_.fill(0u);
+            depth_limited_ = 0u;
+            culled_        = 0u;
+        }
+
+    private:
+        uint32_t                             max_depth_;            ///< Deepest reflected or refracted ray to trace.
+        Scalar                               min_contribution_;     ///< Smallest weight of a reflected or refracted ray to trace.
+        std::array<uint64_t, kCountedDepths> rays_{};               ///< Number of rays traced at each depth.
+        uint64_t                             depth_limited_{ 0u };  ///< Number of rays skipped for their depth.
+        uint64_t                             culled_{ 0u };         ///< Number of rays skipped for their weight.
+    };
+}
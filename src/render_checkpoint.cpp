@@ -0,0 +1,461 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "render_checkpoint.h"
+
+#include "matrix44.h"
+#include "pattern.h"
+#include "ray_budget.h"
+#include "render_region.h"
+#include "shadow_cache.h"
+#include "shape.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <typeinfo>
+#include <vector>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace rtc
+{
+    namespace
+    {
+        constexpr uint32_t kManifestMagic = 0x4b435452u; // "RTCK"
+        constexpr uint32_t kTileMagic     = 0x454c4954u; // "TILE"
+        constexpr uint32_t kVersion       = 1u;
+
+        // 64-bit FNV-1a hash.
+        class Fnv1a
+        {
+        public:
+            void Add(const void* data, size_t size)
+            {
+                const auto bytes = static_cast<const uint8_t*>(data);
+                for (size_t i = 0u; i < size; ++i)
+                {
+                    hash_ = (hash_ ^ bytes[i]) * 1099511628211ull;
+                }
+            }
+
+            void Add(double value) { Add(&value, sizeof(value)); }
+
+            void Add(const Color& color)
+            {
+                Add(static_cast<double>(color.GetR()));
+                Add(static_cast<double>(color.GetG()));
+                Add(static_cast<double>(color.GetB()));
+            }
+
+            void Add(const Matrix44& matrix)
+            {
+                for (uint32_t row = 0u; row < 4u; ++row)
+                {
+                    for (uint32_t column = 0u; column < 4u; ++column)
+                    {
+                        Add(static_cast<double>(matrix.Get(row, column)));
+                    }
+                }
+            }
+
+            uint64_t Get() const { return hash_; }
+
+        private:
+            uint64_t hash_{ 14695981039346656037ull };
+        };
+
+        struct Manifest
+        {
+            uint32_t magic{ kManifestMagic };
+            uint32_t version{ kVersion };
+            uint32_t scalar_size{ sizeof(Scalar) };
+            uint32_t hsize{ 0u };
+            uint32_t vsize{ 0u };
+            uint32_t tile_width{ 0u };
+            uint32_t tile_height{ 0u };
+            uint32_t reserved{ 0u };
+            uint64_t scene_hash{ 0u };
+            double   field_of_view{ 0.0 };
+            double   transform[16]{};
+        };
+
+        struct TileHeader
+        {
+            uint32_t magic{ kTileMagic };
+            uint32_t id{ 0u };
+            uint32_t pixel_count{ 0u }; ///< Number of Scalar components following the header.
+            uint32_t reserved{ 0u };
+            uint64_t checksum{ 0u };    ///< Hash of the id and the pixels.
+        };
+
+        struct TileRecord
+        {
+            uint32_t            id;
+            std::vector<Scalar> pixels;
+        };
+
+        Manifest MakeManifest(const Camera& camera, uint64_t scene_hash, uint32_t tile_width, uint32_t tile_height)
+        {
+            auto manifest          = Manifest{};
+            manifest.hsize         = camera.GetHSize();
+            manifest.vsize         = camera.GetVSize();
+            manifest.tile_width    = tile_width;
+            manifest.tile_height   = tile_height;
+            manifest.scene_hash    = scene_hash;
+            manifest.field_of_view = static_cast<double>(camera.GetFieldOfView());
+
+            const auto transform = camera.GetTransform();
+            for (uint32_t i = 0u; i < 16u; ++i)
+            {
+                manifest.transform[i] = static_cast<double>(transform.Get(i / 4u, i % 4u));
+            }
+
+            return manifest;
+        }
+
+        bool Equal(const Manifest& lhs, const Manifest& rhs)
+        {
+            if ((lhs.magic != rhs.magic) || (lhs.version != rhs.version) || (lhs.scalar_size != rhs.scalar_size) ||
+                (lhs.hsize != rhs.hsize) || (lhs.vsize != rhs.vsize) || (lhs.tile_width != rhs.tile_width) ||
+                (lhs.tile_height != rhs.tile_height) || (lhs.scene_hash != rhs.scene_hash) || (lhs.field_of_view != rhs.field_of_view))
+            {
+                return false;
+            }
+
+            return std::equal(std::begin(lhs.transform), std::end(lhs.transform), std::begin(rhs.transform));
+        }
+
+        uint64_t Checksum(uint32_t id, const std::vector<Scalar>& pixels)
+        {
+            auto hash = Fnv1a{};
+            hash.Add(&id, sizeof(id));
+            hash.Add(pixels.data(), pixels.size() * sizeof(Scalar));
+            return hash.Get();
+        }
+
+        std::vector<Scalar> ReadPixels(const Canvas& canvas, const RenderRegion& region)
+        {
+            auto pixels = std::vector<Scalar>{};
+            pixels.reserve(region.GetPixelCount() * 3u);
+
+            for (uint32_t y = region.GetY(); y < (region.GetY() + region.GetHeight()); ++y)
+            {
+                for (uint32_t x = region.GetX(); x < (region.GetX() + region.GetWidth()); ++x)
+                {
+                    const auto& color = canvas.PixelAt(x, y);
+                    pixels.push_back(color.GetR());
+                    pixels.push_back(color.GetG());
+                    pixels.push_back(color.GetB());
+                }
+            }
+
+            return pixels;
+        }
+
+        void WritePixels(const std::vector<Scalar>& pixels, const RenderRegion& region, Canvas& canvas)
+        {
+            auto pixel = pixels.data();
+
+            for (uint32_t y = region.GetY(); y < (region.GetY() + region.GetHeight()); ++y)
+            {
+                for (uint32_t x = region.GetX(); x < (region.GetX() + region.GetWidth()); ++x)
+                {
+                    canvas.WritePixel(x, y, Color{ pixel[0], pixel[1], pixel[2] });
+                    pixel += 3;
+                }
+            }
+        }
+
+        // Copy the tiles of a checkpoint file that matches the manifest to the canvas, marking them completed.
+        // Returns the size of the file up to the end of the last intact tile, or 0 when the file does not hold
+        // a matching checkpoint.
+        uint64_t LoadTiles(const std::string& filename, const Manifest& manifest, const std::vector<RenderRegion>& tiles, Canvas& canvas, std::vector<uint8_t>& completed)
+        {
+            auto file = std::fopen(filename.c_str(), "rb");
+            if (file == nullptr)
+            {
+                return 0u;
+            }
+
+            auto stored = Manifest{};
+            if ((std::fread(&stored, sizeof(stored), 1u, file) != 1u) || !Equal(stored, manifest))
+            {
+                std::fclose(file);
+                return 0u;
+            }
+
+            auto size   = uint64_t{ sizeof(stored) };
+            auto header = TileHeader{};
+            auto pixels = std::vector<Scalar>{};
+
+            while (std::fread(&header, sizeof(header), 1u, file) == 1u)
+            {
+                if ((header.magic != kTileMagic) || (header.id >= tiles.size()) || (header.pixel_count != (tiles[header.id].GetPixelCount() * 3u)))
+                {
+                    break;
+                }
+
+                pixels.resize(header.pixel_count);
+                if ((std::fread(pixels.data(), sizeof(Scalar), pixels.size(), file) != pixels.size()) || (Checksum(header.id, pixels) != header.checksum))
+                {
+                    break;
+                }
+
+                WritePixels(pixels, tiles[header.id], canvas);
+                completed[header.id] = 1u;
+                size += sizeof(header) + (pixels.size() * sizeof(Scalar));
+            }
+
+            std::fclose(file);
+            return size;
+        }
+
+        // Appends completed tiles to a checkpoint file from its own thread, at an interval.
+        class TileWriter
+        {
+        public:
+            TileWriter(std::FILE* file, std::chrono::milliseconds interval) :
+                file_(file),
+                interval_(interval),
+                thread_(&TileWriter::Run, this)
+            {
+            }
+
+            ~TileWriter() { Finish(); }
+
+            void Push(TileRecord&& record)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                queue_.emplace_back(std::move(record));
+            }
+
+            // Write the remaining tiles and stop the thread. Returns false when a write failed.
+            bool Finish()
+            {
+                if (thread_.joinable())
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(mutex_);
+                        stop_ = true;
+                    }
+
+                    condition_.notify_one();
+                    thread_.join();
+                }
+
+                return !failed_;
+            }
+
+            uint32_t GetWriteCount() const { return write_count_; }
+
+        private:
+            void Run()
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+
+                while (true)
+                {
+                    condition_.wait_for(lock, interval_, [this]() { return stop_; });
+
+                    auto records = std::move(queue_);
+                    queue_.clear();
+
+                    const auto stop = stop_;
+                    lock.unlock();
+
+                    if (!records.empty())
+                    {
+                        failed_ = !Write(records) || failed_;
+                        ++write_count_;
+                    }
+
+                    lock.lock();
+
+                    if (stop && queue_.empty())
+                    {
+                        break;
+                    }
+                }
+            }
+
+            bool Write(const std::vector<TileRecord>& records)
+            {
+                for (const auto& record : records)
+                {
+                    auto header        = TileHeader{};
+                    header.id          = record.id;
+                    header.pixel_count = static_cast<uint32_t>(record.pixels.size());
+                    header.checksum    = Checksum(record.id, record.pixels);
+
+                    if ((std::fwrite(&header, sizeof(header), 1u, file_) != 1u) ||
+                        (std::fwrite(record.pixels.data(), sizeof(Scalar), record.pixels.size(), file_) != record.pixels.size()))
+                    {
+                        return false;
+                    }
+                }
+
+                if (std::fflush(file_) != 0)
+                {
+                    return false;
+                }
+
+                // Make the tiles durable, so that they survive a crash of the machine as well as the process.
+#if defined(_WIN32)
+                return _commit(_fileno(file_)) == 0;
+#else
+                return fsync(fileno(file_)) == 0;
+#endif
+            }
+
+        private:
+            std::FILE*                file_;              ///< Checkpoint file, positioned at its end.
+            std::chrono::milliseconds interval_;          ///< Time between writes.
+            std::mutex                mutex_;             ///< Guards queue_ and stop_.
+            std::condition_variable   condition_;         ///< Signaled to stop the thread.
+            std::vector<TileRecord>   queue_;             ///< Completed tiles that have not been written.
+            bool                      stop_{ false };     ///< Write the remaining tiles and exit.
+            bool                      failed_{ false };   ///< A write failed; only accessed by the thread until it is joined.
+            uint32_t                  write_count_{ 0u }; ///< Number of writes; only accessed by the thread until it is joined.
+            std::thread               thread_;            ///< Thread writing the tiles, started last.
+        };
+    }
+
+    bool RenderCheckpoint::Render(const Camera& camera, const World& world, Canvas& canvas, bool resume)
+    {
+        resumed_tile_count_  = 0u;
+        rendered_tile_count_ = 0u;
+        write_count_         = 0u;
+
+        if ((canvas.GetWidth() != camera.GetHSize()) || (canvas.GetHeight() != camera.GetVSize()))
+        {
+            return false;
+        }
+
+        const auto manifest = MakeManifest(camera, HashScene(world), tile_width_, tile_height_);
+        const auto tiles    = RenderRegion::Tiles(camera.GetHSize(), camera.GetVSize(), tile_width_, tile_height_);
+
+        auto completed = std::vector<uint8_t>(tiles.size());
+        auto size      = resume ? LoadTiles(filename_, manifest, tiles, canvas, completed) : uint64_t{ 0u };
+        auto file      = static_cast<std::FILE*>(nullptr);
+
+        if (size > 0u)
+        {
+            // Drop a tile that was only partly written, and append new tiles after the intact ones.
+            auto error = std::error_code{};
+            std::filesystem::resize_file(filename_, size, error);
+            file = error ? nullptr : std::fopen(filename_.c_str(), "ab");
+        }
+        else
+        {
+            file = std::fopen(filename_.c_str(), "wb");
+
+            if ((file != nullptr) && ((std::fwrite(&manifest, sizeof(manifest), 1u, file) != 1u) || (std::fflush(file) != 0)))
+            {
+                std::fclose(file);
+                file = nullptr;
+            }
+        }
+
+        if (file == nullptr)
+        {
+            return false;
+        }
+
+        auto writer       = TileWriter{ file, interval_ };
+        auto shadow_cache = ShadowCache{};
+        auto budget       = RayBudget{};
+
+        for (uint32_t i = 0u; i < tiles.size(); ++i)
+        {
+            if (completed[i] != 0u)
+            {
+                ++resumed_tile_count_;
+                continue;
+            }
+
+            camera.Render(world, tiles[i], canvas, &shadow_cache, budget);
+            writer.Push(TileRecord{ i, ReadPixels(canvas, tiles[i]) });
+            ++rendered_tile_count_;
+        }
+
+        const auto written = writer.Finish();
+        write_count_       = writer.GetWriteCount();
+
+        return (std::fclose(file) == 0) && written;
+    }
+
+    uint64_t RenderCheckpoint::HashScene(const World& world)
+    {
+        auto hash = Fnv1a{};
+
+        for (const auto& light : world.GetLights())
+        {
+            hash.Add(static_cast<double>(light.GetPosition().GetX()));
+            hash.Add(static_cast<double>(light.GetPosition().GetY()));
+            hash.Add(static_cast<double>(light.GetPosition().GetZ()));
+            hash.Add(light.GetIntensity());
+        }
+
+        for (const auto& object : world.GetObjects())
+        {
+            const auto& shape    = *object;
+            const auto  type     = std::string{ typeid(shape).name() };
+            const auto& material = shape.GetMaterial();
+
+            hash.Add(type.data(), type.size());
+            hash.Add(shape.GetTransform());
+            hash.Add(material.GetColor());
+            hash.Add(static_cast<double>(material.GetAmbient()));
+            hash.Add(static_cast<double>(material.GetDiffuse()));
+            hash.Add(static_cast<double>(material.GetSpecular()));
+            hash.Add(static_cast<double>(material.GetShininess()));
+            hash.Add(static_cast<double>(material.GetReflective()));
+            hash.Add(static_cast<double>(material.GetTransparency()));
+            hash.Add(static_cast<double>(material.GetRefractiveIndex()));
+            hash.Add(static_cast<double>(material.IsFastSpecular() ? 1.0 : 0.0));
+            hash.Add(static_cast<double>(material.IsShadowCaster() ? 1.0 : 0.0));
+
+            const auto& pattern = material.GetPattern();
+            if (pattern != nullptr)
+            {
+                const auto& instance     = *pattern;
+                const auto  pattern_type = std::string{ typeid(instance).name() };
+
+                hash.Add(pattern_type.data(), pattern_type.size());
+                hash.Add(pattern->GetTransform());
+                hash.Add(pattern->PatternAt(Point{ 0.0, 0.0, 0.0 }));
+                hash.Add(pattern->PatternAt(Point{ 0.25, 0.5, 0.75 }));
+                hash.Add(pattern->PatternAt(Point{ -1.5, 0.5, 2.25 }));
+            }
+        }
+
+        return hash.Get();
+    }
+}
@@ -0,0 +1,99 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#pragma once
+
+#include "camera.h"
+#include "canvas.h"
+#include "world.h"
+
+#include <chrono>
+#include <cinttypes>
+#include <string>
+
+namespace rtc
+{
+    // Renders an image tile by tile while saving the completed tiles to a checkpoint file, so that a render
+    // that is interrupted can be resumed without losing its progress. The file starts with a manifest that
+    // identifies the scene, the camera and the tiling, followed by a record for each completed tile. Tiles
+    // are handed to a writer thread as they complete, which appends them to the file and flushes it at each
+    // interval, so the render never waits for the disk. A record that was only partly written when the
+    // process was killed fails its checksum and is rendered again.
+    class RenderCheckpoint
+    {
+    public:
+        static constexpr uint32_t                  kDefaultTileSize = 32u;
+        static constexpr std::chrono::milliseconds kDefaultInterval{ 10000 };
+
+    public:
+        explicit RenderCheckpoint(const std::string& filename) :
+            filename_(filename)
+        {
+        }
+
+        const std::string& GetFilename() const { return filename_; }
+
+        uint32_t GetTileWidth() const { return tile_width_; }
+
+        uint32_t GetTileHeight() const { return tile_height_; }
+
+        // Time between writes of the completed tiles to the file.
+        std::chrono::milliseconds GetInterval() const { return interval_; }
+
+        // Number of tiles loaded from the checkpoint file by the last render.
+        uint32_t GetResumedTileCount() const { return resumed_tile_count_; }
+
+        // Number of tiles rendered by the last render.
+        uint32_t GetRenderedTileCount() const { return rendered_tile_count_; }
+
+        // Number of times the last render wrote tiles to the file.
+        uint32_t GetWriteCount() const { return write_count_; }
+
+        void SetTileSize(uint32_t tile_width, uint32_t tile_height)
+        {
+            tile_width_  = tile_width;
+            tile_height_ = tile_height;
+        }
+
+        void SetInterval(std::chrono::milliseconds interval) { interval_ = interval; }
+
+        // Render the camera's image of the world into canvas, which must be the size of the image. With resume,
+        // the tiles of a checkpoint of the same scene, camera and tile size are copied to the canvas, and only
+        // the missing tiles are rendered. Otherwise, or when the file does not hold a matching checkpoint, a new
+        // checkpoint replaces the file. Returns false when the canvas is the wrong size or the file cannot be
+        // written.
+        bool Render(const Camera& camera, const World& world, Canvas& canvas, bool resume);
+
+        // Fingerprint of the lights, the shapes and their materials. Patterns are identified by their type,
+        // their transform and a few of their colors.
+        static uint64_t HashScene(const World& world);
+
+    private:
+        std::string               filename_;                          ///< Path of the checkpoint file.
+        uint32_t                  tile_width_{ kDefaultTileSize };    ///< Width of the tiles rendered and saved.
+        uint32_t                  tile_height_{ kDefaultTileSize };   ///< Height of the tiles rendered and saved.
+        std::chrono::milliseconds interval_{ kDefaultInterval };      ///< Time between writes to the file.
+        uint32_t                  resumed_tile_count_{ 0u };          ///< Tiles loaded by the last render.
+        uint32_t                  rendered_tile_count_{ 0u };         ///< Tiles rendered by the last render.
+        uint32_t                  write_count_{ 0u };                 ///< Writes to the file during the last render.
+    };
+}
@@ -0,0 +1,186 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "catch2/catch.hpp"
+
+#include "camera.h"
+#include "canvas.h"
+#include "color.h"
+#include "double_util.h"
+#include "material.h"
+#include "matrix44.h"
+#include "point.h"
+#include "render_checkpoint.h"
+#include "vector.h"
+#include "world.h"
+
+#include <filesystem>
+#include <string>
+
+namespace
+{
+    rtc::Camera TestCamera()
+    {
+        const auto from = rtc::Point{ 0.0, 0.0, -5.0 };
+        const auto to   = rtc::Point{ 0.0, 0.0, 0.0 };
+        const auto up   = rtc::Vector{ 0.0, 1.0, 0.0 };
+        return rtc::Camera{ 24u, 20u, rtc::kPi / 2.0, rtc::Matrix44::ViewTransform(from, to, up) };
+    }
+
+    std::string CheckpointFilename()
+    {
+        // Separate files for the double and float suites, which may run at the same time.
+        const auto name = "rtc_render_checkpoint_test_" + std::to_string(sizeof(rtc::Scalar)) + ".rtck";
+        return (std::filesystem::temp_directory_path() / name).string();
+    }
+
+    bool CanvasEqual(const rtc::Canvas& lhs, const rtc::Canvas& rhs)
+    {
+        for (uint32_t y = 0u; y < lhs.GetHeight(); ++y)
+        {
+            for (uint32_t x = 0u; x < lhs.GetWidth(); ++x)
+            {
+                if (!rtc::Color::Equal(lhs.PixelAt(x, y), rhs.PixelAt(x, y)))
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+}
+
+SCENARIO("Rendering with a checkpoint", "[checkpoint]")
+{
+    GIVEN("w <- default_world() and c <- a 24x20 camera and checkpoint <- render_checkpoint(file) with 8x8 tiles")
+    {
+        const auto w        = rtc::World::GetDefault();
+        const auto c        = TestCamera();
+        const auto image    = c.Render(w);
+        const auto filename = CheckpointFilename();
+
+        auto checkpoint = rtc::RenderCheckpoint{ filename };
+        checkpoint.SetTileSize(8u, 8u);
+
+        WHEN("canvas <- render(checkpoint, c, w, resume = false)")
+        {
+            auto canvas = rtc::Canvas{ 24u, 20u };
+            REQUIRE(checkpoint.Render(c, w, canvas, false));
+
+            THEN("canvas = render(c, w) and every tile was rendered and written")
+            {
+                REQUIRE(CanvasEqual(canvas, image));
+                REQUIRE(checkpoint.GetRenderedTileCount() == 9u);
+                REQUIRE(checkpoint.GetResumedTileCount() == 0u);
+                REQUIRE(checkpoint.GetWriteCount() >= 1u);
+            }
+
+            AND_WHEN("resumed <- render(checkpoint, c, w, resume = true)")
+            {
+                auto resumed = rtc::Canvas{ 24u, 20u };
+                REQUIRE(checkpoint.Render(c, w, resumed, true));
+
+                THEN("every tile is loaded from the checkpoint")
+                {
+                    REQUIRE(CanvasEqual(resumed, image));
+                    REQUIRE(checkpoint.GetRenderedTileCount() == 0u);
+                    REQUIRE(checkpoint.GetResumedTileCount() == 9u);
+                }
+            }
+
+            AND_WHEN("the last tile is only partly written and the render is resumed")
+            {
+                std::filesystem::resize_file(filename, std::filesystem::file_size(filename) - 100u);
+
+                auto resumed = rtc::Canvas{ 24u, 20u };
+                REQUIRE(checkpoint.Render(c, w, resumed, true));
+
+                THEN("the partial tile is rendered again")
+                {
+                    REQUIRE(CanvasEqual(resumed, image));
+                    REQUIRE(checkpoint.GetRenderedTileCount() == 1u);
+                    REQUIRE(checkpoint.GetResumedTileCount() == 8u);
+                }
+
+                AND_WHEN("the render is resumed again")
+                {
+                    auto again = rtc::Canvas{ 24u, 20u };
+                    REQUIRE(checkpoint.Render(c, w, again, true));
+
+                    THEN("the tile rendered by the previous resume was appended to the checkpoint")
+                    {
+                        REQUIRE(CanvasEqual(again, image));
+                        REQUIRE(checkpoint.GetResumedTileCount() == 9u);
+                    }
+                }
+            }
+
+            AND_WHEN("the scene changes and the render is resumed")
+            {
+                auto changed  = rtc::World::GetDefault();
+                auto material = changed.GetObject(0)->GetMaterial();
+                material.SetDiffuse(0.5);
+                changed.GetObject(0)->SetMaterial(material);
+
+                auto resumed = rtc::Canvas{ 24u, 20u };
+                REQUIRE(checkpoint.Render(c, changed, resumed, true));
+
+                THEN("the checkpoint is discarded and every tile is rendered")
+                {
+                    REQUIRE(checkpoint.GetRenderedTileCount() == 9u);
+                    REQUIRE(checkpoint.GetResumedTileCount() == 0u);
+                    REQUIRE(CanvasEqual(resumed, c.Render(changed)));
+                }
+            }
+
+            std::filesystem::remove(filename);
+        }
+
+        WHEN("the canvas is not the size of the image")
+        {
+            auto canvas = rtc::Canvas{ 10u, 10u };
+
+            THEN("render fails")
+            {
+                REQUIRE(!checkpoint.Render(c, w, canvas, false));
+            }
+        }
+    }
+}
+
+SCENARIO("The scene hash identifies a scene", "[checkpoint]")
+{
+    GIVEN("w <- default_world()")
+    {
+        const auto w = rtc::World::GetDefault();
+
+        THEN("the hash of an identical scene is the same, and the hash of a different scene is not")
+        {
+            REQUIRE(rtc::RenderCheckpoint::HashScene(w) == rtc::RenderCheckpoint::HashScene(rtc::World::GetDefault()));
+
+            auto moved = rtc::World::GetDefault();
+            moved.GetObject(1)->SetTransform(rtc::Matrix44::Translation(0.0, 1.0, 0.0));
+            REQUIRE(rtc::RenderCheckpoint::HashScene(w) != rtc::RenderCheckpoint::HashScene(moved));
+        }
+    }
+}
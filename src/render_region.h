@@ -0,0 +1,118 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cinttypes>
+#include <vector>
+
+namespace rtc
+{
+    // Rectangle of pixels in an image, from (x, y) to (x + width - 1, y + height - 1).
+    class RenderRegion
+    {
+    public:
+        RenderRegion() = default;
+
+        RenderRegion(uint32_t x, uint32_t y, uint32_t width, uint32_t height) :
+            x_(x),
+            y_(y),
+            width_(width),
+            height_(height)
+        {
+        }
+
+        uint32_t GetX() const { return x_; }
+
+        uint32_t GetY() const { return y_; }
+
+        uint32_t GetWidth() const { return width_; }
+
+        uint32_t GetHeight() const { return height_; }
+
+        uint64_t GetPixelCount() const { return static_cast<uint64_t>(width_) * static_cast<uint64_t>(height_); }
+
+        bool IsEmpty() const { return (width_ == 0u) || (height_ == 0u); }
+
+        // Test that the region lies within an image of the specified size.
+        bool IsWithin(uint32_t image_width, uint32_t image_height) const
+        {
+            return (x_ <= image_width) && (width_ <= (image_width - x_)) && (y_ <= image_height) && (height_ <= (image_height - y_));
+        }
+
+        bool Contains(uint32_t x, uint32_t y) const { return (x >= x_) && ((x - x_) < width_) && (y >= y_) && ((y - y_) < height_); }
+
+        static bool Equal(const RenderRegion& lhs, const RenderRegion& rhs)
+        {
+            return (lhs.x_ == rhs.x_) && (lhs.y_ == rhs.y_) && (lhs.width_ == rhs.width_) && (lhs.height_ == rhs.height_);
+        }
+
+        // Overlap of two regions, which is empty when they do not overlap.
+        static RenderRegion Intersect(const RenderRegion& lhs, const RenderRegion& rhs)
+        {
+            const auto left   = std::max(lhs.x_, rhs.x_);
+            const auto top    = std::max(lhs.y_, rhs.y_);
+            const auto right  = std::min(lhs.x_ + lhs.width_, rhs.x_ + rhs.width_);
+            const auto bottom = std::min(lhs.y_ + lhs.height_, rhs.y_ + rhs.height_);
+
+            if ((right <= left) || (bottom <= top))
+            {
+                return RenderRegion{};
+            }
+
+            return RenderRegion{ left, top, right - left, bottom - top };
+        }
+
+        // Split an image into tiles of the specified size, in scanline order. Tiles on the right and bottom
+        // edges are clipped to the image.
+        static std::vector<RenderRegion> Tiles(uint32_t image_width, uint32_t image_height, uint32_t tile_width, uint32_t tile_height)
+        {
+            std::vector<RenderRegion> tiles;
+
+            if ((tile_width > 0u) && (tile_height > 0u))
+            {
+                for (uint32_t y = 0u; y < image_height;)
+                {
+                    const auto height = std::min(tile_height, image_height - y);
+
+                    for (uint32_t x = 0u; x < image_width;)
+                    {
+                        const auto width = std::min(tile_width, image_width - x);
+                        tiles.emplace_back(x, y, width, height);
+                        x += width;
+                    }
+
+                    y += height;
+                }
+            }
+
+            return tiles;
+        }
+
+    private:
+        uint32_t x_{ 0u };      ///< Horizontal position of the region's left column.
+        uint32_t y_{ 0u };      ///< Vertical position of the region's top row.
+        uint32_t width_{ 0u };  ///< Number of columns in the region.
+        uint32_t height_{ 0u }; ///< Number of rows in the region.
+    };
+}
@@ -0,0 +1,207 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "catch2/catch.hpp"
+
+#include "camera.h"
+#include "canvas.h"
+#include "color.h"
+#include "double_util.h"
+#include "matrix44.h"
+#include "point.h"
+#include "ray_budget.h"
+#include "render_region.h"
+#include "shadow_cache.h"
+#include "vector.h"
+#include "world.h"
+
+#include <vector>
+
+namespace
+{
+    rtc::Camera TestCamera()
+    {
+        const auto from = rtc::Point{ 0.0, 0.0, -5.0 };
+        const auto to   = rtc::Point{ 0.0, 0.0, 0.0 };
+        const auto up   = rtc::Vector{ 0.0, 1.0, 0.0 };
+        return rtc::Camera{ 16u, 12u, rtc::kPi / 2.0, rtc::Matrix44::ViewTransform(from, to, up) };
+    }
+}
+
+SCENARIO("Splitting an image into tiles", "[regions]")
+{
+    GIVEN("tiles <- tiles(10, 7, 4, 4)")
+    {
+        const auto tiles = rtc::RenderRegion::Tiles(10u, 7u, 4u, 4u);
+
+        THEN("there are 6 tiles in scanline order, clipped to the image")
+        {
+            REQUIRE(tiles.size() == 6u);
+            REQUIRE(rtc::RenderRegion::Equal(tiles[0], rtc::RenderRegion{ 0u, 0u, 4u, 4u }));
+            REQUIRE(rtc::RenderRegion::Equal(tiles[1], rtc::RenderRegion{ 4u, 0u, 4u, 4u }));
+            REQUIRE(rtc::RenderRegion::Equal(tiles[2], rtc::RenderRegion{ 8u, 0u, 2u, 4u }));
+            REQUIRE(rtc::RenderRegion::Equal(tiles[3], rtc::RenderRegion{ 0u, 4u, 4u, 3u }));
+            REQUIRE(rtc::RenderRegion::Equal(tiles[5], rtc::RenderRegion{ 8u, 4u, 2u, 3u }));
+        }
+
+        THEN("the tiles cover every pixel exactly once")
+        {
+            auto pixels = uint64_t{ 0u };
+            for (const auto& tile : tiles)
+            {
+                pixels += tile.GetPixelCount();
+            }
+
+            REQUIRE(pixels == 70u);
+        }
+    }
+}
+
+SCENARIO("Intersecting regions", "[regions]")
+{
+    GIVEN("a <- region(2, 2, 6, 4) and b <- region(5, 0, 10, 3)")
+    {
+        const auto a = rtc::RenderRegion{ 2u, 2u, 6u, 4u };
+        const auto b = rtc::RenderRegion{ 5u, 0u, 10u, 3u };
+
+        THEN("intersect(a, b) = region(5, 2, 3, 1)")
+        {
+            REQUIRE(rtc::RenderRegion::Equal(rtc::RenderRegion::Intersect(a, b), rtc::RenderRegion{ 5u, 2u, 3u, 1u }));
+        }
+
+        THEN("a region does not intersect a region to its right")
+        {
+            REQUIRE(rtc::RenderRegion::Intersect(a, rtc::RenderRegion{ 8u, 2u, 1u, 1u }).IsEmpty());
+        }
+
+        THEN("a is within a 10x10 image and b is not")
+        {
+            REQUIRE(a.IsWithin(10u, 10u));
+            REQUIRE(!b.IsWithin(10u, 10u));
+            REQUIRE(a.Contains(7u, 5u));
+            REQUIRE(!a.Contains(8u, 5u));
+        }
+    }
+}
+
+SCENARIO("Rendering a region matches the same pixels of a full render", "[regions]")
+{
+    GIVEN("w <- default_world() and c <- a 16x12 camera and image <- render(c, w)")
+    {
+        const auto w     = rtc::World::GetDefault();
+        const auto c     = TestCamera();
+        const auto image = c.Render(w);
+
+        WHEN("crop <- render(c, w, region(5, 3, 6, 4))")
+        {
+            const auto crop = c.Render(w, rtc::RenderRegion{ 5u, 3u, 6u, 4u });
+
+            THEN("crop is 6x4 and crop[x, y] = image[x + 5, y + 3]")
+            {
+                REQUIRE(crop.GetWidth() == 6u);
+                REQUIRE(crop.GetHeight() == 4u);
+
+                for (uint32_t y = 0u; y < crop.GetHeight(); ++y)
+                {
+                    for (uint32_t x = 0u; x < crop.GetWidth(); ++x)
+                    {
+                        REQUIRE(rtc::Color::Equal(crop.PixelAt(x, y), image.PixelAt(x + 5u, y + 3u)));
+                    }
+                }
+            }
+        }
+
+        WHEN("crop <- render(c, w, region(12, 10, 8, 8))")
+        {
+            const auto crop = c.Render(w, rtc::RenderRegion{ 12u, 10u, 8u, 8u });
+
+            THEN("crop is clipped to the image")
+            {
+                REQUIRE(crop.GetWidth() == 4u);
+                REQUIRE(crop.GetHeight() == 2u);
+                REQUIRE(rtc::Color::Equal(crop.PixelAt(3u, 1u), image.PixelAt(15u, 11u)));
+            }
+        }
+    }
+}
+
+SCENARIO("Rendering a region into an existing canvas", "[regions]")
+{
+    GIVEN("w <- default_world() and c <- a 16x12 camera and canvas <- a 16x12 canvas filled with color(1, 0, 1)")
+    {
+        const auto w      = rtc::World::GetDefault();
+        const auto c      = TestCamera();
+        const auto image  = c.Render(w);
+        const auto marker = rtc::Color{ 1.0, 0.0, 1.0 };
+        auto       canvas = rtc::Canvas{ 16u, 12u };
+        auto       cache  = rtc::ShadowCache{};
+        auto       budget = rtc::RayBudget{};
+
+        canvas.Clear(marker);
+
+        WHEN("render(c, w, region(4, 4, 8, 4), canvas)")
+        {
+            const auto rendered = c.Render(w, rtc::RenderRegion{ 4u, 4u, 8u, 4u }, canvas, &cache, budget);
+
+            THEN("the region is rendered and the other pixels are unchanged")
+            {
+                REQUIRE(rendered);
+                REQUIRE(rtc::Color::Equal(canvas.PixelAt(4u, 4u), image.PixelAt(4u, 4u)));
+                REQUIRE(rtc::Color::Equal(canvas.PixelAt(11u, 7u), image.PixelAt(11u, 7u)));
+                REQUIRE(rtc::Color::Equal(canvas.PixelAt(3u, 4u), marker));
+                REQUIRE(rtc::Color::Equal(canvas.PixelAt(12u, 7u), marker));
+                REQUIRE(rtc::Color::Equal(canvas.PixelAt(8u, 8u), marker));
+                REQUIRE(budget.GetRayCount(0u) == 32u);
+            }
+        }
+
+        WHEN("render(c, w, region(12, 0, 8, 4), canvas)")
+        {
+            const auto rendered = c.Render(w, rtc::RenderRegion{ 12u, 0u, 8u, 4u }, canvas, &cache, budget);
+
+            THEN("the region is rejected and nothing is rendered")
+            {
+                REQUIRE(!rendered);
+                REQUIRE(budget.GetTotalRayCount() == 0u);
+                REQUIRE(rtc::Color::Equal(canvas.PixelAt(12u, 0u), marker));
+            }
+        }
+
+        WHEN("render(c, w, tiles(16, 12, 5, 5), canvas)")
+        {
+            const auto rendered = c.Render(w, rtc::RenderRegion::Tiles(16u, 12u, 5u, 5u), canvas, &cache, budget);
+
+            THEN("canvas = image")
+            {
+                REQUIRE(rendered);
+
+                for (uint32_t y = 0u; y < canvas.GetHeight(); ++y)
+                {
+                    for (uint32_t x = 0u; x < canvas.GetWidth(); ++x)
+                    {
+                        REQUIRE(rtc::Color::Equal(canvas.PixelAt(x, y), image.PixelAt(x, y)));
+                    }
+                }
+            }
+        }
+    }
+}
@@ -48,7 +48,7 @@ namespace rtc
 
         virtual Color PatternAt(const Point& point) const override
         {
-            if (static_cast<uint64_t>(floor(sqrt(rtc::Square(point.GetX()) + rtc::Square(point.GetZ())))) % 2 == 0)
+            if (static_cast<int64_t>(floor(sqrt(rtc::Square(point.GetX()) + rtc::Square(point.GetZ())))) % 2 == 0)
             {
                 return a_;
             }
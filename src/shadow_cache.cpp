@@ -0,0 +1,72 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "shadow_cache.h"
+
+#include "shape.h"
+
+namespace rtc
+{
+    bool ShadowCache::TestOccluder(size_t light_index, const Ray& shadow_ray, Scalar distance)
+    {
+        if (light_index < occluders_.size())
+        {
+            const auto& occluder = occluders_[light_index];
+
+            if (occluder != nullptr)
+            {
+                scratch_.clear();
+                occluder->Intersect(shadow_ray, scratch_);
+
+                for (const auto& value : scratch_)
+                {
+                    const auto t = value.GetT();
+                    if ((t >= 0) && (t < distance))
+                    {
+                        ++hits_;
+                        return true;
+                    }
+                }
+            }
+        }
+
+        ++misses_;
+        return false;
+    }
+
+    void ShadowCache::SetOccluder(size_t light_index, const std::shared_ptr<const Shape>& occluder)
+    {
+        if (light_index >= occluders_.size())
+        {
+            occluders_.resize(light_index + 1u);
+        }
+
+        occluders_[light_index] = occluder;
+    }
+
+    void ShadowCache::Clear()
+    {
+        occluders_.clear();
+        hits_   = 0u;
+        misses_ = 0u;
+    }
+}
@@ -0,0 +1,80 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#pragma once
+
+#include "double_util.h"
+#include "intersections.h"
+#include "light_tree.h"
+#include "ray.h"
+
+#include <cinttypes>
+#include <memory>
+#include <vector>
+
+namespace rtc
+{
+    class Shape;
+
+    // Remembers the last shape found to occlude each light so that the next shadow ray toward that
+    // light can test it before traversing the whole world. Neighboring pixels usually share an
+    // occluder, so most shadowed rays are resolved with a single object test. A cache is not thread
+    // safe; each render thread should own its own, and it must be cleared before it is used with a
+    // different world.
+    class ShadowCache
+    {
+    public:
+        // Test the cached occluder for the light against a shadow ray. Returns true, and counts a hit,
+        // when the occluder blocks the ray before it reaches the light at the specified distance.
+        bool TestOccluder(size_t light_index, const Ray& shadow_ray, Scalar distance);
+
+        void SetOccluder(size_t light_index, const std::shared_ptr<const Shape>& occluder);
+
+        void Clear();
+
+        uint64_t GetHitCount() const { return hits_; }
+
+        uint64_t GetMissCount() const { return misses_; }
+
+        // Fraction of shadow queries resolved by the cached occluder, without a full traversal.
+        double GetHitRate() const
+        {
+            const auto queries = hits_ + misses_;
+            return (queries > 0u) ? static_cast<double>(hits_) / static_cast<double>(queries) : 0.0;
+        }
+
+        // Reused storage for the visibility of each light from a shaded point, so that shading with the
+        // cache does not allocate for each hit.
+        std::vector<Scalar>& GetVisibility() { return visibility_; }
+
+        // Reused storage for the lights selected by a light tree for a shaded point.
+        LightTree::Samples& GetSamples() { return samples_; }
+
+    private:
+        std::vector<std::shared_ptr<const Shape>> occluders_;     ///< Last occluder found for each light, by light index.
+        Intersections::Values                     scratch_;       ///< Reused storage for occluder intersections.
+        std::vector<Scalar>                       visibility_;    ///< Reused storage for light visibility.
+        LightTree::Samples                        samples_;       ///< Reused storage for light tree samples.
+        uint64_t                                  hits_{ 0u };    ///< Number of shadow queries resolved by the cached occluder.
+        uint64_t                                  misses_{ 0u };  ///< Number of shadow queries requiring a full traversal.
+    };
+}
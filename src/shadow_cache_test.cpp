@@ -0,0 +1,171 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "catch2/catch.hpp"
+
+#include "camera.h"
+#include "color.h"
+#include "computations.h"
+#include "double_util.h"
+#include "material.h"
+#include "matrix44.h"
+#include "plane.h"
+#include "point.h"
+#include "point_light.h"
+#include "shadow_cache.h"
+#include "sphere.h"
+#include "vector.h"
+#include "world.h"
+
+SCENARIO("A shadow cache starts empty", "[shadows]")
+{
+    GIVEN("cache <- shadow_cache()")
+    {
+        const auto cache = rtc::ShadowCache{};
+
+        THEN("cache.hits = 0 and cache.misses = 0 and cache.hit_rate = 0")
+        {
+            REQUIRE(cache.GetHitCount() == 0u);
+            REQUIRE(cache.GetMissCount() == 0u);
+            REQUIRE(cache.GetHitRate() == 0.0);
+        }
+    }
+}
+
+SCENARIO("The shadow cache records the occluder found by a full traversal", "[shadows]")
+{
+    GIVEN("w <- default_world() and cache <- shadow_cache() and p <- point(10, -10, 10)")
+    {
+        const auto w     = rtc::World::GetDefault();
+        auto       cache = rtc::ShadowCache{};
+        const auto p     = rtc::Point{ 10.0, -10.0, 10.0 };
+
+        WHEN("is_shadowed(w, 0, p, cache)")
+        {
+            const auto shadowed = rtc::Computations::IsShadowed(w, 0u, p, cache);
+
+            THEN("The point is shadowed and the query was a miss")
+            {
+                REQUIRE(shadowed);
+                REQUIRE(cache.GetHitCount() == 0u);
+                REQUIRE(cache.GetMissCount() == 1u);
+            }
+
+            AND_WHEN("is_shadowed(w, 0, point(10, -10.5, 10), cache)")
+            {
+                const auto shadowed_again = rtc::Computations::IsShadowed(w, 0u, rtc::Point{ 10.0, -10.5, 10.0 }, cache);
+
+                THEN("The point is shadowed by the cached occluder and the query was a hit")
+                {
+                    REQUIRE(shadowed_again);
+                    REQUIRE(cache.GetHitCount() == 1u);
+                    REQUIRE(cache.GetMissCount() == 1u);
+                    REQUIRE(cache.GetHitRate() == 0.5);
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Shadow queries with a cache match queries without one", "[shadows]")
+{
+    GIVEN("w <- default_world() and cache <- shadow_cache()")
+    {
+        const auto w     = rtc::World::GetDefault();
+        auto       cache = rtc::ShadowCache{};
+
+        THEN("is_shadowed(w, 0, p, cache) = is_shadowed(w, w.light, p) for points in and out of shadow")
+        {
+            const rtc::Point points[] = {
+                rtc::Point{ 10.0, -10.0, 10.0 },
+                rtc::Point{ 0.0, 10.0, 0.0 },
+                rtc::Point{ 10.0, -10.0, 10.0 },
+                rtc::Point{ -20.0, 20.0, -20.0 },
+                rtc::Point{ -2.0, 2.0, -2.0 },
+                rtc::Point{ 10.0, -10.0, 10.0 }
+            };
+
+            for (const auto& p : points)
+            {
+                REQUIRE(rtc::Computations::IsShadowed(w, 0u, p, cache) == rtc::Computations::IsShadowed(w, w.GetLight(0), p));
+            }
+        }
+    }
+}
+
+SCENARIO("A stale cached occluder falls back to a full traversal", "[shadows]")
+{
+    GIVEN("w <- default_world() and cache <- shadow_cache() with an occluder that does not block the shadow ray")
+    {
+        const auto w     = rtc::World::GetDefault();
+        auto       cache = rtc::ShadowCache{};
+
+        cache.SetOccluder(0u, rtc::Sphere::Create(rtc::Matrix44::Translation(100.0, 0.0, 0.0)));
+
+        WHEN("is_shadowed(w, 0, point(10, -10, 10), cache)")
+        {
+            const auto shadowed = rtc::Computations::IsShadowed(w, 0u, rtc::Point{ 10.0, -10.0, 10.0 }, cache);
+
+            THEN("The point is shadowed, the query was a miss, and the occluder was replaced")
+            {
+                REQUIRE(shadowed);
+                REQUIRE(cache.GetMissCount() == 1u);
+                REQUIRE(cache.TestOccluder(0u, rtc::Ray{ rtc::Point{ 10.0, -10.0, 10.0 }, rtc::Vector::Normalize(rtc::Vector{ -1.0, 1.0, -1.0 }) }, 30.0));
+            }
+        }
+    }
+}
+
+SCENARIO("Rendering with a shadow cache under a large occluder", "[shadows]")
+{
+    GIVEN("A floor plane shadowed by a large plane between it and the light, and a camera looking at the floor")
+    {
+        const auto w = rtc::World{
+            { rtc::PointLight{ rtc::Point{ 0.0, 10.0, 0.0 }, rtc::Color{ 1.0, 1.0, 1.0 } } },
+            {
+                rtc::Plane::Create(),
+                rtc::Sphere::Create(rtc::Matrix44::Multiply(rtc::Matrix44::Translation(0.0, 5.0, 0.0), rtc::Matrix44::Scaling(50.0, 0.1, 50.0)))
+            } };
+        const auto c = rtc::Camera{ 20u, 20u, rtc::kPi / 3.0, rtc::Matrix44::ViewTransform(rtc::Point{ 0.0, 2.0, -5.0 }, rtc::Point{ 0.0, 0.0, 0.0 }, rtc::Vector{ 0.0, 1.0, 0.0 }) };
+
+        WHEN("image <- render(c, w, cache)")
+        {
+            auto       cache    = rtc::ShadowCache{};
+            const auto image    = c.Render(w, &cache);
+            const auto expected = c.Render(w, nullptr);
+
+            THEN("The image matches the uncached render and only the first shadow ray needs a full traversal")
+            {
+                for (uint32_t y = 0u; y < image.GetHeight(); ++y)
+                {
+                    for (uint32_t x = 0u; x < image.GetWidth(); ++x)
+                    {
+                        REQUIRE(rtc::Color::Equal(image.PixelAt(x, y), expected.PixelAt(x, y)));
+                    }
+                }
+
+                REQUIRE(cache.GetHitCount() > 0u);
+                REQUIRE(cache.GetMissCount() == 1u);
+            }
+        }
+    }
+}
@@ -22,13 +22,18 @@
 
 #pragma once
 
+#include "affine34.h"
+#include "color.h"
 #include "intersections.h"
 #include "material.h"
 #include "matrix44.h"
+#include "pattern.h"
 #include "point.h"
 #include "ray.h"
 #include "vector.h"
 
+#include <algorithm>
+#include <cinttypes>
 #include <memory>
 
 namespace rtc
@@ -40,15 +45,21 @@ namespace rtc
 
         const Material& GetMaterial() const { return material_; }
 
-        void SetMaterial(const Material& material) { material_ = material; }
-
-        void SetMaterial(Material&& material) { material_ = std::move(material); }
+        void SetMaterial(const Material& material)
+        {
+            material_ = material;
+            ComputePatternTransform();
+        }
 
-        const Matrix44& GetTransform() const { return transform_; }
+        void SetMaterial(Material&& material)
+        {
+            material_ = std::move(material);
+            ComputePatternTransform();
+        }
 
-        const Matrix44& GetInverseTransform() const { return inverse_transform_; }
+        Matrix44 GetTransform() const { return transform_.ToMatrix44(); }
 
-        const Matrix44& GetTransposedInverseTransform() const { return transposed_inverse_transform_; }
+        const Affine34& GetInverseTransform() const { return inverse_transform_; }
 
         void SetTransform(const Matrix44& transform)
         {
@@ -56,16 +67,10 @@ namespace rtc
             ComputeInverseTransforms();
         }
 
-        void SetTransform(Matrix44&& transform)
-        {
-            transform_ = std::move(transform);
-            ComputeInverseTransforms();
-        }
-
         void Intersect(const Ray& ray, Intersections::Values& values) const
         {
             // Transform ray to the shape's object space.
-            const auto local_ray = Matrix44::Transform(ray, inverse_transform_);
+            const auto local_ray = Affine34::Transform(ray, inverse_transform_);
             LocalIntersect(local_ray, values);
         }
 
@@ -76,41 +81,94 @@ namespace rtc
             return Intersections{ std::move(values) };
         }
 
+        // Color of the surface at a world space point, from the material's pattern or color. A pattern is
+        // evaluated with the combined world to pattern transform, unless the pattern's transform changed
+        // after the combined transform was computed.
+        Color ColorAt(const Point& world_point) const
+        {
+            const auto& pattern = material_.GetPattern();
+
+            if (!pattern)
+            {
+                return material_.GetColor();
+            }
+
+            if ((pattern.get() == pattern_) && (pattern->GetVersion() == pattern_version_))
+            {
+                return pattern->PatternAt(Affine34::TransformPoint(world_to_pattern_transform_, world_point));
+            }
+
+            return pattern->PatternAtObject(inverse_transform_, world_point);
+        }
+
+        // World space bounding box of the shape. Returns false, leaving the bounds unchanged, when the shape is
+        // unbounded.
+        bool GetBounds(Point& min_bounds, Point& max_bounds) const
+        {
+            auto local_min = Point{};
+            auto local_max = Point{};
+
+            if (!LocalBounds(local_min, local_max))
+            {
+                return false;
+            }
+
+            // Bound the eight transformed corners of the object space box.
+            for (uint32_t i = 0u; i < 8u; ++i)
+            {
+                const auto corner = Affine34::TransformPoint(
+                    transform_,
+                    Point{ ((i & 1u) != 0u) ? local_max.GetX() : local_min.GetX(), ((i & 2u) != 0u) ? local_max.GetY() : local_min.GetY(), ((i & 4u) != 0u) ? local_max.GetZ() : local_min.GetZ() });
+
+                if (i == 0u)
+                {
+                    min_bounds = corner;
+                    max_bounds = corner;
+                }
+                else
+                {
+                    min_bounds = Point{ std::min(min_bounds.GetX(), corner.GetX()), std::min(min_bounds.GetY(), corner.GetY()), std::min(min_bounds.GetZ(), corner.GetZ()) };
+                    max_bounds = Point{ std::max(max_bounds.GetX(), corner.GetX()), std::max(max_bounds.GetY(), corner.GetY()), std::max(max_bounds.GetZ(), corner.GetZ()) };
+                }
+            }
+
+            return true;
+        }
+
         Vector NormalAt(const Point& world_point) const
         {
             // Convert from world space to object space to compute the normal as the vector
             // between the point and the center of the shape.
-            const auto local_point  = Point{ Matrix44::Multiply(inverse_transform_, world_point) };
+            // The normal is transformed by the transpose of the inverse transform, which TransformNormal
+            // applies directly from the inverse without storing a transposed copy.
+            const auto local_point  = Affine34::TransformPoint(inverse_transform_, world_point);
             const auto local_normal = LocalNormalAt(local_point);
-            auto       world_normal = Vector{ Matrix44::Multiply(transposed_inverse_transform_, local_normal) };
-            // The world_normal w component does not need to be set to 0 because the bottom row of the matrix was
-            // cleared when it was computed by ComputeInverseTransform().
+            auto       world_normal = Affine34::TransformNormal(inverse_transform_, local_normal);
             world_normal.Normalize();
             return world_normal;
         }
 
     protected:
         Shape() :
-            transform_(Matrix44::Identity()),
-            inverse_transform_(Matrix44::Identity()),
-            transposed_inverse_transform_(Matrix44::Identity())
+            transform_(Affine34::Identity()),
+            inverse_transform_(Affine34::Identity())
         {
         }
 
         Shape(const Material& material) :
             material_(material),
-            transform_(Matrix44::Identity()),
-            inverse_transform_(Matrix44::Identity()),
-            transposed_inverse_transform_(Matrix44::Identity())
+            transform_(Affine34::Identity()),
+            inverse_transform_(Affine34::Identity())
         {
+            ComputePatternTransform();
         }
 
         Shape(Material&& material) :
             material_(std::move(material)),
-            transform_(Matrix44::Identity()),
-            inverse_transform_(Matrix44::Identity()),
-            transposed_inverse_transform_(Matrix44::Identity())
+            transform_(Affine34::Identity()),
+            inverse_transform_(Affine34::Identity())
         {
+            ComputePatternTransform();
         }
 
         Shape(const Matrix44& transform) :
@@ -119,12 +177,6 @@ namespace rtc
             ComputeInverseTransforms();
         }
 
-        Shape(Matrix44&& transform) :
-            transform_(std::move(transform))
-        {
-            ComputeInverseTransforms();
-        }
-
         Shape(const Material& material, const Matrix44& transform) :
             material_(material),
             transform_(transform)
@@ -132,9 +184,9 @@ namespace rtc
             ComputeInverseTransforms();
         }
 
-        Shape(Material&& material, Matrix44&& transform) :
+        Shape(Material&& material, const Matrix44& transform) :
             material_(std::move(material)),
-            transform_(std::move(transform))
+            transform_(transform)
         {
             ComputeInverseTransforms();
         }
@@ -142,25 +194,40 @@ namespace rtc
     private:
         void ComputeInverseTransforms()
         {
-            inverse_transform_            = Matrix44::Inverse(transform_);
-            transposed_inverse_transform_ = Matrix44::Transpose(inverse_transform_);
+            inverse_transform_ = Affine34::Inverse(transform_);
+            ComputePatternTransform();
+        }
 
-            // If the original transform included translation, the normal computed with the
-            // transpose of the inverse transform could end up with a non-zero w component.
-            // The bottom row is cleared to avoid this.
-            transposed_inverse_transform_.Set(3u, 0u, 0.0);
-            transposed_inverse_transform_.Set(3u, 1u, 0.0);
-            transposed_inverse_transform_.Set(3u, 2u, 0.0);
+        void ComputePatternTransform()
+        {
+            const auto& pattern = material_.GetPattern();
+
+            if (pattern)
+            {
+                world_to_pattern_transform_ = Affine34::Multiply(pattern->GetInverseTransform(), inverse_transform_);
+                pattern_                    = pattern.get();
+                pattern_version_            = pattern->GetVersion();
+            }
+            else
+            {
+                pattern_ = nullptr;
+            }
         }
 
         virtual void LocalIntersect(const Ray& local_ray, Intersections::Values& values) const = 0;
 
         virtual Vector LocalNormalAt(const Point& local_point) const = 0;
 
+        // Object space bounding box of the shape, returning false when the shape is unbounded. Shapes are
+        // unbounded unless they override it.
+        virtual bool LocalBounds(Point&, Point&) const { return false; }
+
     private:
-        Material material_;                      ///< Material properties describing how the sphere shoule be shaded.
-        Matrix44 transform_;                     ///< Transform to determine the shape and position of the sphere.
-        Matrix44 inverse_transform_;             ///< Inverse of the transform to be applied to rays for intersection testing.
-        Matrix44 transposed_inverse_transform_;  ///< Transpose of the inverse of the transform for surface normal calculation.
+        Material       material_;                    ///< Material properties describing how the sphere shoule be shaded.
+        Affine34       transform_;                   ///< Transform to determine the shape and position of the sphere.
+        Affine34       inverse_transform_;           ///< Inverse of the transform, applied to rays for intersection testing and, transposed, to normals.
+        Affine34       world_to_pattern_transform_;  ///< Pattern inverse transform combined with the shape inverse transform.
+        const Pattern* pattern_{ nullptr };          ///< Pattern the combined transform was computed for.
+        uint64_t       pattern_version_{ 0u };       ///< Version of the pattern transform the combined transform was computed for.
     };
 }
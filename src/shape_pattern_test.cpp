@@ -0,0 +1,98 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "catch2/catch.hpp"
+
+#include "color.h"
+#include "material.h"
+#include "matrix44.h"
+#include "pattern.h"
+#include "point.h"
+#include "sphere.h"
+
+#include <memory>
+
+namespace
+{
+    // Pattern whose color is the pattern space point.
+    class PointPattern : public rtc::Pattern
+    {
+    public:
+        static std::shared_ptr<PointPattern> Create() { return std::shared_ptr<PointPattern>(new PointPattern()); }
+
+        virtual rtc::Color PatternAt(const rtc::Point& point) const override { return rtc::Color{ point.GetX(), point.GetY(), point.GetZ() }; }
+    };
+
+    rtc::Material PatternMaterial(const std::shared_ptr<rtc::Pattern>& pattern)
+    {
+        return rtc::Material{ pattern, rtc::Material::GetDefaultAmbient(), rtc::Material::GetDefaultDiffuse(), rtc::Material::GetDefaultSpecular(), rtc::Material::GetDefaultShininess() };
+    }
+}
+
+SCENARIO("The color of a shape without a pattern is the material color", "[patterns]")
+{
+    GIVEN("shape <- sphere() with material color(1, 0.2, 1)")
+    {
+        const auto shape = rtc::Sphere::Create(rtc::Material{ rtc::Color{ 1.0, 0.2, 1.0 }, 0.1, 0.9, 0.9, 200.0 });
+
+        THEN("color_at(shape, point(2, 3, 4)) = color(1, 0.2, 1)")
+        {
+            REQUIRE(rtc::Color::Equal(shape->ColorAt(rtc::Point{ 2.0, 3.0, 4.0 }), rtc::Color{ 1.0, 0.2, 1.0 }));
+        }
+    }
+}
+
+SCENARIO("The color of a shape combines the object and pattern transformations", "[patterns]")
+{
+    GIVEN("pattern <- point_pattern() with transform translation(0.5, 1, 1.5) and shape <- sphere() with transform scaling(2, 2, 2)")
+    {
+        const auto pattern = PointPattern::Create();
+        pattern->SetTransform(rtc::Matrix44::Translation(0.5, 1.0, 1.5));
+
+        const auto shape = rtc::Sphere::Create(PatternMaterial(pattern), rtc::Matrix44::Scaling(2.0, 2.0, 2.0));
+
+        THEN("color_at(shape, point(2.5, 3, 3.5)) = color(0.75, 0.5, 0.25)")
+        {
+            REQUIRE(rtc::Color::Equal(shape->ColorAt(rtc::Point{ 2.5, 3.0, 3.5 }), rtc::Color{ 0.75, 0.5, 0.25 }));
+        }
+
+        WHEN("set_transform(shape, scaling(0.5, 0.5, 0.5))")
+        {
+            shape->SetTransform(rtc::Matrix44::Scaling(0.5, 0.5, 0.5));
+
+            THEN("color_at(shape, point(1, 1, 1)) = color(1.5, 1, 0.5)")
+            {
+                REQUIRE(rtc::Color::Equal(shape->ColorAt(rtc::Point{ 1.0, 1.0, 1.0 }), rtc::Color{ 1.5, 1.0, 0.5 }));
+            }
+        }
+
+        WHEN("set_pattern_transform(pattern, translation(1, 1, 1)) after the pattern was bound to shape")
+        {
+            pattern->SetTransform(rtc::Matrix44::Translation(1.0, 1.0, 1.0));
+
+            THEN("color_at(shape, point(4, 4, 4)) = color(1, 1, 1)")
+            {
+                REQUIRE(rtc::Color::Equal(shape->ColorAt(rtc::Point{ 4.0, 4.0, 4.0 }), rtc::Color{ 1.0, 1.0, 1.0 }));
+            }
+        }
+    }
+}
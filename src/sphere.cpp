@@ -37,20 +37,20 @@ namespace rtc
         const auto ray_direction = local_ray.GetDirection();
 
         const auto a = Vector::Dot(ray_direction, ray_direction);
-        const auto b = 2.0 * Vector::Dot(ray_direction, sphere_to_ray);
-        const auto c = Vector::Dot(sphere_to_ray, sphere_to_ray) - 1.0;
+        const auto b = Scalar{ 2 } * Vector::Dot(ray_direction, sphere_to_ray);
+        const auto c = Vector::Dot(sphere_to_ray, sphere_to_ray) - Scalar{ 1 };
 
-        const auto discriminant = Square(b) - 4.0 * a * c;
+        const auto discriminant = Square(b) - Scalar{ 4 } * a * c;
 
         // When discriminant is less than 0, the ray did not intersect the sphere.
-        if (discriminant < 0.0)
+        if (discriminant < Scalar{ 0 })
         {
             return;
         }
 
         // Compute intersetcion 'times'.  For the tangent case, return the same value twice.
-        const auto two_a = 1.0 / (2.0 * a);
-        const auto sqrt_d = sqrt(discriminant);
+        const auto two_a = Scalar{ 1 } / (Scalar{ 2 } * a);
+        const auto sqrt_d = std::sqrt(discriminant);
         const auto t1 = (-b - sqrt_d) * two_a;
         const auto t2 = (-b + sqrt_d) * two_a;
 
@@ -84,5 +84,12 @@ namespace rtc
         {
             return Vector{ local_point };
         }
+
+        virtual bool LocalBounds(Point& min_bounds, Point& max_bounds) const override
+        {
+            min_bounds = Point{ -1.0, -1.0, -1.0 };
+            max_bounds = Point{ 1.0, 1.0, 1.0 };
+            return true;
+        }
     };
 }
@@ -0,0 +1,310 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "texture.h"
+
+#include "ppm_reader.h"
+#include "texture_cache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace rtc
+{
+    namespace
+    {
+        std::atomic<uint64_t> next_texture_id{ 1u };
+
+        bool Seek(std::FILE* file, uint64_t offset)
+        {
+#if defined(_WIN32)
+            return _fseeki64(file, static_cast<int64_t>(offset), SEEK_SET) == 0;
+#else
+            return fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+        }
+
+        // Wrap a texel coordinate into [0, size).
+        uint32_t Wrap(int64_t coordinate, uint32_t size)
+        {
+            const auto wrapped = coordinate % static_cast<int64_t>(size);
+            return static_cast<uint32_t>((wrapped < 0) ? wrapped + size : wrapped);
+        }
+
+        // Reads texels of one level, holding on to the most recently used tile, since neighboring
+        // texels usually share a tile.
+        class TexelFetcher
+        {
+        public:
+            TexelFetcher(TextureCache& cache, const Texture& texture, uint32_t level) :
+                cache_(cache),
+                texture_(texture),
+                level_(level)
+            {
+            }
+
+            Color Fetch(uint32_t x, uint32_t y)
+            {
+                const auto tile_x = x / Texture::kTileSize;
+                const auto tile_y = y / Texture::kTileSize;
+
+                if (!tile_ || (tile_x != tile_x_) || (tile_y != tile_y_))
+                {
+                    tile_   = cache_.GetTile(texture_, level_, tile_x, tile_y);
+                    tile_x_ = tile_x;
+                    tile_y_ = tile_y;
+                }
+
+                if (!tile_)
+                {
+                    return Color{};
+                }
+
+                const auto  index = (((y % Texture::kTileSize) * Texture::kTileSize) + (x % Texture::kTileSize)) * 3u;
+                const auto& texel = *tile_;
+                return Color{ texel[index], texel[index + 1u], texel[index + 2u] };
+            }
+
+        private:
+            TextureCache&                      cache_;
+            const Texture&                     texture_;
+            uint32_t                           level_;
+            uint32_t                           tile_x_{ 0u };
+            uint32_t                           tile_y_{ 0u };
+            std::shared_ptr<const TextureTile> tile_;
+        };
+    }
+
+    Texture::Texture() :
+        id_(next_texture_id++),
+        file_(nullptr)
+    {
+    }
+
+    Texture::~Texture()
+    {
+        if (file_ != nullptr)
+        {
+            std::fclose(file_);
+        }
+    }
+
+    std::shared_ptr<Texture> Texture::Create(const Canvas& image)
+    {
+        if ((image.GetWidth() == 0u) || (image.GetHeight() == 0u))
+        {
+            return nullptr;
+        }
+
+        auto texture   = std::shared_ptr<Texture>(new Texture());
+        texture->file_ = std::tmpfile();
+
+        if (texture->file_ == nullptr)
+        {
+            return nullptr;
+        }
+
+        auto width  = image.GetWidth();
+        auto height = image.GetHeight();
+        auto texels = std::vector<float>(static_cast<size_t>(width) * height * 3u);
+
+        for (uint32_t y = 0u; y < height; ++y)
+        {
+            for (uint32_t x = 0u; x < width; ++x)
+            {
+                const auto& pixel = image.PixelAt(x, y);
+                const auto  index = ((static_cast<size_t>(y) * width) + x) * 3u;
+
+                texels[index]      = static_cast<float>(pixel.GetR());
+                texels[index + 1u] = static_cast<float>(pixel.GetG());
+                texels[index + 2u] = static_cast<float>(pixel.GetB());
+            }
+        }
+
+        // Write each level, then halve it with a box filter, until a level is a single texel.
+        while (true)
+        {
+            if (!texture->WriteLevel(texels, width, height))
+            {
+                return nullptr;
+            }
+
+            if ((width == 1u) && (height == 1u))
+            {
+                break;
+            }
+
+            const auto next_width  = std::max(width / 2u, 1u);
+            const auto next_height = std::max(height / 2u, 1u);
+            auto       next        = std::vector<float>(static_cast<size_t>(next_width) * next_height * 3u);
+
+            for (uint32_t y = 0u; y < next_height; ++y)
+            {
+                const auto y0 = std::min(y * 2u, height - 1u);
+                const auto y1 = std::min((y * 2u) + 1u, height - 1u);
+
+                for (uint32_t x = 0u; x < next_width; ++x)
+                {
+                    const auto x0 = std::min(x * 2u, width - 1u);
+                    const auto x1 = std::min((x * 2u) + 1u, width - 1u);
+
+                    for (uint32_t c = 0u; c < 3u; ++c)
+                    {
+                        const auto sum =
+                            texels[((static_cast<size_t>(y0) * width) + x0) * 3u + c] +
+                            texels[((static_cast<size_t>(y0) * width) + x1) * 3u + c] +
+                            texels[((static_cast<size_t>(y1) * width) + x0) * 3u + c] +
+                            texels[((static_cast<size_t>(y1) * width) + x1) * 3u + c];
+
+                        next[((static_cast<size_t>(y) * next_width) + x) * 3u + c] = sum * 0.25f;
+                    }
+                }
+            }
+
+            texels = std::move(next);
+            width  = next_width;
+            height = next_height;
+        }
+
+        return texture;
+    }
+
+    std::shared_ptr<Texture> Texture::Load(const std::string& filename)
+    {
+        const auto image = PpmReader::ReadFile(filename);
+
+        if (image)
+        {
+            return Create(*image);
+        }
+
+        return nullptr;
+    }
+
+    bool Texture::ReadTile(uint32_t level, uint32_t tile_x, uint32_t tile_y, TextureTile& tile) const
+    {
+        const auto& info  = levels_.at(level);
+        const auto  index = static_cast<uint64_t>(info.first_tile) + (static_cast<uint64_t>(tile_y) * info.tiles_x) + tile_x;
+
+        tile.resize(kTileSize * kTileSize * 3u);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        return Seek(file_, index * GetTileBytes()) && (std::fread(tile.data(), GetTileBytes(), 1u, file_) == 1u);
+    }
+
+    Color Texture::Sample(TextureCache& cache, Scalar u, Scalar v, Scalar level_of_detail) const
+    {
+        const auto max_level = static_cast<Scalar>(levels_.size() - 1u);
+        const auto lod       = std::clamp(level_of_detail, Scalar{ 0 }, max_level);
+        const auto level     = static_cast<uint32_t>(lod);
+        const auto blend     = lod - static_cast<Scalar>(level);
+
+        auto color = SampleLevel(cache, level, u, v);
+
+        if (blend > 0)
+        {
+            const auto next = SampleLevel(cache, level + 1u, u, v);
+            color = Color::Add(Color::Multiply(color, Scalar{ 1 } - blend), Color::Multiply(next, blend));
+        }
+
+        return color;
+    }
+
+    Color Texture::SampleNearest(TextureCache& cache, Scalar u, Scalar v, uint32_t level) const
+    {
+        const auto  clamped = std::min(level, GetLevelCount() - 1u);
+        const auto& info    = levels_[clamped];
+        auto        texels  = TexelFetcher{ cache, *this, clamped };
+
+        const auto x = std::floor((u - std::floor(u)) * static_cast<Scalar>(info.width));
+        const auto y = std::floor((Scalar{ 1 } - (v - std::floor(v))) * static_cast<Scalar>(info.height));
+
+        return texels.Fetch(Wrap(static_cast<int64_t>(x), info.width), Wrap(static_cast<int64_t>(y), info.height));
+    }
+
+    bool Texture::WriteLevel(const std::vector<float>& texels, uint32_t width, uint32_t height)
+    {
+        const auto tiles_x = (width + kTileSize - 1u) / kTileSize;
+        const auto tiles_y = (height + kTileSize - 1u) / kTileSize;
+        const auto first   = levels_.empty() ? 0u : levels_.back().first_tile + (levels_.back().tiles_x * levels_.back().tiles_y);
+
+        auto tile = TextureTile(kTileSize * kTileSize * 3u);
+
+        for (uint32_t tile_y = 0u; tile_y < tiles_y; ++tile_y)
+        {
+            for (uint32_t tile_x = 0u; tile_x < tiles_x; ++tile_x)
+            {
+                // Tiles past the edge of the level are padded with copies of the edge texels.
+                for (uint32_t y = 0u; y < kTileSize; ++y)
+                {
+                    const auto source_y = std::min((tile_y * kTileSize) + y, height - 1u);
+
+                    for (uint32_t x = 0u; x < kTileSize; ++x)
+                    {
+                        const auto source_x = std::min((tile_x * kTileSize) + x, width - 1u);
+                        const auto source   = ((static_cast<size_t>(source_y) * width) + source_x) * 3u;
+                        const auto target   = ((y * kTileSize) + x) * 3u;
+
+                        tile[target]      = texels[source];
+                        tile[target + 1u] = texels[source + 1u];
+                        tile[target + 2u] = texels[source + 2u];
+                    }
+                }
+
+                if (std::fwrite(tile.data(), GetTileBytes(), 1u, file_) != 1u)
+                {
+                    return false;
+                }
+            }
+        }
+
+        levels_.push_back(Level{ width, height, tiles_x, tiles_y, first });
+
+        return true;
+    }
+
+    Color Texture::SampleLevel(TextureCache& cache, uint32_t level, Scalar u, Scalar v) const
+    {
+        const auto& info   = levels_[level];
+        auto        texels = TexelFetcher{ cache, *this, level };
+
+        // Texel centers are at half integer coordinates, and image rows run from the top down.
+        const auto x  = ((u - std::floor(u)) * static_cast<Scalar>(info.width)) - Scalar{ 0.5 };
+        const auto y  = ((Scalar{ 1 } - (v - std::floor(v))) * static_cast<Scalar>(info.height)) - Scalar{ 0.5 };
+        const auto x0 = std::floor(x);
+        const auto y0 = std::floor(y);
+        const auto fx = x - x0;
+        const auto fy = y - y0;
+
+        const auto left   = Wrap(static_cast<int64_t>(x0), info.width);
+        const auto right  = Wrap(static_cast<int64_t>(x0) + 1, info.width);
+        const auto top    = Wrap(static_cast<int64_t>(y0), info.height);
+        const auto bottom = Wrap(static_cast<int64_t>(y0) + 1, info.height);
+
+        const auto upper = Color::Add(Color::Multiply(texels.Fetch(left, top), Scalar{ 1 } - fx), Color::Multiply(texels.Fetch(right, top), fx));
+        const auto lower = Color::Add(Color::Multiply(texels.Fetch(left, bottom), Scalar{ 1 } - fx), Color::Multiply(texels.Fetch(right, bottom), fx));
+
+        return Color::Add(Color::Multiply(upper, Scalar{ 1 } - fy), Color::Multiply(lower, fy));
+    }
+}
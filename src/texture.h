@@ -0,0 +1,114 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#pragma once
+
+#include "canvas.h"
+#include "color.h"
+#include "double_util.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace rtc
+{
+    class TextureCache;
+
+    // Texels of one tile of a texture level, as rows of red, green and blue values.
+    using TextureTile = std::vector<float>;
+
+    // Mip-mapped image texture. The image and each successively halved level are split into square tiles
+    // that are written to a temporary file when the texture is created, so the texture itself holds no
+    // texels; samples read tiles through a TextureCache, which bounds the memory used by all textures.
+    class Texture
+    {
+    public:
+        static constexpr uint32_t kTileSize = 32u;  ///< Width and height of a tile, in texels.
+
+    public:
+        ~Texture();
+
+        Texture(const Texture&) = delete;
+
+        Texture& operator=(const Texture&) = delete;
+
+        // Create a texture from an image. Returns nullptr if the image is empty or the temporary file cannot be
+        // written.
+        static std::shared_ptr<Texture> Create(const Canvas& image);
+
+        // Create a texture from a PPM image file. Returns nullptr if the file cannot be read.
+        static std::shared_ptr<Texture> Load(const std::string& filename);
+
+        // Unique identifier of the texture, used as part of the texture cache key.
+        uint64_t GetId() const { return id_; }
+
+        uint32_t GetLevelCount() const { return static_cast<uint32_t>(levels_.size()); }
+
+        uint32_t GetWidth(uint32_t level) const { return levels_.at(level).width; }
+
+        uint32_t GetHeight(uint32_t level) const { return levels_.at(level).height; }
+
+        // Size of the texels of a tile, in bytes.
+        static constexpr size_t GetTileBytes() { return kTileSize * kTileSize * 3u * sizeof(float); }
+
+        // Number of tiles in every level of the texture.
+        uint32_t GetTileCount() const { return levels_.back().first_tile + (levels_.back().tiles_x * levels_.back().tiles_y); }
+
+        // Read the texels of a tile from the temporary file. Safe to call from multiple threads.
+        bool ReadTile(uint32_t level, uint32_t tile_x, uint32_t tile_y, TextureTile& tile) const;
+
+        // Sample the texture at (u, v), with (0, 0) at the bottom left of the image. Coordinates outside
+        // [0, 1) wrap around. The level of detail selects the mip level, with 0 for the full image and each
+        // increment halving the resolution; fractional values blend the two nearest levels.
+        Color Sample(TextureCache& cache, Scalar u, Scalar v, Scalar level_of_detail) const;
+
+        // Sample the texel of a mip level that contains (u, v), without filtering.
+        Color SampleNearest(TextureCache& cache, Scalar u, Scalar v, uint32_t level) const;
+
+    private:
+        struct Level
+        {
+            uint32_t width;       ///< Width of the level, in texels.
+            uint32_t height;      ///< Height of the level, in texels.
+            uint32_t tiles_x;     ///< Number of tiles in a row of the level.
+            uint32_t tiles_y;     ///< Number of tiles in a column of the level.
+            uint32_t first_tile;  ///< Index in the temporary file of the first tile of the level.
+        };
+
+    private:
+        Texture();
+
+        bool WriteLevel(const std::vector<float>& texels, uint32_t width, uint32_t height);
+
+        Color SampleLevel(TextureCache& cache, uint32_t level, Scalar u, Scalar v) const;
+
+    private:
+        uint64_t           id_;       ///< Unique identifier of the texture.
+        std::vector<Level> levels_;   ///< Dimensions and tile locations of each mip level, starting with the full image.
+        std::FILE*         file_;     ///< Temporary file holding the tiles of every level.
+        mutable std::mutex mutex_;    ///< Serializes reads from the temporary file.
+    };
+}
@@ -0,0 +1,130 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "texture_cache.h"
+
+#include <algorithm>
+
+namespace rtc
+{
+    namespace
+    {
+        constexpr size_t kSharedCapacity = 256u * 1024u * 1024u;
+    }
+
+    size_t TextureCache::KeyHash::operator()(const Key& key) const
+    {
+        // SplitMix64 finalizer over the combined texture and tile.
+        auto value = key.first ^ (key.second * 0x9e3779b97f4a7c15ull);
+        value      = (value ^ (value >> 30u)) * 0xbf58476d1ce4e5b9ull;
+        value      = (value ^ (value >> 27u)) * 0x94d049bb133111ebull;
+        return static_cast<size_t>(value ^ (value >> 31u));
+    }
+
+    TextureCache::TextureCache(size_t capacity) :
+        capacity_(capacity),
+        shard_capacity_(std::max(capacity / kShardCount, Texture::GetTileBytes()))
+    {
+    }
+
+    std::shared_ptr<const TextureTile> TextureCache::GetTile(const Texture& texture, uint32_t level, uint32_t tile_x, uint32_t tile_y)
+    {
+        const auto key   = Key{ texture.GetId(), (static_cast<uint64_t>(level) << 48u) | (static_cast<uint64_t>(tile_y) << 24u) | tile_x };
+        auto&      shard = shards_[KeyHash{}(key) % kShardCount];
+
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+
+            const auto entry = shard.entries.find(key);
+            if (entry != shard.entries.end())
+            {
+                // Move the tile to the front of the list.
+                shard.lru.splice(shard.lru.begin(), shard.lru, entry->second);
+                ++hits_;
+                return entry->second->second;
+            }
+        }
+
+        // Load the tile without holding the lock, so that other threads are not blocked on file access.
+        // If another thread loads the same tile first, its copy is used.
+        auto tile = std::make_shared<TextureTile>();
+        if (!texture.ReadTile(level, tile_x, tile_y, *tile))
+        {
+            return nullptr;
+        }
+
+        ++misses_;
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        const auto entry = shard.entries.find(key);
+        if (entry != shard.entries.end())
+        {
+            shard.lru.splice(shard.lru.begin(), shard.lru, entry->second);
+            return entry->second->second;
+        }
+
+        shard.lru.emplace_front(key, tile);
+        shard.entries.emplace(key, shard.lru.begin());
+        shard.size += Texture::GetTileBytes();
+
+        while ((shard.size > shard_capacity_) && (shard.lru.size() > 1u))
+        {
+            shard.entries.erase(shard.lru.back().first);
+            shard.lru.pop_back();
+            shard.size -= Texture::GetTileBytes();
+            ++evictions_;
+        }
+
+        return tile;
+    }
+
+    size_t TextureCache::GetSize() const
+    {
+        auto size = size_t{ 0u };
+
+        for (auto& shard : shards_)
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            size += shard.size;
+        }
+
+        return size;
+    }
+
+    void TextureCache::Clear()
+    {
+        for (auto& shard : shards_)
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.entries.clear();
+            shard.lru.clear();
+            shard.size = 0u;
+        }
+    }
+
+    const std::shared_ptr<TextureCache>& TextureCache::GetShared()
+    {
+        static const auto shared = std::make_shared<TextureCache>(kSharedCapacity);
+        return shared;
+    }
+}
@@ -0,0 +1,95 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#pragma once
+
+#include "texture.h"
+
+#include <atomic>
+#include <cinttypes>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace rtc
+{
+    // Least recently used cache of texture tiles, bounded by a total size in bytes and safe to share
+    // between render threads. Tiles are loaded on demand, so scenes whose textures are larger than the
+    // budget render with only the tiles in use resident. The cache is split into shards with separate
+    // locks and budgets, selected by the tile, to reduce contention between threads.
+    class TextureCache
+    {
+    public:
+        explicit TextureCache(size_t capacity);
+
+        // Return the tile, loading it and evicting the least recently used tiles of its shard when it is
+        // not cached. Returns nullptr if the tile cannot be read.
+        std::shared_ptr<const TextureTile> GetTile(const Texture& texture, uint32_t level, uint32_t tile_x, uint32_t tile_y);
+
+        // Maximum size of the cached tiles, in bytes. Each shard holds at least one tile.
+        size_t GetCapacity() const { return capacity_; }
+
+        // Current size of the cached tiles, in bytes.
+        size_t GetSize() const;
+
+        uint64_t GetHitCount() const { return hits_; }
+
+        uint64_t GetMissCount() const { return misses_; }
+
+        uint64_t GetEvictionCount() const { return evictions_; }
+
+        void Clear();
+
+        // Cache shared by image texture patterns that are not given their own, with a 256 MiB budget.
+        static const std::shared_ptr<TextureCache>& GetShared();
+
+    private:
+        static constexpr size_t kShardCount = 16u;
+
+        using Key = std::pair<uint64_t, uint64_t>;
+
+        struct KeyHash
+        {
+            size_t operator()(const Key& key) const;
+        };
+
+        using Entry = std::pair<Key, std::shared_ptr<const TextureTile>>;
+
+        struct Shard
+        {
+            mutable std::mutex                                           mutex;       ///< Guards the shard's tiles.
+            std::list<Entry>                                             lru;         ///< Tiles, most recently used first.
+            std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> entries;     ///< Position of each cached tile in the list.
+            size_t                                                       size{ 0u };  ///< Size of the shard's tiles, in bytes.
+        };
+
+    private:
+        size_t                capacity_;             ///< Maximum size of all cached tiles, in bytes.
+        size_t                shard_capacity_;       ///< Maximum size of the tiles cached by each shard, in bytes.
+        Shard                 shards_[kShardCount];  ///< Independently locked partitions of the cache.
+        std::atomic<uint64_t> hits_{ 0u };           ///< Number of requests for a cached tile.
+        std::atomic<uint64_t> misses_{ 0u };         ///< Number of requests that loaded a tile.
+        std::atomic<uint64_t> evictions_{ 0u };      ///< Number of tiles evicted to stay within the budget.
+    };
+}
@@ -0,0 +1,371 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "catch2/catch.hpp"
+
+#include "canvas.h"
+#include "color.h"
+#include "double_util.h"
+#include "image_texture_pattern.h"
+#include "material.h"
+#include "memory_output_stream.h"
+#include "point.h"
+#include "ppm_reader.h"
+#include "ppm_writer.h"
+#include "sphere.h"
+#include "texture.h"
+#include "texture_cache.h"
+#include "uv_mapping.h"
+
+#include <cmath>
+#include <sstream>
+#include <string>
+
+namespace
+{
+    // Image whose pixels encode their coordinates.
+    rtc::Canvas GradientImage(uint32_t width, uint32_t height)
+    {
+        auto image = rtc::Canvas{ width, height };
+
+        for (uint32_t y = 0u; y < height; ++y)
+        {
+            for (uint32_t x = 0u; x < width; ++x)
+            {
+                image.WritePixel(x, y, rtc::Color{ static_cast<rtc::Scalar>(x) / width, static_cast<rtc::Scalar>(y) / height, 0.5 });
+            }
+        }
+
+        return image;
+    }
+
+    // Texture coordinates of the center of a texel.
+    rtc::Scalar TexelU(uint32_t x, uint32_t width) { return (static_cast<rtc::Scalar>(x) + rtc::Scalar{ 0.5 }) / width; }
+
+    rtc::Scalar TexelV(uint32_t y, uint32_t height) { return rtc::Scalar{ 1 } - ((static_cast<rtc::Scalar>(y) + rtc::Scalar{ 0.5 }) / height); }
+}
+
+SCENARIO("Reading a plain PPM file", "[textures]")
+{
+    GIVEN("ppm <- a P3 file with comments")
+    {
+        auto ppm = std::istringstream{ "P3\n# A comment\n2 2\n255\n255 0 0  0 255 0\n# Another comment\n0 0 255  255 255 255\n" };
+
+        WHEN("canvas <- canvas_from_ppm(ppm)")
+        {
+            const auto canvas = rtc::PpmReader::ReadStream(ppm);
+
+            THEN("The canvas holds the pixels of the file")
+            {
+                REQUIRE(canvas != nullptr);
+                REQUIRE(canvas->GetWidth() == 2u);
+                REQUIRE(canvas->GetHeight() == 2u);
+                REQUIRE(rtc::Color::Equal(canvas->PixelAt(0u, 0u), rtc::Color{ 1.0, 0.0, 0.0 }));
+                REQUIRE(rtc::Color::Equal(canvas->PixelAt(1u, 0u), rtc::Color{ 0.0, 1.0, 0.0 }));
+                REQUIRE(rtc::Color::Equal(canvas->PixelAt(0u, 1u), rtc::Color{ 0.0, 0.0, 1.0 }));
+                REQUIRE(rtc::Color::Equal(canvas->PixelAt(1u, 1u), rtc::Color{ 1.0, 1.0, 1.0 }));
+            }
+        }
+    }
+}
+
+SCENARIO("Reading a raw PPM file", "[textures]")
+{
+    GIVEN("ppm <- a P6 file with a maximum value of 255 and a P6 file with a maximum value of 1000")
+    {
+        auto ppm8  = std::istringstream{ std::string{ "P6 2 1 255\n\xff\x00\x80\x00\x33\xff", 17 } };
+        auto ppm16 = std::istringstream{ std::string{ "P6 1 1 1000\n\x03\xe8\x01\xf4\x00\x00", 18 } };
+
+        WHEN("canvas8 <- canvas_from_ppm(ppm8) and canvas16 <- canvas_from_ppm(ppm16)")
+        {
+            const auto canvas8  = rtc::PpmReader::ReadStream(ppm8);
+            const auto canvas16 = rtc::PpmReader::ReadStream(ppm16);
+
+            THEN("The canvases hold the pixels of the files")
+            {
+                REQUIRE(canvas8 != nullptr);
+                REQUIRE(rtc::Color::Equal(canvas8->PixelAt(0u, 0u), rtc::Color{ 1.0, 0.0, 128.0 / 255.0 }));
+                REQUIRE(rtc::Color::Equal(canvas8->PixelAt(1u, 0u), rtc::Color{ 0.0, 0.2, 1.0 }));
+
+                REQUIRE(canvas16 != nullptr);
+                REQUIRE(rtc::Color::Equal(canvas16->PixelAt(0u, 0u), rtc::Color{ 1.0, 0.5, 0.0 }));
+            }
+        }
+    }
+}
+
+SCENARIO("Reading an invalid PPM file", "[textures]")
+{
+    GIVEN("Files with the wrong magic number, missing pixel data, and a value above the maximum")
+    {
+        auto magic     = std::istringstream{ "P32\n1 1\n255\n0 0 0\n" };
+        auto truncated = std::istringstream{ "P3\n2 1\n255\n0 0 0\n" };
+        auto range     = std::istringstream{ "P3\n1 1\n255\n0 256 0\n" };
+
+        THEN("canvas_from_ppm returns nothing")
+        {
+            REQUIRE(rtc::PpmReader::ReadStream(magic) == nullptr);
+            REQUIRE(rtc::PpmReader::ReadStream(truncated) == nullptr);
+            REQUIRE(rtc::PpmReader::ReadStream(range) == nullptr);
+        }
+    }
+
+    GIVEN("Headers for 65535x65535 images followed by a few bytes of pixel data")
+    {
+        auto raw   = std::istringstream{ std::string{ "P6\n65535 65535\n65535\n" } + std::string(6u, '\0') };
+        auto plain = std::istringstream{ "P3\n65535 65535\n255\n0 0 0\n" };
+
+        THEN("canvas_from_ppm returns nothing without allocating the canvas")
+        {
+            REQUIRE(rtc::PpmReader::ReadStream(raw) == nullptr);
+            REQUIRE(rtc::PpmReader::ReadStream(plain) == nullptr);
+        }
+    }
+}
+
+SCENARIO("Reading a PPM file written by the PPM writer", "[textures]")
+{
+    GIVEN("c <- canvas(5, 3) with pixels written and ppm <- canvas_to_ppm(c)")
+    {
+        auto c = rtc::Canvas{ 5u, 3u };
+        c.WritePixel(0u, 0u, rtc::Color{ 1.0, 0.0, 0.0 });
+        c.WritePixel(2u, 1u, rtc::Color{ 0.0, 0.2, 0.0 });
+        c.WritePixel(4u, 2u, rtc::Color{ 0.4, 0.6, 1.0 });
+
+        auto stream = rtc::MemoryOutputStream{};
+        REQUIRE(rtc::PpmWriter::WriteStream(&stream, c));
+
+        WHEN("canvas <- canvas_from_ppm(ppm)")
+        {
+            auto       ppm    = std::istringstream{ std::string{ reinterpret_cast<const char*>(stream.GetData()), stream.GetSize() } };
+            const auto canvas = rtc::PpmReader::ReadStream(ppm);
+
+            THEN("Every pixel matches to within the precision of the file")
+            {
+                REQUIRE(canvas != nullptr);
+
+                for (uint32_t y = 0u; y < 3u; ++y)
+                {
+                    for (uint32_t x = 0u; x < 5u; ++x)
+                    {
+                        const auto expected = c.PixelAt(x, y);
+                        const auto actual   = canvas->PixelAt(x, y);
+
+                        REQUIRE(std::abs(actual.GetR() - expected.GetR()) < (1.0 / 255.0));
+                        REQUIRE(std::abs(actual.GetG() - expected.GetG()) < (1.0 / 255.0));
+                        REQUIRE(std::abs(actual.GetB() - expected.GetB()) < (1.0 / 255.0));
+                    }
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Using a spherical mapping on a 3D point", "[textures]")
+{
+    GIVEN("Points on the unit sphere")
+    {
+        THEN("spherical_map(p) = (u, v)")
+        {
+            const auto h = std::sqrt(2.0) / 2.0;
+
+            const struct
+            {
+                rtc::Point  p;
+                rtc::Scalar u;
+                rtc::Scalar v;
+            } examples[] = {
+                { rtc::Point{ 0.0, 0.0, -1.0 }, 0.0, 0.5 },
+                { rtc::Point{ 1.0, 0.0, 0.0 }, 0.25, 0.5 },
+                { rtc::Point{ 0.0, 0.0, 1.0 }, 0.5, 0.5 },
+                { rtc::Point{ -1.0, 0.0, 0.0 }, 0.75, 0.5 },
+                { rtc::Point{ 0.0, 1.0, 0.0 }, 0.5, 1.0 },
+                { rtc::Point{ 0.0, -1.0, 0.0 }, 0.5, 0.0 },
+                { rtc::Point{ static_cast<rtc::Scalar>(h), static_cast<rtc::Scalar>(h), 0.0 }, 0.25, 0.75 }
+            };
+
+            for (const auto& example : examples)
+            {
+                auto u = rtc::Scalar{ 0 };
+                auto v = rtc::Scalar{ 0 };
+                rtc::UvMapping::Spherical(example.p, u, v);
+
+                REQUIRE(rtc::Equal(u, example.u));
+                REQUIRE(rtc::Equal(v, example.v));
+            }
+        }
+    }
+}
+
+SCENARIO("Using a planar mapping on a 3D point", "[textures]")
+{
+    GIVEN("Points in and above the xz plane")
+    {
+        THEN("planar_map(p) = (u, v)")
+        {
+            const struct
+            {
+                rtc::Point  p;
+                rtc::Scalar u;
+                rtc::Scalar v;
+            } examples[] = {
+                { rtc::Point{ 0.25, 0.0, 0.5 }, 0.25, 0.5 },
+                { rtc::Point{ 0.25, 0.0, -0.25 }, 0.25, 0.75 },
+                { rtc::Point{ 0.25, 0.5, -0.25 }, 0.25, 0.75 },
+                { rtc::Point{ 1.25, 0.0, 0.5 }, 0.25, 0.5 },
+                { rtc::Point{ 0.25, 0.0, -1.75 }, 0.25, 0.25 },
+                { rtc::Point{ 1.0, 0.0, -1.0 }, 0.0, 0.0 },
+                { rtc::Point{ 0.0, 0.0, 0.0 }, 0.0, 0.0 }
+            };
+
+            for (const auto& example : examples)
+            {
+                auto u = rtc::Scalar{ 0 };
+                auto v = rtc::Scalar{ 0 };
+                rtc::UvMapping::Planar(example.p, u, v);
+
+                REQUIRE(rtc::Equal(u, example.u));
+                REQUIRE(rtc::Equal(v, example.v));
+            }
+        }
+    }
+}
+
+SCENARIO("Creating a mip-mapped texture", "[textures]")
+{
+    GIVEN("image <- a 64x32 image")
+    {
+        const auto image = GradientImage(64u, 32u);
+
+        WHEN("texture <- texture(image) and cache <- texture_cache(1 MiB)")
+        {
+            const auto texture = rtc::Texture::Create(image);
+            auto       cache   = rtc::TextureCache{ 1024u * 1024u };
+
+            THEN("The texture has a level for each halving of the image")
+            {
+                REQUIRE(texture != nullptr);
+                REQUIRE(texture->GetLevelCount() == 7u);
+                REQUIRE(texture->GetWidth(1u) == 32u);
+                REQUIRE(texture->GetHeight(1u) == 16u);
+                REQUIRE(texture->GetWidth(6u) == 1u);
+                REQUIRE(texture->GetHeight(6u) == 1u);
+            }
+
+            THEN("Sampling level 0 at the center of a texel returns the texel")
+            {
+                for (const auto x : { 0u, 17u, 40u, 63u })
+                {
+                    for (const auto y : { 0u, 9u, 31u })
+                    {
+                        REQUIRE(rtc::Color::Equal(texture->Sample(cache, TexelU(x, 64u), TexelV(y, 32u), 0.0), image.PixelAt(x, y)));
+                    }
+                }
+            }
+
+            THEN("Sampling level 1 at the center of a texel returns the average of four texels")
+            {
+                const auto expected = rtc::Color::Multiply(
+                    rtc::Color::Add(image.PixelAt(10u, 6u), image.PixelAt(11u, 6u), image.PixelAt(10u, 7u), image.PixelAt(11u, 7u)), 0.25);
+
+                REQUIRE(rtc::Color::Equal(texture->Sample(cache, TexelU(5u, 32u), TexelV(3u, 16u), 1.0), expected));
+            }
+
+            THEN("Sampling between the centers of texels blends them")
+            {
+                const auto u        = (TexelU(20u, 64u) + TexelU(21u, 64u)) / 2.0;
+                const auto expected = rtc::Color::Multiply(rtc::Color::Add(image.PixelAt(20u, 4u), image.PixelAt(21u, 4u)), 0.5);
+
+                REQUIRE(rtc::Color::Equal(texture->Sample(cache, u, TexelV(4u, 32u), 0.0), expected));
+            }
+        }
+    }
+}
+
+SCENARIO("Creating a texture from an empty image", "[textures]")
+{
+    GIVEN("images with no columns or no rows")
+    {
+        const auto no_columns = rtc::Canvas{ 0u, 4u };
+        const auto no_rows    = rtc::Canvas{ 4u, 0u };
+
+        THEN("No texture is created")
+        {
+            REQUIRE(rtc::Texture::Create(no_columns) == nullptr);
+            REQUIRE(rtc::Texture::Create(no_rows) == nullptr);
+            REQUIRE(rtc::Texture::Create(rtc::Canvas{ 0u, 0u }) == nullptr);
+        }
+    }
+}
+
+SCENARIO("A texture cache stays within its budget", "[textures]")
+{
+    GIVEN("texture <- a 256x256 texture and cache <- texture_cache(48 tiles)")
+    {
+        const auto image   = GradientImage(256u, 256u);
+        const auto texture = rtc::Texture::Create(image);
+        auto       cache   = rtc::TextureCache{ 48u * rtc::Texture::GetTileBytes() };
+
+        REQUIRE(texture != nullptr);
+
+        WHEN("Every texel of level 0, which has 64 tiles, is sampled in scanline order")
+        {
+            auto matches = true;
+
+            for (uint32_t y = 0u; y < 256u; ++y)
+            {
+                for (uint32_t x = 0u; x < 256u; ++x)
+                {
+                    matches = matches && rtc::Color::Equal(texture->Sample(cache, TexelU(x, 256u), TexelV(y, 256u), 0.0), image.PixelAt(x, y));
+                }
+            }
+
+            THEN("Every sample is correct, tiles were evicted, and most tiles were only loaded once")
+            {
+                REQUIRE(matches);
+                REQUIRE(cache.GetSize() <= cache.GetCapacity());
+                REQUIRE(cache.GetEvictionCount() > 0u);
+                REQUIRE(cache.GetMissCount() < 128u);
+            }
+        }
+    }
+}
+
+SCENARIO("An image texture pattern on a sphere", "[textures]")
+{
+    GIVEN("A 2x1 texture with a red and a blue texel, applied to a sphere with a spherical mapping")
+    {
+        auto image = rtc::Canvas{ 2u, 1u };
+        image.WritePixel(0u, 0u, rtc::Color{ 1.0, 0.0, 0.0 });
+        image.WritePixel(1u, 0u, rtc::Color{ 0.0, 0.0, 1.0 });
+
+        const auto texture = rtc::Texture::Create(image);
+        const auto pattern = rtc::ImageTexturePattern::Create(texture, rtc::UvMapping::Type::kSpherical);
+        const auto shape   = rtc::Sphere::Create(rtc::Material{ pattern, 0.1, 0.9, 0.9, 200.0 });
+
+        THEN("color_at(shape, point(1, 0, 0)) = red and color_at(shape, point(-1, 0, 0)) = blue")
+        {
+            REQUIRE(rtc::Color::Equal(shape->ColorAt(rtc::Point{ 1.0, 0.0, 0.0 }), rtc::Color{ 1.0, 0.0, 0.0 }));
+            REQUIRE(rtc::Color::Equal(shape->ColorAt(rtc::Point{ -1.0, 0.0, 0.0 }), rtc::Color{ 0.0, 0.0, 1.0 }));
+        }
+    }
+}
@@ -0,0 +1,378 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "tile_channel.h"
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <initializer_list>
+#include <limits>
+#include <type_traits>
+
+#if !defined(_WIN32)
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace rtc
+{
+    namespace
+    {
+        constexpr uint32_t kMagic = 0x54435452u; // "RTCT"
+
+#if defined(MSG_NOSIGNAL)
+        constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+        constexpr int kSendFlags = 0;
+#endif
+
+        // Fixed size part of every message.
+        struct Header
+        {
+            uint32_t magic{ kMagic };
+            uint32_t type{ 0u };
+            uint32_t scalar_size{ sizeof(Scalar) };
+            uint32_t id{ 0u };
+            uint32_t attempt{ 0u };
+            uint32_t x{ 0u };
+            uint32_t y{ 0u };
+            uint32_t width{ 0u };
+            uint32_t height{ 0u };
+            uint32_t pixel_count{ 0u }; ///< Number of Scalar components following the header.
+        };
+
+        // Messages are encoded field by field in little-endian byte order, with pixels as IEEE 754 values, so
+        // that hosts of different byte orders and compilers with different struct padding agree on the frame.
+        constexpr size_t kHeaderSize = 10u * sizeof(uint32_t);
+
+        using ScalarBits = std::conditional_t<(sizeof(Scalar) == sizeof(uint64_t)), uint64_t, uint32_t>;
+
+        static_assert(std::numeric_limits<Scalar>::is_iec559, "rtc::TileChannel requires IEEE 754 scalars");
+        static_assert(sizeof(Scalar) == sizeof(ScalarBits), "rtc::TileChannel requires 32 or 64 bit scalars");
+
+        template <typename T>
+        uint8_t* Encode(T value, uint8_t* bytes)
+        {
+            for (size_t i = 0u; i < sizeof(T); ++i)
+            {
+                bytes[i] = static_cast<uint8_t>(value >> (i * 8u));
+            }
+
+            return bytes + sizeof(T);
+        }
+
+        template <typename T>
+        const uint8_t* Decode(const uint8_t* bytes, T& value)
+        {
+            value = T{ 0u };
+
+            for (size_t i = 0u; i < sizeof(T); ++i)
+            {
+                value |= static_cast<T>(bytes[i]) << (i * 8u);
+            }
+
+            return bytes + sizeof(T);
+        }
+
+        void EncodeHeader(const Header& header, uint8_t* bytes)
+        {
+            for (const auto field : { header.magic, header.type, header.scalar_size, header.id, header.attempt, header.x, header.y, header.width, header.height, header.pixel_count })
+            {
+                bytes = Encode(field, bytes);
+            }
+        }
+
+        void DecodeHeader(const uint8_t* bytes, Header& header)
+        {
+            for (auto field : { &header.magic, &header.type, &header.scalar_size, &header.id, &header.attempt, &header.x, &header.y, &header.width, &header.height, &header.pixel_count })
+            {
+                bytes = Decode(bytes, *field);
+            }
+        }
+    }
+
+    bool TileMessage::CopyPixels(Canvas& canvas) const
+    {
+        const auto& region = job_.GetRegion();
+
+        if ((type_ != Type::kResult) || (pixels_.size() != (region.GetPixelCount() * 3u)) || !region.IsWithin(canvas.GetWidth(), canvas.GetHeight()))
+        {
+            return false;
+        }
+
+        auto pixel = pixels_.data();
+
+        for (uint32_t y = 0u; y < region.GetHeight(); ++y)
+        {
+            for (uint32_t x = 0u; x < region.GetWidth(); ++x)
+            {
+                canvas.WritePixel(region.GetX() + x, region.GetY() + y, Color{ pixel[0], pixel[1], pixel[2] });
+                pixel += 3;
+            }
+        }
+
+        return true;
+    }
+
+    TileMessage TileMessage::Job(const TileJob& job)
+    {
+        auto message  = TileMessage{};
+        message.type_ = Type::kJob;
+        message.job_  = job;
+        return message;
+    }
+
+    TileMessage TileMessage::Result(const TileJob& job, const Canvas& tile)
+    {
+        auto message  = TileMessage{};
+        message.type_ = Type::kResult;
+        message.job_  = job;
+        message.pixels_.reserve(static_cast<size_t>(tile.GetWidth()) * tile.GetHeight() * 3u);
+
+        for (uint32_t y = 0u; y < tile.GetHeight(); ++y)
+        {
+            for (uint32_t x = 0u; x < tile.GetWidth(); ++x)
+            {
+                const auto& color = tile.PixelAt(x, y);
+                message.pixels_.push_back(color.GetR());
+                message.pixels_.push_back(color.GetG());
+                message.pixels_.push_back(color.GetB());
+            }
+        }
+
+        return message;
+    }
+
+    TileMessage TileMessage::Shutdown()
+    {
+        return TileMessage{};
+    }
+
+    TileChannel::TileChannel(int descriptor) :
+        descriptor_(descriptor)
+    {
+#if defined(SO_NOSIGPIPE)
+        // Platforms without MSG_NOSIGNAL suppress SIGPIPE with a socket option instead.
+        const auto enable = 1;
+        setsockopt(descriptor_, SOL_SOCKET, SO_NOSIGPIPE, &enable, sizeof(enable));
+#endif
+    }
+
+    TileChannel::~TileChannel()
+    {
+#if !defined(_WIN32)
+        if (descriptor_ >= 0)
+        {
+            close(descriptor_);
+        }
+#endif
+    }
+
+    bool TileChannel::Send(const TileMessage& message)
+    {
+        const auto& region = message.job_.GetRegion();
+
+        auto header        = Header{};
+        header.type        = static_cast<uint32_t>(message.type_);
+        header.id          = message.job_.GetId();
+        header.attempt     = message.job_.GetAttempt();
+        header.x           = region.GetX();
+        header.y           = region.GetY();
+        header.width       = region.GetWidth();
+        header.height      = region.GetHeight();
+        header.pixel_count = static_cast<uint32_t>(message.pixels_.size());
+
+        auto frame = std::vector<uint8_t>(kHeaderSize + (message.pixels_.size() * sizeof(Scalar)));
+        auto bytes = frame.data() + kHeaderSize;
+
+        EncodeHeader(header, frame.data());
+
+        for (const auto value : message.pixels_)
+        {
+            bytes = Encode(std::bit_cast<ScalarBits>(value), bytes);
+        }
+
+        return WriteAll(frame.data(), frame.size());
+    }
+
+    bool TileChannel::Receive(TileMessage& message)
+    {
+        return Receive(message, std::chrono::steady_clock::time_point::max());
+    }
+
+    bool TileChannel::Receive(TileMessage& message, std::chrono::steady_clock::time_point deadline)
+    {
+        return Receive(message, deadline, std::numeric_limits<uint64_t>::max());
+    }
+
+    bool TileChannel::Receive(TileMessage& message, std::chrono::steady_clock::time_point deadline, uint64_t max_pixel_count)
+    {
+        uint8_t encoded[kHeaderSize];
+
+        if (!ReadAll(encoded, kHeaderSize, deadline))
+        {
+            return false;
+        }
+
+        auto header = Header{};
+        DecodeHeader(encoded, header);
+
+        if ((header.magic != kMagic) || (header.scalar_size != sizeof(Scalar)))
+        {
+            return false;
+        }
+
+        const auto type   = static_cast<TileMessage::Type>(header.type);
+        const auto region = RenderRegion{ header.x, header.y, header.width, header.height };
+
+        if ((type != TileMessage::Type::kJob) && (type != TileMessage::Type::kResult) && (type != TileMessage::Type::kShutdown))
+        {
+            return false;
+        }
+
+        // A result carries exactly the pixels of its region, and other messages carry none.
+        const auto expected = (type == TileMessage::Type::kResult) ? (region.GetPixelCount() * 3u) : 0u;
+        if ((header.pixel_count != expected) || ((expected > 0u) && (region.GetPixelCount() > max_pixel_count)))
+        {
+            return false;
+        }
+
+        message.type_ = type;
+        message.job_  = TileJob{ header.id, header.attempt, region };
+        message.pixels_.resize(header.pixel_count);
+
+        if (!ReadAll(message.pixels_.data(), message.pixels_.size() * sizeof(Scalar), deadline))
+        {
+            return false;
+        }
+
+        // Decode the pixels in place; each value is read completely before it is replaced.
+        auto bytes = reinterpret_cast<const uint8_t*>(message.pixels_.data());
+
+        for (auto& value : message.pixels_)
+        {
+            auto bits = ScalarBits{ 0u };
+            bytes     = Decode(bytes, bits);
+            value     = std::bit_cast<Scalar>(bits);
+        }
+
+        return true;
+    }
+
+    bool TileChannel::WriteAll(const void* data, size_t size)
+    {
+#if defined(_WIN32)
+        (void)data;
+        return (size == 0u);
+#else
+        auto bytes = static_cast<const char*>(data);
+
+        while (size > 0u)
+        {
+            const auto written = send(descriptor_, bytes, size, kSendFlags);
+
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+
+                return false;
+            }
+
+            bytes += written;
+            size -= static_cast<size_t>(written);
+        }
+
+        return true;
+#endif
+    }
+
+    bool TileChannel::ReadAll(void* data, size_t size, std::chrono::steady_clock::time_point deadline)
+    {
+#if defined(_WIN32)
+        (void)data;
+        (void)deadline;
+        return (size == 0u);
+#else
+        auto bytes = static_cast<char*>(data);
+
+        while (size > 0u)
+        {
+            if (deadline != std::chrono::steady_clock::time_point::max())
+            {
+                // Wait for the next bytes, rounding the remaining time up so that the wait ends after the deadline.
+                // Bytes that have already arrived are read after the deadline has passed.
+                const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+                auto       readable  = pollfd{ descriptor_, POLLIN, 0 };
+                const auto ready     = poll(&readable, 1u, static_cast<int>(std::clamp<decltype(remaining)>(remaining, 0, 60000)));
+
+                if (ready < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+
+                    return false;
+                }
+
+                if (ready == 0)
+                {
+                    if (std::chrono::steady_clock::now() >= deadline)
+                    {
+                        return false;
+                    }
+
+                    continue;
+                }
+            }
+
+            const auto count = read(descriptor_, bytes, size);
+
+            if (count < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+
+                return false;
+            }
+
+            if (count == 0)
+            {
+                // The peer closed the channel.
+                return false;
+            }
+
+            bytes += count;
+            size -= static_cast<size_t>(count);
+        }
+
+        return true;
+#endif
+    }
+}
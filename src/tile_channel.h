@@ -0,0 +1,142 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#pragma once
+
+#include "canvas.h"
+#include "double_util.h"
+#include "render_region.h"
+
+#include <chrono>
+#include <cinttypes>
+#include <vector>
+
+namespace rtc
+{
+    // Request to render one tile of an image.
+    class TileJob
+    {
+    public:
+        TileJob() = default;
+
+        TileJob(uint32_t id, uint32_t attempt, const RenderRegion& region) :
+            id_(id),
+            attempt_(attempt),
+            region_(region)
+        {
+        }
+
+        uint32_t GetId() const { return id_; }
+
+        uint32_t GetAttempt() const { return attempt_; }
+
+        const RenderRegion& GetRegion() const { return region_; }
+
+    private:
+        uint32_t     id_{ 0u };      ///< Index of the tile in the coordinator's list of tiles.
+        uint32_t     attempt_{ 0u }; ///< Number of earlier assignments of the tile, to workers that failed.
+        RenderRegion region_;        ///< Region of the image covered by the tile.
+    };
+
+    // Message exchanged between a tile coordinator and its workers.
+    class TileMessage
+    {
+    public:
+        enum class Type : uint32_t
+        {
+            kJob      = 1u, ///< Coordinator to worker: render the job's tile.
+            kResult   = 2u, ///< Worker to coordinator: pixels of the job's tile.
+            kShutdown = 3u  ///< Coordinator to worker: exit.
+        };
+
+    public:
+        TileMessage() = default;
+
+        Type GetType() const { return type_; }
+
+        const TileJob& GetJob() const { return job_; }
+
+        // Pixels of a result, in scanline order with three components for each pixel.
+        const std::vector<Scalar>& GetPixels() const { return pixels_; }
+
+        // Copy the pixels of a result to the tile's region of canvas. Returns false when the message is not a
+        // result, or its pixels do not match its region.
+        bool CopyPixels(Canvas& canvas) const;
+
+        static TileMessage Job(const TileJob& job);
+
+        static TileMessage Result(const TileJob& job, const Canvas& tile);
+
+        static TileMessage Shutdown();
+
+    private:
+        friend class TileChannel;
+
+    private:
+        Type                type_{ Type::kShutdown }; ///< Kind of message.
+        TileJob             job_;                     ///< Job requested by, or completed for, the coordinator.
+        std::vector<Scalar> pixels_;                  ///< Pixels of a result.
+    };
+
+    // Framed tile messages over a connected stream socket, which may be a Unix domain socket or a TCP
+    // socket. Messages are encoded in little-endian byte order with IEEE 754 pixels, so that peers on hosts
+    // of different byte orders agree. Each message carries the size of Scalar, so that peers built with
+    // different scalar types are rejected instead of misreading pixels. Sending to a closed peer fails
+    // instead of raising SIGPIPE.
+    // Not available on Windows, where Send() and Receive() fail.
+    class TileChannel
+    {
+    public:
+        // Take ownership of a connected socket descriptor, which is closed with the channel.
+        explicit TileChannel(int descriptor);
+
+        ~TileChannel();
+
+        TileChannel(const TileChannel&) = delete;
+
+        TileChannel& operator=(const TileChannel&) = delete;
+
+        int GetDescriptor() const { return descriptor_; }
+
+        bool Send(const TileMessage& message);
+
+        // Wait for and read the next message. Returns false when the peer closes the channel, on a read error,
+        // and for a malformed message.
+        bool Receive(TileMessage& message);
+
+        // Read the next message, also returning false when it has not been received completely by the deadline,
+        // so that a peer that stops in the middle of a message cannot block the reader.
+        bool Receive(TileMessage& message, std::chrono::steady_clock::time_point deadline);
+
+        // Read the next message, also returning false for a result of more than max_pixel_count pixels, which
+        // is rejected before its pixels are allocated, so that a peer cannot claim an arbitrarily large tile.
+        bool Receive(TileMessage& message, std::chrono::steady_clock::time_point deadline, uint64_t max_pixel_count);
+
+    private:
+        bool WriteAll(const void* data, size_t size);
+
+        bool ReadAll(void* data, size_t size, std::chrono::steady_clock::time_point deadline);
+
+    private:
+        int descriptor_; ///< Connected socket descriptor, or -1.
+    };
+}
@@ -0,0 +1,340 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "tile_coordinator.h"
+
+#include "ray_budget.h"
+#include "shadow_cache.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace rtc
+{
+#if !defined(_WIN32)
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        struct Worker
+        {
+            pid_t                        pid{ -1 };
+            std::unique_ptr<TileChannel> channel;
+            bool                         busy{ false }; ///< A job was sent to the worker and its result is pending.
+            TileJob                      job;           ///< Job sent to the worker, while it is busy.
+            Clock::time_point            deadline;      ///< Time at which a busy worker is considered stalled.
+        };
+
+        // Fork a worker process that serves jobs with the renderer over a new socket pair.
+        bool StartWorker(const TileCoordinator::TileRenderer& renderer, const std::vector<Worker>& workers, Worker& worker)
+        {
+            int sockets[2];
+            if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0)
+            {
+                return false;
+            }
+
+            // The child only has a copy of this thread, so it is only safe when no other threads are running,
+            // which Render() requires of its callers.
+            const auto pid = fork();
+
+            if (pid < 0)
+            {
+                close(sockets[0]);
+                close(sockets[1]);
+                return false;
+            }
+
+            if (pid == 0)
+            {
+                // Close the coordinator's end of the other workers' channels, so that each worker sees its
+                // channel close when the coordinator closes it.
+                for (const auto& other : workers)
+                {
+                    if (other.channel != nullptr)
+                    {
+                        close(other.channel->GetDescriptor());
+                    }
+                }
+
+                close(sockets[0]);
+
+                auto       channel = TileChannel{ sockets[1] };
+                const auto served  = TileCoordinator::Serve(channel, renderer);
+
+                // Exit without running the coordinator's atexit handlers or destructors.
+                _exit(served ? 0 : 1);
+            }
+
+            close(sockets[1]);
+
+            worker.pid     = pid;
+            worker.channel = std::make_unique<TileChannel>(sockets[0]);
+            worker.busy    = false;
+            return true;
+        }
+
+        void StopWorker(Worker& worker, bool kill_worker)
+        {
+            if (worker.pid > 0)
+            {
+                if (kill_worker)
+                {
+                    kill(worker.pid, SIGKILL);
+                }
+                else
+                {
+                    worker.channel->Send(TileMessage::Shutdown());
+                }
+
+                worker.channel.reset();
+
+                while ((waitpid(worker.pid, nullptr, 0) < 0) && (errno == EINTR))
+                {
+                }
+            }
+
+            worker.pid  = -1;
+            worker.busy = false;
+            worker.channel.reset();
+        }
+    }
+#endif
+
+    bool TileCoordinator::Render(const Camera& camera, const World& world, Canvas& canvas)
+    {
+        // Each worker receives a copy of the cache when it is forked, and reuses it for all of its tiles.
+        auto shadow_cache = ShadowCache{};
+
+        const auto renderer = [&camera, &world, &shadow_cache](const TileJob& job, Canvas& tile) {
+            auto budget = RayBudget{};
+            tile        = camera.Render(world, job.GetRegion(), &shadow_cache, budget);
+            return true;
+        };
+
+        return Render(camera.GetHSize(), camera.GetVSize(), renderer, canvas);
+    }
+
+    bool TileCoordinator::Render(uint32_t width, uint32_t height, const TileRenderer& renderer, Canvas& canvas)
+    {
+        requeue_count_      = 0u;
+        worker_start_count_ = 0u;
+
+#if defined(_WIN32)
+        (void)width;
+        (void)height;
+        (void)renderer;
+        (void)canvas;
+        return false;
+#else
+        if ((canvas.GetWidth() != width) || (canvas.GetHeight() != height) || (worker_count_ == 0u) || (max_attempts_ == 0u))
+        {
+            return false;
+        }
+
+        const auto tiles = RenderRegion::Tiles(width, height, tile_width_, tile_height_);
+
+        auto pending = std::deque<TileJob>{};
+        for (uint32_t i = 0u; i < tiles.size(); ++i)
+        {
+            pending.emplace_back(i, 0u, tiles[i]);
+        }
+
+        auto remaining = tiles.size();
+        auto workers   = std::vector<Worker>(std::min<size_t>(worker_count_, tiles.size()));
+        auto success   = true;
+
+        // Replace a failed worker and queue its tile again, at the front so that it is retried first.
+        const auto fail_worker = [&](Worker& worker) {
+            const auto job      = worker.job;
+            const auto was_busy = worker.busy;
+
+            StopWorker(worker, true);
+
+            if (was_busy)
+            {
+                if ((job.GetAttempt() + 1u) >= max_attempts_)
+                {
+                    return false;
+                }
+
+                pending.emplace_front(job.GetId(), job.GetAttempt() + 1u, job.GetRegion());
+                ++requeue_count_;
+            }
+
+            if (!StartWorker(renderer, workers, worker))
+            {
+                return false;
+            }
+
+            ++worker_start_count_;
+            return true;
+        };
+
+        for (auto& worker : workers)
+        {
+            if (!StartWorker(renderer, workers, worker))
+            {
+                success = false;
+                break;
+            }
+
+            ++worker_start_count_;
+        }
+
+        auto descriptors = std::vector<pollfd>{};
+        auto polled      = std::vector<Worker*>{};
+
+        while (success && (remaining > 0u))
+        {
+            const auto now = Clock::now();
+
+            // Hand out the pending tiles to idle workers.
+            for (auto& worker : workers)
+            {
+                if (!worker.busy && !pending.empty())
+                {
+                    worker.job      = pending.front();
+                    worker.busy     = true;
+                    worker.deadline = now + tile_timeout_;
+                    pending.pop_front();
+
+                    if (!worker.channel->Send(TileMessage::Job(worker.job)) && !fail_worker(worker))
+                    {
+                        success = false;
+                        break;
+                    }
+                }
+            }
+
+            if (!success)
+            {
+                break;
+            }
+
+            // Wait for a result, or for the earliest deadline.
+            auto deadline = Clock::time_point::max();
+            descriptors.clear();
+            polled.clear();
+
+            for (auto& worker : workers)
+            {
+                if (worker.busy)
+                {
+                    descriptors.push_back(pollfd{ worker.channel->GetDescriptor(), POLLIN, 0 });
+                    polled.push_back(&worker);
+                    deadline = std::min(deadline, worker.deadline);
+                }
+            }
+
+            const auto wait    = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+            const auto timeout = static_cast<int>(std::clamp<decltype(wait)>(wait + 1, 0, 60000));
+            const auto ready   = poll(descriptors.data(), descriptors.size(), timeout);
+
+            if ((ready < 0) && (errno != EINTR))
+            {
+                success = false;
+                break;
+            }
+
+            for (size_t i = 0u; success && (i < descriptors.size()); ++i)
+            {
+                auto& worker = *polled[i];
+
+                if (descriptors[i].revents != 0)
+                {
+                    auto message = TileMessage{};
+
+                    // A worker that stops in the middle of a message is failed at its deadline, like one that
+                    // stops before sending a result, and one that claims a larger tile than its job is failed
+                    // before the tile's pixels are allocated.
+                    if (worker.channel->Receive(message, worker.deadline, worker.job.GetRegion().GetPixelCount()) &&
+                        (message.GetType() == TileMessage::Type::kResult) &&
+                        (message.GetJob().GetId() == worker.job.GetId()) &&
+                        RenderRegion::Equal(message.GetJob().GetRegion(), worker.job.GetRegion()) &&
+                        message.CopyPixels(canvas))
+                    {
+                        worker.busy = false;
+                        --remaining;
+                    }
+                    else
+                    {
+                        success = fail_worker(worker);
+                    }
+                }
+                else if (Clock::now() >= worker.deadline)
+                {
+                    success = fail_worker(worker);
+                }
+            }
+        }
+
+        for (auto& worker : workers)
+        {
+            StopWorker(worker, !success);
+        }
+
+        return success;
+#endif
+    }
+
+    bool TileCoordinator::Serve(TileChannel& channel, const TileRenderer& renderer)
+    {
+        auto message = TileMessage{};
+
+        while (channel.Receive(message))
+        {
+            if (message.GetType() == TileMessage::Type::kShutdown)
+            {
+                return true;
+            }
+
+            if (message.GetType() != TileMessage::Type::kJob)
+            {
+                return false;
+            }
+
+            const auto& job    = message.GetJob();
+            const auto& region = job.GetRegion();
+
+            auto tile = Canvas{ region.GetWidth(), region.GetHeight() };
+
+            if (!renderer(job, tile) || !channel.Send(TileMessage::Result(job, tile)))
+            {
+                return false;
+            }
+        }
+
+        return false;
+    }
+}
@@ -0,0 +1,127 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#pragma once
+
+#include "camera.h"
+#include "canvas.h"
+#include "render_region.h"
+#include "tile_channel.h"
+#include "world.h"
+
+#include <chrono>
+#include <cinttypes>
+#include <functional>
+
+namespace rtc
+{
+    // Renders an image with worker processes. The image is split into tiles, which are handed out one at a
+    // time to idle workers, and the pixels that the workers return are gathered into the canvas. A worker
+    // that exits, closes its channel, returns a bad result, or takes longer than the tile timeout is killed
+    // and replaced, and its tile is queued again.
+    //
+    // Local workers are forked from the coordinator and connected to it with Unix domain sockets. A worker
+    // inherits the scene when it is forked, so the scene is sent to each worker once, and jobs only carry a
+    // tile. Workers only depend on their channel, so a remote worker could load the scene itself and call
+    // Serve() with a TCP connection. Not available on Windows, where Render() fails.
+    //
+    // Workers are forked during Render(), including replacements for failed workers, and a forked child only
+    // has a copy of the thread that forked it. A lock held by any other thread of the process, such as the
+    // allocator's or a stream's, would stay locked forever in the child, so Render() must only be called
+    // while no other threads are running in the process, for example before a preview renderer or an
+    // asynchronous output stream is started. The workers themselves may start threads.
+    class TileCoordinator
+    {
+    public:
+        // Render the job's tile into a canvas the size of its region, returning false on failure.
+        using TileRenderer = std::function<bool(const TileJob& job, Canvas& tile)>;
+
+        static constexpr uint32_t                  kDefaultTileSize    = 32u;
+        static constexpr uint32_t                  kDefaultMaxAttempts = 3u;
+        static constexpr std::chrono::milliseconds kDefaultTileTimeout{ 60000 };
+
+    public:
+        explicit TileCoordinator(uint32_t worker_count) :
+            worker_count_(worker_count)
+        {
+        }
+
+        TileCoordinator(uint32_t worker_count, uint32_t tile_width, uint32_t tile_height) :
+            worker_count_(worker_count),
+            tile_width_(tile_width),
+            tile_height_(tile_height)
+        {
+        }
+
+        uint32_t GetWorkerCount() const { return worker_count_; }
+
+        uint32_t GetTileWidth() const { return tile_width_; }
+
+        uint32_t GetTileHeight() const { return tile_height_; }
+
+        // Time a worker is given to return a tile before it is considered stalled.
+        std::chrono::milliseconds GetTileTimeout() const { return tile_timeout_; }
+
+        // Number of times a tile is assigned before the render fails.
+        uint32_t GetMaxAttempts() const { return max_attempts_; }
+
+        // Number of tiles queued again after their worker failed, during the last render.
+        uint32_t GetRequeueCount() const { return requeue_count_; }
+
+        // Number of worker processes started, including replacements, during the last render.
+        uint32_t GetWorkerStartCount() const { return worker_start_count_; }
+
+        void SetWorkerCount(uint32_t worker_count) { worker_count_ = worker_count; }
+
+        void SetTileSize(uint32_t tile_width, uint32_t tile_height)
+        {
+            tile_width_  = tile_width;
+            tile_height_ = tile_height;
+        }
+
+        void SetTileTimeout(std::chrono::milliseconds tile_timeout) { tile_timeout_ = tile_timeout; }
+
+        void SetMaxAttempts(uint32_t max_attempts) { max_attempts_ = max_attempts; }
+
+        // Render the camera's image of the world into canvas, which must be the size of the image. Returns
+        // false when workers cannot be started, or a tile fails on each of its attempts. As workers are
+        // forked, no other threads may be running in the process; see the class comment.
+        bool Render(const Camera& camera, const World& world, Canvas& canvas);
+
+        // Render an image of the specified size into canvas, with the renderer running in the workers. As
+        // workers are forked, no other threads may be running in the process; see the class comment.
+        bool Render(uint32_t width, uint32_t height, const TileRenderer& renderer, Canvas& canvas);
+
+        // Render the jobs received from channel until the coordinator sends a shutdown message, which
+        // returns true, or the channel fails, which returns false. This is the body of a worker process.
+        static bool Serve(TileChannel& channel, const TileRenderer& renderer);
+
+    private:
+        uint32_t                  worker_count_;                             ///< Number of worker processes to run.
+        uint32_t                  tile_width_{ kDefaultTileSize };           ///< Width of the tiles handed to the workers.
+        uint32_t                  tile_height_{ kDefaultTileSize };          ///< Height of the tiles handed to the workers.
+        std::chrono::milliseconds tile_timeout_{ kDefaultTileTimeout };      ///< Time allowed for a worker to return a tile.
+        uint32_t                  max_attempts_{ kDefaultMaxAttempts };      ///< Assignments of a tile before the render fails.
+        uint32_t                  requeue_count_{ 0u };                      ///< Tiles queued again during the last render.
+        uint32_t                  worker_start_count_{ 0u };                 ///< Workers started during the last render.
+    };
+}
@@ -0,0 +1,378 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "catch2/catch.hpp"
+
+#include "camera.h"
+#include "canvas.h"
+#include "color.h"
+#include "double_util.h"
+#include "matrix44.h"
+#include "point.h"
+#include "render_region.h"
+#include "tile_channel.h"
+#include "tile_coordinator.h"
+#include "vector.h"
+#include "world.h"
+
+#if !defined(_WIN32)
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+namespace
+{
+    // Renderer that colors each pixel with its image coordinates.
+    bool CoordinateRenderer(const rtc::TileJob& job, rtc::Canvas& tile)
+    {
+        const auto& region = job.GetRegion();
+
+        for (uint32_t y = 0u; y < region.GetHeight(); ++y)
+        {
+            for (uint32_t x = 0u; x < region.GetWidth(); ++x)
+            {
+                tile.WritePixel(x, y, rtc::Color{ static_cast<rtc::Scalar>(region.GetX() + x), static_cast<rtc::Scalar>(region.GetY() + y), 1.0 });
+            }
+        }
+
+        return true;
+    }
+
+    bool HasCoordinatePixels(const rtc::Canvas& canvas)
+    {
+        for (uint32_t y = 0u; y < canvas.GetHeight(); ++y)
+        {
+            for (uint32_t x = 0u; x < canvas.GetWidth(); ++x)
+            {
+                if (!rtc::Color::Equal(canvas.PixelAt(x, y), rtc::Color{ static_cast<rtc::Scalar>(x), static_cast<rtc::Scalar>(y), 1.0 }))
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+}
+
+SCENARIO("Sending a tile result over a channel", "[tiles]")
+{
+    GIVEN("a connected pair of channels and tile <- a 2x2 canvas")
+    {
+        int sockets[2];
+        REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == 0);
+
+        auto sender   = std::make_unique<rtc::TileChannel>(sockets[0]);
+        auto receiver = rtc::TileChannel{ sockets[1] };
+        auto tile     = rtc::Canvas{ 2u, 2u };
+        tile.WritePixel(1u, 0u, rtc::Color{ 0.25, 0.5, 0.75 });
+
+        WHEN("the result for job(7, 1, region(3, 4, 2, 2)) is sent and received")
+        {
+            const auto job     = rtc::TileJob{ 7u, 1u, rtc::RenderRegion{ 3u, 4u, 2u, 2u } };
+            auto       message = rtc::TileMessage{};
+
+            REQUIRE(sender->Send(rtc::TileMessage::Result(job, tile)));
+            REQUIRE(receiver.Receive(message));
+
+            THEN("the message holds the job and the pixels, which are copied to the tile's region of a canvas")
+            {
+                REQUIRE(message.GetType() == rtc::TileMessage::Type::kResult);
+                REQUIRE(message.GetJob().GetId() == 7u);
+                REQUIRE(message.GetJob().GetAttempt() == 1u);
+                REQUIRE(rtc::RenderRegion::Equal(message.GetJob().GetRegion(), job.GetRegion()));
+                REQUIRE(message.GetPixels().size() == 12u);
+
+                auto canvas = rtc::Canvas{ 5u, 6u };
+                REQUIRE(message.CopyPixels(canvas));
+                REQUIRE(rtc::Color::Equal(canvas.PixelAt(4u, 4u), rtc::Color{ 0.25, 0.5, 0.75 }));
+
+                auto small = rtc::Canvas{ 4u, 4u };
+                REQUIRE(!message.CopyPixels(small));
+            }
+        }
+
+        WHEN("the result for job(7, 1, region(3, 4, 2, 2)) is sent and received with a limit of 3 pixels")
+        {
+            const auto job     = rtc::TileJob{ 7u, 1u, rtc::RenderRegion{ 3u, 4u, 2u, 2u } };
+            auto       message = rtc::TileMessage{};
+
+            REQUIRE(sender->Send(rtc::TileMessage::Result(job, tile)));
+
+            THEN("receive fails without reading the pixels")
+            {
+                REQUIRE(!receiver.Receive(message, std::chrono::steady_clock::time_point::max(), 3u));
+                REQUIRE(message.GetPixels().empty());
+            }
+        }
+
+        WHEN("the result for job(7, 1, region(3, 4, 2, 2)) is sent and received with a limit of 4 pixels")
+        {
+            const auto job     = rtc::TileJob{ 7u, 1u, rtc::RenderRegion{ 3u, 4u, 2u, 2u } };
+            auto       message = rtc::TileMessage{};
+
+            REQUIRE(sender->Send(rtc::TileMessage::Result(job, tile)));
+
+            THEN("receive succeeds")
+            {
+                REQUIRE(receiver.Receive(message, std::chrono::steady_clock::time_point::max(), 4u));
+                REQUIRE(message.GetPixels().size() == 12u);
+            }
+        }
+
+        WHEN("job(258, 2, region(1, 2, 3, 4)) is sent")
+        {
+            REQUIRE(sender->Send(rtc::TileMessage::Job(rtc::TileJob{ 258u, 2u, rtc::RenderRegion{ 1u, 2u, 3u, 4u } })));
+
+            unsigned char frame[40];
+            REQUIRE(read(sockets[1], frame, sizeof(frame)) == static_cast<ssize_t>(sizeof(frame)));
+
+            THEN("the header is ten little-endian 32-bit fields")
+            {
+                const unsigned char magic[4] = { 'R', 'T', 'C', 'T' };
+                const unsigned char id[4]    = { 0x02, 0x01, 0x00, 0x00 };
+
+                REQUIRE(std::equal(magic, magic + 4, frame));
+                REQUIRE(frame[4] == 1u);
+                REQUIRE(frame[8] == sizeof(rtc::Scalar));
+                REQUIRE(std::equal(id, id + 4, frame + 12));
+                REQUIRE(frame[16] == 2u);
+                REQUIRE(frame[32] == 4u);
+                REQUIRE(frame[36] == 0u);
+            }
+        }
+
+        WHEN("half of a message header is sent")
+        {
+            const char partial[8] = {};
+            REQUIRE(write(sockets[0], partial, sizeof(partial)) == static_cast<ssize_t>(sizeof(partial)));
+
+            auto       message = rtc::TileMessage{};
+            const auto start   = std::chrono::steady_clock::now();
+            const auto result  = receiver.Receive(message, start + std::chrono::milliseconds{ 100 });
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+
+            THEN("receive with a deadline fails at the deadline")
+            {
+                REQUIRE(!result);
+                REQUIRE(elapsed >= std::chrono::milliseconds{ 100 });
+                REQUIRE(elapsed < std::chrono::seconds{ 10 });
+            }
+        }
+
+        WHEN("the sender is closed")
+        {
+            sender.reset();
+
+            auto message = rtc::TileMessage{};
+
+            THEN("receive fails")
+            {
+                REQUIRE(!receiver.Receive(message));
+            }
+        }
+    }
+}
+
+SCENARIO("Rendering with worker processes matches a single process render", "[tiles]")
+{
+    GIVEN("w <- default_world() and c <- a 40x30 camera and coordinator <- tile_coordinator(3 workers, 16x16 tiles)")
+    {
+        const auto w           = rtc::World::GetDefault();
+        const auto c           = rtc::Camera{ 40u, 30u, rtc::kPi / 2.0, rtc::Matrix44::ViewTransform(rtc::Point{ 0.0, 0.0, -5.0 }, rtc::Point{ 0.0, 0.0, 0.0 }, rtc::Vector{ 0.0, 1.0, 0.0 }) };
+        auto       coordinator = rtc::TileCoordinator{ 3u, 16u, 16u };
+
+        WHEN("canvas <- render(coordinator, c, w)")
+        {
+            auto       canvas   = rtc::Canvas{ 40u, 30u };
+            const auto rendered = coordinator.Render(c, w, canvas);
+
+            THEN("canvas = render(c, w)")
+            {
+                REQUIRE(rendered);
+                REQUIRE(coordinator.GetWorkerStartCount() == 3u);
+                REQUIRE(coordinator.GetRequeueCount() == 0u);
+
+                const auto image = c.Render(w);
+
+                for (uint32_t y = 0u; y < image.GetHeight(); ++y)
+                {
+                    for (uint32_t x = 0u; x < image.GetWidth(); ++x)
+                    {
+                        REQUIRE(rtc::Color::Equal(canvas.PixelAt(x, y), image.PixelAt(x, y)));
+                    }
+                }
+            }
+        }
+
+        WHEN("the canvas is not the size of the image")
+        {
+            auto canvas = rtc::Canvas{ 20u, 30u };
+
+            THEN("render fails")
+            {
+                REQUIRE(!coordinator.Render(c, w, canvas));
+            }
+        }
+    }
+}
+
+SCENARIO("Tiles from a worker that crashes are rendered again", "[tiles]")
+{
+    GIVEN("coordinator <- tile_coordinator(2 workers, 8x8 tiles) and a renderer that exits on the first attempt of tile 2")
+    {
+        auto coordinator = rtc::TileCoordinator{ 2u, 8u, 8u };
+
+        const auto renderer = [](const rtc::TileJob& job, rtc::Canvas& tile) {
+            if ((job.GetId() == 2u) && (job.GetAttempt() == 0u))
+            {
+                _exit(3);
+            }
+
+            return CoordinateRenderer(job, tile);
+        };
+
+        WHEN("canvas <- render(coordinator, 20, 20, renderer)")
+        {
+            auto       canvas   = rtc::Canvas{ 20u, 20u };
+            const auto rendered = coordinator.Render(20u, 20u, renderer, canvas);
+
+            THEN("every pixel is rendered and the tile was queued again for a replacement worker")
+            {
+                REQUIRE(rendered);
+                REQUIRE(HasCoordinatePixels(canvas));
+                REQUIRE(coordinator.GetRequeueCount() == 1u);
+                REQUIRE(coordinator.GetWorkerStartCount() == 3u);
+            }
+        }
+    }
+}
+
+SCENARIO("Tiles from a worker that stalls are rendered again", "[tiles]")
+{
+    GIVEN("coordinator <- tile_coordinator(2 workers, 8x8 tiles) with a 200ms timeout and a renderer that stalls on the first attempt of tile 1")
+    {
+        auto coordinator = rtc::TileCoordinator{ 2u, 8u, 8u };
+        coordinator.SetTileTimeout(std::chrono::milliseconds{ 200 });
+
+        const auto renderer = [](const rtc::TileJob& job, rtc::Canvas& tile) {
+            if ((job.GetId() == 1u) && (job.GetAttempt() == 0u))
+            {
+                std::this_thread::sleep_for(std::chrono::seconds{ 30 });
+            }
+
+            return CoordinateRenderer(job, tile);
+        };
+
+        WHEN("canvas <- render(coordinator, 16, 16, renderer)")
+        {
+            auto       canvas   = rtc::Canvas{ 16u, 16u };
+            const auto start    = std::chrono::steady_clock::now();
+            const auto rendered = coordinator.Render(16u, 16u, renderer, canvas);
+            const auto elapsed  = std::chrono::steady_clock::now() - start;
+
+            THEN("every pixel is rendered without waiting for the stalled worker")
+            {
+                REQUIRE(rendered);
+                REQUIRE(HasCoordinatePixels(canvas));
+                REQUIRE(coordinator.GetRequeueCount() == 1u);
+                REQUIRE(elapsed < std::chrono::seconds{ 10 });
+            }
+        }
+    }
+}
+
+SCENARIO("Tiles from a worker that stalls in the middle of a message are rendered again", "[tiles]")
+{
+    GIVEN("coordinator <- tile_coordinator(2 workers, 8x8 tiles) with a 200ms timeout and a renderer that sends half of a header on the first attempt of tile 1")
+    {
+        auto coordinator = rtc::TileCoordinator{ 2u, 8u, 8u };
+        coordinator.SetTileTimeout(std::chrono::milliseconds{ 200 });
+
+        const auto renderer = [](const rtc::TileJob& job, rtc::Canvas& tile) {
+            if ((job.GetId() == 1u) && (job.GetAttempt() == 0u))
+            {
+                // The worker's channel is the only socket open in the worker process.
+                for (int descriptor = 3; descriptor < 1024; ++descriptor)
+                {
+                    struct stat status;
+                    if ((fstat(descriptor, &status) == 0) && S_ISSOCK(status.st_mode))
+                    {
+                        const char partial[8] = {};
+                        if (write(descriptor, partial, sizeof(partial)) < 0)
+                        {
+                            return false;
+                        }
+
+                        break;
+                    }
+                }
+
+                std::this_thread::sleep_for(std::chrono::seconds{ 30 });
+            }
+
+            return CoordinateRenderer(job, tile);
+        };
+
+        WHEN("canvas <- render(coordinator, 16, 16, renderer)")
+        {
+            auto       canvas   = rtc::Canvas{ 16u, 16u };
+            const auto start    = std::chrono::steady_clock::now();
+            const auto rendered = coordinator.Render(16u, 16u, renderer, canvas);
+            const auto elapsed  = std::chrono::steady_clock::now() - start;
+
+            THEN("every pixel is rendered without waiting for the rest of the message")
+            {
+                REQUIRE(rendered);
+                REQUIRE(HasCoordinatePixels(canvas));
+                REQUIRE(coordinator.GetRequeueCount() == 1u);
+                REQUIRE(elapsed < std::chrono::seconds{ 10 });
+            }
+        }
+    }
+}
+
+SCENARIO("A tile that fails on every attempt fails the render", "[tiles]")
+{
+    GIVEN("coordinator <- tile_coordinator(2 workers, 8x8 tiles) with 2 attempts and a renderer that always fails tile 0")
+    {
+        auto coordinator = rtc::TileCoordinator{ 2u, 8u, 8u };
+        coordinator.SetMaxAttempts(2u);
+
+        const auto renderer = [](const rtc::TileJob& job, rtc::Canvas& tile) {
+            return (job.GetId() != 0u) && CoordinateRenderer(job, tile);
+        };
+
+        THEN("render fails after the tile is queued again once")
+        {
+            auto canvas = rtc::Canvas{ 16u, 16u };
+            REQUIRE(!coordinator.Render(16u, 16u, renderer, canvas));
+            REQUIRE(coordinator.GetRequeueCount() == 1u);
+        }
+    }
+}
+#endif
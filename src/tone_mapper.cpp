@@ -0,0 +1,161 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "tone_mapper.h"
+
+#include "parallel_bands.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace rtc
+{
+    namespace
+    {
+        // Number of pixels mapped together.
+        constexpr uint32_t kBlockSize = 256u;
+
+        // Rows mapped by a thread at a time.
+        constexpr uint32_t kBandHeight = 16u;
+
+        // Linear values below this are encoded by the linear segment of the sRGB transfer function.
+        constexpr float kSrgbThreshold = 0.0031308f;
+    }
+
+    Color ToneMapper::Map(const Color& color) const
+    {
+        float values[3] = { static_cast<float>(color.GetR()), static_cast<float>(color.GetG()), static_cast<float>(color.GetB()) };
+        MapValues(values, 3u);
+        return Color{ values[0], values[1], values[2] };
+    }
+
+    void ToneMapper::Apply(Canvas& canvas, uint32_t thread_count) const
+    {
+        Run(canvas, canvas, thread_count);
+    }
+
+    Canvas ToneMapper::Apply(const Canvas& source, Canvas::PixelFormat format, uint32_t thread_count) const
+    {
+        auto destination = Canvas{ source.GetWidth(), source.GetHeight(), format };
+        Run(source, destination, thread_count);
+        return destination;
+    }
+
+    void ToneMapper::Run(const Canvas& source, Canvas& destination, uint32_t thread_count) const
+    {
+        ParallelBands::ForEachBand(source.GetHeight(), kBandHeight, thread_count, [&](uint32_t, uint32_t first_row, uint32_t last_row) {
+            MapRows(source, destination, first_row, last_row);
+            return true;
+        });
+    }
+
+    void ToneMapper::MapRows(const Canvas& source, Canvas& destination, uint32_t first_row, uint32_t last_row) const
+    {
+        const auto width = source.GetWidth();
+
+        float values[kBlockSize * 3u];
+
+        for (auto y = first_row; y < last_row; ++y)
+        {
+            for (uint32_t x = 0u; x < width; x += kBlockSize)
+            {
+                const auto count = std::min(kBlockSize, width - x);
+
+                for (uint32_t i = 0u; i < count; ++i)
+                {
+                    const auto pixel   = source.PixelAt(x + i, y);
+                    values[(i * 3u)]      = static_cast<float>(pixel.GetR());
+                    values[(i * 3u) + 1u] = static_cast<float>(pixel.GetG());
+                    values[(i * 3u) + 2u] = static_cast<float>(pixel.GetB());
+                }
+
+                MapValues(values, count * 3u);
+
+                for (uint32_t i = 0u; i < count; ++i)
+                {
+                    destination.WritePixel(x + i, y, Color{ values[(i * 3u)], values[(i * 3u) + 1u], values[(i * 3u) + 2u] });
+                }
+            }
+        }
+    }
+
+    void ToneMapper::MapValues(float* values, size_t count) const
+    {
+        assert((count <= (kBlockSize * 3u)) && "rtc::ToneMapper::MapValues requires at most one block of values");
+
+        const auto scale = static_cast<float>(std::exp2(exposure_));
+
+        // Each stage is a separate loop without branches, so that each vectorizes.
+        for (size_t i = 0u; i < count; ++i)
+        {
+            values[i] = std::max(values[i] * scale, 0.0f);
+        }
+
+        switch (curve_)
+        {
+        case Curve::kClamp:
+            break;
+        case Curve::kReinhard:
+            for (size_t i = 0u; i < count; ++i)
+            {
+                values[i] = values[i] / (1.0f + values[i]);
+            }
+            break;
+        case Curve::kAces:
+            for (size_t i = 0u; i < count; ++i)
+            {
+                const auto x = values[i];
+                values[i]    = (x * ((2.51f * x) + 0.03f)) / ((x * ((2.43f * x) + 0.59f)) + 0.14f);
+            }
+            break;
+        }
+
+        for (size_t i = 0u; i < count; ++i)
+        {
+            values[i] = std::min(values[i], 1.0f);
+        }
+
+        if (srgb_)
+        {
+            // The linear segment lies below the curve only under the threshold, so the encoding is the minimum
+            // of the two segments. The power's base is kept in its domain by a separate loop, as the loops only
+            // vectorize without a selection between the two.
+            float curve[kBlockSize * 3u];
+
+            for (size_t i = 0u; i < count; ++i)
+            {
+                curve[i] = std::max(values[i], kSrgbThreshold);
+            }
+
+            for (size_t i = 0u; i < count; ++i)
+            {
+                curve[i] = (1.055f * FastPow(curve[i], 1.0f / 2.4f)) - 0.055f;
+            }
+
+            for (size_t i = 0u; i < count; ++i)
+            {
+                values[i] = std::min(values[i] * 12.92f, curve[i]);
+            }
+        }
+    }
+}
@@ -0,0 +1,96 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#pragma once
+
+#include "canvas.h"
+#include "color.h"
+#include "double_util.h"
+
+#include <cinttypes>
+
+namespace rtc
+{
+    // Post-process that converts the linear, unbounded colors of a rendered canvas to display colors in
+    // [0, 1]: the colors are scaled by the exposure, compressed by a tone curve, and encoded with the sRGB
+    // transfer function. The result can be given to any of the image writers. Each channel is mapped
+    // independently, so canvases are processed as blocks of channel values with loops that the compiler
+    // vectorizes, in single precision.
+    class ToneMapper
+    {
+    public:
+        enum class Curve
+        {
+            kClamp,    ///< Clamp to [0, 1], as the writers do without tone mapping.
+            kReinhard, ///< x / (1 + x).
+            kAces      ///< Narkowicz's fit of the ACES filmic curve.
+        };
+
+    public:
+        ToneMapper() = default;
+
+        ToneMapper(Scalar exposure, Curve curve, bool srgb) :
+            exposure_(exposure),
+            curve_(curve),
+            srgb_(srgb)
+        {
+        }
+
+        // Exposure adjustment in stops; each stop doubles the brightness.
+        Scalar GetExposure() const { return exposure_; }
+
+        void SetExposure(Scalar exposure) { exposure_ = exposure; }
+
+        Curve GetCurve() const { return curve_; }
+
+        void SetCurve(Curve curve) { curve_ = curve; }
+
+        bool IsSrgb() const { return srgb_; }
+
+        void SetSrgb(bool srgb) { srgb_ = srgb; }
+
+        // Map a single color, with the same result as mapping it as part of a canvas.
+        Color Map(const Color& color) const;
+
+        // Map every pixel of the canvas in place, on thread_count threads, or one thread for each hardware
+        // thread when thread_count is 0.
+        void Apply(Canvas& canvas, uint32_t thread_count = 0u) const;
+
+        // Map the pixels of the source into a new canvas with the pixel format, such as an 8-bit canvas for
+        // output.
+        Canvas Apply(const Canvas& source, Canvas::PixelFormat format, uint32_t thread_count = 0u) const;
+
+    private:
+        // Map the rows [first_row, last_row) of the source to the destination.
+        void MapRows(const Canvas& source, Canvas& destination, uint32_t first_row, uint32_t last_row) const;
+
+        // Map count color channel values in place, for at most one block of pixels.
+        void MapValues(float* values, size_t count) const;
+
+        void Run(const Canvas& source, Canvas& destination, uint32_t thread_count) const;
+
+    private:
+        Scalar exposure_{ 0 };              ///< Exposure adjustment, in stops.
+        Curve  curve_{ Curve::kReinhard }; ///< Tone curve.
+        bool   srgb_{ true };              ///< Encode with the sRGB transfer function rather than leaving values linear.
+    };
+}
@@ -0,0 +1,156 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "catch2/catch.hpp"
+
+#include "canvas.h"
+#include "color.h"
+#include "double_util.h"
+#include "tone_mapper.h"
+
+#include <cmath>
+
+namespace
+{
+    bool Near(rtc::Scalar actual, double expected)
+    {
+        return std::abs(static_cast<double>(actual) - expected) < 1.0e-3;
+    }
+
+    rtc::Canvas HdrCanvas(uint32_t width, uint32_t height, rtc::Canvas::PixelFormat format)
+    {
+        auto canvas = rtc::Canvas{ width, height, format };
+
+        for (uint32_t y = 0u; y < height; ++y)
+        {
+            for (uint32_t x = 0u; x < width; ++x)
+            {
+                const auto r = static_cast<rtc::Scalar>(x) / static_cast<rtc::Scalar>(8);
+                const auto g = static_cast<rtc::Scalar>(y) / static_cast<rtc::Scalar>(16);
+                const auto b = static_cast<rtc::Scalar>((x * y) % 5u) - static_cast<rtc::Scalar>(1);
+                canvas.WritePixel(x, y, rtc::Color{ r, g, b });
+            }
+        }
+
+        return canvas;
+    }
+}
+
+SCENARIO("Tone mapping a color", "[tone_mapping]")
+{
+    GIVEN("mapper <- tone_mapper() with the Reinhard curve and sRGB encoding")
+    {
+        const auto mapper = rtc::ToneMapper{};
+
+        THEN("black stays black and 1 maps to the sRGB encoding of 1/2")
+        {
+            REQUIRE(rtc::Color::Equal(mapper.Map(rtc::Color{ 0.0, 0.0, 0.0 }), rtc::Color{ 0.0, 0.0, 0.0 }));
+
+            const auto c = mapper.Map(rtc::Color{ 1.0, 1.0, 1.0 });
+            REQUIRE(Near(c.GetR(), 0.735357));
+        }
+
+        THEN("bright values stay below 1 and negative values become 0")
+        {
+            const auto c = mapper.Map(rtc::Color{ static_cast<rtc::Scalar>(1000.0), static_cast<rtc::Scalar>(-1.0), static_cast<rtc::Scalar>(0.001) });
+            REQUIRE(c.GetR() < 1.0);
+            REQUIRE(Near(c.GetR(), 0.999588));
+            REQUIRE(c.GetG() == 0.0);
+            REQUIRE(Near(c.GetB(), 0.001 / 1.001 * 12.92));
+        }
+    }
+
+    GIVEN("mapper <- tone_mapper(1 stop, clamp, linear)")
+    {
+        const auto mapper = rtc::ToneMapper{ static_cast<rtc::Scalar>(1), rtc::ToneMapper::Curve::kClamp, false };
+
+        THEN("the exposure doubles the color before it is clamped")
+        {
+            const auto c = mapper.Map(rtc::Color{ static_cast<rtc::Scalar>(0.25), static_cast<rtc::Scalar>(0.75), static_cast<rtc::Scalar>(-0.5) });
+            REQUIRE(rtc::Color::Equal(c, rtc::Color{ 0.5, 1.0, 0.0 }));
+        }
+    }
+
+    GIVEN("mapper <- tone_mapper(0 stops, ACES, linear)")
+    {
+        auto mapper = rtc::ToneMapper{};
+        mapper.SetCurve(rtc::ToneMapper::Curve::kAces);
+        mapper.SetSrgb(false);
+
+        THEN("the filmic curve compresses highlights to 1")
+        {
+            REQUIRE(Near(mapper.Map(rtc::Color{ 1.0, 1.0, 1.0 }).GetR(), 2.54 / 3.16));
+            REQUIRE(mapper.Map(rtc::Color{ 100.0, 100.0, 100.0 }).GetR() == 1.0);
+        }
+    }
+}
+
+SCENARIO("Tone mapping a canvas", "[tone_mapping]")
+{
+    GIVEN("an HDR canvas of 300x40 and mapper <- tone_mapper(-0.5 stops, ACES, sRGB)")
+    {
+        const auto mapper = rtc::ToneMapper{ static_cast<rtc::Scalar>(-0.5), rtc::ToneMapper::Curve::kAces, true };
+
+        THEN("every pixel of a canvas mapped in place on several threads matches the color mapping")
+        {
+            for (const auto format : { rtc::Canvas::PixelFormat::kColor, rtc::Canvas::PixelFormat::kFloat, rtc::Canvas::PixelFormat::kHalf })
+            {
+                const auto source = HdrCanvas(300u, 40u, format);
+                auto       c      = source;
+
+                mapper.Apply(c, 3u);
+
+                auto mismatches = 0u;
+                for (uint32_t y = 0u; y < 40u; ++y)
+                {
+                    for (uint32_t x = 0u; x < 300u; ++x)
+                    {
+                        // The mapped color, as stored in the canvas's format.
+                        auto expected = rtc::Canvas{ 1u, 1u, format };
+                        expected.WritePixel(0u, 0u, mapper.Map(source.PixelAt(x, y)));
+
+                        if (!rtc::Color::Equal(c.PixelAt(x, y), expected.PixelAt(0u, 0u)))
+                        {
+                            ++mismatches;
+                        }
+                    }
+                }
+
+                REQUIRE(mismatches == 0u);
+            }
+        }
+
+        THEN("mapping into an 8-bit canvas gives the quantized mapped colors")
+        {
+            const auto source = HdrCanvas(300u, 40u, rtc::Canvas::PixelFormat::kColor);
+            const auto c      = mapper.Apply(source, rtc::Canvas::PixelFormat::kByte, 2u);
+
+            REQUIRE(c.GetPixelFormat() == rtc::Canvas::PixelFormat::kByte);
+
+            const auto mapped = mapper.Map(source.PixelAt(123u, 17u));
+            const auto pixel  = c.PixelAt(123u, 17u);
+            REQUIRE(rtc::ToByte(pixel.GetR()) == rtc::ToByte(mapped.GetR()));
+            REQUIRE(rtc::ToByte(pixel.GetG()) == rtc::ToByte(mapped.GetG()));
+            REQUIRE(rtc::ToByte(pixel.GetB()) == rtc::ToByte(mapped.GetB()));
+        }
+    }
+}
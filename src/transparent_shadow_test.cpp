@@ -0,0 +1,234 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#include "catch2/catch.hpp"
+
+#include "color.h"
+#include "computations.h"
+#include "double_util.h"
+#include "intersection.h"
+#include "material.h"
+#include "matrix44.h"
+#include "plane.h"
+#include "point.h"
+#include "point_light.h"
+#include "ray.h"
+#include "shadow_cache.h"
+#include "sphere.h"
+#include "vector.h"
+#include "world.h"
+
+#include <cmath>
+#include <memory>
+
+namespace
+{
+    // A floor at y = 0, lit from directly above, with a sphere of radius 1 centered at (0, 3, 0)
+    // between the light and the origin.
+    rtc::World ShadowWorld(const rtc::Material& occluder_material)
+    {
+        return rtc::World{
+            {
+                rtc::PointLight{ rtc::Point{ 0.0, 10.0, 0.0 }, rtc::Color{ 1.0, 1.0, 1.0 } }
+            },
+            {
+                rtc::Plane::Create(),
+                rtc::Sphere::Create(occluder_material, rtc::Matrix44::Translation(0.0, 3.0, 0.0))
+            } };
+    }
+
+    rtc::Material TransparentMaterial(rtc::Scalar transparency)
+    {
+        auto material = rtc::Material{};
+        material.SetTransparency(transparency);
+        return material;
+    }
+
+    rtc::Material NonCasterMaterial()
+    {
+        auto material = rtc::Material{};
+        material.SetShadowCaster(false);
+        return material;
+    }
+
+    // Shade the floor at the origin, viewed from point(0, 1, -5).
+    rtc::Color ShadeOrigin(const rtc::World& w, rtc::ShadowCache* shadow_cache)
+    {
+        const auto r     = rtc::Ray{ rtc::Point{ 0.0, 1.0, -5.0 }, rtc::Vector::Normalize(rtc::Vector{ 0.0, -1.0, 5.0 }) };
+        const auto i     = rtc::Intersection{ static_cast<rtc::Scalar>(std::sqrt(26.0)), w.GetObject(0) };
+        const auto comps = rtc::Computations::Prepare(i, r);
+        return comps.ShadeHit(w, shadow_cache);
+    }
+}
+
+SCENARIO("The default material casts shadows", "[shadows]")
+{
+    GIVEN("m <- material()")
+    {
+        const auto m = rtc::Material{};
+
+        THEN("m.shadow_caster = true")
+        {
+            REQUIRE(m.IsShadowCaster());
+        }
+    }
+}
+
+SCENARIO("An opaque occluder blocks all light", "[shadows]")
+{
+    GIVEN("w <- a floor below an opaque sphere and p <- point(0, 1, 0)")
+    {
+        const auto w = ShadowWorld(rtc::Material{});
+        const auto p = rtc::Point{ 0.0, 1.0, 0.0 };
+
+        THEN("shadow_transmittance(w, light, p) = 0 and is_shadowed(w, light, p) is true")
+        {
+            REQUIRE(rtc::Computations::ShadowTransmittance(w, w.GetLight(0), p) == 0.0);
+            REQUIRE(rtc::Computations::IsShadowed(w, w.GetLight(0), p));
+        }
+    }
+}
+
+SCENARIO("Each surface of a transparent occluder attenuates the light", "[shadows]")
+{
+    GIVEN("w <- a floor below a sphere with transparency 0.5 and p <- point(0, 1, 0)")
+    {
+        const auto w = ShadowWorld(TransparentMaterial(0.5));
+        const auto p = rtc::Point{ 0.0, 1.0, 0.0 };
+
+        WHEN("t <- shadow_transmittance(w, light, p)")
+        {
+            const auto t = rtc::Computations::ShadowTransmittance(w, w.GetLight(0), p);
+
+            THEN("t = 0.5 * 0.5 and is_shadowed(w, light, p) is false")
+            {
+                REQUIRE(rtc::Equal(t, static_cast<rtc::Scalar>(0.25)));
+                REQUIRE(!rtc::Computations::IsShadowed(w, w.GetLight(0), p));
+            }
+        }
+    }
+}
+
+SCENARIO("An occluder that does not cast shadows is skipped", "[shadows]")
+{
+    GIVEN("w <- a floor below an opaque sphere that does not cast shadows and p <- point(0, 1, 0)")
+    {
+        const auto w = ShadowWorld(NonCasterMaterial());
+        const auto p = rtc::Point{ 0.0, 1.0, 0.0 };
+
+        THEN("shadow_transmittance(w, light, p) = 1")
+        {
+            REQUIRE(rtc::Computations::ShadowTransmittance(w, w.GetLight(0), p) == 1.0);
+        }
+    }
+}
+
+SCENARIO("An opaque occluder behind a transparent one blocks all light", "[shadows]")
+{
+    GIVEN("w <- a floor below a sphere with transparency 0.5 and an opaque sphere above it")
+    {
+        auto w = ShadowWorld(TransparentMaterial(0.5));
+        w.AppendObject(rtc::Sphere::Create(rtc::Matrix44::Translation(0.0, 6.0, 0.0)));
+
+        THEN("shadow_transmittance(w, light, point(0, 1, 0)) = 0")
+        {
+            REQUIRE(rtc::Computations::ShadowTransmittance(w, w.GetLight(0), rtc::Point{ 0.0, 1.0, 0.0 }) == 0.0);
+        }
+    }
+}
+
+SCENARIO("The shadow cache only records opaque occluders", "[shadows]")
+{
+    GIVEN("cache <- shadow_cache() and p <- point(0, 1, 0)")
+    {
+        auto       cache = rtc::ShadowCache{};
+        const auto p     = rtc::Point{ 0.0, 1.0, 0.0 };
+
+        WHEN("the occluder is transparent and the shadow is queried twice")
+        {
+            const auto w      = ShadowWorld(TransparentMaterial(0.5));
+            const auto first  = rtc::Computations::ShadowTransmittance(w, 0u, p, cache);
+            const auto second = rtc::Computations::ShadowTransmittance(w, 0u, p, cache);
+
+            THEN("both queries traverse the world and find the attenuated light")
+            {
+                REQUIRE(rtc::Equal(first, static_cast<rtc::Scalar>(0.25)));
+                REQUIRE(rtc::Equal(second, static_cast<rtc::Scalar>(0.25)));
+                REQUIRE(cache.GetHitCount() == 0u);
+                REQUIRE(cache.GetMissCount() == 2u);
+            }
+        }
+
+        WHEN("the occluder is opaque and the shadow is queried twice")
+        {
+            const auto w      = ShadowWorld(rtc::Material{});
+            const auto first  = rtc::Computations::ShadowTransmittance(w, 0u, p, cache);
+            const auto second = rtc::Computations::ShadowTransmittance(w, 0u, p, cache);
+
+            THEN("the second query is resolved by the cached occluder")
+            {
+                REQUIRE(first == 0.0);
+                REQUIRE(second == 0.0);
+                REQUIRE(cache.GetHitCount() == 1u);
+                REQUIRE(cache.GetMissCount() == 1u);
+            }
+        }
+    }
+}
+
+SCENARIO("Shading a point behind a transparent occluder", "[shadows]")
+{
+    GIVEN("a floor lit from directly above, viewed at the origin")
+    {
+        WHEN("the occluder is opaque")
+        {
+            const auto w = ShadowWorld(rtc::Material{});
+
+            THEN("the floor receives only ambient light")
+            {
+                REQUIRE(rtc::Color::Equal(ShadeOrigin(w, nullptr), rtc::Color{ 0.1, 0.1, 0.1 }));
+            }
+        }
+
+        WHEN("the occluder has transparency 0.5")
+        {
+            const auto w     = ShadowWorld(TransparentMaterial(0.5));
+            auto       cache = rtc::ShadowCache{};
+
+            THEN("the floor receives ambient light and a quarter of the diffuse light")
+            {
+                REQUIRE(rtc::Color::Equal(ShadeOrigin(w, nullptr), rtc::Color{ 0.325, 0.325, 0.325 }));
+                REQUIRE(rtc::Color::Equal(ShadeOrigin(w, &cache), rtc::Color{ 0.325, 0.325, 0.325 }));
+            }
+        }
+
+        WHEN("the occluder does not cast shadows")
+        {
+            const auto w = ShadowWorld(NonCasterMaterial());
+
+            THEN("the floor is fully lit")
+            {
+                REQUIRE(rtc::Color::Equal(ShadeOrigin(w, nullptr), rtc::Color{ 1.0, 1.0, 1.0 }));
+            }
+        }
+    }
+}
@@ -26,29 +26,30 @@
 
 namespace rtc
 {
-    class Tuple
+    template <typename T>
+    class BasicTuple
     {
     public:
-        Tuple(double x, double y, double z, double w) : x_(x), y_(y), z_(z), w_(w) {}
+        constexpr BasicTuple(T x, T y, T z, T w) : x_(x), y_(y), z_(z), w_(w) {}
 
-        double GetX() const { return x_; }
+        constexpr T GetX() const { return x_; }
 
-        double GetY() const { return y_; }
+        constexpr T GetY() const { return y_; }
 
-        double GetZ() const { return z_; }
+        constexpr T GetZ() const { return z_; }
 
-        double GetW() const { return w_; }
+        constexpr T GetW() const { return w_; }
 
-        bool IsPoint() const { return rtc::Equal(w_, 1.0); }
+        constexpr bool IsPoint() const { return rtc::Equal(w_, T{ 1 }); }
 
-        bool IsVector() const { return rtc::Equal(w_, 0.0); }
+        constexpr bool IsVector() const { return rtc::Equal(w_, T{ 0 }); }
 
         //
         // Operations on the tuple object.
         //
 
         // Compare this tuple object with the specified tuple object. Equivalent to this == rhs.
-        bool Equal(const Tuple& rhs)
+        constexpr bool Equal(const BasicTuple& rhs)
         {
             return (rtc::Equal(x_, rhs.x_) &&
                     rtc::Equal(y_, rhs.y_) &&
@@ -57,7 +58,7 @@ namespace rtc
         }
 
         // Negate this tuple object. Equivalent to a -this operation.
-        void Negate()
+        constexpr void Negate()
         {
             x_ = -x_;
             y_ = -y_;
@@ -66,7 +67,7 @@ namespace rtc
         }
 
         // Add the specified tuple object to this tuple object. Equivalent to this + rhs.
-        void Add(const Tuple& rhs)
+        constexpr void Add(const BasicTuple& rhs)
         {
             x_ += rhs.x_;
             y_ += rhs.y_;
@@ -75,7 +76,7 @@ namespace rtc
         }
 
         // Subtract the specified tuple object from this tuple object. Equivalent to this - rhs.
-        void Subtract(const Tuple& rhs)
+        constexpr void Subtract(const BasicTuple& rhs)
         {
             x_ -= rhs.x_;
             y_ -= rhs.y_;
@@ -84,7 +85,7 @@ namespace rtc
         }
 
         // Multiply this tuple object with a scalar. Equivalent to this * scalar.
-        void Multiply(double scalar)
+        constexpr void Multiply(T scalar)
         {
             x_ *= scalar;
             y_ *= scalar;
@@ -93,7 +94,7 @@ namespace rtc
         }
 
         // Divide this tuple object with a scalar. Equivalent to this / scalar.
-        void Divide(double scalar)
+        constexpr void Divide(T scalar)
         {
             x_ /= scalar;
             y_ /= scalar;
@@ -105,7 +106,7 @@ namespace rtc
         // Operations creating a new tuple object.
         //
 
-        static bool Equal(const Tuple& lhs, const Tuple& rhs)
+        static constexpr bool Equal(const BasicTuple& lhs, const BasicTuple& rhs)
         {
             return (rtc::Equal(lhs.x_, rhs.x_) &&
                     rtc::Equal(lhs.y_, rhs.y_) &&
@@ -113,47 +114,49 @@ namespace rtc
                     rtc::Equal(lhs.w_, rhs.w_));
         }
 
-        static Tuple Negate(const Tuple& tuple)
+        static constexpr BasicTuple Negate(const BasicTuple& tuple)
         {
-            return Tuple(-tuple.x_, -tuple.y_, -tuple.z_, -tuple.w_);
+            return BasicTuple(-tuple.x_, -tuple.y_, -tuple.z_, -tuple.w_);
         }
 
-        static Tuple Add(const Tuple& lhs, const Tuple& rhs)
+        static constexpr BasicTuple Add(const BasicTuple& lhs, const BasicTuple& rhs)
         {
-            return Tuple(lhs.x_ + rhs.x_, lhs.y_ + rhs.y_, lhs.z_ + rhs.z_, lhs.w_ + rhs.w_);
+            return BasicTuple(lhs.x_ + rhs.x_, lhs.y_ + rhs.y_, lhs.z_ + rhs.z_, lhs.w_ + rhs.w_);
         }
 
         template <typename... Rest>
-        static Tuple Add(const Tuple& first, const Tuple& second, Rest... rest)
+        static constexpr BasicTuple Add(const BasicTuple& first, const BasicTuple& second, Rest... rest)
         {
             return Add(Add(first, second), rest...);
         }
 
-        static Tuple Subtract(const Tuple& lhs, const Tuple& rhs)
+        static constexpr BasicTuple Subtract(const BasicTuple& lhs, const BasicTuple& rhs)
         {
-            return Tuple(lhs.x_ - rhs.x_, lhs.y_ - rhs.y_, lhs.z_ - rhs.z_, lhs.w_ - rhs.w_);
+            return BasicTuple(lhs.x_ - rhs.x_, lhs.y_ - rhs.y_, lhs.z_ - rhs.z_, lhs.w_ - rhs.w_);
         }
 
         template <typename... Rest>
-        static Tuple Subtract(const Tuple& first, const Tuple& second, Rest... rest)
+        static constexpr BasicTuple Subtract(const BasicTuple& first, const BasicTuple& second, Rest... rest)
         {
             return Subtract(Subtract(first, second), rest...);
         }
 
-        static Tuple Multiply(const Tuple& tuple, double scalar)
+        static constexpr BasicTuple Multiply(const BasicTuple& tuple, T scalar)
         {
-            return Tuple(tuple.x_ * scalar, tuple.y_ * scalar, tuple.z_ * scalar, tuple.w_ * scalar);
+            return BasicTuple(tuple.x_ * scalar, tuple.y_ * scalar, tuple.z_ * scalar, tuple.w_ * scalar);
         }
 
-        static Tuple Divide(const Tuple& tuple, double scalar)
+        static constexpr BasicTuple Divide(const BasicTuple& tuple, T scalar)
         {
-            return Tuple(tuple.x_ / scalar, tuple.y_ / scalar, tuple.z_ / scalar, tuple.w_ / scalar);
+            return BasicTuple(tuple.x_ / scalar, tuple.y_ / scalar, tuple.z_ / scalar, tuple.w_ / scalar);
         }
 
     private:
-        double x_;
-        double y_;
-        double z_;
-        double w_;
+        T x_;
+        T y_;
+        T z_;
+        T w_;
     };
+
+    using Tuple = BasicTuple<Scalar>;
 }
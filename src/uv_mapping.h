@@ -0,0 +1,96 @@
+/*
+** Copyright(c) 2021 Dustin Graves
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this softwareand associated documentation files(the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions :
+**
+** The above copyright notice and this permission notice shall be included in all
+** copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+*/
+
+#pragma once
+
+#include "double_util.h"
+#include "point.h"
+
+#include <cmath>
+
+namespace rtc
+{
+    namespace UvMapping
+    {
+        enum class Type
+        {
+            kPlanar,    ///< Repeat the texture every unit in x and z.
+            kSpherical  ///< Wrap the texture around a sphere centered at the origin.
+        };
+
+        // Map a point in the xz plane to texture coordinates, with the texture repeating every unit.
+        inline void Planar(const Point& point, Scalar& u, Scalar& v)
+        {
+            u = point.GetX() - std::floor(point.GetX());
+            v = point.GetZ() - std::floor(point.GetZ());
+        }
+
+        // Map a point on a sphere centered at the origin to texture coordinates, with u following the
+        // longitude and v the latitude.
+        inline void Spherical(const Point& point, Scalar& u, Scalar& v)
+        {
+            // The azimuthal angle, in (-pi, pi], increases clockwise when viewed from above.
+            const auto theta  = std::atan2(point.GetX(), point.GetZ());
+            const auto radius = std::sqrt(Square(point.GetX()) + Square(point.GetY()) + Square(point.GetZ()));
+
+            // The polar angle, in [0, pi].
+            const auto phi = std::acos(point.GetY() / radius);
+
+            // Convert to [0, 1), flipping u so that it increases counterclockwise when viewed from above.
+            const auto raw_u = theta / static_cast<Scalar>(2.0 * kPi);
+            u                = Scalar{ 1 } - (raw_u + Scalar{ 0.5 });
+            v                = Scalar{ 1 } - (phi / static_cast<Scalar>(kPi));
+        }
+
+        // Point in the xz plane mapped to (u, v) by the planar mapping, in the unit square at the origin.
+        inline Point PlanarInverse(Scalar u, Scalar v)
+        {
+            return Point{ u, Scalar{ 0 }, v };
+        }
+
+        // Point on the unit sphere mapped to (u, v) by the spherical mapping.
+        inline Point SphericalInverse(Scalar u, Scalar v)
+        {
+            const auto theta = (Scalar{ 0.5 } - u) * static_cast<Scalar>(2.0 * kPi);
+            const auto phi   = (Scalar{ 1 } - v) * static_cast<Scalar>(kPi);
+
+            return Point{ std::sin(phi) * std::sin(theta), std::cos(phi), std::sin(phi) * std::cos(theta) };
+        }
+
+        inline void Map(Type type, const Point& point, Scalar& u, Scalar& v)
+        {
+            if (type == Type::kSpherical)
+            {
+                Spherical(point, u, v);
+            }
+            else
+            {
+                Planar(point, u, v);
+            }
+        }
+
+        inline Point MapInverse(Type type, Scalar u, Scalar v)
+        {
+            return (type == Type::kSpherical) ? SphericalInverse(u, v) : PlanarInverse(u, v);
+        }
+    }
+}
@@ -30,53 +30,54 @@
 
 namespace rtc
 {
-    class Vector : public Tuple
+    template <typename T>
+    class BasicVector : public BasicTuple<T>
     {
     public:
-        Vector() : Tuple(0.0, 0.0, 0.0, 0.0) {}
+        constexpr BasicVector() : BasicTuple<T>(T{ 0 }, T{ 0 }, T{ 0 }, T{ 0 }) {}
 
-        Vector(const Tuple& tuple) : Tuple(tuple) { assert(IsVector()); }
+        constexpr BasicVector(const BasicTuple<T>& tuple) : BasicTuple<T>(tuple) { assert(this->IsVector()); }
 
-        Vector(Tuple&& tuple) : Tuple(std::move(tuple)) { assert(IsVector()); }
+        constexpr BasicVector(BasicTuple<T>&& tuple) : BasicTuple<T>(std::move(tuple)) { assert(this->IsVector()); }
 
-        Vector(const Point& point) : Tuple(point.GetX(), point.GetY(), point.GetZ(), 0.0) {}
+        constexpr BasicVector(const BasicPoint<T>& point) : BasicTuple<T>(point.GetX(), point.GetY(), point.GetZ(), T{ 0 }) {}
 
-        Vector(double x, double y, double z) : Tuple(x, y, z, 0.0) {}
+        constexpr BasicVector(T x, T y, T z) : BasicTuple<T>(x, y, z, T{ 0 }) {}
 
         // Compute the magnitude of the vector.
-        double Magnitude() const
+        constexpr T Magnitude() const
         {
-            return sqrt(rtc::Square(GetX()) + rtc::Square(GetY()) + rtc::Square(GetZ()) + rtc::Square(GetW()));
+            return rtc::Sqrt(rtc::Square(this->GetX()) + rtc::Square(this->GetY()) + rtc::Square(this->GetZ()) + rtc::Square(this->GetW()));
         }
 
         // Normalize the vector.
-        void Normalize()
+        constexpr void Normalize()
         {
             const auto magnitude = Magnitude();
-            if (!rtc::Equal(magnitude, 0.0))
+            if (!rtc::Equal(magnitude, T{ 0 }))
             {
-                Divide(magnitude);
+                this->Divide(magnitude);
             }
         }
 
         // Compute the dot product between two vectors (cosine of angle between them).  Equivalend to this . vector.
-        double Dot(const Vector& vector)
+        constexpr T Dot(const BasicVector& vector)
         {
-            return ((GetX() * vector.GetX()) + (GetY() * vector.GetY()) + (GetZ() * vector.GetZ()));
+            return ((this->GetX() * vector.GetX()) + (this->GetY() * vector.GetY()) + (this->GetZ() * vector.GetZ()));
         }
 
         // Reflect the vector around a normal vector.
-        void Reflect(const Vector& normal)
+        constexpr void Reflect(const BasicVector& normal)
         {
-            Subtract(Multiply(normal, 2.0 * Dot(normal)));
+            this->Subtract(BasicTuple<T>::Multiply(normal, T{ 2 } * Dot(normal)));
         }
 
-        static Vector Normalize(const Vector& vector)
+        static constexpr BasicVector Normalize(const BasicVector& vector)
         {
             const auto magnitude = vector.Magnitude();
-            if (!rtc::Equal(magnitude, 0.0))
+            if (!rtc::Equal(magnitude, T{ 0 }))
             {
-                return Vector(vector.GetX() / magnitude, vector.GetY() / magnitude, vector.GetZ() / magnitude);
+                return BasicVector(vector.GetX() / magnitude, vector.GetY() / magnitude, vector.GetZ() / magnitude);
             }
             else
             {
@@ -84,21 +85,23 @@ namespace rtc
             }
         }
 
-        static double Dot(const Vector& lhs, const Vector& rhs)
+        static constexpr T Dot(const BasicVector& lhs, const BasicVector& rhs)
         {
             return ((lhs.GetX() * rhs.GetX()) + (lhs.GetY() * rhs.GetY()) + (lhs.GetZ() * rhs.GetZ()));
         }
 
-        static Vector Reflect(const Vector& in, const Vector& normal)
+        static constexpr BasicVector Reflect(const BasicVector& in, const BasicVector& normal)
         {
-            return Subtract(in, Multiply(normal, 2.0 * Dot(in, normal)));
+            return BasicTuple<T>::Subtract(in, BasicTuple<T>::Multiply(normal, T{ 2 } * Dot(in, normal)));
         }
 
-        static Vector Cross(const Vector& lhs, const Vector& rhs)
+        static constexpr BasicVector Cross(const BasicVector& lhs, const BasicVector& rhs)
         {
-            return Vector((lhs.GetY() * rhs.GetZ()) - (lhs.GetZ() * rhs.GetY()),
-                          (lhs.GetZ() * rhs.GetX()) - (lhs.GetX() * rhs.GetZ()),
-                          (lhs.GetX() * rhs.GetY()) - (lhs.GetY() * rhs.GetX()));
+            return BasicVector((lhs.GetY() * rhs.GetZ()) - (lhs.GetZ() * rhs.GetY()),
+                               (lhs.GetZ() * rhs.GetX()) - (lhs.GetX() * rhs.GetZ()),
+                               (lhs.GetX() * rhs.GetY()) - (lhs.GetY() * rhs.GetX()));
         }
     };
+
+    using Vector = BasicVector<Scalar>;
 }
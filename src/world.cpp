@@ -45,6 +45,48 @@ namespace rtc
         return Intersections{ std::move(values), true };
     }
 
+    Scalar World::Transmittance(const Ray& ray, Scalar distance, std::shared_ptr<const Shape>* occluder) const
+    {
+        Intersections::Values values{};
+        auto                  transmittance = Scalar{ 1 };
+
+        for (const auto& object : objects_)
+        {
+            assert(object && "World::Transmittance attempted to process an invalid object");
+
+            const auto& material = object->GetMaterial();
+            if (!material.IsShadowCaster())
+            {
+                continue;
+            }
+
+            values.clear();
+            object->Intersect(ray, values);
+
+            for (const auto& value : values)
+            {
+                const auto t = value.GetT();
+                if ((t >= 0) && (t < distance))
+                {
+                    const auto transparency = material.GetTransparency();
+                    if (transparency <= 0)
+                    {
+                        if (occluder != nullptr)
+                        {
+                            *occluder = object;
+                        }
+
+                        return Scalar{ 0 };
+                    }
+
+                    transmittance *= transparency;
+                }
+            }
+        }
+
+        return transmittance;
+    }
+
     World World::GetDefault()
     {
         return World{
@@ -23,6 +23,8 @@
 #pragma once
 
 #include "intersections.h"
+#include "light_batch.h"
+#include "light_tree.h"
 #include "point_light.h"
 #include "ray.h"
 #include "shape.h"
@@ -43,7 +45,8 @@ namespace rtc
 
         World(Lights&& lights, Objects&& objects) :
             lights_(std::move(lights)),
-            objects_(std::move(objects))
+            objects_(std::move(objects)),
+            light_batch_(lights_)
         {
         }
 
@@ -53,34 +56,94 @@ namespace rtc
 
         const Lights& GetLights() const { return lights_; }
 
+        // Copy of the lights laid out for batched shading.
+        const LightBatch& GetLightBatch() const { return light_batch_; }
+
         const Objects& GetObjects() const { return objects_; }
 
         const PointLight& GetLight(size_t index) const { return lights_.at(index); }
 
         const std::shared_ptr<Shape>& GetObject(size_t index) const { return objects_.at(index); }
 
-        void SetLight(size_t index, const PointLight& light) { lights_.at(index) = light; }
+        void SetLight(size_t index, const PointLight& light)
+        {
+            lights_.at(index) = light;
+            light_batch_.Set(index, light);
+            light_tree_.reset();
+        }
+
+        void SetLight(size_t index, PointLight&& light)
+        {
+            lights_.at(index) = std::move(light);
+            light_batch_.Set(index, lights_[index]);
+            light_tree_.reset();
+        }
 
-        void SetLight(size_t index, PointLight&& light) { lights_.at(index) = std::move(light); }
+        // Move a light, keeping its intensity and the light tree. The tree does not bound the light at its new
+        // position until RefitLightTree() is called, which should be done after moving a set of lights and
+        // before rendering.
+        void SetLightPosition(size_t index, const Point& position)
+        {
+            lights_.at(index) = PointLight{ position, lights_[index].GetIntensity() };
+            light_batch_.SetPosition(index, position);
+        }
 
         void SetObject(size_t index, const std::shared_ptr<Shape>& object) { objects_.at(index) = object; }
 
         void SetObject(size_t index, std::shared_ptr<Shape>&& object) { objects_.at(index) = std::move(object); }
 
-        void AppendLight(const PointLight& light) { lights_.push_back(light); }
+        void AppendLight(const PointLight& light)
+        {
+            lights_.push_back(light);
+            light_batch_.Append(light);
+            light_tree_.reset();
+        }
 
-        void AppendLight(PointLight&& light) { lights_.emplace_back(std::move(light)); }
+        void AppendLight(PointLight&& light)
+        {
+            lights_.emplace_back(std::move(light));
+            light_batch_.Append(lights_.back());
+            light_tree_.reset();
+        }
 
         void AppendObject(const std::shared_ptr<Shape>& object) { objects_.push_back(object); }
 
         void AppendObject(std::shared_ptr<Shape>&& object) { objects_.emplace_back(std::move(object)); }
 
+        // Build a light hierarchy over the current lights. While the world has a light tree, shading uses it
+        // to skip lights behind the surface, and optionally to cull or sample lights as described for
+        // LightTree. Without one, every light is shaded. Changing the lights discards the tree.
+        void BuildLightTree() { light_tree_ = std::make_shared<const LightTree>(lights_); }
+
+        void BuildLightTree(Scalar min_importance, uint32_t sample_count) { light_tree_ = std::make_shared<const LightTree>(lights_, min_importance, sample_count); }
+
+        // Refit the light tree, if there is one, to the current light positions, keeping its structure.
+        void RefitLightTree()
+        {
+            if (light_tree_)
+            {
+                light_tree_ = std::make_shared<const LightTree>(*light_tree_, lights_);
+            }
+        }
+
+        void ClearLightTree() { light_tree_.reset(); }
+
+        const std::shared_ptr<const LightTree>& GetLightTree() const { return light_tree_; }
+
         Intersections Intersect(const Ray& ray) const;
 
+        // Fraction of the light traveling along a shadow ray that reaches distance. Objects with a material that
+        // does not cast shadows are skipped, and every surface of a transparent object crossed by the ray scales
+        // the light by its transparency. The traversal stops at the first opaque occluder, without collecting
+        // or sorting intersections, and returns it through occluder when occluder is not null.
+        Scalar Transmittance(const Ray& ray, Scalar distance, std::shared_ptr<const Shape>* occluder) const;
+
         static World GetDefault();
 
     private:
-        Lights  lights_;    ///< List of lights in the world.
-        Objects objects_;   ///< List of objects in the world.
+        Lights                           lights_;       ///< List of lights in the world.
+        Objects                          objects_;      ///< List of objects in the world.
+        LightBatch                       light_batch_;  ///< Structure of arrays copy of the lights.
+        std::shared_ptr<const LightTree> light_tree_;   ///< Optional hierarchy over the lights, used to cull and sample lights when shading.
     };
 }